@@ -1,10 +1,78 @@
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string>
 #include "game.h"
+#include "leaderboard.h"
+#include "transcript.h"
 
 using namespace std;
 
 int main(int argc, char *argv[]) {
+    string record = "";
+    string replay = "";
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--leaderboard" && i + 1 < argc) {
+            // Saved when the game ends
+            if (!globalLeaderboard().persistTo(argv[++i], chrono::milliseconds(0))) {
+                cerr << "Can't read the leaderboard " << argv[i] << endl;
+                return 1;
+            }
+        } else if (arg == "--record" && i + 1 < argc) {
+            record = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (arg == "--json") {
+            json = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--leaderboard FILE]"
+                 << " [--record FILE] [--replay FILE] [--json]" << endl;
+            return 1;
+        }
+    }
+
     AdventureGame ag;
-    cout << "Welcome to Adventure Game" << endl;
-    return ag.start();
+    TranscriptWriter transcript(ag.getVerbs());
+    if (!record.empty()) {
+        ag.setTranscript(&transcript);
+    }
+    if (json) {
+        ag.setOutputFormat(JSON_OUTPUT);
+    } else {
+        cout << "Welcome to Adventure Game" << endl;
+    }
+
+    // Replaying a recorded game before playing on from it
+    if (!replay.empty()) {
+        ifstream file(replay, ios::binary);
+        string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        TranscriptReader reader(data, ag.getVerbs());
+        TranscriptEntry entry;
+        GameStatus status = GameStatus::CONTINUE;
+        while (status == GameStatus::CONTINUE && reader.next(entry)) {
+            status = ag.replayCommand(entry);
+        }
+        if (!file || !reader.isValid()) {
+            cerr << "Can't replay the transcript " << replay << endl;
+            return 1;
+        }
+        if (status != GameStatus::CONTINUE) {
+            ag.finish(status);
+            return 0;
+        }
+    }
+
+    int status = ag.start();
+    if (!record.empty()) {
+        ofstream file(record, ios::binary);
+        file << transcript.getData();
+        if (!file.flush()) {
+            cerr << "Can't write the transcript " << record << endl;
+            return 1;
+        }
+    }
+    return status;
 }
@@ -0,0 +1,33 @@
+#ifndef ALLOC_BUDGET_H_
+#define ALLOC_BUDGET_H_
+
+/** @file alloc-budget.h
+ *
+ * The allocation budget of the walkthrough, checked by
+ * `game-bench --check-allocs`.
+ *
+ * The budgets are the recorded allocation counts of the engine. When a
+ * change makes a command allocate less, lower its budget so the saving
+ * can't regress unnoticed.
+ * */
+
+#include "walkthrough.h"
+
+/** Allocations allowed while constructing the game. */
+static const int SETUP_ALLOC_BUDGET = 154
+#ifdef GAME_ALLOC_TRACKING
+    // The allocation accounting adds a map node for every verb
+    + 28
+#endif
+    ;
+
+/** Allocations allowed for each command of the walkthrough, in order. */
+static const int WALKTHROUGH_ALLOC_BUDGET[] = {
+    0, 0, 0, 0, 5, 0, 0, 0, 1, 0, 0, 0, 3, 0, 0, 4, 0, 1,
+    0, 0, 0, 3, 0, 3, 0, 0, 0, 0, 0, 0, 1, 3, 0, 0, 0, 0
+};
+
+static_assert(sizeof(WALKTHROUGH_ALLOC_BUDGET) / sizeof(WALKTHROUGH_ALLOC_BUDGET[0])
+              == WALKTHROUGH_LENGTH, "every walkthrough command needs a budget");
+
+#endif // ALLOC_BUDGET_H_
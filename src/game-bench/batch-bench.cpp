@@ -0,0 +1,142 @@
+#include "suites.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "batch-environment.h"
+#include "game.h"
+
+using namespace std;
+
+/** Picks random actions for the games of a batch environment, without the
+ * fights so the games don't end while measuring.
+ *
+ * @param env The environment.
+ * @param steps The number of steps.
+ * @param seed The seed of the random numbers.
+ * @return The actions of every step.
+ * */
+static vector<vector<uint32_t>> peacefulActions(const BatchEnvironment &env, size_t steps,
+                                                uint32_t seed) {
+    mt19937 random(seed);
+    uniform_int_distribution<uint32_t> pick(0, (uint32_t) env.getActions().size() - 1);
+    vector<vector<uint32_t>> actions(steps, vector<uint32_t>(env.size()));
+    for (vector<uint32_t> &step: actions) {
+        for (uint32_t &action: step) {
+            do {
+                action = pick(random);
+            } while (env.getActions()[action] == "killmonster");
+        }
+    }
+    return actions;
+}
+
+/** Benchmarks stepping 1024 games of a batch environment from 1 to 8
+ * threads, and typing the same actions into the games one at a time. */
+void benchBatchEnvironment(BenchRunner &runner) {
+    const size_t games = 1024;
+    const size_t steps = 64;
+    BenchResult single;
+    for (size_t threads: {1, 2, 4, 8}) {
+        string name = "batch/step/" + to_string(threads);
+        if (!runner.selected(name)) {
+            continue;
+        }
+        BatchEnvironment env(games, threads);
+        env.reset(vector<uint32_t>(games, 0));
+        vector<vector<uint32_t>> actions = peacefulActions(env, steps, 49);
+        size_t step = 0;
+        BenchResult result = runner.measure(name, [&]() {
+            env.step(actions[step++ % steps]);
+            doNotOptimize(env.getRewards().data());
+        });
+        result.items_per_op = (double) games;
+        if (threads == 1) {
+            single = result;
+        } else if (single.ns_per_op > 0) {
+            result.speedup = single.ns_per_op / result.ns_per_op;
+        }
+        runner.report(result);
+    }
+
+    if (runner.selected("batch/typed/1")) {
+        BatchEnvironment env(games, 1);
+        env.reset(vector<uint32_t>(games, 0));
+        vector<vector<uint32_t>> actions = peacefulActions(env, steps, 49);
+        size_t step = 0;
+        BenchResult result = runner.measure("batch/typed/1", [&]() {
+            const vector<uint32_t> &typed = actions[step++ % steps];
+            for (size_t i = 0; i < games; i++) {
+                doNotOptimize(env.getGame(i)->runCommand(env.getActions()[typed[i]]));
+            }
+        });
+        result.items_per_op = (double) games;
+        runner.report(result);
+    }
+}
+
+/** Checks a batch environment against itself with another number of
+ * threads and against typing its actions into games.
+ *
+ * Random actions are run on 256 games for 300 steps, every game that ends
+ * is reset with a new seed.
+ *
+ * @param out The stream to write the report to.
+ * @return If every observation, reward and done flag was the same.
+ * */
+bool checkBatchEnvironment(ostream &out) {
+    const size_t games = 256;
+    const size_t steps = 300;
+    BatchEnvironment single(games, 1);
+    BatchEnvironment parallel(games, 4);
+    vector<uint32_t> seeds(games);
+    for (size_t i = 0; i < games; i++) {
+        seeds[i] = (uint32_t) i;
+    }
+    single.reset(seeds);
+    parallel.reset(seeds);
+
+    // Games typed into one at a time
+    vector<unique_ptr<AdventureGame>> typed(games);
+    for (unique_ptr<AdventureGame> &game: typed) {
+        game.reset(new AdventureGame());
+    }
+
+    mt19937 random(49);
+    uniform_int_distribution<uint32_t> pick(0, (uint32_t) single.getActions().size() - 1);
+    vector<uint32_t> actions(games);
+    size_t differ = 0;
+    size_t wins = 0;
+    size_t defeats = 0;
+    for (size_t step = 0; step < steps; step++) {
+        for (uint32_t &action: actions) {
+            action = pick(random);
+        }
+        single.step(actions);
+        parallel.step(actions);
+
+        for (size_t i = 0; i < games; i++) {
+            GameStatus status = typed[i]->runCommand(single.getActions()[actions[i]]);
+            differ += status != single.getStatuses()[i] ||
+                      typed[i]->saveState() != single.getGame(i)->saveState();
+            if (single.getDone()[i]) {
+                wins += status == GameStatus::VICTORY;
+                defeats += status == GameStatus::DEFEAT;
+                single.reset(i, 0);
+                parallel.reset(i, 0);
+                typed[i].reset(new AdventureGame());
+            }
+        }
+        differ += single.getObservations() != parallel.getObservations() ||
+                  single.getRewards() != parallel.getRewards() ||
+                  single.getDone() != parallel.getDone();
+    }
+    out << (differ == 0 ? "ok   " : "FAIL ") << differ << " differences in "
+        << games * steps << " steps of " << single.getActions().size() << " actions with "
+        << parallel.getThreads() << " threads, " << wins << " won, " << defeats
+        << " lost" << endl;
+    return differ == 0;
+}
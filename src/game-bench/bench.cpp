@@ -0,0 +1,56 @@
+#include "bench.h"
+
+#include <ostream>
+#include <string>
+
+/** Constructor for BenchRunner.
+ *
+ * @param out The stream to write the JSON to.
+ * @param filter Only benchmarks whose name contains this are run.
+ * @param min_time_ms The minimum time of a repetition.
+ * */
+BenchRunner::BenchRunner(std::ostream &out, std::string filter, double min_time_ms):
+    m_out(out), m_filter(filter), m_min_time_ns(min_time_ms * 1e6) {
+    this->m_out << "{\n  \"benchmarks\": [";
+}
+
+/** Finishes the JSON document. */
+BenchRunner::~BenchRunner(void) {
+    this->m_out << "\n  ]\n}" << std::endl;
+}
+
+/** Checks if a benchmark is selected by the filter.
+ *
+ * @param name The name of the benchmark.
+ * @return If the benchmark should run.
+ * */
+bool BenchRunner::selected(const std::string &name) const {
+    return name.find(this->m_filter) != std::string::npos;
+}
+
+/** Writes a result measured outside of the runner.
+ *
+ * @param result The result to write.
+ * */
+void BenchRunner::report(const BenchResult &result) {
+    if (!this->m_first) {
+        this->m_out << ",";
+    }
+    this->m_first = false;
+
+    double ops_per_sec = result.ns_per_op > 0 ? 1e9 / result.ns_per_op : 0;
+    this->m_out << "\n    {\"name\": \"" << result.name << "\""
+                << ", \"iterations\": " << result.iterations
+                << ", \"ns_per_op\": " << result.ns_per_op
+                << ", \"ops_per_sec\": " << ops_per_sec
+                << ", \"allocs_per_op\": " << result.allocs_per_op
+                << ", \"bytes_per_op\": " << result.bytes_per_op;
+    if (result.items_per_op > 0) {
+        this->m_out << ", \"items_per_sec\": " << result.items_per_op * ops_per_sec;
+    }
+    if (result.speedup > 0) {
+        this->m_out << ", \"speedup\": " << result.speedup;
+    }
+    this->m_out << "}";
+    this->m_out.flush();
+}
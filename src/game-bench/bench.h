@@ -0,0 +1,139 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/** @file bench.h
+ *
+ * Header file containing a small microbenchmark runner that reports its
+ * results as JSON.
+ * */
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "alloc-counter.h"
+
+/** Prevents the compiler from optimising away a value.
+ *
+ * @param value The value to keep.
+ * */
+template <class T>
+inline void doNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** The result of a benchmark. */
+struct BenchResult {
+    std::string name; /**<Name of the benchmark. */
+    uint64_t iterations = 0; /**<Iterations in each repetition. */
+    double ns_per_op = 0; /**<Median nanoseconds per operation. */
+    double allocs_per_op = 0; /**<Allocations per operation. */
+    double bytes_per_op = 0; /**<Bytes allocated per operation. */
+    double items_per_op = 0; /**<Items processed per operation, if they are counted. */
+    double speedup = 0; /**<Speedup over a baseline, if there is one. */
+};
+
+/** Runs microbenchmarks and writes the results as JSON.
+ *
+ * Each benchmark is calibrated until a repetition takes at least the
+ * minimum time, then repeated a few times and the median is reported.
+ * */
+class BenchRunner {
+    public:
+        /** Constructor for BenchRunner.
+         *
+         * @param out The stream to write the JSON to.
+         * @param filter Only benchmarks whose name contains this are run.
+         * @param min_time_ms The minimum time of a repetition.
+         * */
+        BenchRunner(std::ostream &out, std::string filter = "",
+                    double min_time_ms = 50);
+        /** Finishes the JSON document. */
+        ~BenchRunner(void);
+
+        /** Checks if a benchmark is selected by the filter.
+         *
+         * @param name The name of the benchmark.
+         * @return If the benchmark should run.
+         * */
+        bool selected(const std::string &name) const;
+        /** Runs a benchmark.
+         *
+         * @param name The name of the benchmark.
+         * @param op The operation to measure, called once per iteration.
+         * */
+        template <class Op>
+        void run(const std::string &name, Op &&op) {
+            if (this->selected(name)) {
+                this->report(this->measure(name, op));
+            }
+        }
+        /** Measures a benchmark without writing its result.
+         *
+         * @param name The name of the benchmark.
+         * @param op The operation to measure, called once per iteration.
+         * @return The result.
+         * */
+        template <class Op>
+        BenchResult measure(const std::string &name, Op &&op) {
+
+            // Calibrating the number of iterations
+            uint64_t iterations = 1;
+            while (this->time(op, iterations) < this->m_min_time_ns &&
+                   iterations < (1ull << 30)) {
+                iterations *= 2;
+            }
+
+            // Measuring
+            std::vector<double> samples;
+            samples.reserve(REPETITIONS);
+            AllocStats before = allocStats();
+            for (int i = 0; i < REPETITIONS; i++) {
+                samples.push_back(this->time(op, iterations) / iterations);
+            }
+            AllocStats allocs = allocDelta(before, allocStats());
+            std::sort(samples.begin(), samples.end());
+
+            BenchResult result;
+            result.name = name;
+            result.iterations = iterations;
+            result.ns_per_op = samples[samples.size() / 2];
+            result.allocs_per_op = (double) allocs.count / (iterations * REPETITIONS);
+            result.bytes_per_op = (double) allocs.bytes / (iterations * REPETITIONS);
+            return result;
+        }
+        /** Writes a result measured outside of the runner.
+         *
+         * @param result The result to write.
+         * */
+        void report(const BenchResult &result);
+    private:
+        /** Number of measured repetitions of each benchmark. */
+        static constexpr int REPETITIONS = 5;
+
+        /** Times a number of iterations of the operation.
+         *
+         * @param op The operation.
+         * @param iterations The number of iterations.
+         * @return The time taken in nanoseconds.
+         * */
+        template <class Op>
+        double time(Op &op, uint64_t iterations) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < iterations; i++) {
+                op();
+            }
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        std::ostream &m_out; /**<The JSON output. */
+        std::string m_filter; /**<Selected benchmarks. */
+        double m_min_time_ns; /**<Minimum time of a repetition. */
+        bool m_first = true; /**<If no result has been written yet. */
+};
+
+#endif // BENCH_H_
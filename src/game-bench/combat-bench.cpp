@@ -0,0 +1,204 @@
+#include "suites.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "combat.h"
+#include "combat-batch.h"
+#include "enemies.h"
+#include "items.h"
+#include "player.h"
+#include "room.h"
+#include "world.h"
+
+using namespace std;
+
+/** Benchmarks a fight against each kind of enemy.
+ *
+ * The player and the enemy are healed after every fight so each iteration
+ * is a full fight. The virtual and kernel paths are measured separately.
+ * */
+void benchCombat(BenchRunner &runner) {
+    struct Setup {
+        string name;
+        EnemyKind kind;
+        vector<string> items;
+    };
+    for (Setup setup: {Setup{"generic", GENERIC_ENEMY, {"Sword"}},
+                       Setup{"werewolf", WEREWOLF, {"Silver Spear"}},
+                       Setup{"vampire", VAMPIRE, {"Sword", "Diamond Cross"}}}) {
+        World world;
+        Room room("Arena", world);
+        Player player(1000000, 1, 3, world);
+        for (string item: setup.items) {
+            player.addItem(world.createItem<Weapon>(item, 2));
+        }
+
+        EnemyHandle handle;
+        if (setup.kind == WEREWOLF) {
+            handle = world.createEnemy<Werewolf>(12, 3, "Werewolf");
+        } else if (setup.kind == VAMPIRE) {
+            handle = world.createEnemy<Vampire>(12, 3, "Dracula");
+        } else {
+            handle = world.createEnemy<GenericEnemy>(12, 3, "Zombie");
+        }
+        room.addEnemey(handle);
+        GenericEnemy *enemy = world.getEnemy(handle);
+
+        auto heal = [&]() {
+            enemy->healEntity(enemy->getMaxHealth());
+            player.healEntity(player.getMaxHealth());
+        };
+        runner.run("combat/killEnemy/" + setup.name, [&]() {
+            doNotOptimize(room.killEnemy(0, &player));
+            heal();
+        });
+        runner.run("combat/virtual/" + setup.name, [&]() {
+            doNotOptimize(fightVirtual(&player, enemy));
+            heal();
+        });
+        runner.run("combat/kernel/" + setup.name, [&]() {
+            doNotOptimize(fight(&player, enemy));
+            heal();
+        });
+    }
+}
+
+/** Creates random fights with stats around the ones of the castle.
+ *
+ * Fights where neither side can hurt the other are left out, they never
+ * end in the game.
+ *
+ * @param count The number of fights.
+ * @param seed The seed of the random numbers.
+ * @return The fights.
+ * */
+static FightBatch randomFights(size_t count, uint32_t seed) {
+    mt19937 random(seed);
+    auto between = [&](int low, int high) {
+        return low + (int) (random() % (high - low + 1));
+    };
+
+    FightBatch fights;
+    fights.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        int damage;
+        do {
+            fights.player_health[i] = between(1, 30);
+            fights.player_damage[i] = between(0, 6);
+            fights.spears[i] = between(0, 2);
+            fights.swords[i] = between(0, 2);
+            fights.crosses[i] = between(0, 1);
+            fights.enemy_kind[i] = between(GENERIC_ENEMY, VAMPIRE);
+            fights.enemy_health[i] = between(0, 20);
+            fights.enemy_damage[i] = between(-1, 5);
+
+            damage = fights.player_damage[i];
+            if (fights.enemy_kind[i] == WEREWOLF) {
+                damage += 3 * fights.spears[i];
+            } else if (fights.enemy_kind[i] == VAMPIRE) {
+                damage += 4 * fights.crosses[i] - fights.swords[i];
+            }
+        } while (damage <= 0 && fights.enemy_damage[i] <= 0);
+    }
+    return fights;
+}
+
+/** Benchmarks resolving a batch of fights with each kernel.
+ *
+ * The speedup of the vector kernel is over the scalar kernel.
+ * */
+void benchBatchCombat(BenchRunner &runner) {
+    FightBatch fights = randomFights(4096, 2);
+    FightResults results;
+    BenchResult scalar;
+    for (FightKernel kernel: {SCALAR_FIGHT_KERNEL, AVX2_FIGHT_KERNEL}) {
+        string name = kernel == SCALAR_FIGHT_KERNEL ? "combat/batch/scalar"
+                                                    : "combat/batch/avx2";
+        if (!runner.selected(name) || !fightKernelSupported(kernel)) {
+            continue;
+        }
+        BenchResult result = runner.measure(name, [&]() {
+            resolveFights(fights, results, kernel);
+            doNotOptimize(results.status.data());
+        });
+        result.items_per_op = (double) fights.size();
+        if (kernel == SCALAR_FIGHT_KERNEL) {
+            scalar = result;
+        } else if (scalar.ns_per_op > 0) {
+            result.speedup = scalar.ns_per_op / result.ns_per_op;
+        }
+        runner.report(result);
+    }
+}
+
+/** Checks the batch kernels against Room::killEnemy().
+ *
+ * Every fight is also fought by a Player with the loadout in a room.
+ *
+ * @param out The stream to write the report to.
+ * @return If every kernel gave the results of the game.
+ * */
+bool checkCombat(ostream &out) {
+    FightBatch fights = randomFights(100000, 1);
+    vector<FightKernel> kernels = {SCALAR_FIGHT_KERNEL};
+    if (fightKernelSupported(AVX2_FIGHT_KERNEL)) {
+        kernels.push_back(AVX2_FIGHT_KERNEL);
+    }
+    vector<FightResults> results(kernels.size());
+    for (size_t k = 0; k < kernels.size(); k++) {
+        resolveFights(fights, results[k], kernels[k]);
+    }
+
+    vector<size_t> mismatches(kernels.size(), 0);
+    for (size_t i = 0; i < fights.size(); i++) {
+        World world;
+        Room room("Arena", world);
+        int items = fights.spears[i] + fights.swords[i] + fights.crosses[i];
+        Player player(fights.player_health[i], fights.player_damage[i],
+                      items > 0 ? items : 1, world);
+        for (int j = 0; j < fights.spears[i]; j++) {
+            player.getInventory()->addItem(world.createItem<GenericItem>("Silver Spear"));
+        }
+        for (int j = 0; j < fights.swords[i]; j++) {
+            player.getInventory()->addItem(world.createItem<GenericItem>("Sword"));
+        }
+        for (int j = 0; j < fights.crosses[i]; j++) {
+            player.getInventory()->addItem(world.createItem<GenericItem>("Diamond Cross"));
+        }
+
+        int health = fights.enemy_health[i];
+        int damage = fights.enemy_damage[i];
+        EnemyHandle handle;
+        if (fights.enemy_kind[i] == WEREWOLF) {
+            handle = world.createEnemy<Werewolf>(health, damage, "Werewolf");
+        } else if (fights.enemy_kind[i] == VAMPIRE) {
+            handle = world.createEnemy<Vampire>(health, damage, "Dracula");
+        } else {
+            handle = world.createEnemy<GenericEnemy>(health, damage, "Zombie");
+        }
+        room.addEnemey(handle);
+        KillStatus status = room.killEnemy(0, &player);
+
+        for (size_t k = 0; k < kernels.size(); k++) {
+            if (results[k].status[i] != status ||
+                results[k].player_health[i] != player.getCurrentHealth() ||
+                results[k].enemy_health[i] != world.getEnemy(handle)->getCurrentHealth() ||
+                results[k].xp[i] != player.getXP()) {
+                mismatches[k]++;
+            }
+        }
+    }
+
+    bool identical = true;
+    for (size_t k = 0; k < kernels.size(); k++) {
+        out << (mismatches[k] == 0 ? "ok   " : "FAIL ")
+            << (kernels[k] == SCALAR_FIGHT_KERNEL ? "scalar" : "avx2")
+            << ": " << mismatches[k] << " of " << fights.size()
+            << " fights differ from Room::killEnemy()" << endl;
+        identical = identical && mismatches[k] == 0;
+    }
+    return identical;
+}
@@ -0,0 +1,161 @@
+#include "suites.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "alloc-budget.h"
+#include "game.h"
+#include "command-stats.h"
+#include "player.h"
+#include "room.h"
+#include "world.h"
+
+using namespace std;
+
+/** Benchmarks the command dispatch of HKGE through AdventureGame. */
+void benchDispatch(BenchRunner &runner) {
+    for (string command: {"look", "inventory", "north", "help", "xyzzy"}) {
+        AdventureGame game;
+        runner.run("hkge/dispatch/" + command, [&]() {
+            doNotOptimize(game.runCommand(command));
+        });
+    }
+}
+
+/** Benchmarks rendering the description of a room. */
+void benchDescription(BenchRunner &runner) {
+    AdventureGame game;
+    game.runCommand("e");
+    game.runCommand("s");
+    Room *room = game.getRoom();
+    runner.run("room/getDescription", [&]() {
+        string description = room->getDescription();
+        doNotOptimize(description);
+    });
+}
+
+/** Benchmarks the overhead of timing and recording a command. */
+void benchStats(BenchRunner &runner) {
+    CommandStats stats;
+    stats.addVerb("get");
+    string command = "get silver spear";
+    runner.run("stats/record", [&]() {
+        stats.record(command, 1234);
+    });
+    GameLatencies latencies;
+    latencies.addVerb("get");
+    runner.run("stats/game-record", [&]() {
+        latencies.record(command, 1234);
+    });
+    runner.run("stats/time+record", [&]() {
+        auto start = chrono::steady_clock::now();
+        doNotOptimize(start);
+        auto end = chrono::steady_clock::now();
+        stats.record(command, chrono::duration_cast<chrono::nanoseconds>(
+                     end - start).count());
+    });
+}
+
+/** Benchmarks creating and destroying a player and a game. */
+void benchGame(BenchRunner &runner) {
+    World world;
+    runner.run("player/construct+destroy", [&]() {
+        Player player(12, 1, 3, world);
+        doNotOptimize(player.getInventory());
+    });
+    runner.run("game/construct+destroy", [&]() {
+        AdventureGame game;
+        doNotOptimize(game.getRoom());
+    });
+}
+
+/** Checks the allocations of the walkthrough against its budget.
+ *
+ * The walkthrough is played once first so the object pools and the
+ * buffers of the thread already have their blocks, as in a process serving
+ * many games. Every command over its budget is reported.
+ *
+ * @param out The stream to write the report to.
+ * @return If every command was within its budget.
+ * */
+bool checkAllocs(ostream &out) {
+    bool within_budget = true;
+    auto check = [&](const string &name, AllocStats allocs, int budget) {
+        bool within = allocs.count <= (size_t) budget;
+        out << (within ? "ok   " : "FAIL ") << name << ": " << allocs.count
+            << " allocations (" << allocs.bytes << " bytes), budget "
+            << budget << endl;
+        within_budget = within_budget && within;
+    };
+
+    {
+        AdventureGame warmup;
+        for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+            warmup.runCommand(WALKTHROUGH[i]);
+        }
+    }
+    AllocStats before = allocStats();
+    AdventureGame game;
+    check("(setup)", allocDelta(before, allocStats()), SETUP_ALLOC_BUDGET);
+
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        before = allocStats();
+        game.runCommand(WALKTHROUGH[i]);
+        check(to_string(i) + " " + WALKTHROUGH[i],
+              allocDelta(before, allocStats()), WALKTHROUGH_ALLOC_BUDGET[i]);
+    }
+    return within_budget;
+}
+
+/** Checks the latencies kept by a game against a LatencyHistogram fed the
+ * same latencies, and that a game doesn't see the commands of another game
+ * run on the same thread.
+ *
+ * @param out The stream to write the report to.
+ * @return If the latencies were right.
+ * */
+bool checkStats(ostream &out) {
+    const string verbs[] = {"get", "look", "kill"};
+    LatencyHistogram histograms[3];
+    GameLatencies latencies(4);
+    for (const string &verb: verbs) {
+        latencies.addVerb(verb);
+    }
+    mt19937_64 random(29);
+    uniform_int_distribution<size_t> pick(0, 3);
+    size_t differ = 0;
+    for (int i = 0; i < 20000; i++) {
+        // Latencies spread over many powers of two, and unknown verbs
+        size_t verb = pick(random);
+        uint64_t ns = random() >> (random() % 64);
+        latencies.record(verb < 3 ? verbs[verb] + " thing" : "xyzzy", ns);
+        if (verb < 3) {
+            histograms[verb].record(ns);
+        }
+    }
+    for (size_t verb = 0; verb < 3; verb++) {
+        differ += latencies.count(verbs[verb]) != histograms[verb].count();
+        for (double percentile: {0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+            differ += latencies.percentile(verbs[verb], percentile) !=
+                      histograms[verb].percentile(percentile);
+        }
+    }
+    differ += latencies.count("xyzzy") != 0 || latencies.count(CommandStats::INVALID_VERB) == 0;
+
+    // Two games on the thread
+    AdventureGame first;
+    first.runCommand("e");
+    first.runCommand("l");
+    AdventureGame second;
+    second.runCommand("e");
+    differ += first.getStats().count("e") != 1 || second.getStats().count("e") != 1 ||
+              second.getStats().count("l") != 0 ||
+              HKGE::getThreadStats().getHistogram("e")->count() < 2;
+
+    out << (differ == 0 ? "ok   " : "FAIL ") << differ
+        << " of 26 latency statistics differ" << endl;
+    return differ == 0;
+}
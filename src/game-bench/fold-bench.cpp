@@ -0,0 +1,137 @@
+#include "suites.h"
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "ascii-fold.h"
+#include "items.h"
+#include "world.h"
+
+using namespace std;
+
+/** Gets the supported case folding kernels.
+ *
+ * @return The kernels, scalar first.
+ * */
+static vector<FoldKernel> foldKernels(void) {
+    vector<FoldKernel> kernels;
+    for (FoldKernel kernel: {SCALAR_FOLD_KERNEL, SSE2_FOLD_KERNEL, AVX2_FOLD_KERNEL}) {
+        if (foldKernelSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+/** Gets the name of a case folding kernel.
+ *
+ * @param kernel The kernel.
+ * @return The name.
+ * */
+static const char* foldKernelName(FoldKernel kernel) {
+    return kernel == AVX2_FOLD_KERNEL ? "avx2" :
+           kernel == SSE2_FOLD_KERNEL ? "sse2" : "scalar";
+}
+
+/** Benchmarks folding typed lines of a few lengths with std::transform()
+ * and every kernel, and comparing names ignoring case. */
+void benchFold(BenchRunner &runner) {
+    for (size_t size: {12, 64, 1024}) {
+        string line;
+        while (line.size() < size) {
+            line += "Get Silver Spear ";
+        }
+        line.resize(size);
+        runner.run("fold/transform/" + to_string(size), [&]() {
+            transform(line.begin(), line.end(), line.begin(), ::tolower);
+            doNotOptimize(line.data());
+        });
+        for (FoldKernel kernel: foldKernels()) {
+            runner.run(string("fold/") + foldKernelName(kernel) + "/" + to_string(size), [&]() {
+                normalizeLine(line, kernel);
+                doNotOptimize(line.data());
+            });
+        }
+    }
+
+    World world;
+    GenericItem item("Golden Chalice");
+    string name = "golden chalice";
+    runner.run("compare/transform", [&]() {
+        string this_lower = item.getName();
+        string other_lower = name;
+        transform(this_lower.begin(), this_lower.end(), this_lower.begin(), ::tolower);
+        transform(other_lower.begin(), other_lower.end(), other_lower.begin(), ::tolower);
+        doNotOptimize(this_lower == other_lower);
+    });
+    runner.run("compare/equalsFolded", [&]() {
+        doNotOptimize(item == name);
+    });
+}
+
+/** Checks every case folding kernel against folding one byte at a time
+ * with std::tolower() on random lines.
+ *
+ * @param out The stream to write the report to.
+ * @return If every kernel folded, normalised and compared like the
+ * reference.
+ * */
+bool checkFold(ostream &out) {
+    mt19937 random(47);
+    const string alphabet = "aZmQz@[`{ \t\r\n\x80\xC3\xFF" "09";
+    uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    uniform_int_distribution<size_t> length(0, 100);
+    vector<FoldKernel> kernels = foldKernels();
+    vector<size_t> mismatches(kernels.size(), 0);
+    const size_t lines = 20000;
+    for (size_t n = 0; n < lines; n++) {
+        string line;
+        for (size_t size = length(random); line.size() < size;) {
+            line += alphabet[pick(random)];
+        }
+
+        // Folding and splitting into words one byte at a time
+        string folded = line;
+        for (char &c: folded) {
+            c = (char) tolower((unsigned char) c);
+        }
+        string normalized;
+        istringstream words(folded);
+        for (string word; words >> word;) {
+            normalized += (normalized.empty() ? "" : " ") + word;
+        }
+        string other = line;
+        if (!other.empty() && n % 2 == 1) {
+            other[n % other.size()] ^= 1;
+        }
+        bool equal = folded.size() == other.size();
+        for (size_t i = 0; equal && i < other.size(); i++) {
+            equal = folded[i] == (char) tolower((unsigned char) other[i]);
+        }
+
+        for (size_t k = 0; k < kernels.size(); k++) {
+            string case_folded = line;
+            foldCase(case_folded, kernels[k]);
+            string line_normalized = line;
+            normalizeLine(line_normalized, kernels[k]);
+            if (case_folded != folded || line_normalized != normalized ||
+                equalsFolded(line, other, kernels[k]) != equal) {
+                mismatches[k]++;
+            }
+        }
+    }
+
+    bool identical = true;
+    for (size_t k = 0; k < kernels.size(); k++) {
+        out << (mismatches[k] == 0 ? "ok   " : "FAIL ") << foldKernelName(kernels[k])
+            << ": " << mismatches[k] << " of " << lines
+            << " lines differ from std::tolower()" << endl;
+        identical = identical && mismatches[k] == 0;
+    }
+    return identical;
+}
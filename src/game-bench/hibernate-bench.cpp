@@ -0,0 +1,76 @@
+#include "suites.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "hibernating-game.h"
+
+using namespace std;
+
+/** Benchmarks saving a game halfway through the walkthrough, and freeing
+ * it and bringing it back. */
+void benchHibernate(BenchRunner &runner) {
+    HibernatingGame game;
+    for (int i = 0; i < WALKTHROUGH_LENGTH / 2; i++) {
+        game.get().runCommand(WALKTHROUGH[i]);
+    }
+    game.takeOutput();
+    runner.run("hibernate/saveState", [&]() {
+        doNotOptimize(game.get().saveState());
+    });
+    runner.run("hibernate/hibernate+rehydrate", [&]() {
+        game.hibernate();
+        doNotOptimize(&game.get());
+    });
+}
+
+/** Checks that hibernating a game before every command of the walkthrough
+ * doesn't change what the game writes.
+ *
+ * @param out The stream to write the report to.
+ * @return If the output was the same.
+ * */
+bool checkHibernate(ostream &out) {
+    // Inventories, dead enemies and repeated commands in between the
+    // walkthrough, its second half in JSON
+    vector<string> commands;
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        if (i == WALKTHROUGH_LENGTH / 2) {
+            commands.push_back("format json");
+        }
+        commands.push_back(WALKTHROUGH[i]);
+        if (commands.back() == "km") {
+            commands.push_back("km");
+        }
+        if (i % 5 == 4) {
+            commands.push_back("i");
+            commands.push_back("");
+        }
+    }
+
+    HibernatingGame awake;
+    HibernatingGame hibernating;
+    size_t differ = 0;
+    size_t largest = 0;
+    double slowest_ms = 0;
+    for (const string &command: commands) {
+        hibernating.hibernate();
+        largest = max(largest, hibernating.hibernatedBytes());
+        auto start = chrono::steady_clock::now();
+        AdventureGame &game = hibernating.get();
+        slowest_ms = max(slowest_ms, chrono::duration<double, milli>(
+                         chrono::steady_clock::now() - start).count());
+
+        awake.get().runCommand(command);
+        game.runCommand(command);
+        differ += awake.takeOutput() != hibernating.takeOutput();
+    }
+    out << (differ == 0 ? "ok   " : "FAIL ") << differ << " of " << commands.size()
+        << " commands differ after hibernating, at most " << largest
+        << " bytes kept, slowest rehydration " << slowest_ms << " ms" << endl;
+    return differ == 0;
+}
@@ -0,0 +1,281 @@
+#include "suites.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "event-queue.h"
+#include "game.h"
+#include "interest-map.h"
+#include "room.h"
+#include "shared-world.h"
+#include "world.h"
+
+using namespace std;
+
+/** Benchmarks keeping the interest of players moving on a grid and
+ * delivering updates of random rooms only to the players near them.
+ *
+ * The grids range from 16x16 to 256x256 rooms with a player every 16 or 4
+ * rooms. The recipients of an update are counted as items, the speedup of
+ * routing is over broadcasting to every player.
+ * */
+void benchInterest(BenchRunner &runner) {
+    const unsigned int radius = 2;
+    for (size_t side: {16, 64, 256}) {
+        for (size_t rooms_per_player: {16, 4}) {
+            size_t players = side * side / rooms_per_player;
+            string suffix = to_string(side) + "x" + to_string(side) + "/" + to_string(players);
+            if (!runner.selected("interest/move/" + suffix) &&
+                !runner.selected("interest/route/" + suffix) &&
+                !runner.selected("interest/broadcast/" + suffix)) {
+                continue;
+            }
+
+            World world;
+            buildGrid(world, side);
+            InterestMap interest(world, radius);
+            vector<EventQueue> queues(players);
+            vector<Room *> rooms(players);
+            mt19937 random(1);
+            for (size_t i = 0; i < players; i++) {
+                rooms[i] = world.getRoom(random() % world.roomCount());
+                interest.move(&queues[i], rooms[i]);
+            }
+            vector<size_t> targets(4096);
+            for (size_t &target: targets) {
+                target = random() % world.roomCount();
+            }
+            vector<EventBuffer> drained;
+            auto drainAll = [&]() {
+                for (EventQueue &queue: queues) {
+                    queue.drain(drained);
+                    drained.clear();
+                }
+            };
+
+            size_t next = 0;
+            runner.run("interest/move/" + suffix, [&]() {
+                size_t player = next++ % players;
+                Room *room = rooms[player]->getRoom((Direction) (random() % 4));
+                if (room != nullptr) {
+                    rooms[player] = room;
+                    interest.move(&queues[player], room);
+                }
+            });
+
+            double recipients = 0;
+            for (size_t id = 0; id < world.roomCount(); id++) {
+                recipients += interest.getInterested(world.getRoom(id)).size();
+            }
+            recipients /= world.roomCount();
+
+            EventBuffer event = makeEvent("Player 1 picks up the Stone.\n");
+            BenchResult route = runner.measure("interest/route/" + suffix, [&]() {
+                doNotOptimize(interest.route(world.getRoom(targets[next++ % targets.size()]),
+                                             event));
+                if (next % 4096 == 0) {
+                    drainAll();
+                }
+            });
+            route.items_per_op = recipients;
+            drainAll();
+
+            BenchResult broadcast = runner.measure("interest/broadcast/" + suffix, [&]() {
+                for (EventQueue &queue: queues) {
+                    queue.push(event);
+                }
+                if (++next % 64 == 0) {
+                    drainAll();
+                }
+            });
+            broadcast.items_per_op = (double) players;
+            drainAll();
+            if (route.ns_per_op > 0) {
+                route.speedup = broadcast.ns_per_op / route.ns_per_op;
+            }
+            runner.report(route);
+            runner.report(broadcast);
+        }
+    }
+}
+
+/** Checks the interest of players wandering a grid against the rooms
+ * within the radius of their room, and the players each update is routed
+ * to. A game tracked through HKGE::setInterest() and the events of a
+ * SharedWorld with a radius are checked the same way.
+ *
+ * @param out The stream to write the report to.
+ * @return If every interest and recipient was right.
+ * */
+bool checkInterest(ostream &out) {
+    const size_t side = 16;
+    const unsigned int radius = 2;
+    // On the grid the exits between two rooms are their Manhattan distance
+    auto within = [&](size_t from, size_t to) {
+        size_t rows = from / side > to / side ? from / side - to / side : to / side - from / side;
+        size_t columns = from % side > to % side ? from % side - to % side : to % side - from % side;
+        return rows + columns <= radius;
+    };
+
+    // Players moving, leaving and coming back at random
+    World world;
+    buildGrid(world, side);
+    InterestMap interest(world, radius);
+    vector<EventQueue> queues(32);
+    vector<Room *> rooms(queues.size(), nullptr);
+    EventBuffer event = makeEvent("Cell 0: Player 1 drops the Stone.\n");
+    vector<EventBuffer> drained;
+    vector<size_t> expected;
+    mt19937 random(44);
+    size_t wrong_interest = 0;
+    size_t wrong_routes = 0;
+    const size_t steps = 2000;
+    for (size_t step = 0; step < steps; step++) {
+        size_t player = random() % queues.size();
+        if (rooms[player] != nullptr && random() % 8 == 0) {
+            interest.remove(&queues[player]);
+            rooms[player] = nullptr;
+        } else {
+            Room *room = rooms[player] == nullptr ?
+                world.getRoom(random() % world.roomCount()) :
+                rooms[player]->getRoom((Direction) (random() % 4));
+            if (room != nullptr) {
+                rooms[player] = room;
+                interest.move(&queues[player], room);
+            }
+        }
+
+        for (size_t i = 0; i < queues.size(); i++) {
+            expected.clear();
+            for (size_t id = 0; rooms[i] != nullptr && id < world.roomCount(); id++) {
+                if (within(rooms[i]->getId(), id)) {
+                    expected.push_back(id);
+                }
+            }
+            wrong_interest += interest.getInterest(&queues[i]) != expected;
+        }
+
+        // An update of a random room, except for a random player
+        Room *target = world.getRoom(random() % world.roomCount());
+        size_t except = random() % queues.size();
+        size_t sent = interest.route(target, event, &queues[except]);
+        size_t recipients = 0;
+        for (size_t i = 0; i < queues.size(); i++) {
+            bool hears = rooms[i] != nullptr && i != except &&
+                         within(rooms[i]->getId(), target->getId());
+            wrong_routes += queues[i].size() != (size_t) hears;
+            recipients += hears;
+            queues[i].drain(drained);
+        }
+        wrong_routes += sent != recipients;
+    }
+    bool right = wrong_interest == 0 && wrong_routes == 0;
+    out << (right ? "ok   " : "FAIL ") << wrong_interest << " of " << steps * queues.size()
+        << " interests and " << wrong_routes << " of " << steps
+        << " routes differ from the rooms within " << radius << " exits" << endl;
+
+    // A game moving its player on every setRoom(), and removing it when it
+    // is destroyed
+    unique_ptr<AdventureGame> game(new AdventureGame());
+    InterestMap castle(game->getWorld(), 1);
+    EventQueue player;
+    game->setInterest(&castle, &player);
+    size_t wrong_game = 0;
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        game->runCommand(WALKTHROUGH[i]);
+        expected.assign(1, game->getRoom()->getId());
+        for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+            Room *exit = game->getRoom()->getRoom(direction);
+            if (exit != nullptr) {
+                expected.push_back(exit->getId());
+            }
+        }
+        sort(expected.begin(), expected.end());
+        wrong_game += castle.getInterest(&player) != expected;
+    }
+    game.reset();
+    wrong_game += !castle.getInterest(&player).empty();
+    out << (wrong_game == 0 ? "ok   " : "FAIL ") << wrong_game << " of "
+        << WALKTHROUGH_LENGTH + 1 << " interests of a game differ" << endl;
+
+    // A shared world telling the players within the radius, with an actor
+    // in a room with a Stone and listeners 0 to 3 exits from it
+    SharedWorld shared([&](World &world) {
+        buildGrid(world, side);
+        return world.getRoom(0);
+    }, radius);
+    const size_t start = 5 * side + 4;
+    const size_t listened[] = {start, start + 1, start + 2, start + 3, start + side,
+                               start + 2 * side, start + 2 * side + 1};
+    deque<EventQueue> heard(sizeof(listened) / sizeof(listened[0]));
+    deque<SharedPlayer> listeners;
+    for (size_t i = 0; i < heard.size(); i++) {
+        listeners.emplace_back(shared, shared.getWorld().getRoom(listened[i]), &heard[i]);
+    }
+    EventQueue actor_events;
+    unique_ptr<SharedPlayer> actor(new SharedPlayer(shared, shared.getWorld().getRoom(start),
+                                                    &actor_events));
+    for (EventQueue &queue: heard) {
+        queue.drain(drained);
+    }
+    drained.clear();
+
+    // Taking in the room, then leaving it for the next one
+    actor->take("Stone");
+    actor->move(EAST);
+    size_t wrong_shared = 0;
+    for (size_t i = 0; i < heard.size(); i++) {
+        size_t expected_events = within(start, listened[i]) + within(start, listened[i]) +
+                                 within(start + 1, listened[i]);
+        wrong_shared += heard[i].size() != expected_events;
+        heard[i].drain(drained);
+        if (within(start, listened[i])) {
+            wrong_shared += drained.empty() || *drained[0] != "Cell " + to_string(start) +
+                            ": " + actor->getName() + " picks up the Stone.\n";
+        }
+        drained.clear();
+    }
+
+    // Listeners that left aren't sent anything, and the actor doesn't hear
+    // itself
+    listeners.clear();
+    heard.clear();
+    actor_events.drain(drained);
+    drained.clear();
+    actor->drop("Stone");
+    wrong_shared += actor_events.size() != 0;
+
+    // Players wandering from several threads, for the thread sanitizer
+    vector<thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&shared, t]() {
+            EventQueue events;
+            SharedPlayer wanderer(shared, shared.getWorld().getRoom(t * 5), &events);
+            mt19937 random(t);
+            vector<EventBuffer> drained;
+            for (int i = 0; i < 2000; i++) {
+                wanderer.move((Direction) (random() % 4));
+                if (wanderer.take("Stone") == SUCCESS) {
+                    wanderer.drop("Stone");
+                }
+                events.drain(drained);
+                drained.clear();
+            }
+        });
+    }
+    for (thread &thread: threads) {
+        thread.join();
+    }
+    actor.reset();
+    out << (wrong_shared == 0 ? "ok   " : "FAIL ") << wrong_shared << " of "
+        << sizeof(listened) / sizeof(listened[0]) + 1
+        << " players of a shared world heard the wrong events" << endl;
+    return right && wrong_game == 0 && wrong_shared == 0;
+}
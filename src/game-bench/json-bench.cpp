@@ -0,0 +1,157 @@
+#include "suites.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "enemies.h"
+#include "game.h"
+#include "items.h"
+
+using namespace std;
+
+/** Benchmarks playing the walkthrough with a look and the inventory after
+ * every command, with the text and the JSON output. */
+void benchOutput(BenchRunner &runner) {
+    for (OutputFormat format: {TEXT_OUTPUT, JSON_OUTPUT}) {
+        string name = format == JSON_OUTPUT ? "json" : "text";
+        runner.run("output/" + name, [&]() {
+            AdventureGame game;
+            game.setOutputFormat(format);
+            for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+                doNotOptimize(game.runCommand(string(WALKTHROUGH[i]) + ";look;i"));
+            }
+        });
+    }
+}
+
+/** Checks if a line is a single JSON object with an event field.
+ *
+ * The brackets must balance outside the strings and nothing may follow the
+ * object.
+ *
+ * @param line The line, without its new line.
+ * @return If the line is a record.
+ * */
+static bool isRecord(const string &line) {
+    if (line.compare(0, 10, "{\"event\":\"") != 0) {
+        return false;
+    }
+    vector<char> open;
+    bool in_string = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (in_string) {
+            if (c == '\\') {
+                i++;
+            } else if (c == '"') {
+                in_string = false;
+            } else if ((unsigned char) c < 0x20) {
+                return false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            open.push_back(c == '{' ? '}' : ']');
+        } else if (c == '}' || c == ']') {
+            if (open.empty() || open.back() != c) {
+                return false;
+            }
+            open.pop_back();
+            if (open.empty() && i + 1 != line.size()) {
+                return false;
+            }
+        }
+    }
+    return !in_string && open.empty();
+}
+
+/** Checks the JSON output by playing the walkthrough with every kind of
+ * record.
+ *
+ * Every line must be a record, the game must end the same as with the text
+ * output and be won. A room whose enemies and items were destroyed by the
+ * world must then be looked at and fought in without them, the enemy added
+ * after them being the one fought.
+ *
+ * @param out The stream to write the report to.
+ * @return If the records were right.
+ * */
+bool checkJson(ostream &out) {
+    vector<string> commands = {"help", "complete ki", "dance", "look", "i",
+                               "kill nobody", "drop nothing", "eat food",
+                               "unlock door", "leaderboard"};
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        commands.push_back(WALKTHROUGH[i]);
+        commands.push_back("look;i");
+    }
+
+    ostringstream text_output;
+    AdventureGame text;
+    text.setOutput(&text_output);
+    ostringstream json_output;
+    AdventureGame json;
+    json.setOutput(&json_output);
+    json.setOutputFormat(JSON_OUTPUT);
+    GameStatus text_status = GameStatus::CONTINUE;
+    GameStatus json_status = GameStatus::CONTINUE;
+    for (size_t i = 0; i < commands.size() && json_status == GameStatus::CONTINUE; i++) {
+        text_status = text.runCommand(commands[i]);
+        json_status = json.runCommand(commands[i]);
+    }
+    json.finish(json_status);
+
+    // Every line a record
+    istringstream lines(json_output.str());
+    size_t records = 0;
+    size_t wrong = 0;
+    string last;
+    for (string line; getline(lines, line);) {
+        records++;
+        wrong += !isRecord(line);
+        last = line;
+    }
+
+    // Enemies and items destroyed by the world while their handles are
+    // still in the room
+    ostringstream stale_output;
+    AdventureGame stale;
+    stale.setOutput(&stale_output);
+    stale.setOutputFormat(JSON_OUTPUT);
+    for (int i = 0; i < WALKTHROUGH_LENGTH && stale.getRoom()->getEnemyHandles().empty(); i++) {
+        stale.runCommand(WALKTHROUGH[i]);
+    }
+    World &world = stale.getWorld();
+    Room *room = stale.getRoom();
+    ItemHandle stone = world.createItem<Weapon>("Stone", 1);
+    room->addItem(stone);
+    world.destroyItem(stone);
+    vector<EnemyHandle> enemies = room->getEnemyHandles();
+    for (EnemyHandle enemy: enemies) {
+        world.destroyEnemy(enemy);
+    }
+    room->addEnemey(world.createEnemy<GenericEnemy>(1, 0, "Rat"));
+    stale_output.str("");
+    stale.runCommand("look");
+    stale.runCommand("killmonster");
+    istringstream stale_lines(stale_output.str());
+    string look;
+    string kill;
+    getline(stale_lines, look);
+    getline(stale_lines, kill);
+    records += 2;
+    wrong += !isRecord(look) || look.find("\"enemies\":[{") == string::npos ||
+             look.find("Stone") != string::npos || !isRecord(kill) ||
+             kill.find("\"enemy\":\"Rat\"") == string::npos ||
+             kill.find("\"status\":\"NO_ENEMY\"") != string::npos || enemies.empty();
+
+    bool right = wrong == 0 && json_status == GameStatus::VICTORY &&
+                 text_status == json_status && text.saveState() == json.saveState() &&
+                 last.compare(0, 33, "{\"event\":\"end\",\"status\":\"VICTORY\"") == 0;
+    out << (right ? "ok   " : "FAIL ") << records << " records of " << commands.size()
+        << " lines, " << wrong << " malformed, " << json_output.str().size()
+        << " bytes against " << text_output.str().size() << " bytes of text" << endl;
+    return right;
+}
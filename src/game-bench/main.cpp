@@ -0,0 +1,103 @@
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+#include "bench.h"
+#include "suites.h"
+
+using namespace std;
+
+/** Stream buffer discarding everything written to it. */
+class NullBuffer: public streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+        streamsize xsputn(const char *, streamsize n) override {
+            return n;
+        }
+};
+
+/** The self-checks, each run by --check-NAME. */
+static const BenchCheck CHECKS[] = {
+    {"allocs", checkAllocs},
+    {"stats", checkStats},
+    {"combat", checkCombat},
+    {"shared", checkSharedWorld},
+    {"interest", checkInterest},
+    {"partition", checkPartitionedWorld},
+    {"hibernate", checkHibernate},
+    {"transcript", checkTranscript},
+    {"fold", checkFold},
+    {"json", checkJson},
+    {"batch", checkBatchEnvironment},
+    {"observation", checkObservation}
+};
+
+/** The benchmarks, in the order they run. */
+static void (*const BENCHMARKS[])(BenchRunner &runner) = {
+    benchDispatch, benchDescription, benchFold, benchCombat, benchBatchCombat,
+    benchInventory, benchWorld, benchLeaderboard, benchSharedWorld,
+    benchRoomEvents, benchInterest, benchPartitionedWorld, benchStats,
+    benchGame, benchHibernate, benchTranscript, benchOutput,
+    benchBatchEnvironment, benchObservation
+};
+
+/** Finds the self-check selected by an argument.
+ *
+ * @param arg The argument.
+ * @return The check, nullptr if the argument isn't --check-NAME.
+ * */
+static const BenchCheck* findCheck(const string &arg) {
+    for (const BenchCheck &check: CHECKS) {
+        if (arg == string("--check-") + check.name) {
+            return &check;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char *argv[]) {
+    string filter = "";
+    double min_time_ms = 50;
+    const BenchCheck *check = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (findCheck(arg) != nullptr) {
+            check = findCheck(arg);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            min_time_ms = stod(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--filter NAME] [--min-time MILLISECONDS]";
+            for (const BenchCheck &candidate: CHECKS) {
+                cerr << " [--check-" << candidate.name << "]";
+            }
+            cerr << endl;
+            return 1;
+        }
+    }
+
+    // The game writes to standard output, the results are written to the
+    // original buffer
+    NullBuffer null_buffer;
+    ostream json(cout.rdbuf());
+    cout.rdbuf(&null_buffer);
+
+    if (check != nullptr) {
+        bool passed = check->run(json);
+        cout.rdbuf(json.rdbuf());
+        return passed ? 0 : 1;
+    }
+
+    {
+        BenchRunner runner(json, filter, min_time_ms);
+        for (auto bench: BENCHMARKS) {
+            bench(runner);
+        }
+    }
+
+    cout.rdbuf(json.rdbuf());
+    return 0;
+}
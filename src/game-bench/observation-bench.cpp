@@ -0,0 +1,150 @@
+#include "suites.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "game.h"
+#include "observation-encoder.h"
+
+using namespace std;
+
+/** Benchmarks observing the room a player walks into on grids of 16x16 and
+ * 256x256 rooms, with an encoder that has a place for every item of the
+ * world.
+ *
+ * The observation is encoded in full, only where it changed, or described
+ * as text. The speedup is of the changes over the full encoding.
+ * */
+void benchObservation(BenchRunner &runner) {
+    for (size_t side: {16, 256}) {
+        string suffix = to_string(side) + "x" + to_string(side);
+        if (!runner.selected("observation/full/" + suffix) &&
+            !runner.selected("observation/delta/" + suffix) &&
+            !runner.selected("observation/describe/" + suffix)) {
+            continue;
+        }
+        AdventureGame game([side](World &world) {
+            buildGrid(world, side);
+            return world.getRoom(0);
+        });
+        World &world = game.getWorld();
+        ObservationEncoder encoder(world.itemSlots(), world.enemySlots());
+        vector<int32_t> buffer(encoder.getSize(), 0);
+        encoder.encode(game, buffer.data(), true);
+
+        // Walking along the first row and back
+        size_t step = 0;
+        auto walk = [&]() {
+            size_t column = step++ % (2 * side - 2);
+            game.setRoom(world.getRoom(column < side ? column : 2 * side - 2 - column));
+        };
+        BenchResult full = runner.measure("observation/full/" + suffix, [&]() {
+            walk();
+            doNotOptimize(encoder.encode(game, buffer.data(), true));
+        });
+        runner.report(full);
+        BenchResult delta = runner.measure("observation/delta/" + suffix, [&]() {
+            walk();
+            doNotOptimize(encoder.encode(game, buffer.data()));
+        });
+        if (delta.ns_per_op > 0) {
+            delta.speedup = full.ns_per_op / delta.ns_per_op;
+        }
+        runner.report(delta);
+        runner.run("observation/describe/" + suffix, [&]() {
+            walk();
+            string description = game.getRoom()->getDescription();
+            doNotOptimize(description);
+        });
+    }
+}
+
+/** Checks the observations written only where they changed against full
+ * encodings, in int and float buffers.
+ *
+ * The walkthrough is played with a look at the inventory in between, the
+ * enemies of a room are destroyed by the world under the player, and a
+ * player wanders a 64x64 grid taking and dropping stones with an encoder
+ * that has fewer places than the rooms have items.
+ *
+ * @param out The stream to write the report to.
+ * @return If every observation was the same as the full encoding.
+ * */
+bool checkObservation(ostream &out) {
+    size_t differ = 0;
+    size_t steps = 0;
+    size_t written = 0;
+    size_t values = 0;
+    auto compare = [&](AdventureGame &game, const ObservationEncoder &encoder,
+                       vector<int32_t> &delta, vector<float> &delta_float) {
+        vector<int32_t> expected(encoder.getSize(), -7);
+        encoder.encode(game, expected.data(), true);
+        written += encoder.encode(game, delta.data());
+        encoder.encode(game, delta_float.data());
+        values += encoder.getSize();
+        steps++;
+        differ += delta != expected ||
+                  !equal(expected.begin(), expected.end(), delta_float.begin()) ||
+                  expected[ObservationEncoder::ROOM_FIELD] != (int32_t) game.getRoom()->getId() ||
+                  expected[ObservationEncoder::HEALTH_FIELD] != game.getPlayer()->getCurrentHealth() ||
+                  expected[ObservationEncoder::XP_FIELD] != game.getPlayer()->getXP();
+    };
+
+    AdventureGame castle;
+    World &castle_world = castle.getWorld();
+    ObservationEncoder castle_encoder(castle_world.itemSlots(), castle_world.enemySlots());
+    vector<int32_t> castle_delta(castle_encoder.getSize(), 0);
+    vector<float> castle_float(castle_encoder.getSize(), 0);
+    castle_encoder.encode(castle, castle_delta.data(), true);
+    castle_encoder.encode(castle, castle_float.data(), true);
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        castle.runCommand(WALKTHROUGH[i]);
+        compare(castle, castle_encoder, castle_delta, castle_float);
+        castle.runCommand("i");
+        compare(castle, castle_encoder, castle_delta, castle_float);
+    }
+
+    // Enemies destroyed by the world while their handles are still in the
+    // room are empty places
+    AdventureGame stale;
+    vector<int32_t> stale_delta(castle_encoder.getSize(), 0);
+    vector<float> stale_float(castle_encoder.getSize(), 0);
+    castle_encoder.encode(stale, stale_delta.data(), true);
+    castle_encoder.encode(stale, stale_float.data(), true);
+    for (int i = 0; i < WALKTHROUGH_LENGTH && stale.getRoom()->getEnemyHandles().empty(); i++) {
+        stale.runCommand(WALKTHROUGH[i]);
+        compare(stale, castle_encoder, stale_delta, stale_float);
+    }
+    vector<EnemyHandle> enemies = stale.getRoom()->getEnemyHandles();
+    for (EnemyHandle enemy: enemies) {
+        stale.getWorld().destroyEnemy(enemy);
+    }
+    compare(stale, castle_encoder, stale_delta, stale_float);
+    differ += enemies.empty() || stale_delta[castle_encoder.getEnemiesOffset()] != 0;
+
+    AdventureGame grid([](World &world) {
+        buildGrid(world, 64);
+        return world.getRoom(0);
+    });
+    ObservationEncoder grid_encoder(1, 0, 3);
+    vector<int32_t> grid_delta(grid_encoder.getSize(), 0);
+    vector<float> grid_float(grid_encoder.getSize(), 0);
+    grid_encoder.encode(grid, grid_delta.data(), true);
+    grid_encoder.encode(grid, grid_float.data(), true);
+    mt19937 random(50);
+    const char *commands[] = {"n", "s", "e", "w", "get stone", "drop stone"};
+    uniform_int_distribution<size_t> pick(0, 5);
+    for (size_t i = 0; i < 5000; i++) {
+        grid.runCommand(commands[pick(random)]);
+        compare(grid, grid_encoder, grid_delta, grid_float);
+    }
+
+    out << (differ == 0 ? "ok   " : "FAIL ") << differ << " of " << steps
+        << " observations differ from a full encoding, " << written << " of "
+        << values << " values written" << endl;
+    return differ == 0;
+}
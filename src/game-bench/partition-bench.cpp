@@ -0,0 +1,87 @@
+#include "suites.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "room.h"
+#include "world.h"
+#include "world-partition.h"
+
+using namespace std;
+
+/** Benchmarks players wandering a grid split between workers.
+ *
+ * The steps and the handoffs between workers of every walk are counted as
+ * items, the speedup is over a single worker.
+ * */
+void benchPartitionedWorld(BenchRunner &runner) {
+    const size_t players = 256;
+    const size_t steps = 1000;
+    World world;
+    buildGrid(world, 64);
+    BenchResult single;
+    for (size_t workers: {1, 2, 4, 8}) {
+        string name = "partition/walk/" + to_string(workers);
+        if (!runner.selected(name)) {
+            continue;
+        }
+        PartitionedWorld partitioned(world, workers);
+        WalkStats stats;
+        BenchResult result = runner.measure(name, [&]() {
+            stats = partitioned.walk(players, steps, 7);
+        });
+        result.items_per_op = (double) stats.steps;
+        if (workers == 1) {
+            single = result;
+        } else if (single.ns_per_op > 0) {
+            result.speedup = single.ns_per_op / result.ns_per_op;
+        }
+        runner.report(result);
+
+        BenchResult handoffs = result;
+        handoffs.name = "partition/handoffs/" + to_string(workers);
+        handoffs.items_per_op = (double) stats.handoffs;
+        handoffs.speedup = 0;
+        runner.report(handoffs);
+    }
+}
+
+/** Checks that a grid split between workers is balanced, cuts fewer exits
+ * than splitting the rooms by id and keeps every item through a walk.
+ *
+ * @param out The stream to write the report to.
+ * @return If the partition and the walk were right.
+ * */
+bool checkPartitionedWorld(ostream &out) {
+    const size_t workers = 4;
+    World world;
+    buildGrid(world, 64);
+    PartitionedWorld partitioned(world, workers);
+    const WorldPartition &partition = partitioned.getPartition();
+
+    vector<size_t> sizes(workers, 0);
+    vector<uint32_t> by_id(world.roomCount());
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        sizes[partition.part[id]]++;
+        by_id[id] = (uint32_t) (id * workers / world.roomCount());
+    }
+    size_t largest = *max_element(sizes.begin(), sizes.end());
+    size_t by_id_cut = countCutEdges(world, by_id);
+    bool balanced = largest * workers <= world.roomCount() * 21 / 20;
+    bool cut = partition.cut_edges < by_id_cut;
+    out << (balanced && cut ? "ok   " : "FAIL ") << workers << " partitions of at most "
+        << largest << " rooms cut " << partition.cut_edges << " exits, "
+        << by_id_cut << " split by id" << endl;
+
+    WalkStats stats = partitioned.walk(256, 1000, 7);
+    size_t items = 0;
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        items += world.getRoom(id)->getItems().size();
+    }
+    bool kept = items == world.roomCount() / 4;
+    out << (kept ? "ok   " : "FAIL ") << stats.handoffs << " handoffs, "
+        << stats.items_taken << " items taken, " << items << " left in the rooms" << endl;
+    return balanced && cut && kept;
+}
@@ -0,0 +1,182 @@
+#include "suites.h"
+
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "castle-map.h"
+#include "event-queue.h"
+#include "room.h"
+#include "shared-world.h"
+
+using namespace std;
+
+/** Rooms of the castle with an item that can be picked up, with the item. */
+static const pair<size_t, const char *> FREE_ITEMS[] = {
+    {1, "Food"}, {3, "Sword"}, {5, "Medpack"}, {7, "Elixir"}
+};
+
+/** Takes and drops items in a shared castle from several threads.
+ *
+ * @param world The shared castle.
+ * @param threads The number of threads.
+ * @param spread If the threads are spread over the rooms with a free item,
+ * otherwise they all race for the Food.
+ * @param rounds The number of times each thread takes and drops its item.
+ * @return The number of items taken by all the threads.
+ * */
+static size_t raceForItems(SharedWorld &world, size_t threads, bool spread,
+                           size_t rounds) {
+    atomic<size_t> taken{0};
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        const auto &item = FREE_ITEMS[spread ? t % size(FREE_ITEMS) : 0];
+        workers.emplace_back([&world, &taken, item, rounds]() {
+            SharedPlayer player(world, world.getWorld().getRoom(item.first));
+            size_t count = 0;
+            for (size_t i = 0; i < rounds; i++) {
+                if (player.take(item.second) == SUCCESS) {
+                    count++;
+                    player.drop(item.second);
+                }
+            }
+            taken += count;
+        });
+    }
+    for (thread &worker: workers) {
+        worker.join();
+    }
+    return taken;
+}
+
+/** Benchmarks players taking and dropping items in a shared castle.
+ *
+ * The players are either spread over the rooms or racing in one room, the
+ * speedup is over a single thread.
+ * */
+void benchSharedWorld(BenchRunner &runner) {
+    const size_t rounds = 10000;
+    for (bool spread: {true, false}) {
+        BenchResult single;
+        for (size_t threads: {1, 2, 4, 8}) {
+            string name = string("shared-world/") + (spread ? "spread/" : "same-room/")
+                          + to_string(threads);
+            if (!runner.selected(name)) {
+                continue;
+            }
+            SharedWorld world([](World &world) {
+                return buildMap(world, CASTLE_MAP);
+            });
+            BenchResult result = runner.measure(name, [&]() {
+                doNotOptimize(raceForItems(world, threads, spread, rounds));
+            });
+            result.items_per_op = (double) (threads * rounds);
+            if (threads == 1) {
+                single = result;
+            } else if (single.ns_per_op > 0) {
+                result.speedup = (single.ns_per_op / single.items_per_op) /
+                                 (result.ns_per_op / result.items_per_op);
+            }
+            runner.report(result);
+        }
+    }
+}
+
+/** Benchmarks announcing a player taking and dropping an item to the other
+ * players in the room.
+ *
+ * The events are either shared by the recipients or formatted and copied
+ * into the output of each of them, the speedup is of sharing them.
+ * */
+void benchRoomEvents(BenchRunner &runner) {
+    const auto &item = FREE_ITEMS[0];
+    for (size_t recipients: {1, 16, 256}) {
+        string copy_name = "events/copy/" + to_string(recipients);
+        string shared_name = "events/fanout/" + to_string(recipients);
+        if (!runner.selected(copy_name) && !runner.selected(shared_name)) {
+            continue;
+        }
+
+        vector<string> outputs(recipients);
+        string actor = "Player 1";
+        BenchResult copy = runner.measure(copy_name, [&]() {
+            for (const char *action: {" picks up the ", " drops the "}) {
+                for (string &output: outputs) {
+                    output += actor + action + item.second + ".\n";
+                }
+            }
+            for (string &output: outputs) {
+                output.clear();
+            }
+        });
+        copy.items_per_op = (double) (2 * recipients);
+        runner.report(copy);
+
+        SharedWorld world([](World &world) {
+            return buildMap(world, CASTLE_MAP);
+        });
+        Room *room = world.getWorld().getRoom(item.first);
+        SharedPlayer actor_player(world, room);
+        vector<EventQueue> queues(recipients);
+        deque<SharedPlayer> listeners;
+        for (EventQueue &queue: queues) {
+            listeners.emplace_back(world, room, &queue);
+        }
+        vector<EventBuffer> events;
+        for (EventQueue &queue: queues) {
+            queue.drain(events);
+            events.clear();
+        }
+        BenchResult shared = runner.measure(shared_name, [&]() {
+            actor_player.take(item.second);
+            actor_player.drop(item.second);
+            for (EventQueue &queue: queues) {
+                queue.drain(events);
+                events.clear();
+            }
+        });
+        shared.items_per_op = (double) (2 * recipients);
+        if (shared.ns_per_op > 0) {
+            shared.speedup = copy.ns_per_op / shared.ns_per_op;
+        }
+        runner.report(shared);
+    }
+}
+
+/** Checks that players racing for the same item in a shared castle never
+ * duplicate or lose it, and that a player watching sees every take and drop.
+ *
+ * @param out The stream to write the report to.
+ * @return If the Food ended up back in its room once and every event was
+ * announced.
+ * */
+bool checkSharedWorld(ostream &out) {
+    SharedWorld world([](World &world) {
+        return buildMap(world, CASTLE_MAP);
+    });
+    Room *hall = world.getWorld().getRoom(FREE_ITEMS[0].first);
+    EventQueue watched;
+    SharedPlayer watcher(world, hall, &watched);
+    size_t taken = raceForItems(world, 4, false, 100000);
+
+    size_t food = 0;
+    for (GenericItem *item: hall->getItems()) {
+        food += *item == "Food";
+    }
+    bool kept = food == 1 && world.getVersion(hall) == 2 * taken;
+    out << (kept ? "ok   " : "FAIL ") << "4 players took the Food " << taken
+        << " times, " << food << " left in the room" << endl;
+
+    // Every take and drop, and the players arriving and leaving
+    vector<EventBuffer> events;
+    watched.drain(events);
+    bool announced = events.size() == 2 * taken + 8;
+    out << (announced ? "ok   " : "FAIL ") << "a player in the room saw "
+        << events.size() << " events" << endl;
+    return kept && announced;
+}
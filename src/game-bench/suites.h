@@ -0,0 +1,255 @@
+#ifndef SUITES_H_
+#define SUITES_H_
+
+/** @file suites.h
+ *
+ * Header file containing the benchmarks and the self-checks of every
+ * feature, each feature in its own file.
+ * */
+
+#include <cstddef>
+#include <ostream>
+
+#include "bench.h"
+#include "world.h"
+
+/** A self-check run by `game-bench --check-NAME`. */
+struct BenchCheck {
+    const char *name; /**<Name of the check on the command line. */
+    /** Runs the check and writes its report, returns if it passed. */
+    bool (*run)(std::ostream &out);
+};
+
+/////////
+// Engine
+/** Benchmarks the command dispatch of HKGE through AdventureGame. */
+void benchDispatch(BenchRunner &runner);
+/** Benchmarks rendering the description of a room. */
+void benchDescription(BenchRunner &runner);
+/** Benchmarks the overhead of timing and recording a command. */
+void benchStats(BenchRunner &runner);
+/** Benchmarks creating and destroying a player and a game. */
+void benchGame(BenchRunner &runner);
+/** Checks the allocations of the walkthrough against its budget.
+ *
+ * The walkthrough is played once first so the object pools and the
+ * buffers of the thread already have their blocks, as in a process serving
+ * many games. Every command over its budget is reported.
+ *
+ * @param out The stream to write the report to.
+ * @return If every command was within its budget.
+ * */
+bool checkAllocs(std::ostream &out);
+/** Checks the latencies kept by a game against a LatencyHistogram fed the
+ * same latencies, and that a game doesn't see the commands of another game
+ * run on the same thread.
+ *
+ * @param out The stream to write the report to.
+ * @return If the latencies were right.
+ * */
+bool checkStats(std::ostream &out);
+
+///////////////
+// Case folding
+/** Benchmarks folding typed lines of a few lengths with std::transform()
+ * and every kernel, and comparing names ignoring case. */
+void benchFold(BenchRunner &runner);
+/** Checks every case folding kernel against folding one byte at a time
+ * with std::tolower() on random lines.
+ *
+ * @param out The stream to write the report to.
+ * @return If every kernel folded, normalised and compared like the
+ * reference.
+ * */
+bool checkFold(std::ostream &out);
+
+/////////
+// Combat
+/** Benchmarks a fight against each kind of enemy.
+ *
+ * The player and the enemy are healed after every fight so each iteration
+ * is a full fight. The virtual and kernel paths are measured separately.
+ * */
+void benchCombat(BenchRunner &runner);
+/** Benchmarks resolving a batch of fights with each kernel.
+ *
+ * The speedup of the vector kernel is over the scalar kernel.
+ * */
+void benchBatchCombat(BenchRunner &runner);
+/** Checks the batch kernels against Room::killEnemy().
+ *
+ * Every fight is also fought by a Player with the loadout in a room.
+ *
+ * @param out The stream to write the report to.
+ * @return If every kernel gave the results of the game.
+ * */
+bool checkCombat(std::ostream &out);
+
+////////
+// World
+/** Benchmarks the inventory at several capacities.
+ *
+ * The inventory is filled except for the last slot.
+ * */
+void benchInventory(BenchRunner &runner);
+/** Benchmarks the churn of items and enemies, against the global
+ * allocator. */
+void benchWorld(BenchRunner &runner);
+/** Benchmarks submitting scores to the leaderboard and querying it once
+ * the shards were merged. */
+void benchLeaderboard(BenchRunner &runner);
+/** Builds a square grid of rooms linked to their neighbours, with an item
+ * in every fourth room.
+ *
+ * @param world The world to build in.
+ * @param side The number of rooms along a side.
+ * */
+void buildGrid(World &world, size_t side);
+
+///////////////
+// Shared world
+/** Benchmarks players taking and dropping items in a shared castle.
+ *
+ * The players are either spread over the rooms or racing in one room, the
+ * speedup is over a single thread.
+ * */
+void benchSharedWorld(BenchRunner &runner);
+/** Benchmarks announcing a player taking and dropping an item to the other
+ * players in the room.
+ *
+ * The events are either shared by the recipients or formatted and copied
+ * into the output of each of them, the speedup is of sharing them.
+ * */
+void benchRoomEvents(BenchRunner &runner);
+/** Checks that players racing for the same item in a shared castle never
+ * duplicate or lose it, and that a player watching sees every take and drop.
+ *
+ * @param out The stream to write the report to.
+ * @return If the Food ended up back in its room once and every event was
+ * announced.
+ * */
+bool checkSharedWorld(std::ostream &out);
+
+///////////
+// Interest
+/** Benchmarks keeping the interest of players moving on a grid and
+ * delivering updates of random rooms only to the players near them.
+ *
+ * The grids range from 16x16 to 256x256 rooms with a player every 16 or 4
+ * rooms. The recipients of an update are counted as items, the speedup of
+ * routing is over broadcasting to every player.
+ * */
+void benchInterest(BenchRunner &runner);
+/** Checks the interest of players wandering a grid against the rooms
+ * within the radius of their room, and the players each update is routed
+ * to. A game tracked through HKGE::setInterest() and the events of a
+ * SharedWorld with a radius are checked the same way.
+ *
+ * @param out The stream to write the report to.
+ * @return If every interest and recipient was right.
+ * */
+bool checkInterest(std::ostream &out);
+
+////////////
+// Partition
+/** Benchmarks players wandering a grid split between workers.
+ *
+ * The steps and the handoffs between workers of every walk are counted as
+ * items, the speedup is over a single worker.
+ * */
+void benchPartitionedWorld(BenchRunner &runner);
+/** Checks that a grid split between workers is balanced, cuts fewer exits
+ * than splitting the rooms by id and keeps every item through a walk.
+ *
+ * @param out The stream to write the report to.
+ * @return If the partition and the walk were right.
+ * */
+bool checkPartitionedWorld(std::ostream &out);
+
+//////////////
+// Hibernation
+/** Benchmarks saving a game halfway through the walkthrough, and freeing
+ * it and bringing it back. */
+void benchHibernate(BenchRunner &runner);
+/** Checks that hibernating a game before every command of the walkthrough
+ * doesn't change what the game writes.
+ *
+ * @param out The stream to write the report to.
+ * @return If the output was the same.
+ * */
+bool checkHibernate(std::ostream &out);
+
+//////////////
+// Transcripts
+/** Benchmarks replaying the walkthrough on a new game, typed and from a
+ * binary transcript, and recording it. */
+void benchTranscript(BenchRunner &runner);
+/** Checks that replaying the transcript of a game leaves a new game in the
+ * same state with the same output, and compares its size with the typed
+ * lines.
+ *
+ * The game is played with abbreviations, batches, repeated and invalid
+ * commands. For the sizes the lines are typed a few seconds apart and
+ * stored with a millisecond timestamp.
+ *
+ * @param out The stream to write the report to.
+ * @return If the replayed game was the same.
+ * */
+bool checkTranscript(std::ostream &out);
+
+//////////////
+// JSON output
+/** Benchmarks playing the walkthrough with a look and the inventory after
+ * every command, with the text and the JSON output. */
+void benchOutput(BenchRunner &runner);
+/** Checks the JSON output by playing the walkthrough with every kind of
+ * record.
+ *
+ * Every line must be a record, the game must end the same as with the text
+ * output and be won.
+ *
+ * @param out The stream to write the report to.
+ * @return If the records were right.
+ * */
+bool checkJson(std::ostream &out);
+
+////////////////////
+// Batch environment
+/** Benchmarks stepping 1024 games of a batch environment from 1 to 8
+ * threads, and typing the same actions into the games one at a time. */
+void benchBatchEnvironment(BenchRunner &runner);
+/** Checks a batch environment against itself with another number of
+ * threads and against typing its actions into games.
+ *
+ * Random actions are run on 256 games for 300 steps, every game that ends
+ * is reset with a new seed.
+ *
+ * @param out The stream to write the report to.
+ * @return If every observation, reward and done flag was the same.
+ * */
+bool checkBatchEnvironment(std::ostream &out);
+
+///////////////
+// Observations
+/** Benchmarks observing the room a player walks into on grids of 16x16 and
+ * 256x256 rooms, with an encoder that has a place for every item of the
+ * world.
+ *
+ * The observation is encoded in full, only where it changed, or described
+ * as text. The speedup is of the changes over the full encoding.
+ * */
+void benchObservation(BenchRunner &runner);
+/** Checks the observations written only where they changed against full
+ * encodings, in int and float buffers.
+ *
+ * The walkthrough is played with a look at the inventory in between, the
+ * enemies of a room are destroyed by the world under the player, and a
+ * player wanders a 64x64 grid taking and dropping stones with an encoder
+ * that has fewer places than the rooms have items.
+ *
+ * @param out The stream to write the report to.
+ * @return If every observation was the same as the full encoding.
+ * */
+bool checkObservation(std::ostream &out);
+
+#endif // SUITES_H_
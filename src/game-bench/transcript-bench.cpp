@@ -0,0 +1,136 @@
+#include "suites.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "walkthrough.h"
+#include "game.h"
+#include "transcript.h"
+
+using namespace std;
+
+/** Benchmarks replaying the walkthrough on a new game, typed and from a
+ * binary transcript, and recording it. */
+void benchTranscript(BenchRunner &runner) {
+    runner.run("transcript/walkthrough", [&]() {
+        AdventureGame game;
+        for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+            doNotOptimize(game.runCommand(WALKTHROUGH[i]));
+        }
+    });
+
+    AdventureGame recorded;
+    TranscriptWriter transcript(recorded.getVerbs());
+    recorded.setTranscript(&transcript);
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        recorded.runCommand(WALKTHROUGH[i]);
+    }
+    const string &data = transcript.getData();
+    const vector<string> verbs = recorded.getVerbs();
+    runner.run("transcript/binary", [&]() {
+        AdventureGame game;
+        TranscriptReader reader(data, verbs);
+        TranscriptEntry entry;
+        while (reader.next(entry)) {
+            doNotOptimize(game.replayCommand(entry));
+        }
+    });
+    runner.run("transcript/record", [&]() {
+        AdventureGame game;
+        TranscriptWriter writer(game.getVerbs());
+        game.setTranscript(&writer);
+        for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+            doNotOptimize(game.runCommand(WALKTHROUGH[i]));
+        }
+        doNotOptimize(writer.getData().size());
+    });
+    runner.run("transcript/read", [&]() {
+        TranscriptReader reader(data, verbs);
+        TranscriptEntry entry;
+        while (reader.next(entry)) {
+            doNotOptimize(entry.argument);
+        }
+    });
+}
+
+/** Rebuilds the command of a transcript entry.
+ *
+ * @param entry The entry.
+ * @return The command.
+ * */
+static string commandOf(const TranscriptEntry &entry) {
+    string command = entry.verb == nullptr ? "" : *entry.verb;
+    if (entry.verb != nullptr && entry.argument != nullptr) {
+        command += ' ';
+    }
+    return entry.argument == nullptr ? command : command + *entry.argument;
+}
+
+/** Checks that replaying the transcript of a game leaves a new game in the
+ * same state with the same output, and compares its size with the typed
+ * lines.
+ *
+ * The game is played with abbreviations, batches, repeated and invalid
+ * commands. For the sizes the lines are typed a few seconds apart and
+ * stored with a millisecond timestamp.
+ *
+ * @param out The stream to write the report to.
+ * @return If the replayed game was the same.
+ * */
+bool checkTranscript(ostream &out) {
+    vector<string> commands;
+    for (int i = 0; i < WALKTHROUGH_LENGTH; i++) {
+        commands.push_back(WALKTHROUGH[i]);
+        if (i % 7 == 3) {
+            commands.push_back("i;look");
+            commands.push_back("");
+        } else if (i % 7 == 6) {
+            commands.push_back("dance");
+            commands.push_back("L");
+        }
+    }
+
+    ostringstream recorded_output;
+    AdventureGame recorded;
+    recorded.setOutput(&recorded_output);
+    TranscriptWriter transcript(recorded.getVerbs());
+    recorded.setTranscript(&transcript);
+
+    // The same commands timed as typed
+    mt19937 random(46);
+    uniform_int_distribution<uint64_t> think_ms(800, 6000);
+    const uint64_t epoch_ms = 1760000000000;
+    TranscriptWriter timed(recorded.getVerbs());
+    TranscriptReader recorded_reader(transcript.getData(), recorded.getVerbs());
+    TranscriptEntry entry;
+    string text;
+    uint64_t time = 0;
+    for (const string &command: commands) {
+        time += think_ms(random);
+        text += to_string(epoch_ms + time) + " " + command + "\n";
+        recorded.runCommand(command);
+        while (recorded_reader.next(entry)) {
+            timed.record(commandOf(entry), time);
+        }
+    }
+
+    ostringstream replayed_output;
+    AdventureGame replayed;
+    replayed.setOutput(&replayed_output);
+    TranscriptReader reader(transcript.getData(), replayed.getVerbs());
+    while (reader.next(entry)) {
+        replayed.replayCommand(entry);
+    }
+
+    bool same = reader.isValid() && recorded_reader.isValid() &&
+                recorded_output.str() == replayed_output.str() &&
+                recorded.saveState() == replayed.saveState();
+    out << (same ? "ok   " : "FAIL ") << transcript.getCount() << " commands of "
+        << commands.size() << " lines replayed " << (same ? "the same" : "differently")
+        << ", " << timed.getData().size() << " bytes against " << text.size()
+        << " bytes of timestamped lines" << endl;
+    return same;
+}
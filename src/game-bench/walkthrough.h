@@ -0,0 +1,22 @@
+#ifndef WALKTHROUGH_H_
+#define WALKTHROUGH_H_
+
+/** @file walkthrough.h
+ *
+ * The canonical walkthrough of the castle, it wins the game.
+ * */
+
+/** Commands of the walkthrough in order. */
+static const char *const WALKTHROUGH[] = {
+    "e", "get food", "e", "km", "get silver spear", "w", "s", "km",
+    "eat food", "get sword", "s", "km", "get diamond cross", "n", "w",
+    "drop silver spear", "get medpack", "use medpack", "s", "km",
+    "get copper key", "drop diamond cross", "n", "get silver spear",
+    "e", "e", "km", "unlock door", "s", "km", "drop copper key",
+    "get golden chalice", "n", "w", "n", "w"
+};
+
+/** Number of commands in the walkthrough. */
+static const int WALKTHROUGH_LENGTH = sizeof(WALKTHROUGH) / sizeof(WALKTHROUGH[0]);
+
+#endif // WALKTHROUGH_H_
@@ -0,0 +1,112 @@
+#include "suites.h"
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "bench.h"
+#include "inventory.h"
+#include "items.h"
+#include "enemies.h"
+#include "leaderboard.h"
+#include "object-pool.h"
+#include "room.h"
+#include "world.h"
+
+using namespace std;
+
+/** Benchmarks the inventory at several capacities.
+ *
+ * The inventory is filled except for the last slot.
+ * */
+void benchInventory(BenchRunner &runner) {
+    for (unsigned int capacity: {3u, 16u, 256u}) {
+        World world;
+        Inventory inventory(capacity, world);
+        for (unsigned int i = 0; i + 1 < capacity; i++) {
+            inventory.addItem(world.createItem<GenericItem>("Item " + to_string(i)));
+        }
+        ItemHandle item = world.createItem<GenericItem>("Last Item");
+        string size = to_string(capacity);
+
+        runner.run("inventory/addItem+removeItem/" + size, [&]() {
+            doNotOptimize(inventory.addItem(item));
+            doNotOptimize(inventory.removeItem(capacity - 1));
+        });
+        inventory.addItem(item);
+        runner.run("inventory/getItem/" + size, [&]() {
+            doNotOptimize(inventory.getItem("Last Item"));
+        });
+        runner.run("inventory/removeItem+addItem/" + size, [&]() {
+            doNotOptimize(inventory.removeItem("Last Item"));
+            doNotOptimize(inventory.addItem(item));
+        });
+    }
+}
+
+/** Benchmarks the churn of items and enemies, against the global
+ * allocator. */
+void benchWorld(BenchRunner &runner) {
+    World world;
+    runner.run("world/createItem+destroyItem", [&]() {
+        ItemHandle item = world.createItem<Weapon>("Sword", 2);
+        doNotOptimize(world.destroyItem(item));
+    });
+    runner.run("world/createEnemy+destroyEnemy", [&]() {
+        EnemyHandle enemy = world.createEnemy<Vampire>(12, 3, "Dracula");
+        doNotOptimize(world.destroyEnemy(enemy));
+    });
+    runner.run("pool/create+destroy", [&]() {
+        Weapon *sword = ObjectPool<Weapon>::create("Sword", 2);
+        doNotOptimize(sword);
+        ObjectPool<Weapon>::destroy(sword);
+    });
+    runner.run("heap/new+delete", [&]() {
+        Weapon *sword = new Weapon("Sword", 2);
+        doNotOptimize(sword);
+        delete sword;
+    });
+}
+
+/** Benchmarks submitting scores to the leaderboard and querying it once
+ * the shards were merged. */
+void benchLeaderboard(BenchRunner &runner) {
+    unique_ptr<Leaderboard> leaderboard(new Leaderboard());
+    mt19937 random(1);
+    for (int i = 0; i < 100000; i++) {
+        leaderboard->submit((int) (random() % 200));
+    }
+    int score = 0;
+    runner.run("leaderboard/submit", [&]() {
+        leaderboard->submit(score++ % 200);
+    });
+    leaderboard->submit(0);
+    runner.run("leaderboard/rank", [&]() {
+        doNotOptimize(leaderboard->rank(score++ % 200));
+    });
+    runner.run("leaderboard/top10", [&]() {
+        doNotOptimize(leaderboard->top(10));
+    });
+}
+
+/** Builds a square grid of rooms linked to their neighbours, with an item
+ * in every fourth room.
+ *
+ * @param world The world to build in.
+ * @param side The number of rooms along a side.
+ * */
+void buildGrid(World &world, size_t side) {
+    world.reserve(side * side, side * side / 4 + 1, 0);
+    for (size_t id = 0; id < side * side; id++) {
+        Room *room = world.createRoom("Cell " + to_string(id));
+        if (id % side > 0) {
+            room->setRoom(world.getRoom(id - 1), WEST);
+        }
+        if (id >= side) {
+            room->setRoom(world.getRoom(id - side), NORTH);
+        }
+        if (id % 4 == 0) {
+            room->addItem(world.createItem<GenericItem>("Stone"));
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include "event-loop.h"
+
+#include <cstdio>
+#include <exception>
+#include <utility>
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+/** Terminates, a detached coroutine has no one to rethrow to. */
+void DetachedTask::promise_type::unhandled_exception(void) {
+    std::terminate();
+}
+
+/** Constructor for EventLoop. */
+EventLoop::EventLoop(void): m_epoll_fd(epoll_create1(EPOLL_CLOEXEC)) {
+}
+
+/** Destructor for EventLoop, closes the epoll instance. */
+EventLoop::~EventLoop(void) {
+    if (this->m_epoll_fd >= 0) {
+        close(this->m_epoll_fd);
+    }
+}
+
+/** Adds a file descriptor to the loop.
+ *
+ * @param fd The non-blocking file descriptor.
+ * @return If the file descriptor was added.
+ * */
+bool EventLoop::add(int fd) {
+    // Added disarmed, resumeWhenReady() arms it
+    epoll_event event = {};
+    event.events = EPOLLONESHOT;
+    return epoll_ctl(this->m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/** Removes a file descriptor from the loop.
+ *
+ * @param fd The file descriptor.
+ * */
+void EventLoop::remove(int fd) {
+    epoll_ctl(this->m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+/** Resumes a coroutine once a file descriptor is ready.
+ *
+ * @param fd The file descriptor, added with add().
+ * @param events The epoll events to wait for.
+ * @param handle The coroutine to resume.
+ * @return If the wait was registered.
+ * */
+bool EventLoop::resumeWhenReady(int fd, uint32_t events,
+                                std::coroutine_handle<> handle) {
+    epoll_event event = {};
+    event.events = events | EPOLLONESHOT | EPOLLRDHUP;
+    event.data.ptr = handle.address();
+    return epoll_ctl(this->m_epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+/** Runs the loop until stop() is called.
+ *
+ * @return 0 on success, 1 if epoll failed.
+ * */
+int EventLoop::run(void) {
+    if (this->m_epoll_fd < 0) {
+        std::perror("epoll_create1");
+        return 1;
+    }
+
+    epoll_event events[256];
+    this->m_running = true;
+    while (this->m_running) {
+        // Waking up for the next tick at the latest
+        int timeout = -1;
+        if (this->m_tick) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= this->m_next_tick) {
+                this->m_next_tick = now + this->m_tick_interval;
+                this->m_tick();
+            }
+            timeout = (int) std::chrono::ceil<std::chrono::milliseconds>(
+                this->m_next_tick - now).count();
+        }
+
+        int count = epoll_wait(this->m_epoll_fd, events, 256, timeout);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::perror("epoll_wait");
+            return 1;
+        }
+        for (int i = 0; i < count; i++) {
+            std::coroutine_handle<>::from_address(events[i].data.ptr).resume();
+        }
+    }
+    return 0;
+}
+
+/** Stops the loop after the current events. */
+void EventLoop::stop(void) {
+    this->m_running = false;
+}
+
+/** Calls a function periodically while the loop runs.
+ *
+ * @param interval The time between two calls.
+ * @param tick The function, replacing the previous one. An empty function
+ * stops the calls.
+ * */
+void EventLoop::every(std::chrono::milliseconds interval, std::function<void()> tick) {
+    this->m_tick = std::move(tick);
+    this->m_tick_interval = interval;
+    this->m_next_tick = std::chrono::steady_clock::now() + interval;
+}
+
+/** Waits until a file descriptor is readable.
+ *
+ * @param fd The file descriptor, added with add().
+ * @return The awaitable, it results in false if waiting failed.
+ * */
+EventLoop::Ready EventLoop::readable(int fd) {
+    return Ready{*this, fd, EPOLLIN};
+}
+
+/** Waits until a file descriptor is writable.
+ *
+ * @param fd The file descriptor, added with add().
+ * @return The awaitable, it results in false if waiting failed.
+ * */
+EventLoop::Ready EventLoop::writable(int fd) {
+    return Ready{*this, fd, EPOLLOUT};
+}
@@ -0,0 +1,127 @@
+#ifndef EVENT_LOOP_H_
+#define EVENT_LOOP_H_
+
+/** @file event-loop.h
+ *
+ * Header file containing a single threaded epoll event loop that resumes
+ * coroutines when their file descriptor is ready.
+ * */
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+
+/** A coroutine that starts eagerly and frees itself when it finishes.
+ *
+ * Nothing holds on to the coroutine, it is resumed by the EventLoop until
+ * it returns.
+ * */
+struct DetachedTask {
+    /** The promise of a DetachedTask. */
+    struct promise_type {
+        DetachedTask get_return_object(void) {
+            return {};
+        }
+        std::suspend_never initial_suspend(void) noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend(void) noexcept {
+            return {};
+        }
+        void return_void(void) {}
+        void unhandled_exception(void);
+    };
+};
+
+/** An epoll event loop resuming coroutines waiting on file descriptors.
+ *
+ * Every file descriptor is waited on by at most one coroutine at a time.
+ * Waits are one-shot, the coroutine waits again if it needs more.
+ * */
+class EventLoop {
+    public:
+        /** Constructor for EventLoop. */
+        EventLoop(void);
+        /** Destructor for EventLoop, closes the epoll instance. */
+        ~EventLoop(void);
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /** Adds a file descriptor to the loop.
+         *
+         * @param fd The non-blocking file descriptor.
+         * @return If the file descriptor was added.
+         * */
+        bool add(int fd);
+        /** Removes a file descriptor from the loop.
+         *
+         * @param fd The file descriptor.
+         * */
+        void remove(int fd);
+        /** Resumes a coroutine once a file descriptor is ready.
+         *
+         * @param fd The file descriptor, added with add().
+         * @param events The epoll events to wait for.
+         * @param handle The coroutine to resume.
+         * @return If the wait was registered.
+         * */
+        bool resumeWhenReady(int fd, uint32_t events, std::coroutine_handle<> handle);
+        /** Runs the loop until stop() is called.
+         *
+         * @return 0 on success, 1 if epoll failed.
+         * */
+        int run(void);
+        /** Stops the loop after the current events. */
+        void stop(void);
+        /** Calls a function periodically while the loop runs.
+         *
+         * @param interval The time between two calls.
+         * @param tick The function, replacing the previous one. An empty
+         * function stops the calls.
+         * */
+        void every(std::chrono::milliseconds interval, std::function<void()> tick);
+
+        /** Awaitable suspending the coroutine until a file descriptor is
+         * ready.
+         * */
+        struct Ready {
+            EventLoop &loop; /**<The loop to wait in. */
+            int fd; /**<The file descriptor. */
+            uint32_t events; /**<The epoll events to wait for. */
+            bool failed = false; /**<If the wait couldn't be registered. */
+
+            bool await_ready(void) const noexcept {
+                return false;
+            }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                this->failed = !this->loop.resumeWhenReady(this->fd, this->events, handle);
+                return !this->failed;
+            }
+            /** @return If the file descriptor is ready. */
+            bool await_resume(void) const noexcept {
+                return !this->failed;
+            }
+        };
+        /** Waits until a file descriptor is readable.
+         *
+         * @param fd The file descriptor, added with add().
+         * @return The awaitable, it results in false if waiting failed.
+         * */
+        Ready readable(int fd);
+        /** Waits until a file descriptor is writable.
+         *
+         * @param fd The file descriptor, added with add().
+         * @return The awaitable, it results in false if waiting failed.
+         * */
+        Ready writable(int fd);
+    private:
+        int m_epoll_fd; /**<The epoll instance. */
+        bool m_running = false; /**<If the loop is running. */
+        std::function<void()> m_tick; /**<Called every m_tick_interval. */
+        std::chrono::milliseconds m_tick_interval{0}; /**<Time between two ticks. */
+        std::chrono::steady_clock::time_point m_next_tick; /**<Time of the next tick. */
+};
+
+#endif // EVENT_LOOP_H_
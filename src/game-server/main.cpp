@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "event-loop.h"
+#include "leaderboard.h"
+#include "session.h"
+
+using namespace std;
+
+/** Least time between two saves of the leaderboard. */
+static const chrono::milliseconds LEADERBOARD_SAVE_INTERVAL(10000);
+/** Default time a game is unused before it is hibernated. */
+static const chrono::milliseconds DEFAULT_HIBERNATE_AFTER(60000);
+/** Most time between two looks for idle games. */
+static const chrono::milliseconds HIBERNATE_CHECK_INTERVAL(1000);
+
+/** Opens a non-blocking listening socket.
+ *
+ * @param address The IPv4 address to listen on.
+ * @param port The port to listen on.
+ * @return The socket, -1 on failure.
+ * */
+static int listenOn(const string &address, int port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        cerr << "Invalid address " << address << endl;
+        return -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, (sockaddr*) &addr, sizeof(addr)) < 0 ||
+        listen(fd, SOMAXCONN) < 0) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+    string address = "127.0.0.1";
+    int port = 4000;
+    string leaderboard = "";
+    chrono::milliseconds hibernate_after = DEFAULT_HIBERNATE_AFTER;
+    string transcripts = "";
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--address" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = stoi(argv[++i]);
+        } else if (arg == "--leaderboard" && i + 1 < argc) {
+            leaderboard = argv[++i];
+        } else if (arg == "--hibernate-after" && i + 1 < argc) {
+            hibernate_after = chrono::milliseconds(stol(argv[++i]));
+        } else if (arg == "--transcripts" && i + 1 < argc) {
+            transcripts = argv[++i];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--address IPV4] [--port PORT]"
+                 << " [--leaderboard FILE] [--hibernate-after MILLISECONDS]"
+                 << " [--transcripts DIRECTORY]" << endl;
+            return 1;
+        }
+    }
+
+    if (!leaderboard.empty() &&
+        !globalLeaderboard().persistTo(leaderboard, LEADERBOARD_SAVE_INTERVAL)) {
+        cerr << "Can't read the leaderboard " << leaderboard << endl;
+        return 1;
+    }
+
+    int listen_fd = listenOn(address, port);
+    if (listen_fd < 0) {
+        return 1;
+    }
+    cerr << "Serving Adventure Game on " << address << ":" << port << endl;
+
+    EventLoop loop;
+    SessionGames games(hibernate_after, transcripts);
+    if (hibernate_after.count() > 0) {
+        loop.every(min(hibernate_after, HIBERNATE_CHECK_INTERVAL), [&games]() {
+            games.hibernateIdle();
+        });
+    }
+    acceptConnections(loop, listen_fd, games);
+    int status = loop.run();
+    close(listen_fd);
+    globalLeaderboard().save();
+    return status;
+}
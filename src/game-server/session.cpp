@@ -0,0 +1,383 @@
+#include "session.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "game.h"
+
+//////////////
+// Connection
+/** Constructor for Connection, adds the socket to the loop.
+ *
+ * @param loop The loop the socket is waited on in.
+ * @param fd The non-blocking socket, the connection owns it.
+ * */
+Connection::Connection(EventLoop &loop, int fd):
+    m_loop(loop), m_fd(fd), m_open(loop.add(fd)) {
+}
+
+/** Destructor for Connection, removes and closes the socket. */
+Connection::~Connection(void) {
+    this->m_loop.remove(this->m_fd);
+    close(this->m_fd);
+}
+
+/** Takes the next complete line out of the input.
+ *
+ * The line ending, including a carriage return, is removed.
+ *
+ * @param line Where the line is stored.
+ * @return If there was a complete line.
+ * */
+bool Connection::takeLine(std::string &line) {
+    size_t end = this->m_input.find('\n');
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    line.assign(this->m_input, 0, end);
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    this->m_input.erase(0, end + 1);
+    return true;
+}
+
+/** Reads whatever the socket has available.
+ *
+ * @return If the connection is still open.
+ * */
+bool Connection::fill(void) {
+    char buffer[1024];
+    while (this->m_open) {
+        ssize_t size = recv(this->m_fd, buffer, sizeof(buffer), 0);
+        if (size > 0) {
+            this->m_input.append(buffer, size);
+            // A line that long isn't a command
+            if (this->m_input.size() > MAX_LINE &&
+                this->m_input.find('\n') == std::string::npos) {
+                this->m_open = false;
+            }
+        } else if (size < 0 && errno == EINTR) {
+            continue;
+        } else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            // Closed by the peer or failed
+            this->m_open = false;
+        }
+    }
+    return this->m_open;
+}
+
+/** Queues data to be sent.
+ *
+ * @param data The data.
+ * */
+void Connection::send(const std::string &data) {
+    if (!data.empty()) {
+        this->m_output.push_back(makeEvent(data));
+    }
+}
+
+/** Queues a shared buffer to be sent, without copying it.
+ *
+ * @param data The buffer.
+ * */
+void Connection::send(const EventBuffer &data) {
+    if (data != nullptr && !data->empty()) {
+        this->m_output.push_back(data);
+    }
+}
+
+/** Sends as much of the queued data as the socket accepts.
+ *
+ * @return If nothing is left to send, also when the connection closed.
+ * */
+bool Connection::flush(void) {
+    iovec buffers[MAX_GATHER];
+    while (this->m_open && !this->m_output.empty()) {
+        // Gathering the queued buffers into one write
+        size_t count = 0;
+        for (const EventBuffer &data: this->m_output) {
+            size_t skip = count == 0 ? this->m_output_sent : 0;
+            buffers[count].iov_base = const_cast<char*>(data->data()) + skip;
+            buffers[count].iov_len = data->size() - skip;
+            if (++count == MAX_GATHER) {
+                break;
+            }
+        }
+        msghdr message = {};
+        message.msg_iov = buffers;
+        message.msg_iovlen = count;
+
+        ssize_t size = sendmsg(this->m_fd, &message, MSG_NOSIGNAL);
+        if (size >= 0) {
+            // Dropping the buffers sent whole
+            size_t sent = this->m_output_sent + size;
+            while (!this->m_output.empty() && sent >= this->m_output.front()->size()) {
+                sent -= this->m_output.front()->size();
+                this->m_output.pop_front();
+            }
+            this->m_output_sent = sent;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        } else {
+            this->m_open = false;
+        }
+    }
+    this->m_output.clear();
+    this->m_output_sent = 0;
+    return true;
+}
+
+//////////
+// Getters
+/** Checks if the connection is still open.
+ *
+ * @return If the connection is open.
+ * */
+bool Connection::isOpen(void) const {
+    return this->m_open;
+}
+
+/** Gets the socket of the connection.
+ *
+ * @return The socket.
+ * */
+int Connection::getFd(void) const {
+    return this->m_fd;
+}
+
+////////////////
+// SessionGames
+/** Constructor for SessionGames.
+ *
+ * @param idle_after How long a game is unused before it is hibernated, 0 to
+ * never hibernate.
+ * @param transcripts The directory the transcripts of the games are
+ * archived in, empty to not record them.
+ * */
+SessionGames::SessionGames(std::chrono::milliseconds idle_after,
+                           std::string transcripts):
+    m_idle_after(idle_after), m_transcripts(transcripts) {
+}
+
+/** Adds the game of a session.
+ *
+ * @param game The game, it is removed before it is destroyed.
+ * */
+void SessionGames::add(HibernatingGame *game) {
+    this->m_games.push_back(game);
+}
+
+/** Removes the game of a session.
+ *
+ * @param game The game.
+ * */
+void SessionGames::remove(HibernatingGame *game) {
+    auto found = std::find(this->m_games.begin(), this->m_games.end(), game);
+    if (found != this->m_games.end()) {
+        *found = this->m_games.back();
+        this->m_games.pop_back();
+    }
+}
+
+/** Hibernates the games idle for long enough.
+ *
+ * @return The number of games hibernated.
+ * */
+size_t SessionGames::hibernateIdle(void) {
+    if (this->m_idle_after.count() <= 0) {
+        return 0;
+    }
+    auto idle_since = std::chrono::steady_clock::now() - this->m_idle_after;
+    size_t hibernated = 0;
+    for (HibernatingGame *game: this->m_games) {
+        if (!game->isHibernated() && game->getLastUsed() <= idle_since) {
+            hibernated += game->hibernate();
+        }
+    }
+    return hibernated;
+}
+
+/** Archives the transcript of a finished game.
+ *
+ * The transcript is written to the first session-N.hkt that doesn't exist
+ * yet, so the transcripts of earlier runs of the server are kept. The file
+ * is written on the thread of the loop, which waits for it.
+ *
+ * @param transcript The transcript.
+ * @return If the transcript was written.
+ * */
+bool SessionGames::archive(const TranscriptWriter &transcript) {
+    std::string path;
+    int fd;
+    do {
+        path = this->m_transcripts + "/session-" +
+               std::to_string(++this->m_archived) + ".hkt";
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    } while (fd < 0 && (errno == EEXIST || errno == EINTR));
+    if (fd < 0) {
+        std::perror(path.c_str());
+        return false;
+    }
+
+    const std::string &data = transcript.getData();
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t size = write(fd, data.data() + written, data.size() - written);
+        if (size > 0) {
+            written += size;
+        } else if (size < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    bool complete = written == data.size();
+    if (!complete) {
+        std::perror(path.c_str());
+    }
+    if (close(fd) < 0 && complete) {
+        std::perror(path.c_str());
+        complete = false;
+    }
+    return complete;
+}
+
+//////////
+// Getters
+/** Gets how long a game is unused before it is hibernated.
+ *
+ * @return The time, 0 if games are never hibernated.
+ * */
+std::chrono::milliseconds SessionGames::getIdleAfter(void) const {
+    return this->m_idle_after;
+}
+
+/** Gets the directory the transcripts are archived in.
+ *
+ * @return The directory, empty if transcripts aren't recorded.
+ * */
+const std::string& SessionGames::getTranscripts(void) const {
+    return this->m_transcripts;
+}
+
+/////////////
+// Coroutines
+/** Plays a game over a connection until it ends or the peer leaves.
+ *
+ * @param loop The loop the connection is waited on in.
+ * @param fd The non-blocking socket of the connection.
+ * @param games Where the game of the session is added while it runs.
+ * @return The coroutine, it frees itself when it finishes.
+ * */
+DetachedTask serveSession(EventLoop &loop, int fd, SessionGames &games) {
+    Connection connection(loop, fd);
+    HibernatingGame game;
+    std::unique_ptr<TranscriptWriter> transcript;
+    if (!games.getTranscripts().empty()) {
+        transcript.reset(new TranscriptWriter(game.get().getVerbs()));
+    }
+    // Removing the game and archiving its transcript however the session
+    // ends
+    struct Registration {
+        SessionGames &games;
+        HibernatingGame *game;
+        TranscriptWriter *transcript;
+        ~Registration(void) {
+            this->games.remove(this->game);
+            if (this->transcript != nullptr && this->transcript->getCount() > 0) {
+                this->games.archive(*this->transcript);
+            }
+        }
+    } registration{games, &game, transcript.get()};
+    games.add(&game);
+
+    game.get().out() << "Welcome to Adventure Game" << std::endl;
+    game.get().printPrompt();
+
+    std::string command;
+    while (connection.isOpen()) {
+        // Sending the output of the last command, the game may be
+        // hibernated once it was sent
+        connection.send(game.takeOutput());
+        while (!connection.flush()) {
+            if (!co_await loop.writable(connection.getFd())) {
+                co_return;
+            }
+        }
+
+        // Suspending until the next command arrives
+        while (!connection.takeLine(command)) {
+            if (!connection.isOpen() || !co_await loop.readable(connection.getFd())) {
+                co_return;
+            }
+            connection.fill();
+        }
+
+        // Rehydrating the game if it was hibernated, a rehydrated game
+        // doesn't know its transcript
+        game.get().setTranscript(transcript.get());
+        GameStatus status = game.get().runCommand(command);
+        if (status != GameStatus::CONTINUE) {
+            game.get().finish(status);
+            connection.send(game.takeOutput());
+            while (!connection.flush()) {
+                if (!co_await loop.writable(connection.getFd())) {
+                    co_return;
+                }
+            }
+            co_return;
+        }
+        game.get().printPrompt();
+    }
+}
+
+/** Accepts connections and starts a session for each of them.
+ *
+ * Stops the loop if the listening socket fails.
+ *
+ * @param loop The loop the sockets are waited on in.
+ * @param listen_fd The non-blocking listening socket.
+ * @param games Where the games of the sessions are added.
+ * @return The coroutine, it frees itself when it finishes.
+ * */
+DetachedTask acceptConnections(EventLoop &loop, int listen_fd, SessionGames &games) {
+    if (!loop.add(listen_fd)) {
+        std::perror("epoll_ctl");
+        loop.stop();
+        co_return;
+    }
+
+    while (co_await loop.readable(listen_fd)) {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0) {
+                // Runs until the session first waits
+                serveSession(loop, fd, games);
+            } else if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else {
+                // Out of file descriptors, retried on the next wake up
+                std::perror("accept4");
+                break;
+            }
+        }
+    }
+    loop.stop();
+}
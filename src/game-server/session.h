@@ -0,0 +1,181 @@
+#ifndef SESSION_H_
+#define SESSION_H_
+
+/** @file session.h
+ *
+ * Header file containing the game sessions served over sockets.
+ *
+ * Every connection is played by a coroutine. Waiting for the next command
+ * suspends the coroutine, so an idle player only costs its suspended frame
+ * and its game instead of a blocked thread. Games idle for long enough are
+ * hibernated, leaving only their saved state, and the commands of every
+ * game can be archived as a transcript.
+ * */
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "event-loop.h"
+#include "event-queue.h"
+#include "hibernating-game.h"
+#include "transcript.h"
+
+/** A non-blocking socket with line buffered input and buffered output.
+ *
+ * The output is a queue of shared buffers sent with one gathering write, so
+ * an event sent to many connections is never copied.
+ * */
+class Connection {
+    public:
+        /** Longest command accepted, longer lines close the connection. */
+        static constexpr size_t MAX_LINE = 4096;
+
+        /** Constructor for Connection, adds the socket to the loop.
+         *
+         * @param loop The loop the socket is waited on in.
+         * @param fd The non-blocking socket, the connection owns it.
+         * */
+        Connection(EventLoop &loop, int fd);
+        /** Destructor for Connection, removes and closes the socket. */
+        ~Connection(void);
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        /** Takes the next complete line out of the input.
+         *
+         * The line ending, including a carriage return, is removed.
+         *
+         * @param line Where the line is stored.
+         * @return If there was a complete line.
+         * */
+        bool takeLine(std::string &line);
+        /** Reads whatever the socket has available.
+         *
+         * @return If the connection is still open.
+         * */
+        bool fill(void);
+        /** Maximum number of buffers sent by one write. */
+        static constexpr size_t MAX_GATHER = 64;
+
+        /** Queues data to be sent.
+         *
+         * @param data The data.
+         * */
+        void send(const std::string &data);
+        /** Queues a shared buffer to be sent, without copying it.
+         *
+         * @param data The buffer.
+         * */
+        void send(const EventBuffer &data);
+        /** Sends as much of the queued data as the socket accepts.
+         *
+         * @return If nothing is left to send, also when the connection
+         * closed.
+         * */
+        bool flush(void);
+
+        //////////
+        // Getters
+        /** Checks if the connection is still open.
+         *
+         * @return If the connection is open.
+         * */
+        bool isOpen(void) const;
+        /** Gets the socket of the connection.
+         *
+         * @return The socket.
+         * */
+        int getFd(void) const;
+    private:
+        EventLoop &m_loop; /**<The loop the socket is waited on in. */
+        int m_fd; /**<The socket. */
+        bool m_open; /**<If the connection is open. */
+        std::string m_input; /**<Received data not yet taken as lines. */
+        std::deque<EventBuffer> m_output; /**<Queued buffers not yet sent. */
+        size_t m_output_sent = 0; /**<Bytes of the first buffer already sent. */
+};
+
+/** The games of the sessions, hibernated once they are idle. */
+class SessionGames {
+    public:
+        /** Constructor for SessionGames.
+         *
+         * @param idle_after How long a game is unused before it is
+         * hibernated, 0 to never hibernate.
+         * @param transcripts The directory the transcripts of the games are
+         * archived in, empty to not record them.
+         * */
+        SessionGames(std::chrono::milliseconds idle_after,
+                     std::string transcripts = "");
+
+        /** Adds the game of a session.
+         *
+         * @param game The game, it is removed before it is destroyed.
+         * */
+        void add(HibernatingGame *game);
+        /** Removes the game of a session.
+         *
+         * @param game The game.
+         * */
+        void remove(HibernatingGame *game);
+        /** Hibernates the games idle for long enough.
+         *
+         * @return The number of games hibernated.
+         * */
+        size_t hibernateIdle(void);
+        /** Archives the transcript of a finished game.
+         *
+         * The transcript is written to the first session-N.hkt that
+         * doesn't exist yet, so the transcripts of earlier runs of the
+         * server are kept. The file is written on the thread of the loop,
+         * which waits for it.
+         *
+         * @param transcript The transcript.
+         * @return If the transcript was written.
+         * */
+        bool archive(const TranscriptWriter &transcript);
+
+        //////////
+        // Getters
+        /** Gets how long a game is unused before it is hibernated.
+         *
+         * @return The time, 0 if games are never hibernated.
+         * */
+        std::chrono::milliseconds getIdleAfter(void) const;
+        /** Gets the directory the transcripts are archived in.
+         *
+         * @return The directory, empty if transcripts aren't recorded.
+         * */
+        const std::string& getTranscripts(void) const;
+    private:
+        std::chrono::milliseconds m_idle_after; /**<Time before hibernating. */
+        std::string m_transcripts; /**<Where transcripts are archived. */
+        size_t m_archived = 0; /**<Number of the last transcript file tried. */
+        std::vector<HibernatingGame *> m_games; /**<The games of the sessions. */
+};
+
+/** Plays a game over a connection until it ends or the peer leaves.
+ *
+ * @param loop The loop the connection is waited on in.
+ * @param fd The non-blocking socket of the connection.
+ * @param games Where the game of the session is added while it runs.
+ * @return The coroutine, it frees itself when it finishes.
+ * */
+DetachedTask serveSession(EventLoop &loop, int fd, SessionGames &games);
+
+/** Accepts connections and starts a session for each of them.
+ *
+ * Stops the loop if the listening socket fails.
+ *
+ * @param loop The loop the sockets are waited on in.
+ * @param listen_fd The non-blocking listening socket.
+ * @param games Where the games of the sessions are added.
+ * @return The coroutine, it frees itself when it finishes.
+ * */
+DetachedTask acceptConnections(EventLoop &loop, int listen_fd, SessionGames &games);
+
+#endif // SESSION_H_
@@ -0,0 +1,147 @@
+#include "generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "enemies.h"
+#include "items.h"
+#include "room.h"
+#include "world.h"
+
+/** Offsets of the grid cell in each Direction. */
+static const int DX[4] = {0, 0, 1, -1};
+static const int DY[4] = {-1, 1, 0, 0};
+
+/** Creates a random castle.
+ *
+ * The rooms are laid out on a grid as a random tree with a few extra
+ * doors making loops. The items and enemies of the coursework castle are
+ * spread over distinct rooms and the Golden Chalice is in a locked Boss
+ * Room as far as possible from the entrance. The same seed always gives
+ * the same castle.
+ *
+ * @param world The world owning the castle.
+ * @param rooms The number of rooms, at least MIN_GENERATED_ROOMS.
+ * @param seed The seed of the random numbers.
+ * @return The room the player starts in.
+ * */
+Room* generateCastle(World &world, size_t rooms, uint32_t seed) {
+    if (rooms < MIN_GENERATED_ROOMS) {
+        throw std::invalid_argument("A castle needs at least " +
+                                    std::to_string(MIN_GENERATED_ROOMS) +
+                                    " rooms");
+    }
+    std::mt19937 random(seed);
+    auto below = [&](size_t n) {
+        return (size_t) (random() % n);
+    };
+
+    // Growing a tree of rooms from the centre of the grid, the last room
+    // is kept for the Boss Room
+    const int side = (int) std::ceil(std::sqrt(2.0 * rooms)) + 2;
+    std::vector<Room *> grid(side * side, nullptr);
+    std::vector<int> cells;
+    auto neighbour = [&](int cell, int direction) {
+        int x = cell % side + DX[direction];
+        int y = cell / side + DY[direction];
+        if (x < 0 || y < 0 || x >= side || y >= side) {
+            return -1;
+        }
+        return y * side + x;
+    };
+
+    Room *entrance = world.createRoom("Castle Entrance");
+    cells.push_back(side / 2 * side + side / 2);
+    grid[cells[0]] = entrance;
+    while (cells.size() + 1 < rooms) {
+        int cell = cells[below(cells.size())];
+        int direction = (int) below(4);
+        int next = neighbour(cell, direction);
+        if (next < 0 || grid[next] != nullptr) {
+            continue;
+        }
+        grid[next] = grid[cell]->setRoom("Room " + std::to_string(cells.size()),
+                                         (Direction) direction);
+        cells.push_back(next);
+    }
+
+    // Extra doors between a quarter of the neighbouring rooms
+    for (int cell: cells) {
+        for (int direction: {SOUTH, EAST}) {
+            int next = neighbour(cell, direction);
+            if (next >= 0 && grid[next] != nullptr &&
+                grid[cell]->getRoom((Direction) direction) == nullptr &&
+                below(4) == 0) {
+                grid[cell]->setRoom(grid[next], (Direction) direction);
+            }
+        }
+    }
+
+    // The Boss Room hangs off the furthest room with a free side
+    std::vector<size_t> distance(world.roomCount(), SIZE_MAX);
+    std::vector<Room *> queue = {entrance};
+    distance[entrance->getId()] = 0;
+    for (size_t i = 0; i < queue.size(); i++) {
+        for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+            Room *next = queue[i]->getRoom(direction);
+            if (next != nullptr && distance[next->getId()] == SIZE_MAX) {
+                distance[next->getId()] = distance[queue[i]->getId()] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    std::vector<int> by_distance = cells;
+    std::stable_sort(by_distance.begin(), by_distance.end(), [&](int a, int b) {
+        return distance[grid[a]->getId()] > distance[grid[b]->getId()];
+    });
+    Room *boss = nullptr;
+    for (size_t i = 0; i < by_distance.size() && boss == nullptr; i++) {
+        for (int direction = 0; direction < 4 && boss == nullptr; direction++) {
+            int next = neighbour(by_distance[i], direction);
+            if (next >= 0 && grid[next] == nullptr) {
+                boss = grid[by_distance[i]]->setRoom("Boss Room", (Direction) direction);
+                grid[next] = boss;
+            }
+        }
+    }
+
+    // The content of the coursework castle in distinct rooms
+    std::vector<Room *> content;
+    for (size_t i = 1; i < cells.size(); i++) {
+        content.push_back(grid[cells[i]]);
+    }
+    std::shuffle(content.begin(), content.end(), random);
+
+    content[0]->addItem(world.createItem<Consumable>("Food", 5));
+
+    ItemHandle spear = world.createItem<Weapon>("Silver Spear", 1);
+    content[1]->addItem(spear);
+    content[1]->addEnemey(world.createEnemy<GenericEnemy>(6, 1, "Zombie", spear));
+
+    content[2]->addItem(world.createItem<Weapon>("Sword", 2));
+    content[2]->addEnemey(world.createEnemy<GenericEnemy>(5, 1, "Lizard-man"));
+
+    ItemHandle cross = world.createItem<GenericItem>("Diamond Cross");
+    content[3]->addItem(cross);
+    content[3]->addEnemey(world.createEnemy<Werewolf>(12, 3, "Werewolf", cross));
+
+    content[4]->addItem(world.createItem<Consumable>("Medpack", 10));
+
+    ItemHandle key = world.createItem<GenericItem>("Copper Key");
+    content[5]->addItem(key);
+    content[5]->addEnemey(world.createEnemy<Vampire>(12, 3, "Dracula", key));
+
+    content[6]->addItem(world.createItem<Consumable>("Elixir", 10));
+    content[6]->addEnemey(world.createEnemy<GenericEnemy>(4, 3, "Monster"));
+
+    ItemHandle chalice = world.createItem<GenericItem>("Golden Chalice");
+    boss->addItem(chalice);
+    boss->addEnemey(world.createEnemy<GenericEnemy>(12, 4, "Dragon", chalice));
+    boss->lockRoom();
+
+    return entrance;
+}
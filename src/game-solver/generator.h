@@ -0,0 +1,33 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+/** @file generator.h
+ *
+ * Header file containing the generator of random castles for the solver.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+
+class Room;
+class World;
+
+/** Smallest number of rooms of a generated castle. */
+static const size_t MIN_GENERATED_ROOMS = 9;
+
+/** Creates a random castle.
+ *
+ * The rooms are laid out on a grid as a random tree with a few extra
+ * doors making loops. The items and enemies of the coursework castle are
+ * spread over distinct rooms and the Golden Chalice is in a locked Boss
+ * Room as far as possible from the entrance. The same seed always gives
+ * the same castle.
+ *
+ * @param world The world owning the castle.
+ * @param rooms The number of rooms, at least MIN_GENERATED_ROOMS.
+ * @param seed The seed of the random numbers.
+ * @return The room the player starts in.
+ * */
+Room* generateCastle(World &world, size_t rooms, uint32_t seed);
+
+#endif // GENERATOR_H_
@@ -0,0 +1,172 @@
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "generator.h"
+#include "model.h"
+#include "solver.h"
+#include "game.h"
+
+using namespace std;
+
+/** Stream buffer discarding everything written to it. */
+class NullBuffer: public streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+        streamsize xsputn(const char *, streamsize n) override {
+            return n;
+        }
+};
+
+/** Creates a game in the selected world.
+ *
+ * @param rooms The rooms of a generated castle, 0 for the coursework castle.
+ * @param seed The seed of the generated castle.
+ * @return The game.
+ * */
+static unique_ptr<AdventureGame> createGame(size_t rooms, uint32_t seed) {
+    if (rooms == 0) {
+        return make_unique<AdventureGame>();
+    }
+    return make_unique<AdventureGame>([=](World &world) {
+        return generateCastle(world, rooms, seed);
+    });
+}
+
+/** Prints commands separated by ';', as they can be typed in the game.
+ *
+ * @param out The output stream.
+ * @param model The model the commands belong to.
+ * @param path The commands.
+ * */
+static void printPath(ostream &out, const WorldModel &model,
+                      const vector<uint32_t> &path) {
+    for (size_t i = 0; i < path.size(); i++) {
+        out << (i == 0 ? "" : "; ") << model.getCommand(path[i]);
+    }
+    out << endl;
+}
+
+/** Replays the winning commands in a new game.
+ *
+ * @param game The game, no command was run in it yet.
+ * @param model The model the commands belong to.
+ * @param path The commands.
+ * @return If the last command wins the game and none ends it before.
+ * */
+static bool verify(AdventureGame &game, const WorldModel &model,
+                   const vector<uint32_t> &path) {
+    NullBuffer null_buffer;
+    ostream null_stream(&null_buffer);
+    game.setOutput(&null_stream);
+
+    GameStatus status = CONTINUE;
+    for (size_t i = 0; i < path.size() && status == CONTINUE; i++) {
+        status = game.runCommand(model.getCommand(path[i]));
+    }
+    game.setOutput(&cout);
+    return status == VICTORY;
+}
+
+int main(int argc, char *argv[]) {
+    SolverOptions options;
+    options.threads = max(thread::hardware_concurrency(), 1u);
+    size_t rooms = 0;
+    uint32_t seed = 1;
+    DropPolicy drops = DROP_ANYWHERE;
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                options.threads = (unsigned int) stoul(argv[++i]);
+            } else if (arg == "--rooms" && i + 1 < argc) {
+                rooms = stoul(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = (uint32_t) stoul(argv[++i]);
+            } else if (arg == "--max-states" && i + 1 < argc) {
+                options.max_states = stoul(argv[++i]);
+            } else if (arg == "--no-dead-ends") {
+                options.dead_ends = false;
+            } else if (arg == "--drops" && i + 1 < argc) {
+                string policy = argv[++i];
+                if (policy == "anywhere") {
+                    drops = DROP_ANYWHERE;
+                } else if (policy == "content") {
+                    drops = DROP_IN_CONTENT_ROOMS;
+                } else if (policy == "none") {
+                    drops = DROP_NOWHERE;
+                } else {
+                    throw invalid_argument("unknown drop policy " + policy);
+                }
+            } else {
+                throw invalid_argument("unknown argument " + arg);
+            }
+        }
+        if (rooms != 0 && rooms < MIN_GENERATED_ROOMS) {
+            throw invalid_argument("--rooms must be at least " +
+                                   to_string(MIN_GENERATED_ROOMS));
+        }
+    } catch (const exception &e) {
+        cerr << argv[0] << ": " << e.what() << endl;
+        cerr << "Usage: " << argv[0] << " [--threads N] [--rooms N [--seed S]]"
+             << " [--drops anywhere|content|none] [--max-states N]"
+             << " [--no-dead-ends]" << endl;
+        return 1;
+    }
+
+    unique_ptr<AdventureGame> game = createGame(rooms, seed);
+    WorldModel model(*game, drops);
+    cout << "World: " << model.roomCount() << " rooms, " << model.itemCount()
+         << " items, " << model.enemyCount() << " enemies, states of "
+         << model.words() << " words" << endl;
+
+    SolveResult result = solve(model, options);
+    cout << "Searched " << result.states << " states and "
+         << result.transitions << " transitions in " << result.levels
+         << " levels with " << options.threads << " threads in "
+         << result.seconds << " s" << endl;
+    if (!result.complete && result.solvable && !options.dead_ends) {
+        cout << "The search stopped at the shortest win" << endl;
+    } else if (!result.complete) {
+        cout << "The search stopped after " << options.max_states
+             << " states, the results are partial" << endl;
+    }
+    if (drops != DROP_ANYWHERE) {
+        cout << "Items can't be dropped in every room, an unsolvable world"
+             << " may still be won" << endl;
+    }
+
+    bool verified = false;
+    if (result.solvable) {
+        cout << "Solvable, the shortest win takes " << result.path.size()
+             << " commands:" << endl;
+        printPath(cout, model, result.path);
+        verified = verify(*createGame(rooms, seed), model, result.path);
+        cout << (verified ? "Verified by replaying the commands in the game"
+                          : "Replaying the commands in the game didn't win")
+             << endl;
+    } else {
+        cout << "No winning path was found" << endl;
+    }
+
+    cout << result.defeats << " commands kill the player";
+    if (result.complete && options.dead_ends) {
+        cout << ", " << result.dead_ends << " states can't be won anymore, "
+             << result.fatal_commands << " commands lead to them" << endl;
+        if (!result.dead_end_path.empty()) {
+            cout << "The closest dead end is " << model.describe(result.dead_end.data())
+                 << " after:" << endl;
+            printPath(cout, model, result.dead_end_path);
+        }
+    } else {
+        cout << endl;
+    }
+    return verified ? 0 : 2;
+}
@@ -0,0 +1,361 @@
+#include "model.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "game.h"
+#include "ascii-fold.h"
+#include "combat.h"
+#include "enemies.h"
+#include "inventory.h"
+#include "items.h"
+#include "player.h"
+#include "room.h"
+#include "world.h"
+
+/** Converts a name to lower case, as the game compares names.
+ *
+ * @param name The name.
+ * @return The name in lower case.
+ * */
+static std::string lowerCase(std::string name) {
+    foldCase(name);
+    return name;
+}
+
+/** Gets the command using a consumable.
+ *
+ * @param name The name of the consumable, in lower case.
+ * @return The command, empty if the game has no command using it.
+ * */
+static std::string useCommand(const std::string &name) {
+    if (name == "food") {
+        return "eat food";
+    } else if (name == "elixir") {
+        return "drink elixir";
+    } else if (name == "medpack") {
+        return "use medpack";
+    }
+    return "";
+}
+
+/** Constructor for WorldModel.
+ *
+ * The game must not have processed any command yet.
+ *
+ * @param game The game to model.
+ * @param drops The rooms the player may drop items in.
+ * */
+WorldModel::WorldModel(AdventureGame &game, DropPolicy drops) {
+    World &world = game.getWorld();
+    Player *player = game.getPlayer();
+    Inventory *inventory = player->getInventory();
+
+    // The command of each direction is its index
+    for (const char *command: {"north", "south", "east", "west"}) {
+        this->addCommand(command);
+    }
+    this->m_kill_first = this->addCommand("km");
+    this->m_unlock = this->addCommand("unlock door");
+
+    // Rooms, with the items and enemies in them
+    std::vector<GenericItem *> items;
+    std::vector<GenericEnemy *> enemies;
+    size_t locks = 0;
+    this->m_rooms.resize(world.roomCount());
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        Room *room = world.getRoom(id);
+        RoomModel &model = this->m_rooms[id];
+        model.name = room->getName();
+        for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+            Room *exit = room->getRoom(direction);
+            if (exit == nullptr) {
+                continue;
+            }
+            if (exit->getId() >= world.roomCount()) {
+                throw std::invalid_argument("Room " + exit->getName() +
+                                            " isn't owned by the world");
+            }
+            model.exits[direction] = (uint32_t) exit->getId();
+        }
+        if (room->isLocked()) {
+            model.lock = (uint32_t) locks++;
+        }
+
+        for (GenericItem *item: room->getItems()) {
+            items.push_back(item);
+            this->m_items.emplace_back();
+            this->m_items.back().start = (uint32_t) id;
+        }
+        std::vector<std::string> names;
+        for (GenericEnemy *enemy: room->getEnemies()) {
+            uint32_t index = (uint32_t) enemies.size();
+            std::string name = lowerCase(enemy->getName());
+            if (names.empty()) {
+                model.first_enemy = index;
+            } else if (std::find(names.begin(), names.end(), name) == names.end()) {
+                model.kills.emplace_back(index, this->addCommand("kill " + name));
+            }
+            names.push_back(name);
+            enemies.push_back(enemy);
+        }
+        model.drops = drops == DROP_ANYWHERE ||
+                      (drops == DROP_IN_CONTENT_ROOMS &&
+                       (!room->getItems().empty() || !names.empty() ||
+                        room == game.getInitialRoom()));
+    }
+    this->m_initial_room = (uint32_t) game.getInitialRoom()->getId();
+    this->m_inventory = (uint32_t) this->m_rooms.size();
+    this->m_gone = this->m_inventory + 1;
+
+    // Items the player already holds
+    for (unsigned int i = 0; i < inventory->maxSize(); i++) {
+        GenericItem *item = inventory->getItem(i);
+        if (item != nullptr) {
+            items.push_back(item);
+            this->m_items.emplace_back();
+            this->m_items.back().start = this->m_inventory;
+        }
+    }
+
+    // Items
+    int weapon_damage = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        ItemModel &model = this->m_items[i];
+        model.name = items[i]->getName();
+        std::string name = lowerCase(model.name);
+        model.pickup = items[i]->canPickup();
+        model.chalice = name == "golden chalice";
+        model.key = name == "copper key";
+        model.get_command = this->addCommand("get " + name);
+        model.drop_command = this->addCommand("drop " + name);
+        if (Weapon *weapon = dynamic_cast<Weapon *>(items[i])) {
+            model.damage = weapon->getDamage();
+            if (model.damage < 0) {
+                throw std::invalid_argument("Weapon " + model.name +
+                                            " lowers the damage");
+            }
+            weapon_damage += model.damage;
+        }
+        if (Consumable *consumable = dynamic_cast<Consumable *>(items[i])) {
+            model.healing = consumable->getHealing();
+            if (!useCommand(name).empty()) {
+                model.use_command = this->addCommand(useCommand(name));
+            }
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (lowerCase(this->m_items[j].name) == name) {
+                model.same_name.push_back((uint32_t) j);
+            }
+        }
+    }
+
+    // Enemies, the damage modifiers are measured one item at a time with
+    // the modifiers of the game
+    World scratch;
+    Inventory held(1, scratch);
+    std::map<std::pair<EnemyKind, std::string>, int> deltas;
+    int max_health = 0;
+    int max_penalty = 0;
+    for (size_t e = 0; e < enemies.size(); e++) {
+        GenericEnemy *enemy = enemies[e];
+        EnemyModel &model = this->m_enemies.emplace_back();
+        model.name = enemy->getName();
+        model.health = enemy->getCurrentHealth();
+        model.damage = enemy->getDamage();
+        model.dead = enemy->isDead();
+        max_health = std::max(max_health, model.health);
+
+        auto modify = [&](int damage) {
+            return visitEnemy(*enemy, [&](auto &concrete) {
+                using Enemy = std::decay_t<decltype(concrete)>;
+                return Enemy::modifyDamage(damage, &held);
+            });
+        };
+        int base = modify(0);
+        int penalty = 0;
+        for (size_t i = 0; i < items.size(); i++) {
+            auto key = std::make_pair(enemy->getKind(), this->m_items[i].name);
+            auto delta = deltas.find(key);
+            if (delta == deltas.end()) {
+                ItemHandle item = scratch.createItem<GenericItem>(key.second);
+                held.addItem(item);
+                delta = deltas.emplace(key, modify(0) - base).first;
+                scratch.destroyItem(held.removeItem(0u));
+            }
+            if (delta->second != 0) {
+                model.modifiers.emplace_back((uint32_t) i, delta->second);
+            }
+            penalty += std::max(-delta->second, 0);
+        }
+        max_penalty = std::max(max_penalty, penalty);
+
+        // Items protected by the enemy until it dies
+        GenericItem *protected_item = world.getItem(enemy->getProtectedItem());
+        auto item = std::find(items.begin(), items.end(), protected_item);
+        if (!model.dead && protected_item != nullptr && item != items.end()) {
+            this->m_items[item - items.begin()].guards.push_back((uint32_t) e);
+        }
+    }
+
+    // Player
+    this->m_max_hp = player->getMaxHealth();
+    this->m_initial_hp = (uint32_t) std::clamp(player->getCurrentHealth(), 0,
+                                               this->m_max_hp);
+    this->m_initial_damage = (uint32_t) std::max(player->getDamage(), 0);
+    this->m_max_damage = std::max(max_health + max_penalty + weapon_damage,
+                                  (int) this->m_initial_damage);
+    this->m_capacity = inventory->maxSize();
+
+    // Packing the state
+    this->m_room = this->addField(this->m_rooms.size());
+    this->m_hp = this->addField(this->m_max_hp + 1);
+    this->m_damage = this->addField(this->m_max_damage + 1);
+    for (size_t i = 0; i < this->m_items.size(); i++) {
+        this->m_locations.push_back(this->addField(this->m_gone + 1));
+    }
+    for (size_t e = 0; e < this->m_enemies.size(); e++) {
+        this->m_dead.push_back(this->addField(2));
+    }
+    for (size_t lock = 0; lock < locks; lock++) {
+        this->m_unlocked.push_back(this->addField(2));
+    }
+}
+
+/** Writes the state the game starts in.
+ *
+ * @param state The state, words() long.
+ * */
+void WorldModel::initialState(uint64_t *state) const {
+    std::fill(state, state + this->m_words, 0);
+    this->m_room.set(state, this->m_initial_room);
+    this->m_hp.set(state, this->m_initial_hp);
+    this->m_damage.set(state, std::min(this->m_initial_damage,
+                                       (uint32_t) this->m_max_damage));
+    for (size_t i = 0; i < this->m_items.size(); i++) {
+        this->m_locations[i].set(state, this->m_items[i].start);
+    }
+    for (size_t e = 0; e < this->m_enemies.size(); e++) {
+        this->m_dead[e].set(state, this->m_enemies[e].dead);
+    }
+}
+
+/** Describes a state.
+ *
+ * @param state The state.
+ * @return The room, health, damage and inventory of the player.
+ * */
+std::string WorldModel::describe(const uint64_t *state) const {
+    std::ostringstream out;
+    int damage = (int) this->m_damage.get(state);
+    out << "in " << this->m_rooms[this->m_room.get(state)].name
+        << " with " << this->m_hp.get(state) << "/" << this->m_max_hp
+        << " health and " << (damage == this->m_max_damage ? ">= " : "")
+        << damage << " damage, holding";
+    bool holding = false;
+    for (size_t i = 0; i < this->m_items.size(); i++) {
+        if (this->m_locations[i].get(state) == this->m_inventory) {
+            out << (holding ? ", " : " ") << this->m_items[i].name;
+            holding = true;
+        }
+    }
+    if (!holding) {
+        out << " nothing";
+    }
+    return out.str();
+}
+
+/** Adds a field to the state.
+ *
+ * @param values The number of values of the field.
+ * @return The field.
+ * */
+StateField WorldModel::addField(uint64_t values) {
+    uint32_t bits = 1;
+    while (bits < 64 && (values - 1) >> bits != 0) {
+        bits++;
+    }
+    if (this->m_shift + bits > 64) {
+        this->m_words++;
+        this->m_shift = 0;
+    }
+
+    StateField field;
+    field.word = (uint32_t) this->m_words - 1;
+    field.shift = this->m_shift;
+    field.mask = bits == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1;
+    this->m_shift += bits;
+    return field;
+}
+
+/** Adds a command, unless it is already known.
+ *
+ * @param command The command.
+ * @return The index of the command.
+ * */
+uint32_t WorldModel::addCommand(const std::string &command) {
+    auto known = std::find(this->m_commands.begin(), this->m_commands.end(),
+                           command);
+    if (known != this->m_commands.end()) {
+        return (uint32_t) (known - this->m_commands.begin());
+    }
+    this->m_commands.push_back(command);
+    return (uint32_t) this->m_commands.size() - 1;
+}
+
+//////////
+// Getters
+/** Gets the number of words of a state.
+ *
+ * @return The number of words.
+ * */
+size_t WorldModel::words(void) const {
+    return this->m_words;
+}
+
+/** Gets a command of the model.
+ *
+ * @param command The index of the command.
+ * @return The command as typed in the game.
+ * */
+const std::string& WorldModel::getCommand(uint32_t command) const {
+    return this->m_commands[command];
+}
+
+/** Gets the fields where a larger value is never worse.
+ *
+ * More health or damage never loses a fight that less would win, and every
+ * command keeps the order of the values.
+ *
+ * @return The health and damage of the player.
+ * */
+std::vector<StateField> WorldModel::getMonotoneFields(void) const {
+    return {this->m_hp, this->m_damage};
+}
+
+/** Gets the number of rooms.
+ *
+ * @return The number of rooms.
+ * */
+size_t WorldModel::roomCount(void) const {
+    return this->m_rooms.size();
+}
+
+/** Gets the number of items.
+ *
+ * @return The number of items.
+ * */
+size_t WorldModel::itemCount(void) const {
+    return this->m_items.size();
+}
+
+/** Gets the number of enemies.
+ *
+ * @return The number of enemies.
+ * */
+size_t WorldModel::enemyCount(void) const {
+    return this->m_enemies.size();
+}
@@ -0,0 +1,408 @@
+#ifndef MODEL_H_
+#define MODEL_H_
+
+/** @file model.h
+ *
+ * Header file containing the model of a world searched by the solver. The
+ * state of a game is packed into a few 64 bit words.
+ * */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class AdventureGame;
+
+/** A field of a packed state, a field never straddles two words. */
+struct StateField {
+    uint32_t word = 0; /**<Index of the word holding the field. */
+    uint32_t shift = 0; /**<Position of the lowest bit of the field. */
+    uint64_t mask = 0; /**<Mask of the field once shifted down. */
+
+    /** Gets the value of the field.
+     *
+     * @param state The packed state.
+     * @return The value.
+     * */
+    uint64_t get(const uint64_t *state) const {
+        return (state[this->word] >> this->shift) & this->mask;
+    }
+    /** Sets the value of the field.
+     *
+     * @param state The packed state.
+     * @param value The value, it must fit in the field.
+     * */
+    void set(uint64_t *state, uint64_t value) const {
+        state[this->word] = (state[this->word] & ~(this->mask << this->shift)) |
+                            (value << this->shift);
+    }
+};
+
+/** Result of a command in a state. */
+enum Outcome {
+NEXT_STATE, /**<The game continues in a new state. */
+VICTORY_OUTCOME, /**<The player won the game. */
+DEFEAT_OUTCOME /**<The player died. */
+};
+
+/** Rooms the player is allowed to drop items in.
+ *
+ * Dropping items anywhere multiplies the states by the rooms every held
+ * item can be left in, the other policies trade completeness for worlds
+ * with hundreds of rooms. A path found with them is still a valid win but
+ * an unsolvable result only holds for the policy.
+ * */
+enum DropPolicy {
+DROP_ANYWHERE, /**<Items can be dropped in every room, the search is exact. */
+DROP_IN_CONTENT_ROOMS, /**<Only rooms that start with items or enemies and the initial room. */
+DROP_NOWHERE /**<Items are never dropped. */
+};
+
+/** Model of the world of an AdventureGame.
+ *
+ * The model mirrors AdventureGame::processCommand(), a state holds the room
+ * of the player, their health and damage, where every item is, which
+ * enemies are dead and which locked rooms were unlocked. Once the damage
+ * reaches a value that kills every enemy in one hit, even after dropping
+ * every weapon, it stays there so it takes a bounded number of bits. The
+ * damage modifiers of the enemies are assumed to add up item by item.
+ *
+ * Items with the same name are assumed to be interchangeable, the game
+ * picks between them by their order in the room or the inventory which
+ * isn't part of the state.
+ * */
+class WorldModel {
+    public:
+        /** Marks a missing room, lock or command. */
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        /** Constructor for WorldModel.
+         *
+         * The game must not have processed any command yet.
+         *
+         * @param game The game to model.
+         * @param drops The rooms the player may drop items in.
+         * */
+        WorldModel(AdventureGame &game, DropPolicy drops = DROP_ANYWHERE);
+
+        /** Writes the state the game starts in.
+         *
+         * @param state The state, words() long.
+         * */
+        void initialState(uint64_t *state) const;
+        /** Calls the visitor with every command that changes a state.
+         *
+         * Commands that leave the state unchanged aren't visited.
+         *
+         * @param state The state.
+         * @param next Scratch space of words() for the next states.
+         * @param visit Called with the command, the outcome and the next
+         * state, which is nullptr unless the outcome is NEXT_STATE.
+         * */
+        template <class Visit>
+        void expand(const uint64_t *state, uint64_t *next, Visit &&visit) const;
+        /** Describes a state.
+         *
+         * @param state The state.
+         * @return The room, health, damage and inventory of the player.
+         * */
+        std::string describe(const uint64_t *state) const;
+
+        //////////
+        // Getters
+        /** Gets the number of words of a state.
+         *
+         * @return The number of words.
+         * */
+        size_t words(void) const;
+        /** Gets a command of the model.
+         *
+         * @param command The index of the command.
+         * @return The command as typed in the game.
+         * */
+        const std::string& getCommand(uint32_t command) const;
+        /** Gets the fields where a larger value is never worse.
+         *
+         * More health or damage never loses a fight that less would win,
+         * and every command keeps the order of the values.
+         *
+         * @return The health and damage of the player.
+         * */
+        std::vector<StateField> getMonotoneFields(void) const;
+        /** Gets the number of rooms.
+         *
+         * @return The number of rooms.
+         * */
+        size_t roomCount(void) const;
+        /** Gets the number of items.
+         *
+         * @return The number of items.
+         * */
+        size_t itemCount(void) const;
+        /** Gets the number of enemies.
+         *
+         * @return The number of enemies.
+         * */
+        size_t enemyCount(void) const;
+    private:
+        /** A room of the model. */
+        struct RoomModel {
+            std::string name; /**<Name of the room. */
+            uint32_t exits[4] = {NONE, NONE, NONE, NONE}; /**<Rooms in each Direction. */
+            uint32_t lock = NONE; /**<Index of the lock of the room. */
+            bool drops = true; /**<If items can be dropped in the room. */
+            uint32_t first_enemy = NONE; /**<Enemy attacked by km. */
+            /** Enemies attacked by kill, other than the first enemy, with
+             * their command. */
+            std::vector<std::pair<uint32_t, uint32_t>> kills;
+        };
+        /** An item of the model. */
+        struct ItemModel {
+            std::string name; /**<Name of the item. */
+            uint32_t start = NONE; /**<Where the item starts. */
+            int damage = 0; /**<Damage added when picked up. */
+            int healing = 0; /**<Health healed when used. */
+            bool pickup = true; /**<If it can be picked up without killing a guard. */
+            bool chalice = false; /**<If it wins the game. */
+            bool key = false; /**<If it unlocks doors. */
+            uint32_t get_command = NONE; /**<Command picking it up. */
+            uint32_t drop_command = NONE; /**<Command dropping it. */
+            uint32_t use_command = NONE; /**<Command using it. */
+            std::vector<uint32_t> guards; /**<Enemies protecting it. */
+            std::vector<uint32_t> same_name; /**<Earlier items with the same name. */
+        };
+        /** An enemy of the model. */
+        struct EnemyModel {
+            std::string name; /**<Name of the enemy. */
+            int health = 0; /**<Health of the enemy. */
+            int damage = 0; /**<Damage of the enemy. */
+            bool dead = false; /**<If it starts dead. */
+            /** Items changing the damage dealt to the enemy and by how much. */
+            std::vector<std::pair<uint32_t, int>> modifiers;
+        };
+
+        /** Adds a field to the state.
+         *
+         * @param values The number of values of the field.
+         * @return The field.
+         * */
+        StateField addField(uint64_t values);
+        /** Adds a command, unless it is already known.
+         *
+         * @param command The command.
+         * @return The index of the command.
+         * */
+        uint32_t addCommand(const std::string &command);
+        /** Checks if a room is locked in a state.
+         *
+         * @param state The state.
+         * @param room The room.
+         * @return If the room is locked.
+         * */
+        bool isLocked(const uint64_t *state, uint32_t room) const {
+            uint32_t lock = this->m_rooms[room].lock;
+            return lock != NONE && this->m_unlocked[lock].get(state) == 0;
+        }
+        /** Checks if an item can be picked up in a state.
+         *
+         * @param state The state.
+         * @param item The item.
+         * @return If the item can be picked up.
+         * */
+        bool canPickup(const uint64_t *state, uint32_t item) const {
+            const ItemModel &model = this->m_items[item];
+            bool pickup = model.pickup;
+            for (uint32_t guard: model.guards) {
+                pickup = pickup || this->m_dead[guard].get(state) != 0;
+            }
+            return pickup;
+        }
+        /** Checks if an earlier item with the same name is at a location.
+         *
+         * @param state The state.
+         * @param item The item.
+         * @param location The location.
+         * @return If the item is shadowed by another one.
+         * */
+        bool isShadowed(const uint64_t *state, uint32_t item,
+                        uint64_t location) const {
+            for (uint32_t other: this->m_items[item].same_name) {
+                if (this->m_locations[other].get(state) == location) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<RoomModel> m_rooms; /**<The rooms by id. */
+        std::vector<ItemModel> m_items; /**<The items. */
+        std::vector<EnemyModel> m_enemies; /**<The enemies. */
+        std::vector<std::string> m_commands; /**<The commands. */
+        uint32_t m_initial_room = 0; /**<The room the player starts in. */
+        uint32_t m_initial_hp = 0; /**<The health the player starts with. */
+        uint32_t m_initial_damage = 0; /**<The damage the player starts with. */
+        int m_max_hp = 0; /**<The maximum health of the player. */
+        int m_max_damage = 0; /**<The damage the player saturates at, it kills anything. */
+        uint32_t m_capacity = 0; /**<The size of the inventory. */
+        uint32_t m_inventory = 0; /**<Location of held items. */
+        uint32_t m_gone = 0; /**<Location of used items. */
+        uint32_t m_kill_first = 0; /**<The km command. */
+        uint32_t m_unlock = 0; /**<The unlock door command. */
+
+        size_t m_words = 1; /**<Words used by the fields. */
+        uint32_t m_shift = 0; /**<Bits used in the last word. */
+        StateField m_room; /**<Room of the player. */
+        StateField m_hp; /**<Health of the player. */
+        StateField m_damage; /**<Damage of the player. */
+        std::vector<StateField> m_locations; /**<Location of each item. */
+        std::vector<StateField> m_dead; /**<If each enemy is dead. */
+        std::vector<StateField> m_unlocked; /**<If each lock is open. */
+};
+
+/** Calls the visitor with every command that changes a state.
+ *
+ * Commands that leave the state unchanged aren't visited.
+ *
+ * @param state The state.
+ * @param next Scratch space of words() for the next states.
+ * @param visit Called with the command, the outcome and the next state,
+ * which is nullptr unless the outcome is NEXT_STATE.
+ * */
+template <class Visit>
+void WorldModel::expand(const uint64_t *state, uint64_t *next, Visit &&visit) const {
+    const uint32_t room = (uint32_t) this->m_room.get(state);
+    const RoomModel &here = this->m_rooms[room];
+    const int hp = (int) this->m_hp.get(state);
+    const int damage = (int) this->m_damage.get(state);
+    auto copy = [&]() {
+        std::copy(state, state + this->m_words, next);
+    };
+
+    // What the player holds
+    uint32_t held = 0;
+    bool chalice = false;
+    bool key = false;
+    for (size_t i = 0; i < this->m_items.size(); i++) {
+        if (this->m_locations[i].get(state) == this->m_inventory) {
+            held++;
+            chalice = chalice || this->m_items[i].chalice;
+            key = key || this->m_items[i].key;
+        }
+    }
+
+    // Moving, the command of each direction is its index
+    for (uint32_t direction = 0; direction < 4; direction++) {
+        uint32_t target = here.exits[direction];
+        if (target == NONE) {
+            continue;
+        }
+        if (target == this->m_initial_room && chalice) {
+            visit(direction, VICTORY_OUTCOME, nullptr);
+        } else if (target != room && !this->isLocked(state, target)) {
+            copy();
+            this->m_room.set(next, target);
+            visit(direction, NEXT_STATE, next);
+        }
+    }
+
+    // Fighting, the same exchange as fightEnemy() worked out in one step
+    auto fight = [&](uint32_t enemy, uint32_t command) {
+        const EnemyModel &model = this->m_enemies[enemy];
+        if (this->m_dead[enemy].get(state) != 0) {
+            return;
+        }
+        int player_damage = damage;
+        for (const auto &modifier: model.modifiers) {
+            if (this->m_locations[modifier.first].get(state) == this->m_inventory) {
+                player_damage += modifier.second;
+            }
+        }
+        if (player_damage <= 0) {
+            // The enemy can't be hurt, the game never ends the fight if the
+            // enemy can't hurt the player either
+            if (model.damage > 0) {
+                visit(command, DEFEAT_OUTCOME, nullptr);
+            }
+            return;
+        }
+        int hits = (model.health + player_damage - 1) / player_damage;
+        int health = hp - (hits - 1) * model.damage;
+        if (health <= 0) {
+            visit(command, DEFEAT_OUTCOME, nullptr);
+            return;
+        }
+        copy();
+        this->m_hp.set(next, std::min(health, this->m_max_hp));
+        this->m_dead[enemy].set(next, 1);
+        visit(command, NEXT_STATE, next);
+    };
+    if (here.first_enemy != NONE) {
+        fight(here.first_enemy, this->m_kill_first);
+    }
+    for (const auto &kill: here.kills) {
+        fight(kill.first, kill.second);
+    }
+
+    for (uint32_t i = 0; i < this->m_items.size(); i++) {
+        const ItemModel &item = this->m_items[i];
+        uint64_t location = this->m_locations[i].get(state);
+
+        // Picking up, a weapon adds its damage even if the pickup fails
+        if (location == room && !this->isShadowed(state, i, room)) {
+            int new_damage = std::min(damage + item.damage, this->m_max_damage);
+            if (damage == this->m_max_damage) {
+                new_damage = damage;
+            }
+            bool added = held < this->m_capacity && this->canPickup(state, i);
+            if (added || new_damage != damage) {
+                copy();
+                this->m_damage.set(next, new_damage);
+                if (added) {
+                    this->m_locations[i].set(next, this->m_inventory);
+                }
+                visit(item.get_command, NEXT_STATE, next);
+            }
+        }
+        if (location != this->m_inventory ||
+            this->isShadowed(state, i, this->m_inventory)) {
+            continue;
+        }
+
+        // Dropping
+        if (here.drops) {
+            copy();
+            if (damage != this->m_max_damage) {
+                this->m_damage.set(next, damage - item.damage);
+            }
+            this->m_locations[i].set(next, room);
+            visit(item.drop_command, NEXT_STATE, next);
+        }
+
+        // Using
+        if (item.use_command != NONE) {
+            copy();
+            this->m_hp.set(next, std::min(hp + item.healing, this->m_max_hp));
+            this->m_locations[i].set(next, this->m_gone);
+            visit(item.use_command, NEXT_STATE, next);
+        }
+    }
+
+    // Unlocking every locked room next to the player
+    if (key) {
+        bool unlocked = false;
+        copy();
+        for (uint32_t target: here.exits) {
+            if (target != NONE && this->isLocked(next, target)) {
+                this->m_unlocked[this->m_rooms[target].lock].set(next, 1);
+                unlocked = true;
+            }
+        }
+        if (unlocked) {
+            visit(this->m_unlock, NEXT_STATE, next);
+        }
+    }
+}
+
+#endif // MODEL_H_
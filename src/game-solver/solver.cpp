@@ -0,0 +1,281 @@
+#include "solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include "state-set.h"
+
+/** Number of states claimed by a thread at a time. */
+static const size_t CHUNK = 256;
+/** Parent of the initial state. */
+static const uint32_t NO_PARENT = UINT32_MAX;
+
+/** What a thread found while expanding a level. */
+struct LevelWork {
+    std::vector<uint64_t> states; /**<The new states, one after another. */
+    std::vector<uint32_t> ids; /**<The ids of the new states. */
+    std::vector<uint32_t> parents; /**<The state each new state came from. */
+    std::vector<uint32_t> commands; /**<The command each new state came from. */
+    uint32_t win_parent = NO_PARENT; /**<First state with a winning command. */
+    uint32_t win_command = 0; /**<Its winning command. */
+};
+
+/** Everything a thread found during the search. */
+struct ThreadWork {
+    LevelWork level; /**<What was found in the current level. */
+    std::vector<std::pair<uint32_t, uint32_t>> edges; /**<Transitions found. */
+    std::vector<uint32_t> winners; /**<States with a winning command. */
+    size_t transitions = 0; /**<Commands leading to another state. */
+    size_t victories = 0; /**<Winning commands found. */
+    size_t defeats = 0; /**<Losing commands found. */
+};
+
+/** Gets the commands leading to a state.
+ *
+ * @param id The state.
+ * @param parents The parent of every state.
+ * @param commands The command leading to every state.
+ * @return The commands from the initial state.
+ * */
+static std::vector<uint32_t> pathTo(uint32_t id,
+                                    const std::vector<uint32_t> &parents,
+                                    const std::vector<uint32_t> &commands) {
+    std::vector<uint32_t> path;
+    for (; parents[id] != NO_PARENT; id = parents[id]) {
+        path.push_back(commands[id]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/** Follows commands from the initial state.
+ *
+ * @param model The model of the world.
+ * @param path The commands, each must lead to a new state.
+ * @return The state reached.
+ * */
+static std::vector<uint64_t> follow(const WorldModel &model,
+                                    const std::vector<uint32_t> &path) {
+    std::vector<uint64_t> state(model.words());
+    std::vector<uint64_t> next(model.words());
+    model.initialState(state.data());
+    for (uint32_t command: path) {
+        std::vector<uint64_t> reached;
+        model.expand(state.data(), next.data(),
+                     [&](uint32_t done, Outcome outcome, const uint64_t *to) {
+            if (done == command && outcome == NEXT_STATE) {
+                reached.assign(to, to + model.words());
+            }
+        });
+        state.swap(reached);
+    }
+    return state;
+}
+
+/** Searches every state reachable in a world.
+ *
+ * The search is breadth first one level at a time. The states of a level
+ * are shared by the threads in small chunks claimed with an atomic counter,
+ * so a thread running out of work takes the next chunk instead of waiting
+ * on a fixed share. New states are deduplicated by a StateSet and ids are
+ * handed out in discovery order, so every state of a level has a larger id
+ * than the states of the previous levels.
+ *
+ * Once every state is known the winnable states are found by walking the
+ * transitions backwards from the winning commands, the remaining states are
+ * dead ends.
+ *
+ * @param model The model of the world.
+ * @param options The options of the search.
+ * @return The result.
+ * */
+SolveResult solve(const WorldModel &model, const SolverOptions &options) {
+    auto start = std::chrono::steady_clock::now();
+    const size_t words = model.words();
+    const unsigned int threads = std::max(options.threads, 1u);
+    const size_t max_states = std::min(options.max_states,
+                                       (size_t) NO_PARENT / 2);
+    SolveResult result;
+
+    // Dominated states can't be left out when every state is counted
+    StateSet visited(words, options.dead_ends ? std::vector<StateField>()
+                                              : model.getMonotoneFields());
+    std::atomic<uint32_t> ids(0);
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> commands;
+    std::vector<ThreadWork> work(threads);
+
+    // The first level is the initial state
+    std::vector<uint64_t> frontier(words);
+    std::vector<uint32_t> frontier_ids;
+    model.initialState(frontier.data());
+    frontier_ids.push_back(visited.insert(frontier.data(), ids).first);
+    parents.push_back(NO_PARENT);
+    commands.push_back(0);
+
+    while (!frontier_ids.empty()) {
+        result.levels++;
+        std::atomic<size_t> next_chunk(0);
+        auto expand = [&](unsigned int thread) {
+            ThreadWork &mine = work[thread];
+            LevelWork &level = mine.level;
+            std::vector<uint64_t> next(words);
+            while (true) {
+                size_t begin = next_chunk.fetch_add(CHUNK, std::memory_order_relaxed);
+                if (begin >= frontier_ids.size()) {
+                    break;
+                }
+                size_t end = std::min(begin + CHUNK, frontier_ids.size());
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t from = frontier_ids[i];
+                    bool won = false;
+                    model.expand(&frontier[i * words], next.data(),
+                                 [&](uint32_t command, Outcome outcome,
+                                     const uint64_t *state) {
+                        if (outcome == VICTORY_OUTCOME) {
+                            mine.victories++;
+                            won = true;
+                            if (from < level.win_parent ||
+                                (from == level.win_parent &&
+                                 command < level.win_command)) {
+                                level.win_parent = from;
+                                level.win_command = command;
+                            }
+                            return;
+                        } else if (outcome == DEFEAT_OUTCOME) {
+                            mine.defeats++;
+                            return;
+                        }
+
+                        auto inserted = visited.insert(state, ids);
+                        mine.transitions++;
+                        if (options.dead_ends) {
+                            mine.edges.emplace_back(from, inserted.first);
+                        }
+                        if (inserted.second) {
+                            level.states.insert(level.states.end(), state,
+                                                state + words);
+                            level.ids.push_back(inserted.first);
+                            level.parents.push_back(from);
+                            level.commands.push_back(command);
+                        }
+                    });
+                    if (won && options.dead_ends) {
+                        mine.winners.push_back(from);
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned int thread = 1; thread < threads; thread++) {
+            workers.emplace_back(expand, thread);
+        }
+        expand(0);
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+
+        // Merging the new states into the next level
+        frontier.clear();
+        frontier_ids.clear();
+        parents.resize(ids.load());
+        commands.resize(ids.load());
+        uint32_t win_parent = NO_PARENT;
+        uint32_t win_command = 0;
+        for (ThreadWork &mine: work) {
+            LevelWork &level = mine.level;
+            for (size_t i = 0; i < level.ids.size(); i++) {
+                parents[level.ids[i]] = level.parents[i];
+                commands[level.ids[i]] = level.commands[i];
+            }
+            frontier.insert(frontier.end(), level.states.begin(), level.states.end());
+            frontier_ids.insert(frontier_ids.end(), level.ids.begin(), level.ids.end());
+            if (level.win_parent < win_parent ||
+                (level.win_parent == win_parent && level.win_command < win_command)) {
+                win_parent = level.win_parent;
+                win_command = level.win_command;
+            }
+            level = LevelWork();
+        }
+
+        // The first level with a win has the shortest winning path
+        if (!result.solvable && win_parent != NO_PARENT) {
+            result.solvable = true;
+            result.path = pathTo(win_parent, parents, commands);
+            result.path.push_back(win_command);
+        }
+        if (ids.load() >= max_states || (result.solvable && !options.dead_ends)) {
+            break;
+        }
+    }
+    result.complete = frontier_ids.empty();
+    result.states = ids.load();
+    for (ThreadWork &mine: work) {
+        result.transitions += mine.transitions;
+        result.victories += mine.victories;
+        result.defeats += mine.defeats;
+    }
+
+    // Walking the transitions backwards from the winning states
+    if (result.complete && options.dead_ends) {
+        std::vector<size_t> offsets(result.states + 1, 0);
+        for (ThreadWork &mine: work) {
+            for (const auto &edge: mine.edges) {
+                offsets[edge.second + 1]++;
+            }
+        }
+        for (size_t i = 0; i < result.states; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+        std::vector<uint32_t> sources(offsets.back());
+        std::vector<size_t> filled(offsets.begin(), offsets.end() - 1);
+        for (ThreadWork &mine: work) {
+            for (const auto &edge: mine.edges) {
+                sources[filled[edge.second]++] = edge.first;
+            }
+        }
+
+        std::vector<uint8_t> winnable(result.states, 0);
+        std::vector<uint32_t> queue;
+        for (ThreadWork &mine: work) {
+            for (uint32_t winner: mine.winners) {
+                if (!winnable[winner]) {
+                    winnable[winner] = 1;
+                    queue.push_back(winner);
+                }
+            }
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            uint32_t state = queue[i];
+            for (size_t j = offsets[state]; j < offsets[state + 1]; j++) {
+                if (!winnable[sources[j]]) {
+                    winnable[sources[j]] = 1;
+                    queue.push_back(sources[j]);
+                }
+            }
+        }
+
+        result.dead_ends = result.states - queue.size();
+        for (ThreadWork &mine: work) {
+            for (const auto &edge: mine.edges) {
+                if (winnable[edge.first] && !winnable[edge.second]) {
+                    result.fatal_commands++;
+                }
+            }
+        }
+        // The smallest id is the closest dead end
+        auto dead_end = std::find(winnable.begin(), winnable.end(), 0);
+        if (dead_end != winnable.end()) {
+            result.dead_end_path = pathTo((uint32_t) (dead_end - winnable.begin()),
+                                          parents, commands);
+            result.dead_end = follow(model, result.dead_end_path);
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,65 @@
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+/** @file solver.h
+ *
+ * Header file containing the parallel breadth first search of the states
+ * of a world.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "model.h"
+
+/** Options of the solver. */
+struct SolverOptions {
+    unsigned int threads = 1; /**<Number of threads expanding states. */
+    size_t max_states = 50000000; /**<The search stops after this many states. */
+    /** If the transitions are kept to find the dead ends. Otherwise the
+     * search stops at the level of the shortest win and leaves out the
+     * states dominated by a state with more health or damage. */
+    bool dead_ends = true;
+};
+
+/** The result of searching the states of a world. */
+struct SolveResult {
+    bool complete = false; /**<If every reachable state was searched. */
+    bool solvable = false; /**<If a winning path was found. */
+    size_t states = 0; /**<Number of reachable states found. */
+    size_t transitions = 0; /**<Commands leading to another state. */
+    size_t victories = 0; /**<Commands winning the game. */
+    size_t defeats = 0; /**<Commands losing the game. */
+    size_t levels = 0; /**<Number of levels of the search. */
+    /** Number of states the game can't be won from, only known when the
+     * search is complete and the dead ends were asked for. */
+    size_t dead_ends = 0;
+    /** Commands moving from a winnable state to a dead end. */
+    size_t fatal_commands = 0;
+    std::vector<uint32_t> path; /**<Shortest winning commands. */
+    std::vector<uint32_t> dead_end_path; /**<Shortest commands reaching a dead end. */
+    std::vector<uint64_t> dead_end; /**<The dead end the path reaches. */
+    double seconds = 0; /**<Time taken by the search. */
+};
+
+/** Searches every state reachable in a world.
+ *
+ * The search is breadth first one level at a time. The states of a level
+ * are shared by the threads in small chunks claimed with an atomic counter,
+ * so a thread running out of work takes the next chunk instead of waiting
+ * on a fixed share. New states are deduplicated by a StateSet and ids are
+ * handed out in discovery order, so every state of a level has a larger id
+ * than the states of the previous levels.
+ *
+ * Once every state is known the winnable states are found by walking the
+ * transitions backwards from the winning commands, the remaining states are
+ * dead ends.
+ *
+ * @param model The model of the world.
+ * @param options The options of the search.
+ * @return The result.
+ * */
+SolveResult solve(const WorldModel &model, const SolverOptions &options);
+
+#endif // SOLVER_H_
@@ -0,0 +1,151 @@
+#include "state-set.h"
+
+#include <algorithm>
+
+/** Number of slots of a stripe before its first insertion. */
+static const size_t INITIAL_SLOTS = 16;
+
+/** Constructor for StateSet.
+ *
+ * @param words The number of words of a state.
+ * @param monotone Fields where a larger value is never worse.
+ * @param stripe_bits The log2 of the number of stripes.
+ * */
+StateSet::StateSet(size_t words, std::vector<StateField> monotone,
+                   unsigned int stripe_bits):
+    m_words(words), m_monotone(std::move(monotone)),
+    m_key_mask(words, ~(uint64_t) 0), m_stripe_bits(stripe_bits),
+    m_stripes(new Stripe[(size_t) 1 << stripe_bits]) {
+    for (const StateField &field: this->m_monotone) {
+        this->m_key_mask[field.word] &= ~(field.mask << field.shift);
+    }
+}
+
+/** Inserts a state unless it or a state dominating it is already in the
+ * set.
+ *
+ * @param state The state.
+ * @param ids Counter handing out the ids of new states.
+ * @return The id of the state, or of the state dominating it, and if it
+ * was inserted.
+ * */
+std::pair<uint32_t, bool> StateSet::insert(const uint64_t *state,
+                                           std::atomic<uint32_t> &ids) {
+    uint64_t hash = this->hash(state);
+    // The top bits pick the stripe, the low bits the slot in it
+    Stripe &stripe = this->m_stripes[hash >> (64 - this->m_stripe_bits)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    // Keeping the load below 3/4
+    if ((stripe.count + 1) * 4 > stripe.ids.size() * 3) {
+        this->grow(stripe);
+    }
+
+    // States with the same key are next to each other in the probe sequence
+    size_t mask = stripe.ids.size() - 1;
+    size_t slot = hash & mask;
+    for (; stripe.ids[slot] != EMPTY; slot = (slot + 1) & mask) {
+        const uint64_t *other = stripe.keys.data() + slot * this->m_words;
+        if (this->sameKey(other, state) && this->dominates(other, state)) {
+            return {stripe.ids[slot], false};
+        }
+    }
+
+    uint32_t id = ids.fetch_add(1, std::memory_order_relaxed);
+    stripe.ids[slot] = id;
+    std::copy(state, state + this->m_words,
+              stripe.keys.begin() + slot * this->m_words);
+    stripe.count++;
+    return {id, true};
+}
+
+/** Gets the number of states in the set.
+ *
+ * @return The number of states, only exact when nothing is being inserted.
+ * */
+size_t StateSet::size(void) const {
+    size_t size = 0;
+    for (size_t i = 0; i < ((size_t) 1 << this->m_stripe_bits); i++) {
+        std::lock_guard<std::mutex> lock(this->m_stripes[i].mutex);
+        size += this->m_stripes[i].count;
+    }
+    return size;
+}
+
+/** Hashes the key of a state, the monotone fields are left out.
+ *
+ * @param state The state.
+ * @return The hash.
+ * */
+uint64_t StateSet::hash(const uint64_t *state) const {
+    uint64_t hash = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < this->m_words; i++) {
+        // splitmix64 finaliser of each word
+        uint64_t word = (state[i] & this->m_key_mask[i]) + hash +
+                        0x9e3779b97f4a7c15ull * (i + 1);
+        word = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9ull;
+        word = (word ^ (word >> 27)) * 0x94d049bb133111ebull;
+        hash ^= word ^ (word >> 31);
+        hash *= 0x9e3779b97f4a7c15ull;
+    }
+    return hash ^ (hash >> 29);
+}
+
+/** Doubles the slots of a stripe.
+ *
+ * @param stripe The stripe, its mutex is held.
+ * */
+void StateSet::grow(Stripe &stripe) {
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> ids;
+    keys.swap(stripe.keys);
+    ids.swap(stripe.ids);
+
+    size_t slots = std::max(ids.size() * 2, INITIAL_SLOTS);
+    size_t mask = slots - 1;
+    stripe.keys.assign(slots * this->m_words, 0);
+    stripe.ids.assign(slots, EMPTY);
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] == EMPTY) {
+            continue;
+        }
+        const uint64_t *state = keys.data() + i * this->m_words;
+        size_t slot = this->hash(state) & mask;
+        while (stripe.ids[slot] != EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        stripe.ids[slot] = ids[i];
+        std::copy(state, state + this->m_words,
+                  stripe.keys.begin() + slot * this->m_words);
+    }
+}
+
+/** Checks if two states only differ by the monotone fields.
+ *
+ * @param a A state.
+ * @param b Another state.
+ * @return If the states have the same other fields.
+ * */
+bool StateSet::sameKey(const uint64_t *a, const uint64_t *b) const {
+    for (size_t i = 0; i < this->m_words; i++) {
+        if (((a[i] ^ b[i]) & this->m_key_mask[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Checks if a state dominates another with the same key.
+ *
+ * @param a A state.
+ * @param b Another state.
+ * @return If every monotone field of a is larger or equal.
+ * */
+bool StateSet::dominates(const uint64_t *a, const uint64_t *b) const {
+    for (const StateField &field: this->m_monotone) {
+        if (field.get(a) < field.get(b)) {
+            return false;
+        }
+    }
+    return true;
+}
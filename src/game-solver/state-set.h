@@ -0,0 +1,102 @@
+#ifndef STATE_SET_H_
+#define STATE_SET_H_
+
+/** @file state-set.h
+ *
+ * Header file containing the concurrent set of visited states of the
+ * solver.
+ * */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "model.h"
+
+/** A concurrent set of packed states giving every state a dense id.
+ *
+ * The set is split into stripes picked by the hash of a state. Each stripe
+ * is an open addressing table behind its own mutex, so threads inserting
+ * different states rarely wait for each other.
+ *
+ * Fields where a larger value is never worse for the player can be given,
+ * a state is then left out when a state that only differs by larger or
+ * equal values of these fields is already in the set.
+ * */
+class StateSet {
+    public:
+        /** Constructor for StateSet.
+         *
+         * @param words The number of words of a state.
+         * @param monotone Fields where a larger value is never worse.
+         * @param stripe_bits The log2 of the number of stripes.
+         * */
+        StateSet(size_t words, std::vector<StateField> monotone = {},
+                 unsigned int stripe_bits = 10);
+
+        /** Inserts a state unless it or a state dominating it is already
+         * in the set.
+         *
+         * @param state The state.
+         * @param ids Counter handing out the ids of new states.
+         * @return The id of the state, or of the state dominating it, and
+         * if it was inserted.
+         * */
+        std::pair<uint32_t, bool> insert(const uint64_t *state,
+                                         std::atomic<uint32_t> &ids);
+        /** Gets the number of states in the set.
+         *
+         * @return The number of states, only exact when nothing is
+         * being inserted.
+         * */
+        size_t size(void) const;
+    private:
+        /** Marks an empty slot. */
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        /** A stripe of the set, on its own cache line. */
+        struct alignas(64) Stripe {
+            std::mutex mutex; /**<Guards the stripe. */
+            std::vector<uint64_t> keys; /**<The states of the slots. */
+            std::vector<uint32_t> ids; /**<The ids of the slots. */
+            size_t count = 0; /**<Number of used slots. */
+        };
+
+        /** Hashes the key of a state, the monotone fields are left out.
+         *
+         * @param state The state.
+         * @return The hash.
+         * */
+        uint64_t hash(const uint64_t *state) const;
+        /** Doubles the slots of a stripe.
+         *
+         * @param stripe The stripe, its mutex is held.
+         * */
+        void grow(Stripe &stripe);
+        /** Checks if two states only differ by the monotone fields.
+         *
+         * @param a A state.
+         * @param b Another state.
+         * @return If the states have the same other fields.
+         * */
+        bool sameKey(const uint64_t *a, const uint64_t *b) const;
+        /** Checks if a state dominates another with the same key.
+         *
+         * @param a A state.
+         * @param b Another state.
+         * @return If every monotone field of a is larger or equal.
+         * */
+        bool dominates(const uint64_t *a, const uint64_t *b) const;
+
+        size_t m_words; /**<Words of a state. */
+        std::vector<StateField> m_monotone; /**<Fields where larger is better. */
+        std::vector<uint64_t> m_key_mask; /**<Bits of each word outside the monotone fields. */
+        unsigned int m_stripe_bits; /**<Log2 of the number of stripes. */
+        std::unique_ptr<Stripe[]> m_stripes; /**<The stripes. */
+};
+
+#endif // STATE_SET_H_
@@ -0,0 +1,119 @@
+#include "alloc-counter.h"
+
+#include <cstdlib>
+#include <new>
+
+/** Allocations made by the current thread. */
+static thread_local AllocStats thread_stats;
+
+/** Allocates memory and counts it.
+ *
+ * @param size The size to allocate.
+ * @return The allocated memory, nullptr on failure.
+ * */
+static void* countedAlloc(std::size_t size) {
+    thread_stats.count++;
+    thread_stats.bytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+/** Allocates aligned memory and counts it.
+ *
+ * @param size The size to allocate.
+ * @param alignment The alignment of the memory.
+ * @return The allocated memory, nullptr on failure.
+ * */
+static void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    thread_stats.count++;
+    thread_stats.bytes += size;
+    // aligned_alloc() needs the size to be a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+/** Gets the allocations made by the calling thread so far.
+ *
+ * @return The allocation counters of the thread.
+ * */
+AllocStats allocStats(void) {
+    return thread_stats;
+}
+
+/** Gets the allocations made between two snapshots.
+ *
+ * @param before The earlier snapshot.
+ * @param after The later snapshot.
+ * @return The allocations made in between.
+ * */
+AllocStats allocDelta(AllocStats before, AllocStats after) {
+    AllocStats delta;
+    delta.count = after.count - before.count;
+    delta.bytes = after.bytes - before.bytes;
+    return delta;
+}
+
+////////////////////////
+// Replacement operators
+void* operator new(std::size_t size) {
+    void *ptr = countedAlloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void *ptr = countedAlignedAlloc(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,35 @@
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+
+/** @file alloc-counter.h
+ *
+ * Header file for the allocation counter.
+ *
+ * Linking the game-alloc-counter library replaces the global operator new
+ * and operator delete with versions that count the allocations made by
+ * the calling thread.
+ * */
+
+#include <cstddef>
+
+/** Allocations made by a thread. */
+struct AllocStats {
+    size_t count = 0; /**<Number of allocations. */
+    size_t bytes = 0; /**<Number of bytes allocated. */
+};
+
+/** Gets the allocations made by the calling thread so far.
+ *
+ * @return The allocation counters of the thread.
+ * */
+AllocStats allocStats(void);
+
+/** Gets the allocations made between two snapshots.
+ *
+ * @param before The earlier snapshot.
+ * @param after The later snapshot.
+ * @return The allocations made in between.
+ * */
+AllocStats allocDelta(AllocStats before, AllocStats after);
+
+#endif // ALLOC_COUNTER_H_
@@ -0,0 +1,328 @@
+#include "ascii-fold.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GAME_HAVE_SIMD_FOLD
+#endif
+
+/** Whitespace found while folding a line. */
+struct FoldedSpace {
+        bool space_before = false; /**<If the last byte folded was a space. */
+        bool collapse = false; /**<If the whitespace must be normalised. */
+};
+
+/** Checks if a byte is whitespace other than a space.
+ *
+ * @param c The byte.
+ * @return If the byte is a tab, carriage return or new line.
+ * */
+static inline bool isOtherSpace(char c) {
+    return c == '\t' || c == '\r' || c == '\n';
+}
+
+/////////////////
+// Scalar kernel
+/** Folds bytes one at a time.
+ *
+ * @param data The bytes.
+ * @param start The first byte to fold.
+ * @param end One past the last byte to fold.
+ * @param space The whitespace found so far, updated with the bytes.
+ * */
+static void foldScalar(char *data, size_t start, size_t end, FoldedSpace &space) {
+    for (size_t i = start; i < end; i++) {
+        char c = data[i];
+        bool is_space = c == ' ';
+        space.collapse |= isOtherSpace(c) || (is_space && space.space_before);
+        space.space_before = is_space;
+        data[i] = foldAscii(c);
+    }
+}
+
+/** Compares bytes one at a time.
+ *
+ * @param a The first bytes.
+ * @param b The second bytes.
+ * @param start The first byte to compare.
+ * @param end One past the last byte to compare.
+ * @return If the bytes are the same ignoring case.
+ * */
+static bool equalsScalar(const char *a, const char *b, size_t start, size_t end) {
+    for (size_t i = start; i < end; i++) {
+        if (foldAscii(a[i]) != foldAscii(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef GAME_HAVE_SIMD_FOLD
+///////////////
+// SSE2 kernel
+/** Converts 16 bytes to lower case.
+ *
+ * The comparisons are signed, so bytes above 127 are never letters.
+ *
+ * @param bytes The bytes.
+ * @return The lower case bytes.
+ * */
+__attribute__((target("sse2")))
+static inline __m128i lowerSse2(__m128i bytes) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+    return _mm_add_epi8(bytes, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+
+/** Folds the whole blocks of 16 bytes.
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param space The whitespace found so far, updated with the blocks.
+ * @return The number of bytes folded.
+ * */
+__attribute__((target("sse2")))
+static size_t foldSse2(char *data, size_t size, FoldedSpace &space) {
+    size_t i = 0;
+    uint32_t other = 0;
+    uint32_t pairs = 0;
+    uint32_t before = space.space_before;
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (data + i));
+        uint32_t spaces = (uint32_t) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+        other |= (uint32_t) _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')),
+                         _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r'))),
+            _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))));
+        // A space following a space, across blocks too
+        pairs |= spaces & (spaces << 1 | before);
+        before = spaces >> 15;
+        _mm_storeu_si128((__m128i *) (data + i), lowerSse2(bytes));
+    }
+    space.collapse |= other != 0 || pairs != 0;
+    space.space_before = before;
+    return i;
+}
+
+/** Compares the whole blocks of 16 bytes.
+ *
+ * @param a The first bytes.
+ * @param b The second bytes.
+ * @param size The number of bytes.
+ * @param same Where if the blocks are the same ignoring case is stored.
+ * @return The number of bytes compared.
+ * */
+__attribute__((target("sse2")))
+static size_t equalsSse2(const char *a, const char *b, size_t size, bool &same) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i equal = _mm_cmpeq_epi8(
+            lowerSse2(_mm_loadu_si128((const __m128i *) (a + i))),
+            lowerSse2(_mm_loadu_si128((const __m128i *) (b + i))));
+        if (_mm_movemask_epi8(equal) != 0xFFFF) {
+            same = false;
+            return i;
+        }
+    }
+    same = true;
+    return i;
+}
+
+///////////////
+// AVX2 kernel
+/** Converts 32 bytes to lower case.
+ *
+ * @param bytes The bytes.
+ * @return The lower case bytes.
+ * */
+__attribute__((target("avx2")))
+static inline __m256i lowerAvx2(__m256i bytes) {
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes));
+    return _mm256_add_epi8(bytes, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+}
+
+/** Folds the whole blocks of 32 bytes.
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param space The whitespace found so far, updated with the blocks.
+ * @return The number of bytes folded.
+ * */
+__attribute__((target("avx2")))
+static size_t foldAvx2(char *data, size_t size, FoldedSpace &space) {
+    size_t i = 0;
+    uint32_t other = 0;
+    uint32_t pairs = 0;
+    uint32_t before = space.space_before;
+    for (; i + 32 <= size; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *) (data + i));
+        uint32_t spaces = (uint32_t) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+        other |= (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t')),
+                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r'))),
+            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'))));
+        // A space following a space, across blocks too
+        pairs |= spaces & (spaces << 1 | before);
+        before = spaces >> 31;
+        _mm256_storeu_si256((__m256i *) (data + i), lowerAvx2(bytes));
+    }
+    space.collapse |= other != 0 || pairs != 0;
+    space.space_before = before;
+    return i;
+}
+
+/** Compares the whole blocks of 32 bytes.
+ *
+ * @param a The first bytes.
+ * @param b The second bytes.
+ * @param size The number of bytes.
+ * @param same Where if the blocks are the same ignoring case is stored.
+ * @return The number of bytes compared.
+ * */
+__attribute__((target("avx2")))
+static size_t equalsAvx2(const char *a, const char *b, size_t size, bool &same) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i equal = _mm256_cmpeq_epi8(
+            lowerAvx2(_mm256_loadu_si256((const __m256i *) (a + i))),
+            lowerAvx2(_mm256_loadu_si256((const __m256i *) (b + i))));
+        if ((uint32_t) _mm256_movemask_epi8(equal) != 0xFFFFFFFFu) {
+            same = false;
+            return i;
+        }
+    }
+    same = true;
+    return i;
+}
+#endif
+
+/** Folds a string with a kernel, the bytes left over are folded one at a
+ * time.
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param kernel The kernel.
+ * @return The whitespace found.
+ * */
+static FoldedSpace fold(char *data, size_t size, FoldKernel kernel) {
+    FoldedSpace space;
+    size_t folded = 0;
+#ifdef GAME_HAVE_SIMD_FOLD
+    if (kernel == AVX2_FOLD_KERNEL) {
+        folded = foldAvx2(data, size, space);
+    } else if (kernel == SSE2_FOLD_KERNEL) {
+        folded = foldSse2(data, size, space);
+    }
+#endif
+    foldScalar(data, folded, size, space);
+    return space;
+}
+
+/** Checks if a kernel can run on this CPU.
+ *
+ * @param kernel The kernel.
+ * @return If the kernel is available.
+ * */
+bool foldKernelSupported(FoldKernel kernel) {
+    switch (kernel) {
+        case SCALAR_FOLD_KERNEL:
+            return true;
+        case SSE2_FOLD_KERNEL:
+#ifdef GAME_HAVE_SIMD_FOLD
+            return __builtin_cpu_supports("sse2");
+#else
+            return false;
+#endif
+        case AVX2_FOLD_KERNEL:
+#ifdef GAME_HAVE_SIMD_FOLD
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/** Gets the fastest kernel that can run on this CPU.
+ *
+ * @return The kernel.
+ * */
+FoldKernel bestFoldKernel(void) {
+    static const FoldKernel best = foldKernelSupported(AVX2_FOLD_KERNEL) ? AVX2_FOLD_KERNEL :
+                                   foldKernelSupported(SSE2_FOLD_KERNEL) ? SSE2_FOLD_KERNEL :
+                                   SCALAR_FOLD_KERNEL;
+    return best;
+}
+
+/** Converts a string to lower case in place.
+ *
+ * @param text The string.
+ * @param kernel The kernel folding the string, it must be supported.
+ * */
+void foldCase(std::string &text, FoldKernel kernel) {
+    fold(&text[0], text.size(), kernel);
+}
+
+/** Converts a typed line to lower case and normalises its whitespace in
+ * place.
+ *
+ * Spaces, tabs, carriage returns and new lines are whitespace. Whitespace
+ * at either end is removed and every run of whitespace in between becomes a
+ * single space. The whitespace is found while folding, so a line that is
+ * already normalised is only read once.
+ *
+ * @param text The line.
+ * @param kernel The kernel folding the line, it must be supported.
+ * */
+void normalizeLine(std::string &text, FoldKernel kernel) {
+    FoldedSpace space = fold(&text[0], text.size(), kernel);
+    if (!space.collapse && (text.empty() || (text.front() != ' ' && text.back() != ' '))) {
+        return;
+    }
+
+    // Compacting the words, a space is only written before a word
+    size_t size = 0;
+    bool pending = false;
+    for (char c: text) {
+        if (c == ' ' || isOtherSpace(c)) {
+            pending = size != 0;
+        } else {
+            if (pending) {
+                text[size++] = ' ';
+                pending = false;
+            }
+            text[size++] = c;
+        }
+    }
+    text.resize(size);
+}
+
+/** Checks if two strings are the same ignoring the case of ASCII letters.
+ *
+ * Nothing is allocated.
+ *
+ * @param a The first string.
+ * @param b The second string.
+ * @param kernel The kernel folding the strings, it must be supported.
+ * @return If the strings are the same.
+ * */
+bool equalsFolded(std::string_view a, std::string_view b, FoldKernel kernel) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    size_t compared = 0;
+    bool same = true;
+#ifdef GAME_HAVE_SIMD_FOLD
+    if (kernel == AVX2_FOLD_KERNEL) {
+        compared = equalsAvx2(a.data(), b.data(), a.size(), same);
+    } else if (kernel == SSE2_FOLD_KERNEL) {
+        compared = equalsSse2(a.data(), b.data(), a.size(), same);
+    }
+#endif
+    return same && equalsScalar(a.data(), b.data(), compared, a.size());
+}
@@ -0,0 +1,76 @@
+#ifndef ASCII_FOLD_H_
+#define ASCII_FOLD_H_
+
+/** @file ascii-fold.h
+ *
+ * Header file containing the ASCII case folding of the typed commands and
+ * of the names of the game.
+ *
+ * Only 'A' to 'Z' are folded, every other byte is kept, so the result
+ * doesn't depend on the locale. The SSE2 and AVX2 kernels fold 16 and 32
+ * bytes per instruction, shorter strings and the bytes left over are folded
+ * by the scalar kernel.
+ * */
+
+#include <string>
+#include <string_view>
+
+/** Kernels folding the case of a string. */
+enum FoldKernel {
+SCALAR_FOLD_KERNEL, /**<One byte at a time, always available. */
+SSE2_FOLD_KERNEL, /**<16 bytes at a time, needs a CPU with SSE2. */
+AVX2_FOLD_KERNEL /**<32 bytes at a time, needs a CPU with AVX2. */
+};
+
+/** Checks if a kernel can run on this CPU.
+ *
+ * @param kernel The kernel.
+ * @return If the kernel is available.
+ * */
+bool foldKernelSupported(FoldKernel kernel);
+/** Gets the fastest kernel that can run on this CPU.
+ *
+ * @return The kernel.
+ * */
+FoldKernel bestFoldKernel(void);
+
+/** Converts an ASCII character to lower case.
+ *
+ * @param c The character.
+ * @return The lower case character, c if it isn't an upper case letter.
+ * */
+inline char foldAscii(char c) {
+    return c >= 'A' && c <= 'Z' ? (char) (c + ('a' - 'A')) : c;
+}
+
+/** Converts a string to lower case in place.
+ *
+ * @param text The string.
+ * @param kernel The kernel folding the string, it must be supported.
+ * */
+void foldCase(std::string &text, FoldKernel kernel = bestFoldKernel());
+/** Converts a typed line to lower case and normalises its whitespace in
+ * place.
+ *
+ * Spaces, tabs, carriage returns and new lines are whitespace. Whitespace
+ * at either end is removed and every run of whitespace in between becomes
+ * a single space. The whitespace is found while folding, so a line that is
+ * already normalised is only read once.
+ *
+ * @param text The line.
+ * @param kernel The kernel folding the line, it must be supported.
+ * */
+void normalizeLine(std::string &text, FoldKernel kernel = bestFoldKernel());
+/** Checks if two strings are the same ignoring the case of ASCII letters.
+ *
+ * Nothing is allocated.
+ *
+ * @param a The first string.
+ * @param b The second string.
+ * @param kernel The kernel folding the strings, it must be supported.
+ * @return If the strings are the same.
+ * */
+bool equalsFolded(std::string_view a, std::string_view b,
+                  FoldKernel kernel = bestFoldKernel());
+
+#endif // ASCII_FOLD_H_
@@ -0,0 +1,370 @@
+#include "batch-environment.h"
+
+#include <algorithm>
+
+#include "ascii-fold.h"
+#include "castle-map.h"
+
+/** Environments taken at once by a thread. */
+static const size_t BLOCK_SIZE = 16;
+/** Verb of the actions getting an item. */
+static const std::string GET_VERB = "get";
+/** Verb of the actions dropping an item. */
+static const std::string DROP_VERB = "drop";
+
+/** Stream buffer discarding everything written to it, it keeps no state so
+ * every thread can share it. */
+class DiscardBuffer: public std::streambuf {
+        protected:
+                /** Discards a character.
+                 *
+                 * @param c The character.
+                 * @return c, as if it was written.
+                 * */
+                virtual int_type overflow(int_type c) override {
+                    return traits_type::not_eof(c);
+                }
+                /** Discards characters.
+                 *
+                 * @param s The characters.
+                 * @param n The number of characters.
+                 * @return n, as if they were written.
+                 * */
+                virtual std::streamsize xsputn(const char *s, std::streamsize n) override {
+                    return n;
+                }
+};
+
+/** The buffer the output of every game is discarded into. */
+static DiscardBuffer discard_buffer;
+
+/** Creates the coursework castle.
+ *
+ * @param world The world owning the castle.
+ * @param seed Unused, the castle is always the same.
+ * @return The room the player starts in.
+ * */
+static Room* buildCastle(World &world, uint32_t seed) {
+    return buildMap(world, CASTLE_MAP);
+}
+
+/** Constructor for Environment. */
+BatchEnvironment::Environment::Environment(void): output(&discard_buffer) {
+}
+
+/** Constructor for BatchEnvironment.
+ *
+ * The games are only created by reset().
+ *
+ * @param count The number of games.
+ * @param threads The number of threads stepping the games, the calling
+ * thread included. 0 uses one per core.
+ * @param build Creates the world of a game from its seed and returns the
+ * room the player starts in. The coursework castle, whatever the seed, by
+ * default. The actions and the size of the observations are made from the
+ * world of seed 0.
+ * */
+BatchEnvironment::BatchEnvironment(size_t count, size_t threads,
+                                   std::function<Room*(World&, uint32_t)> build):
+    m_build(build == nullptr ? buildCastle : build), m_environments(count),
+    m_rewards(count, 0), m_done(count, 0), m_statuses(count, GameStatus::CONTINUE) {
+    // Actions without an argument
+    this->m_actions = {"north", "south", "east", "west", "killmonster",
+                       "eat food", "drink elixir", "use medpack", "unlock door"};
+    size_t plain = this->m_actions.size();
+
+    // Getting and dropping every item of the world, once per name
+    AdventureGame game([this](World &world) {
+        return this->m_build(world, 0);
+    });
+    World &world = game.getWorld();
+    this->m_encoder = ObservationEncoder(world.itemSlots(), world.enemySlots(),
+                                         game.getPlayer()->getInventory()->maxSize());
+    this->m_observations.assign(count * this->m_encoder.getSize(), 0);
+    for (size_t i = 0; i < world.itemSlots(); i++) {
+        GenericItem *item = world.getItem(world.itemAt(i));
+        if (item == nullptr) {
+            continue;
+        }
+        std::string name = item->getName();
+        foldCase(name);
+        if (std::find(this->m_arguments.begin(), this->m_arguments.end(), name) ==
+            this->m_arguments.end()) {
+            this->m_arguments.push_back(name);
+        }
+    }
+    for (const std::string *verb: {&GET_VERB, &DROP_VERB}) {
+        for (const std::string &name: this->m_arguments) {
+            this->m_actions.push_back(*verb + " " + name);
+        }
+    }
+
+    // The commands point into the names, which don't change anymore
+    for (size_t i = 0; i < this->m_actions.size(); i++) {
+        if (i < plain) {
+            this->m_commands.push_back(TranscriptEntry{&this->m_actions[i], nullptr, 0});
+        } else {
+            size_t argument = (i - plain) % this->m_arguments.size();
+            const std::string *verb = i - plain < this->m_arguments.size() ? &GET_VERB : &DROP_VERB;
+            this->m_commands.push_back(TranscriptEntry{verb, &this->m_arguments[argument], 0});
+        }
+    }
+
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 1; i < threads; i++) {
+        this->m_threads.emplace_back(&BatchEnvironment::work, this);
+    }
+}
+
+/** Destructor for BatchEnvironment, stops the threads. */
+BatchEnvironment::~BatchEnvironment(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_stopping = true;
+    }
+    this->m_wake.notify_all();
+    for (std::thread &thread: this->m_threads) {
+        thread.join();
+    }
+}
+
+/** Starts a new game in every environment.
+ *
+ * The rewards are set to 0 and the games aren't done.
+ *
+ * @param seeds The seed of the world of each game, size() long.
+ * */
+void BatchEnvironment::reset(const std::vector<uint32_t> &seeds) {
+    for (size_t i = 0; i < this->m_environments.size() && i < seeds.size(); i++) {
+        this->m_environments[i].seed = seeds[i];
+    }
+    this->runAll(&BatchEnvironment::resetOne);
+}
+
+/** Starts a new game in one environment.
+ *
+ * @param index The environment.
+ * @param seed The seed of the world of the game.
+ * */
+void BatchEnvironment::reset(size_t index, uint32_t seed) {
+    this->m_environments[index].seed = seed;
+    this->resetOne(index);
+}
+
+/** Runs an action in every game.
+ *
+ * The reward of a game is the XP it gained, plus VICTORY_REWARD or
+ * DEFEAT_REWARD when the action ended it. A game that is done ignores its
+ * action until it is reset and its reward is 0.
+ *
+ * @param actions The index in getActions() of the action of each game,
+ * size() long. An unknown index runs no action.
+ * */
+void BatchEnvironment::step(const std::vector<uint32_t> &actions) {
+    if (actions.size() < this->m_environments.size()) {
+        return;
+    }
+    this->m_step_actions = actions.data();
+    this->runAll(&BatchEnvironment::stepOne);
+    this->m_step_actions = nullptr;
+}
+
+//////////
+// Getters
+/** Gets the number of games.
+ *
+ * @return The number of games.
+ * */
+size_t BatchEnvironment::size(void) const {
+    return this->m_environments.size();
+}
+
+/** Gets the number of threads stepping the games.
+ *
+ * @return The number of threads, the calling thread included.
+ * */
+size_t BatchEnvironment::getThreads(void) const {
+    return this->m_threads.size() + 1;
+}
+
+/** Gets the commands run by the actions.
+ *
+ * The moves, the fights, the items that are used and unlocking come first,
+ * then getting and dropping every item of the world.
+ *
+ * @return The command of each action.
+ * */
+const std::vector<std::string>& BatchEnvironment::getActions(void) const {
+    return this->m_actions;
+}
+
+/** Gets the encoder of the observations.
+ *
+ * @return The encoder, it gives the layout of an observation.
+ * */
+const ObservationEncoder& BatchEnvironment::getEncoder(void) const {
+    return this->m_encoder;
+}
+
+/** Gets the observations of the games.
+ *
+ * Every game has getEncoder().getSize() values. A step only writes the
+ * values that changed.
+ *
+ * @return The observations, game after game.
+ * */
+const std::vector<int32_t>& BatchEnvironment::getObservations(void) const {
+    return this->m_observations;
+}
+
+/** Gets the rewards of the last step.
+ *
+ * @return The reward of each game.
+ * */
+const std::vector<float>& BatchEnvironment::getRewards(void) const {
+    return this->m_rewards;
+}
+
+/** Gets which games are done.
+ *
+ * @return 1 for each game that was won, lost or exited, 0 for the others.
+ * */
+const std::vector<uint8_t>& BatchEnvironment::getDone(void) const {
+    return this->m_done;
+}
+
+/** Gets the status of the games.
+ *
+ * @return The status of each game.
+ * */
+const std::vector<GameStatus>& BatchEnvironment::getStatuses(void) const {
+    return this->m_statuses;
+}
+
+/** Gets the game of an environment.
+ *
+ * @param index The environment.
+ * @return The game, nullptr before it is reset.
+ * */
+AdventureGame* BatchEnvironment::getGame(size_t index) {
+    return this->m_environments[index].game.get();
+}
+
+/////////
+// private
+/** Starts the game of an environment with its seed.
+ *
+ * @param index The environment.
+ * */
+void BatchEnvironment::resetOne(size_t index) {
+    Environment &environment = this->m_environments[index];
+    uint32_t seed = environment.seed;
+    // The old game is freed first so its objects go back to the pools
+    environment.game.reset();
+    environment.game.reset(new AdventureGame([this, seed](World &world) {
+        return this->m_build(world, seed);
+    }));
+    environment.game->setOutput(&environment.output);
+    this->m_rewards[index] = 0;
+    this->m_done[index] = 0;
+    this->m_statuses[index] = GameStatus::CONTINUE;
+    this->observe(index, true);
+}
+
+/** Runs the action of an environment.
+ *
+ * @param index The environment.
+ * */
+void BatchEnvironment::stepOne(size_t index) {
+    AdventureGame *game = this->m_environments[index].game.get();
+    uint32_t action = this->m_step_actions[index];
+    this->m_rewards[index] = 0;
+    if (game == nullptr || this->m_done[index] || action >= this->m_commands.size()) {
+        return;
+    }
+
+    int xp = game->getPlayer()->getXP();
+    GameStatus status = game->replayCommand(this->m_commands[action]);
+    float reward = (float) (game->getPlayer()->getXP() - xp);
+    if (status == GameStatus::VICTORY) {
+        reward += VICTORY_REWARD;
+    } else if (status == GameStatus::DEFEAT) {
+        reward += DEFEAT_REWARD;
+    }
+    this->m_rewards[index] = reward;
+    this->m_statuses[index] = status;
+    this->m_done[index] = status != GameStatus::CONTINUE;
+    this->observe(index, false);
+}
+
+/** Stores the observation of an environment.
+ *
+ * @param index The environment.
+ * @param full If every value is written, otherwise only the ones that
+ * changed since the last step are.
+ * */
+void BatchEnvironment::observe(size_t index, bool full) {
+    size_t size = this->m_encoder.getSize();
+    this->m_encoder.encode(*this->m_environments[index].game,
+                           &this->m_observations[index * size], full);
+}
+
+/** Runs a job on every environment with all the threads and waits for it to
+ * be done.
+ *
+ * @param job The job.
+ * */
+void BatchEnvironment::runAll(Job job) {
+    this->m_next.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_job = job;
+        this->m_busy = this->m_threads.size();
+        this->m_generation++;
+    }
+    this->m_wake.notify_all();
+    this->runBlocks();
+
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    this->m_idle.wait(lock, [this]() {
+        return this->m_busy == 0;
+    });
+}
+
+/** Runs the job on blocks of environments until none are left. */
+void BatchEnvironment::runBlocks(void) {
+    size_t count = this->m_environments.size();
+    size_t start;
+    while ((start = this->m_next.fetch_add(BLOCK_SIZE, std::memory_order_relaxed)) < count) {
+        size_t end = std::min(start + BLOCK_SIZE, count);
+        for (size_t i = start; i < end; i++) {
+            (this->*m_job)(i);
+        }
+    }
+}
+
+/** Waits for jobs and runs them until the environment is destroyed. */
+void BatchEnvironment::work(void) {
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->m_mutex);
+            this->m_wake.wait(lock, [&]() {
+                return this->m_stopping || this->m_generation != generation;
+            });
+            if (this->m_stopping) {
+                return;
+            }
+            generation = this->m_generation;
+        }
+
+        this->runBlocks();
+
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        if (--this->m_busy == 0) {
+            this->m_idle.notify_one();
+        }
+    }
+}
@@ -0,0 +1,223 @@
+#ifndef BATCH_ENVIRONMENT_H_
+#define BATCH_ENVIRONMENT_H_
+
+/** @file batch-environment.h
+ *
+ * Header file containing the environment stepping many games at once for
+ * learning agents.
+ * */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "observation-encoder.h"
+#include "transcript.h"
+
+/** Many games stepped together with numbered actions.
+ *
+ * Every game is reset with a seed and stepped with the index of an action
+ * in getActions(). After a step the observation, the reward and if the game
+ * is done are stored for every game in contiguous arrays. The games are
+ * stepped in parallel by a pool of threads kept for the life of the
+ * environment, each taking blocks of games until none are left.
+ *
+ * The actions are dispatched like commands read from a transcript, so
+ * they are never parsed. The output of the games is discarded.
+ *
+ * @code
+ * BatchEnvironment env(1024);
+ * env.reset(std::vector<uint32_t>(1024, 0));
+ * env.step(actions);
+ * const std::vector<float> &rewards = env.getRewards();
+ * @endcode
+ * */
+class BatchEnvironment {
+        public:
+                /** Reward added when a game is won. */
+                static constexpr float VICTORY_REWARD = 100;
+                /** Reward added when a game is lost. */
+                static constexpr float DEFEAT_REWARD = -100;
+
+                /** Constructor for BatchEnvironment.
+                 *
+                 * The games are only created by reset().
+                 *
+                 * @param count The number of games.
+                 * @param threads The number of threads stepping the games,
+                 * the calling thread included. 0 uses one per core.
+                 * @param build Creates the world of a game from its seed and
+                 * returns the room the player starts in. The coursework
+                 * castle, whatever the seed, by default. The actions and
+                 * the size of the observations are made from the world of
+                 * seed 0.
+                 * */
+                BatchEnvironment(size_t count, size_t threads = 0,
+                                 std::function<Room*(World&, uint32_t)> build = nullptr);
+                /** Destructor for BatchEnvironment, stops the threads. */
+                ~BatchEnvironment(void);
+                BatchEnvironment(const BatchEnvironment &) = delete;
+                BatchEnvironment& operator = (const BatchEnvironment &) = delete;
+
+                /** Starts a new game in every environment.
+                 *
+                 * The rewards are set to 0 and the games aren't done.
+                 *
+                 * @param seeds The seed of the world of each game, size()
+                 * long.
+                 * */
+                void reset(const std::vector<uint32_t> &seeds);
+                /** Starts a new game in one environment.
+                 *
+                 * @param index The environment.
+                 * @param seed The seed of the world of the game.
+                 * */
+                void reset(size_t index, uint32_t seed);
+                /** Runs an action in every game.
+                 *
+                 * The reward of a game is the XP it gained, plus
+                 * VICTORY_REWARD or DEFEAT_REWARD when the action ended it.
+                 * A game that is done ignores its action until it is reset
+                 * and its reward is 0.
+                 *
+                 * @param actions The index in getActions() of the action of
+                 * each game, size() long. An unknown index runs no action.
+                 * */
+                void step(const std::vector<uint32_t> &actions);
+
+                //////////
+                // Getters
+                /** Gets the number of games.
+                 *
+                 * @return The number of games.
+                 * */
+                size_t size(void) const;
+                /** Gets the number of threads stepping the games.
+                 *
+                 * @return The number of threads, the calling thread
+                 * included.
+                 * */
+                size_t getThreads(void) const;
+                /** Gets the commands run by the actions.
+                 *
+                 * The moves, the fights, the items that are used and
+                 * unlocking come first, then getting and dropping every
+                 * item of the world.
+                 *
+                 * @return The command of each action.
+                 * */
+                const std::vector<std::string>& getActions(void) const;
+                /** Gets the encoder of the observations.
+                 *
+                 * @return The encoder, it gives the layout of an
+                 * observation.
+                 * */
+                const ObservationEncoder& getEncoder(void) const;
+                /** Gets the observations of the games.
+                 *
+                 * Every game has getEncoder().getSize() values. A step only
+                 * writes the values that changed.
+                 *
+                 * @return The observations, game after game.
+                 * */
+                const std::vector<int32_t>& getObservations(void) const;
+                /** Gets the rewards of the last step.
+                 *
+                 * @return The reward of each game.
+                 * */
+                const std::vector<float>& getRewards(void) const;
+                /** Gets which games are done.
+                 *
+                 * @return 1 for each game that was won, lost or exited, 0
+                 * for the others.
+                 * */
+                const std::vector<uint8_t>& getDone(void) const;
+                /** Gets the status of the games.
+                 *
+                 * @return The status of each game.
+                 * */
+                const std::vector<GameStatus>& getStatuses(void) const;
+                /** Gets the game of an environment.
+                 *
+                 * @param index The environment.
+                 * @return The game, nullptr before it is reset.
+                 * */
+                AdventureGame* getGame(size_t index);
+        private:
+                /** A game and the stream its output is discarded into. */
+                struct Environment {
+                    std::ostream output; /**<The output of the game. */
+                    std::unique_ptr<AdventureGame> game; /**<The game. */
+                    uint32_t seed = 0; /**<Seed of the next reset. */
+
+                    /** Constructor for Environment. */
+                    Environment(void);
+                };
+
+                /** Work run on every environment. */
+                using Job = void (BatchEnvironment::*)(size_t);
+
+                /** Starts the game of an environment with its seed.
+                 *
+                 * @param index The environment.
+                 * */
+                void resetOne(size_t index);
+                /** Runs the action of an environment.
+                 *
+                 * @param index The environment.
+                 * */
+                void stepOne(size_t index);
+                /** Stores the observation of an environment.
+                 *
+                 * @param index The environment.
+                 * @param full If every value is written, otherwise only the
+                 * ones that changed since the last step are.
+                 * */
+                void observe(size_t index, bool full);
+                /** Runs a job on every environment with all the threads and
+                 * waits for it to be done.
+                 *
+                 * @param job The job.
+                 * */
+                void runAll(Job job);
+                /** Runs the job on blocks of environments until none are
+                 * left. */
+                void runBlocks(void);
+                /** Waits for jobs and runs them until the environment is
+                 * destroyed. */
+                void work(void);
+
+                std::function<Room*(World&, uint32_t)> m_build; /**<Creates the worlds. */
+                std::vector<Environment> m_environments; /**<The games. */
+                std::vector<std::string> m_actions; /**<Command of each action. */
+                std::vector<std::string> m_arguments; /**<Arguments of the actions. */
+                std::vector<TranscriptEntry> m_commands; /**<Dispatched command of each action. */
+                ObservationEncoder m_encoder; /**<Encodes the observations. */
+
+                const uint32_t *m_step_actions = nullptr; /**<Actions of the running step. */
+                std::vector<int32_t> m_observations; /**<Observation of each game. */
+                std::vector<float> m_rewards; /**<Reward of each game. */
+                std::vector<uint8_t> m_done; /**<If each game is done. */
+                std::vector<GameStatus> m_statuses; /**<Status of each game. */
+
+                std::vector<std::thread> m_threads; /**<Threads besides the caller. */
+                std::mutex m_mutex; /**<Guards the job and m_stopping. */
+                std::condition_variable m_wake; /**<Signals a new job. */
+                std::condition_variable m_idle; /**<Signals the job is done. */
+                Job m_job = nullptr; /**<The running job. */
+                uint64_t m_generation = 0; /**<Number of jobs started. */
+                bool m_stopping = false; /**<If the threads must stop. */
+                std::atomic<size_t> m_next{0}; /**<First environment not taken. */
+                size_t m_busy = 0; /**<Threads still running the job. */
+};
+
+#endif // BATCH_ENVIRONMENT_H_
@@ -0,0 +1,63 @@
+#ifndef CASTLE_MAP_H_
+#define CASTLE_MAP_H_
+
+/** @file castle-map.h
+ *
+ * Header file containing the map of the castle of the coursework.
+ * */
+
+#include <iterator>
+
+#include "world-map.h"
+
+/** Rooms of the castle, the exits are in the order of Direction. */
+constexpr RoomSpec CASTLE_ROOMS[] = {
+    {"Castle Entrance", {NO_SPEC, NO_SPEC, 1, NO_SPEC}, false},
+    {"Castle Hall", {NO_SPEC, 3, 2, 0}, false},
+    {"Armory", {NO_SPEC, NO_SPEC, NO_SPEC, 1}, false},
+    {"Castle Center", {1, 4, 7, 5}, false},
+    {"Religious Room", {3, NO_SPEC, NO_SPEC, NO_SPEC}, false},
+    {"Medical Room", {NO_SPEC, 6, 3, NO_SPEC}, false},
+    {"Storage Room", {5, NO_SPEC, NO_SPEC, NO_SPEC}, false},
+    {"Magic Room", {NO_SPEC, 8, NO_SPEC, 3}, false},
+    {"Boss Room", {7, NO_SPEC, NO_SPEC, NO_SPEC}, true},
+};
+
+/** Items of the castle. */
+constexpr ItemSpec CASTLE_ITEMS[] = {
+    {"Food", CONSUMABLE_ITEM, 5, 1},
+    {"Silver Spear", WEAPON_ITEM, 1, 2},
+    {"Sword", WEAPON_ITEM, 2, 3},
+    {"Diamond Cross", PLAIN_ITEM, 0, 4},
+    {"Medpack", CONSUMABLE_ITEM, 10, 5},
+    {"Copper Key", PLAIN_ITEM, 0, 6},
+    {"Elixir", CONSUMABLE_ITEM, 10, 7},
+    {"Golden Chalice", PLAIN_ITEM, 0, 8},
+};
+
+/** Enemies of the castle. */
+constexpr EnemySpec CASTLE_ENEMIES[] = {
+    {"Zombie", GENERIC_ENEMY, 6, 1, 2, 1},
+    {"Lizard-man", GENERIC_ENEMY, 5, 1, 3, NO_SPEC},
+    {"Werewolf", WEREWOLF, 12, 3, 4, 3},
+    {"Dracula", VAMPIRE, 12, 3, 6, 5},
+    {"Monster", GENERIC_ENEMY, 4, 3, 7, NO_SPEC},
+    {"Dragon", GENERIC_ENEMY, 12, 4, 8, 7},
+};
+
+/** The castle of the coursework, the player starts in the Castle
+ * Entrance. */
+constexpr WorldMap CASTLE_MAP = {
+    CASTLE_ROOMS, std::size(CASTLE_ROOMS),
+    CASTLE_ITEMS, std::size(CASTLE_ITEMS),
+    CASTLE_ENEMIES, std::size(CASTLE_ENEMIES),
+    0
+};
+
+static_assert(hasReciprocalExits(CASTLE_MAP),
+              "Every exit of the castle must lead back to its room");
+static_assert(hasPlacedEntities(CASTLE_MAP),
+              "The items and enemies of the castle must be in its rooms");
+static_assert(isValidMap(CASTLE_MAP), "The castle must be a valid map");
+
+#endif // CASTLE_MAP_H_
@@ -0,0 +1,292 @@
+#include "combat-batch.h"
+
+#include <cstdint>
+#include <limits>
+
+#include "combat.h"
+#include "enemies.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GAME_HAVE_AVX2_KERNEL
+#endif
+
+/** Hits standing for a side that can't hurt the other. */
+static const int32_t NEVER = std::numeric_limits<int32_t>::max();
+
+////////////////
+// FightBatch
+/** Resizes every array.
+ *
+ * @param size The number of fights.
+ * */
+void FightBatch::resize(size_t size) {
+    for (std::vector<int32_t> *array: {&this->player_health, &this->player_damage,
+                                       &this->spears, &this->swords, &this->crosses,
+                                       &this->enemy_kind, &this->enemy_health,
+                                       &this->enemy_damage}) {
+        array->resize(size);
+    }
+}
+
+/** Gets the number of fights.
+ *
+ * @return The number of fights.
+ * */
+size_t FightBatch::size(void) const {
+    return this->player_health.size();
+}
+
+////////////////
+// FightResults
+/** Resizes every array.
+ *
+ * @param size The number of fights.
+ * */
+void FightResults::resize(size_t size) {
+    for (std::vector<int32_t> *array: {&this->status, &this->player_health,
+                                       &this->enemy_health, &this->xp}) {
+        array->resize(size);
+    }
+}
+
+/** Gets the number of fights.
+ *
+ * @return The number of fights.
+ * */
+size_t FightResults::size(void) const {
+    return this->status.size();
+}
+
+/////////////////
+// Scalar kernel
+/** Multiplies with the wrap around of the vector kernel.
+ *
+ * @param a A factor.
+ * @param b The other factor.
+ * @return The product modulo 2^32.
+ * */
+static inline int32_t wrappingMultiply(int32_t a, int32_t b) {
+    return (int32_t) ((uint32_t) a * (uint32_t) b);
+}
+
+/** Resolves fights one at a time.
+ *
+ * @param fights The fights.
+ * @param results The results, as large as the fights.
+ * @param begin The first fight to resolve.
+ * @param end One past the last fight to resolve.
+ * */
+static void resolveScalar(const FightBatch &fights, FightResults &results,
+                          size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        int32_t player_health = fights.player_health[i];
+        int32_t enemy_health = fights.enemy_health[i];
+        int32_t enemy_damage = fights.enemy_damage[i];
+
+        // Werewolf::modifyDamage() and Vampire::modifyDamage()
+        int32_t player_damage = fights.player_damage[i];
+        if (fights.enemy_kind[i] == WEREWOLF) {
+            player_damage += 3 * fights.spears[i];
+        } else if (fights.enemy_kind[i] == VAMPIRE) {
+            player_damage += 4 * fights.crosses[i] - fights.swords[i];
+        }
+
+        // Hits each side needs to kill the other, the player hits first
+        int32_t kill = player_damage > 0 ?
+                       (enemy_health - 1) / player_damage + 1 : NEVER;
+        int32_t die = enemy_damage > 0 ?
+                      (player_health - 1) / enemy_damage + 1 : NEVER;
+        bool fought = enemy_health > 0 && player_health > 0 &&
+                      (player_damage > 0 || enemy_damage > 0);
+        bool won = kill <= die;
+
+        int32_t player_hits = 0;
+        int32_t enemy_hits = 0;
+        if (fought) {
+            player_hits = won ? kill : die;
+            enemy_hits = won ? kill - 1 : die;
+        }
+
+        if (enemy_health <= 0) {
+            results.status[i] = DEAD_ENEMY;
+        } else {
+            results.status[i] = fought && won ? KILL_SUCCESS : KILL_FAILURE;
+        }
+        int32_t xp = wrappingMultiply(player_hits, player_damage);
+        results.player_health[i] = player_health -
+                                   wrappingMultiply(enemy_hits, enemy_damage);
+        results.enemy_health[i] = enemy_health - xp;
+        results.xp[i] = xp;
+    }
+}
+
+///////////////
+// AVX2 kernel
+#ifdef GAME_HAVE_AVX2_KERNEL
+/** Divides positive integers rounding up.
+ *
+ * The quotient of two 32 bit integers is exact in double precision, so
+ * truncating it gives the integer quotient.
+ *
+ * @param a The dividends, they must be positive.
+ * @param b The divisors, they must be positive.
+ * @return The quotients rounded up.
+ * */
+__attribute__((target("avx2")))
+static inline __m256i ceilDivAvx2(__m256i a, __m256i b) {
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i dividend = _mm256_sub_epi32(a, one);
+    __m256d low = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(dividend)),
+                                _mm256_cvtepi32_pd(_mm256_castsi256_si128(b)));
+    __m256d high = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(dividend, 1)),
+                                 _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1)));
+    __m256i quotient = _mm256_set_m128i(_mm256_cvttpd_epi32(high),
+                                        _mm256_cvttpd_epi32(low));
+    return _mm256_add_epi32(quotient, one);
+}
+
+/** Loads 8 elements of an array.
+ *
+ * @param array The array.
+ * @param i The first element.
+ * @return The elements.
+ * */
+__attribute__((target("avx2")))
+static inline __m256i load(const std::vector<int32_t> &array, size_t i) {
+    return _mm256_loadu_si256((const __m256i *) (array.data() + i));
+}
+
+/** Stores 8 elements of an array.
+ *
+ * @param array The array.
+ * @param i The first element.
+ * @param value The elements.
+ * */
+__attribute__((target("avx2")))
+static inline void store(std::vector<int32_t> &array, size_t i, __m256i value) {
+    _mm256_storeu_si256((__m256i *) (array.data() + i), value);
+}
+
+/** Resolves fights 8 at a time.
+ *
+ * The branches of resolveScalar() become masks, the fights that don't fit
+ * in a full vector are left to the caller.
+ *
+ * @param fights The fights.
+ * @param results The results, as large as the fights.
+ * @return The number of fights resolved.
+ * */
+__attribute__((target("avx2")))
+static size_t resolveAvx2(const FightBatch &fights, FightResults &results) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i never = _mm256_set1_epi32(NEVER);
+    const __m256i werewolf = _mm256_set1_epi32(WEREWOLF);
+    const __m256i vampire = _mm256_set1_epi32(VAMPIRE);
+
+    size_t size = fights.size() / 8 * 8;
+    for (size_t i = 0; i < size; i += 8) {
+        __m256i player_health = load(fights.player_health, i);
+        __m256i enemy_health = load(fights.enemy_health, i);
+        __m256i enemy_damage = load(fights.enemy_damage, i);
+        __m256i kind = load(fights.enemy_kind, i);
+
+        // Werewolf::modifyDamage() and Vampire::modifyDamage()
+        __m256i spears = load(fights.spears, i);
+        __m256i werewolf_bonus = _mm256_add_epi32(_mm256_slli_epi32(spears, 1), spears);
+        __m256i vampire_bonus = _mm256_sub_epi32(_mm256_slli_epi32(load(fights.crosses, i), 2),
+                                                 load(fights.swords, i));
+        __m256i player_damage = _mm256_add_epi32(
+            load(fights.player_damage, i),
+            _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi32(kind, werewolf), werewolf_bonus),
+                            _mm256_and_si256(_mm256_cmpeq_epi32(kind, vampire), vampire_bonus)));
+
+        // Hits each side needs to kill the other, the player hits first
+        __m256i player_hurts = _mm256_cmpgt_epi32(player_damage, zero);
+        __m256i enemy_hurts = _mm256_cmpgt_epi32(enemy_damage, zero);
+        __m256i enemy_alive = _mm256_cmpgt_epi32(enemy_health, zero);
+        __m256i player_alive = _mm256_cmpgt_epi32(player_health, zero);
+        __m256i kill = _mm256_blendv_epi8(
+            never, ceilDivAvx2(_mm256_max_epi32(enemy_health, one),
+                               _mm256_max_epi32(player_damage, one)), player_hurts);
+        __m256i die = _mm256_blendv_epi8(
+            never, ceilDivAvx2(_mm256_max_epi32(player_health, one),
+                               _mm256_max_epi32(enemy_damage, one)), enemy_hurts);
+        __m256i fought = _mm256_and_si256(_mm256_and_si256(enemy_alive, player_alive),
+                                          _mm256_or_si256(player_hurts, enemy_hurts));
+        __m256i won = _mm256_andnot_si256(_mm256_cmpgt_epi32(kill, die),
+                                          _mm256_set1_epi32(-1));
+
+        __m256i player_hits = _mm256_and_si256(fought, _mm256_blendv_epi8(die, kill, won));
+        __m256i enemy_hits = _mm256_and_si256(
+            fought, _mm256_blendv_epi8(die, _mm256_sub_epi32(kill, one), won));
+
+        __m256i status = _mm256_blendv_epi8(
+            _mm256_set1_epi32(KILL_FAILURE), _mm256_set1_epi32(KILL_SUCCESS),
+            _mm256_and_si256(fought, won));
+        status = _mm256_blendv_epi8(_mm256_set1_epi32(DEAD_ENEMY), status, enemy_alive);
+        __m256i xp = _mm256_mullo_epi32(player_hits, player_damage);
+
+        store(results.status, i, status);
+        store(results.player_health, i, _mm256_sub_epi32(
+            player_health, _mm256_mullo_epi32(enemy_hits, enemy_damage)));
+        store(results.enemy_health, i, _mm256_sub_epi32(enemy_health, xp));
+        store(results.xp, i, xp);
+    }
+    return size;
+}
+#endif
+
+/** Checks if a kernel can run on this CPU.
+ *
+ * @param kernel The kernel.
+ * @return If the kernel is available.
+ * */
+bool fightKernelSupported(FightKernel kernel) {
+    switch (kernel) {
+        case SCALAR_FIGHT_KERNEL:
+            return true;
+        case AVX2_FIGHT_KERNEL:
+#ifdef GAME_HAVE_AVX2_KERNEL
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/** Gets the fastest kernel that can run on this CPU.
+ *
+ * @return The kernel.
+ * */
+FightKernel bestFightKernel(void) {
+    static const FightKernel best = fightKernelSupported(AVX2_FIGHT_KERNEL) ?
+                                    AVX2_FIGHT_KERNEL : SCALAR_FIGHT_KERNEL;
+    return best;
+}
+
+/** Resolves a batch of fights.
+ *
+ * Every fight has the result Room::killEnemy() would give for a Player
+ * with the loadout fighting the enemy: DEAD_ENEMY if the enemy is already
+ * dead, KILL_FAILURE if the player is dead, otherwise the exchange of
+ * fightEnemy(). A fight where neither side can hurt the other never ends
+ * in the game, it is resolved as a KILL_FAILURE without any hits.
+ *
+ * @param fights The fights.
+ * @param results The results, resized to the number of fights.
+ * @param kernel The kernel resolving the fights, it must be supported.
+ * */
+void resolveFights(const FightBatch &fights, FightResults &results,
+                   FightKernel kernel) {
+    results.resize(fights.size());
+    size_t resolved = 0;
+#ifdef GAME_HAVE_AVX2_KERNEL
+    if (kernel == AVX2_FIGHT_KERNEL) {
+        resolved = resolveAvx2(fights, results);
+    }
+#endif
+    resolveScalar(fights, results, resolved, fights.size());
+}
@@ -0,0 +1,96 @@
+#ifndef COMBAT_BATCH_H_
+#define COMBAT_BATCH_H_
+
+/** @file combat-batch.h
+ *
+ * Header file containing the resolution of many independent fights at
+ * once.
+ *
+ * A fight is worked out in closed form from the number of hits each side
+ * needs to kill the other, which gives the same result as the exchange of
+ * fightEnemy() without looping over the hits. The fights are stored as a
+ * struct of arrays so the AVX2 kernel resolves 8 fights per instruction.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Fights between player loadouts and enemies as a struct of arrays.
+ *
+ * Element i of every array describes fight i.
+ * */
+struct FightBatch {
+        std::vector<int32_t> player_health; /**<Current health of the player. */
+        std::vector<int32_t> player_damage; /**<Damage of the player, with its weapons. */
+        std::vector<int32_t> spears; /**<Silver Spears held by the player. */
+        std::vector<int32_t> swords; /**<Swords held by the player. */
+        std::vector<int32_t> crosses; /**<Diamond Crosses held by the player. */
+        std::vector<int32_t> enemy_kind; /**<EnemyKind of the enemy. */
+        std::vector<int32_t> enemy_health; /**<Current health of the enemy. */
+        std::vector<int32_t> enemy_damage; /**<Damage of the enemy. */
+
+        /** Resizes every array.
+         *
+         * @param size The number of fights.
+         * */
+        void resize(size_t size);
+        /** Gets the number of fights.
+         *
+         * @return The number of fights.
+         * */
+        size_t size(void) const;
+};
+
+/** Results of a FightBatch as a struct of arrays. */
+struct FightResults {
+        std::vector<int32_t> status; /**<KillStatus of the fight. */
+        std::vector<int32_t> player_health; /**<Health of the player afterwards. */
+        std::vector<int32_t> enemy_health; /**<Health of the enemy afterwards. */
+        std::vector<int32_t> xp; /**<XP gained by the player. */
+
+        /** Resizes every array.
+         *
+         * @param size The number of fights.
+         * */
+        void resize(size_t size);
+        /** Gets the number of fights.
+         *
+         * @return The number of fights.
+         * */
+        size_t size(void) const;
+};
+
+/** Kernels resolving a FightBatch. */
+enum FightKernel {
+SCALAR_FIGHT_KERNEL, /**<One fight at a time, always available. */
+AVX2_FIGHT_KERNEL /**<8 fights at a time, needs a CPU with AVX2. */
+};
+
+/** Checks if a kernel can run on this CPU.
+ *
+ * @param kernel The kernel.
+ * @return If the kernel is available.
+ * */
+bool fightKernelSupported(FightKernel kernel);
+/** Gets the fastest kernel that can run on this CPU.
+ *
+ * @return The kernel.
+ * */
+FightKernel bestFightKernel(void);
+/** Resolves a batch of fights.
+ *
+ * Every fight has the result Room::killEnemy() would give for a Player
+ * with the loadout fighting the enemy: DEAD_ENEMY if the enemy is already
+ * dead, KILL_FAILURE if the player is dead, otherwise the exchange of
+ * fightEnemy(). A fight where neither side can hurt the other never ends
+ * in the game, it is resolved as a KILL_FAILURE without any hits.
+ *
+ * @param fights The fights.
+ * @param results The results, resized to the number of fights.
+ * @param kernel The kernel resolving the fights, it must be supported.
+ * */
+void resolveFights(const FightBatch &fights, FightResults &results,
+                   FightKernel kernel = bestFightKernel());
+
+#endif // COMBAT_BATCH_H_
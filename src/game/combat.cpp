@@ -0,0 +1,63 @@
+#include "combat.h"
+
+#include "generics.h"
+#include "enemies.h"
+#include "player.h"
+
+/** Fights the enemy using the compile time dispatched kernel.
+ *
+ * @param player The player fighting the enemy.
+ * @param enemy The enemy being fought, it must be alive.
+ * @return The kill status.
+ *
+ * @see fightEnemy()
+ * */
+KillStatus fight(Player *player, GenericEnemy *enemy) {
+    return visitEnemy(*enemy, [player](auto &concrete) {
+        return fightEnemy(*player, concrete);
+    });
+}
+
+/** Fights the enemy through the virtual dealDamage() methods.
+ *
+ * This is used for any killer that isn't exactly a Player.
+ *
+ * @param killer The entity fighting the enemy.
+ * @param enemy The enemy being fought, it must be alive.
+ * @return The kill status.
+ * */
+KillStatus fightVirtual(GenericEntity *killer, GenericEnemy *enemy) {
+    // Deal Damage until either dies
+    while (!killer->isDead() && !enemy->isDead()) {
+        killer->dealDamage(enemy);
+        if (!(enemy->isDead())) {
+            enemy->dealDamage(killer);
+        }
+    }
+
+    // If killer died
+    if (killer->isDead()) {
+        return KillStatus::KILL_FAILURE;
+    } else { // Successful kill
+        return KillStatus::KILL_SUCCESS;
+    }
+}
+
+/** Gets the name of a kill status.
+ *
+ * @param status The kill status.
+ * @return The name of the enumerator, such as "KILL_SUCCESS".
+ * */
+const char* killStatusName(KillStatus status) {
+    switch (status) {
+        case KILL_SUCCESS:
+            return "KILL_SUCCESS";
+        case KILL_FAILURE:
+            return "KILL_FAILURE";
+        case NO_ENEMY:
+            return "NO_ENEMY";
+        case DEAD_ENEMY:
+            return "DEAD_ENEMY";
+    }
+    return "UNKNOWN";
+}
@@ -0,0 +1,120 @@
+#ifndef COMBAT_H_
+#define COMBAT_H_
+
+/** @file combat.h
+ *
+ * Header file containing the fight resolution between an entity and
+ * an enemy.
+ *
+ * The enemy classes are a closed set (see EnemyKind) so a fight between
+ * the Player and an enemy is dispatched once on the kind of the enemy and
+ * then resolved by a kernel that is specialised for the concrete type. The
+ * kernel doesn't make any virtual calls while the fight is going on.
+ * */
+
+#include "generics.h"
+#include "enemies.h"
+#include "player.h"
+
+/** Enumeration of kill statuses. */
+enum KillStatus {
+KILL_SUCCESS, /**<Sucessfully killed enemy. */
+KILL_FAILURE, /**<Failed to kill enemy. */
+NO_ENEMY, /**<The enemy given isn't valid. */
+DEAD_ENEMY /**<The enemy is already dead. */
+};
+
+/** Calls the visitor with the enemy casted to its concrete type.
+ *
+ * @param enemy The enemy to visit.
+ * @param visitor The callable to call with the concrete enemy.
+ * @return The value returned by the visitor.
+ *
+ * @see EnemyKind
+ * */
+template <class Visitor>
+auto visitEnemy(GenericEnemy &enemy, Visitor &&visitor) {
+    switch (enemy.getKind()) {
+        case WEREWOLF:
+            return visitor(static_cast<Werewolf &>(enemy));
+        case VAMPIRE:
+            return visitor(static_cast<Vampire &>(enemy));
+        default:
+            return visitor(enemy);
+    }
+}
+
+/** Fights the enemy until either the player or the enemy dies.
+ *
+ * This has the same semantics as the virtual Player::dealDamage() and
+ * GenericEntity::dealDamage() exchange. As the inventory of the player
+ * can't change during a fight the damage modifier of the enemy is
+ * worked out once and the exchange itself is done on local copies of
+ * the health.
+ *
+ * @param player The player fighting the enemy.
+ * @param enemy The enemy being fought, it must be alive.
+ * @return KILL_SUCCESS if the enemy died, KILL_FAILURE otherwise.
+ * */
+template <class Enemy>
+KillStatus fightEnemy(Player &player, Enemy &enemy) {
+    int player_damage = Enemy::modifyDamage(player.getDamage(),
+                                            player.getInventory());
+    int enemy_damage = enemy.getDamage();
+    int player_health = player.getCurrentHealth();
+    int enemy_health = enemy.getCurrentHealth();
+    int player_hits = 0;
+    int enemy_hits = 0;
+
+    // Deal Damage until either dies
+    while (player_health > 0 && enemy_health > 0) {
+        enemy_health -= player_damage;
+        player_hits++;
+        if (enemy_health > 0) {
+            player_health -= enemy_damage;
+            enemy_hits++;
+        }
+    }
+
+    // Applying the result, this calls the onDeath() callbacks
+    if (player_hits > 0) {
+        player.addXP(player_hits * player_damage);
+        enemy.GenericEntity::takeDamage(player_hits * player_damage, nullptr);
+    }
+    if (enemy_hits > 0) {
+        player.GenericEntity::takeDamage(enemy_hits * enemy_damage, nullptr);
+    }
+
+    if (player.isDead()) {
+        return KillStatus::KILL_FAILURE;
+    } else {
+        return KillStatus::KILL_SUCCESS;
+    }
+}
+
+/** Fights the enemy using the compile time dispatched kernel.
+ *
+ * @param player The player fighting the enemy.
+ * @param enemy The enemy being fought, it must be alive.
+ * @return The kill status.
+ *
+ * @see fightEnemy()
+ * */
+KillStatus fight(Player *player, GenericEnemy *enemy);
+/** Fights the enemy through the virtual dealDamage() methods.
+ *
+ * This is used for any killer that isn't exactly a Player.
+ *
+ * @param killer The entity fighting the enemy.
+ * @param enemy The enemy being fought, it must be alive.
+ * @return The kill status.
+ * */
+KillStatus fightVirtual(GenericEntity *killer, GenericEnemy *enemy);
+/** Gets the name of a kill status.
+ *
+ * @param status The kill status.
+ * @return The name of the enumerator, such as "KILL_SUCCESS".
+ * */
+const char* killStatusName(KillStatus status);
+
+#endif // COMBAT_H_
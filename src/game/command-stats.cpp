@@ -0,0 +1,507 @@
+#include "command-stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/** Gets the rank of a percentile.
+ *
+ * @param percentile The percentile, between 0 and 100.
+ * @param count The number of values.
+ * @return The rank of the percentile, rounded up and at least 1.
+ * */
+static uint64_t rankOf(double percentile, uint64_t count) {
+    uint64_t rank = (uint64_t) (percentile / 100.0 * count);
+    if (rank * 100.0 < percentile * count || rank == 0) {
+        rank++;
+    }
+    return rank;
+}
+
+/** Prints the header of a latency table.
+ *
+ * @param out The output stream.
+ * @param title The title of the table.
+ * */
+static void printLatencyHeader(std::ostream &out, const char *title) {
+    out << title << std::endl;
+    out << std::left << std::setw(14) << "verb" << std::right
+        << std::setw(8) << "count" << std::setw(10) << "p50"
+        << std::setw(10) << "p90" << std::setw(10) << "p99"
+        << std::setw(10) << "max" << std::endl;
+}
+
+/** Prints a row of a latency table.
+ *
+ * @param out The output stream.
+ * @param verb The verb of the row.
+ * @param count The number of latencies.
+ * @param percentile Gets a percentile of the latencies.
+ * @param max The largest latency.
+ * */
+template <class Percentile>
+static void printLatencyRow(std::ostream &out, const std::string &verb,
+                            uint64_t count, Percentile percentile, uint64_t max) {
+    out << std::left << std::setw(14) << verb << std::right
+        << std::setw(8) << count
+        << std::setw(10) << percentile(50)
+        << std::setw(10) << percentile(90)
+        << std::setw(10) << percentile(99)
+        << std::setw(10) << max << std::endl;
+}
+
+////////////////////
+// LatencyHistogram
+/** Records a latency.
+ *
+ * @param ns The latency in nanoseconds.
+ * */
+void LatencyHistogram::record(uint64_t ns) {
+    this->m_buckets[bucketOf(ns)]++;
+    this->m_count++;
+    if (ns > this->m_max) {
+        this->m_max = ns;
+    }
+}
+
+/** Gets the number of recorded latencies.
+ *
+ * @return The number of recorded latencies.
+ * */
+uint64_t LatencyHistogram::count(void) const {
+    return this->m_count;
+}
+
+/** Gets the largest recorded latency.
+ *
+ * @return The largest recorded latency in nanoseconds.
+ * */
+uint64_t LatencyHistogram::max(void) const {
+    return this->m_max;
+}
+
+/** Gets a percentile of the recorded latencies.
+ *
+ * @param percentile The percentile, between 0 and 100.
+ * @return The upper bound of the bucket of the percentile in nanoseconds,
+ * 0 if nothing was recorded.
+ * */
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (this->m_count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = rankOf(percentile, this->m_count);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += this->m_buckets[i];
+        if (seen >= rank) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < this->m_max ? bound : this->m_max;
+        }
+    }
+    return this->m_max;
+}
+
+/** Gets the bucket of a value.
+ *
+ * @param value The value.
+ * @return The index of the bucket.
+ * */
+int LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < 8) {
+        return (int) value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    int mantissa = (int) (value >> (exponent - 3)) & 7;
+    return (exponent - 2) * 8 + mantissa;
+}
+
+/** Gets the largest value of a bucket.
+ *
+ * @param bucket The index of the bucket.
+ * @return The largest value in the bucket.
+ * */
+uint64_t LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < 8) {
+        return (uint64_t) bucket;
+    }
+    int exponent = bucket / 8 + 2;
+    uint64_t mantissa = bucket % 8;
+    uint64_t lower = (8 + mantissa) << (exponent - 3);
+    return lower + ((uint64_t) 1 << (exponent - 3)) - 1;
+}
+
+////////////////
+// CommandStats
+/** The verb unknown commands are recorded as. */
+const char *const CommandStats::INVALID_VERB = "(invalid)";
+
+/** Constructor for CommandStats. */
+CommandStats::CommandStats(void) {
+    this->addVerb(INVALID_VERB);
+}
+
+/** Adds a verb to keep a histogram of.
+ *
+ * Adding a verb again keeps its histogram and allocates nothing.
+ *
+ * @param verb The verb, in lower case.
+ * */
+void CommandStats::addVerb(const std::string &verb) {
+    this->m_histograms.try_emplace(verb);
+}
+
+/** Records the latency of a command.
+ *
+ * @param command The command, in lower case.
+ * @param ns The latency in nanoseconds.
+ * */
+void CommandStats::record(const std::string &command, uint64_t ns) {
+    std::string_view verb(command);
+    verb = verb.substr(0, verb.find(' '));
+
+    auto histogram = this->m_histograms.find(verb);
+    if (histogram == this->m_histograms.end()) {
+        histogram = this->m_histograms.find(std::string_view(INVALID_VERB));
+    }
+    histogram->second.record(ns);
+}
+
+/** Gets the histogram of a verb.
+ *
+ * @param verb The verb.
+ * @return The histogram, nullptr if the verb wasn't added.
+ * */
+const LatencyHistogram* CommandStats::getHistogram(const std::string &verb) const {
+    auto histogram = this->m_histograms.find(verb);
+    if (histogram == this->m_histograms.end()) {
+        return nullptr;
+    }
+    return &histogram->second;
+}
+
+/** Overloaded operator to print the statistics.
+ *
+ * Prints the count, p50, p90, p99 and max latency of every verb that was
+ * used.
+ *
+ * @param out The output stream.
+ * @param cls The class iteself.
+ *
+ * @return The new output stream.
+ * */
+std::ostream& operator << (std::ostream &out, const CommandStats &cls) {
+    printLatencyHeader(out, "Command latencies of the thread (ns):");
+    for (const auto &verb: cls.m_histograms) {
+        const LatencyHistogram &histogram = verb.second;
+        if (histogram.count() == 0) {
+            continue;
+        }
+        printLatencyRow(out, verb.first, histogram.count(), [&](double percentile) {
+            return histogram.percentile(percentile);
+        }, histogram.max());
+    }
+    return out;
+}
+
+/////////////////
+// GameLatencies
+/** Constructor for GameLatencies.
+ *
+ * Room for 32 verbs is reserved as well.
+ *
+ * @param capacity The number of buckets to reserve.
+ * */
+GameLatencies::GameLatencies(size_t capacity) {
+    this->m_verbs.reserve(32);
+    this->m_buckets.reserve(capacity);
+    this->addVerb(CommandStats::INVALID_VERB);
+}
+
+/** Adds a verb to keep the latencies of.
+ *
+ * Adding a verb again does nothing.
+ *
+ * @param verb The verb, in lower case.
+ * */
+void GameLatencies::addVerb(const std::string &verb) {
+    auto position = std::lower_bound(this->m_verbs.begin(), this->m_verbs.end(), verb,
+        [](const Verb &a, const std::string &b) { return a.name < b; });
+    if (position != this->m_verbs.end() && position->name == verb) {
+        return;
+    }
+
+    // The verbs after it move one index up
+    uint16_t index = (uint16_t) (position - this->m_verbs.begin());
+    for (Bucket &bucket: this->m_buckets) {
+        if (bucket.verb >= index) {
+            bucket.verb++;
+        }
+    }
+    this->m_verbs.insert(position, Verb{verb, 0});
+}
+
+/** Records the latency of a command.
+ *
+ * @param command The command, in lower case.
+ * @param ns The latency in nanoseconds.
+ * */
+void GameLatencies::record(const std::string &command, uint64_t ns) {
+    std::string_view verb(command);
+    uint16_t index = (uint16_t) this->find(verb.substr(0, verb.find(' ')));
+    uint16_t bucket = (uint16_t) LatencyHistogram::bucketOf(ns);
+    if (ns > this->m_verbs[index].max) {
+        this->m_verbs[index].max = ns;
+    }
+
+    auto position = std::lower_bound(this->m_buckets.begin(), this->m_buckets.end(),
+        Bucket{index, bucket, 0}, [](const Bucket &a, const Bucket &b) {
+            return a.verb < b.verb || (a.verb == b.verb && a.bucket < b.bucket);
+        });
+    if (position != this->m_buckets.end() && position->verb == index &&
+        position->bucket == bucket) {
+        position->count++;
+    } else {
+        this->m_buckets.insert(position, Bucket{index, bucket, 1});
+    }
+}
+
+//////////
+// Getters
+/** Gets the number of recorded latencies of a verb.
+ *
+ * @param verb The verb.
+ * @return The number of latencies, 0 if the verb wasn't added.
+ * */
+uint64_t GameLatencies::count(const std::string &verb) const {
+    size_t index = this->find(verb);
+    return this->m_verbs[index].name == verb ? this->verbCount(index) : 0;
+}
+
+/** Gets a percentile of the recorded latencies of a verb.
+ *
+ * @param verb The verb.
+ * @param percentile The percentile, between 0 and 100.
+ * @return The same as LatencyHistogram::percentile() for the latencies of
+ * the verb, 0 if nothing was recorded.
+ * */
+uint64_t GameLatencies::percentile(const std::string &verb, double percentile) const {
+    size_t index = this->find(verb);
+    return this->m_verbs[index].name == verb ? this->verbPercentile(index, percentile) : 0;
+}
+
+/** Overloaded operator to print the latencies.
+ *
+ * Prints the same table as CommandStats for the verbs the game used.
+ *
+ * @param out The output stream.
+ * @param cls The class iteself.
+ *
+ * @return The new output stream.
+ * */
+std::ostream& operator << (std::ostream &out, const GameLatencies &cls) {
+    printLatencyHeader(out, "Command latencies (ns):");
+    for (size_t i = 0; i < cls.m_verbs.size(); i++) {
+        uint64_t count = cls.verbCount(i);
+        if (count == 0) {
+            continue;
+        }
+        printLatencyRow(out, cls.m_verbs[i].name, count, [&](double percentile) {
+            return cls.verbPercentile(i, percentile);
+        }, cls.m_verbs[i].max);
+    }
+    return out;
+}
+
+/////////
+// private
+/** Finds a verb.
+ *
+ * @param verb The verb.
+ * @return The index of the verb, or of INVALID_VERB if the verb wasn't
+ * added.
+ * */
+size_t GameLatencies::find(std::string_view verb) const {
+    auto position = std::lower_bound(this->m_verbs.begin(), this->m_verbs.end(), verb,
+        [](const Verb &a, std::string_view b) { return a.name < b; });
+    if (position == this->m_verbs.end() || position->name != verb) {
+        return this->find(CommandStats::INVALID_VERB);
+    }
+    return position - this->m_verbs.begin();
+}
+
+/** Gets a percentile of the latencies of a verb.
+ *
+ * @param verb The index of the verb.
+ * @param percentile The percentile, between 0 and 100.
+ * @return The upper bound of the bucket of the percentile.
+ * */
+uint64_t GameLatencies::verbPercentile(size_t verb, double percentile) const {
+    uint64_t count = this->verbCount(verb);
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = rankOf(percentile, count);
+    uint64_t seen = 0;
+    uint64_t max = this->m_verbs[verb].max;
+    for (const Bucket &bucket: this->m_buckets) {
+        if (bucket.verb != verb) {
+            continue;
+        }
+        seen += bucket.count;
+        if (seen >= rank) {
+            uint64_t bound = LatencyHistogram::bucketUpperBound(bucket.bucket);
+            return bound < max ? bound : max;
+        }
+    }
+    return max;
+}
+
+/** Gets the number of recorded latencies of a verb.
+ *
+ * @param verb The index of the verb.
+ * @return The number of latencies.
+ * */
+uint64_t GameLatencies::verbCount(size_t verb) const {
+    uint64_t count = 0;
+    for (const Bucket &bucket: this->m_buckets) {
+        if (bucket.verb == verb) {
+            count += bucket.count;
+        }
+    }
+    return count;
+}
+
+///////////////
+// AllocTotals
+/** Accounts a sample.
+ *
+ * @param count The number of allocations of the sample.
+ * @param bytes The number of bytes allocated by the sample.
+ * */
+void AllocTotals::add(uint64_t count, uint64_t bytes) {
+    this->samples++;
+    this->count += count;
+    this->bytes += bytes;
+    if (count > this->max_count) {
+        this->max_count = count;
+    }
+}
+
+/////////////////
+// CommandAllocs
+/** Names of the engine phases when printed. */
+static const char *const PHASE_NAMES[ENGINE_PHASES] = {
+    "(setup)", "(input)", "(dispatch)", "(end)"
+};
+
+/** Prints a row of the allocation table.
+ *
+ * @param out The output stream.
+ * @param name The name of the row.
+ * @param totals The allocations of the row.
+ * */
+static void printAllocRow(std::ostream &out, const std::string &name,
+                          const AllocTotals &totals) {
+    out << std::left << std::setw(14) << name << std::right
+        << std::setw(8) << totals.samples
+        << std::setw(10) << totals.count
+        << std::setw(12) << totals.bytes
+        << std::setw(10) << totals.max_count << std::endl;
+}
+
+/** Constructor for CommandAllocs. */
+CommandAllocs::CommandAllocs(void) {
+    this->addVerb(CommandStats::INVALID_VERB);
+}
+
+/** Adds a verb to account allocations to.
+ *
+ * @param verb The verb, in lower case.
+ * */
+void CommandAllocs::addVerb(const std::string &verb) {
+    this->m_verbs.emplace(verb, AllocTotals());
+}
+
+/** Accounts the allocations of a processed command.
+ *
+ * @param command The command, in lower case.
+ * @param count The number of allocations.
+ * @param bytes The number of bytes allocated.
+ * */
+void CommandAllocs::record(const std::string &command, uint64_t count,
+                           uint64_t bytes) {
+    std::string_view verb(command);
+    verb = verb.substr(0, verb.find(' '));
+
+    auto totals = this->m_verbs.find(verb);
+    if (totals == this->m_verbs.end()) {
+        totals = this->m_verbs.find(std::string_view(CommandStats::INVALID_VERB));
+    }
+    totals->second.add(count, bytes);
+}
+
+/** Accounts the allocations of an engine phase.
+ *
+ * @param phase The phase.
+ * @param count The number of allocations.
+ * @param bytes The number of bytes allocated.
+ * */
+void CommandAllocs::recordPhase(EnginePhase phase, uint64_t count, uint64_t bytes) {
+    this->m_phases[phase].add(count, bytes);
+}
+
+//////////
+// Getters
+/** Gets the allocations of a verb.
+ *
+ * @param verb The verb.
+ * @return The allocations, nullptr if the verb wasn't added.
+ * */
+const AllocTotals* CommandAllocs::getVerb(const std::string &verb) const {
+    auto totals = this->m_verbs.find(verb);
+    if (totals == this->m_verbs.end()) {
+        return nullptr;
+    }
+    return &totals->second;
+}
+
+/** Gets the allocations of an engine phase.
+ *
+ * @param phase The phase.
+ * @return The allocations.
+ * */
+const AllocTotals& CommandAllocs::getPhase(EnginePhase phase) const {
+    return this->m_phases[phase];
+}
+
+/** Overloaded operator to print the allocations.
+ *
+ * Prints the allocations of every phase and of every verb that was used.
+ *
+ * @param out The output stream.
+ * @param cls The class iteself.
+ *
+ * @return The new output stream.
+ * */
+std::ostream& operator << (std::ostream &out, const CommandAllocs &cls) {
+    out << "Allocations:" << std::endl;
+    out << std::left << std::setw(14) << "verb/phase" << std::right
+        << std::setw(8) << "samples" << std::setw(10) << "allocs"
+        << std::setw(12) << "bytes" << std::setw(10) << "max" << std::endl;
+
+    for (int phase = 0; phase < ENGINE_PHASES; phase++) {
+        printAllocRow(out, PHASE_NAMES[phase], cls.m_phases[phase]);
+    }
+    for (const auto &verb: cls.m_verbs) {
+        if (verb.second.samples == 0) {
+            continue;
+        }
+        printAllocRow(out, verb.first, verb.second);
+    }
+    return out;
+}
@@ -0,0 +1,316 @@
+#ifndef COMMAND_STATS_H_
+#define COMMAND_STATS_H_
+
+/** @file command-stats.h
+ *
+ * Header file containing the latency histograms and allocation totals of
+ * the commands processed by the game engine.
+ * */
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** A fixed size histogram of latencies with logarithmic buckets.
+ *
+ * Values below 8 have their own bucket. Above that every power of two is
+ * split into 8 buckets, so a recorded value is off by at most 12.5%.
+ * */
+class LatencyHistogram {
+        public:
+                /** Number of buckets of the histogram. */
+                static constexpr int BUCKETS = 62 * 8;
+
+                /** Records a latency.
+                 *
+                 * @param ns The latency in nanoseconds.
+                 * */
+                void record(uint64_t ns);
+
+                //////////
+                // Getters
+                /** Gets the number of recorded latencies.
+                 *
+                 * @return The number of recorded latencies.
+                 * */
+                uint64_t count(void) const;
+                /** Gets the largest recorded latency.
+                 *
+                 * @return The largest recorded latency in nanoseconds.
+                 * */
+                uint64_t max(void) const;
+                /** Gets a percentile of the recorded latencies.
+                 *
+                 * @param percentile The percentile, between 0 and 100.
+                 * @return The upper bound of the bucket of the percentile in
+                 * nanoseconds, 0 if nothing was recorded.
+                 * */
+                uint64_t percentile(double percentile) const;
+                /** Gets the bucket of a value.
+                 *
+                 * @param value The value.
+                 * @return The index of the bucket.
+                 * */
+                static int bucketOf(uint64_t value);
+                /** Gets the largest value of a bucket.
+                 *
+                 * @param bucket The index of the bucket.
+                 * @return The largest value in the bucket.
+                 * */
+                static uint64_t bucketUpperBound(int bucket);
+        private:
+                uint32_t m_buckets[BUCKETS] = {}; /**<Count of each bucket. */
+                uint64_t m_count = 0; /**<Number of recorded values. */
+                uint64_t m_max = 0; /**<Largest recorded value. */
+};
+
+/** Latency histograms of the commands keyed by their verb.
+ *
+ * The verb is the first word of a command. Histograms are only created
+ * when a verb is added, commands with an unknown verb are recorded under
+ * INVALID_VERB so the memory used doesn't depend on the input. The engine
+ * keeps one for all the games run on a thread.
+ * */
+class CommandStats {
+        public:
+                /** The verb unknown commands are recorded as. */
+                static const char *const INVALID_VERB;
+
+                /** Constructor for CommandStats. */
+                CommandStats(void);
+
+                /** Adds a verb to keep a histogram of.
+                 *
+                 * Adding a verb again keeps its histogram and allocates
+                 * nothing.
+                 *
+                 * @param verb The verb, in lower case.
+                 * */
+                void addVerb(const std::string &verb);
+                /** Records the latency of a command.
+                 *
+                 * @param command The command, in lower case.
+                 * @param ns The latency in nanoseconds.
+                 * */
+                void record(const std::string &command, uint64_t ns);
+                /** Gets the histogram of a verb.
+                 *
+                 * @param verb The verb.
+                 * @return The histogram, nullptr if the verb wasn't added.
+                 * */
+                const LatencyHistogram* getHistogram(const std::string &verb) const;
+
+                ////////////
+                // Operators
+                /** Overloaded operator to print the statistics.
+                 *
+                 * Prints the count, p50, p90, p99 and max latency of every
+                 * verb that was used.
+                 *
+                 * @param out The output stream.
+                 * @param cls The class iteself.
+                 *
+                 * @return The new output stream.
+                 * */
+                friend std::ostream& operator << (std::ostream &out, const CommandStats &cls);
+        private:
+                /** The histograms of each verb. */
+                std::map<std::string, LatencyHistogram, std::less<>> m_histograms;
+};
+
+/** Latencies of the commands of a single game keyed by their verb.
+ *
+ * The latencies are counted in the buckets of LatencyHistogram, but only
+ * the buckets a verb used are kept, sorted by verb and bucket. A game
+ * touches a few buckets per verb, so this takes a few hundred bytes where
+ * a CommandStats takes 2 KB per verb. Recording only allocates when a new
+ * bucket doesn't fit in the reserved ones.
+ * */
+class GameLatencies {
+        public:
+                /** Constructor for GameLatencies.
+                 *
+                 * Room for 32 verbs is reserved as well.
+                 *
+                 * @param capacity The number of buckets to reserve.
+                 * */
+                GameLatencies(size_t capacity = 64);
+
+                /** Adds a verb to keep the latencies of.
+                 *
+                 * Adding a verb again does nothing.
+                 *
+                 * @param verb The verb, in lower case.
+                 * */
+                void addVerb(const std::string &verb);
+                /** Records the latency of a command.
+                 *
+                 * @param command The command, in lower case.
+                 * @param ns The latency in nanoseconds.
+                 * */
+                void record(const std::string &command, uint64_t ns);
+
+                //////////
+                // Getters
+                /** Gets the number of recorded latencies of a verb.
+                 *
+                 * @param verb The verb.
+                 * @return The number of latencies, 0 if the verb wasn't
+                 * added.
+                 * */
+                uint64_t count(const std::string &verb) const;
+                /** Gets a percentile of the recorded latencies of a verb.
+                 *
+                 * @param verb The verb.
+                 * @param percentile The percentile, between 0 and 100.
+                 * @return The same as LatencyHistogram::percentile() for the
+                 * latencies of the verb, 0 if nothing was recorded.
+                 * */
+                uint64_t percentile(const std::string &verb, double percentile) const;
+
+                ////////////
+                // Operators
+                /** Overloaded operator to print the latencies.
+                 *
+                 * Prints the same table as CommandStats for the verbs the
+                 * game used.
+                 *
+                 * @param out The output stream.
+                 * @param cls The class iteself.
+                 *
+                 * @return The new output stream.
+                 * */
+                friend std::ostream& operator << (std::ostream &out, const GameLatencies &cls);
+        private:
+                /** A verb and the largest latency recorded for it. */
+                struct Verb {
+                        std::string name; /**<The verb. */
+                        uint64_t max; /**<Largest recorded latency. */
+                };
+                /** The count of a bucket of a verb. */
+                struct Bucket {
+                        uint16_t verb; /**<Index of the verb. */
+                        uint16_t bucket; /**<Index of the LatencyHistogram bucket. */
+                        uint32_t count; /**<Number of recorded latencies. */
+                };
+
+                /** Finds a verb.
+                 *
+                 * @param verb The verb.
+                 * @return The index of the verb, or of INVALID_VERB if the
+                 * verb wasn't added.
+                 * */
+                size_t find(std::string_view verb) const;
+                /** Gets a percentile of the latencies of a verb.
+                 *
+                 * @param verb The index of the verb.
+                 * @param percentile The percentile, between 0 and 100.
+                 * @return The upper bound of the bucket of the percentile.
+                 * */
+                uint64_t verbPercentile(size_t verb, double percentile) const;
+                /** Gets the number of recorded latencies of a verb.
+                 *
+                 * @param verb The index of the verb.
+                 * @return The number of latencies.
+                 * */
+                uint64_t verbCount(size_t verb) const;
+
+                std::vector<Verb> m_verbs; /**<The verbs, sorted. */
+                std::vector<Bucket> m_buckets; /**<The used buckets, sorted. */
+};
+
+/** Phases of the game engine allocations are accounted to. */
+enum EnginePhase {
+SETUP_PHASE, /**<From constructing the engine until the first command. */
+INPUT_PHASE, /**<Reading and storing the commands. */
+DISPATCH_PHASE, /**<Processing the commands. */
+END_PHASE, /**<Ending the game. */
+ENGINE_PHASES /**<Number of phases. */
+};
+
+/** Allocations accounted to a verb or a phase. */
+struct AllocTotals {
+        uint64_t samples = 0; /**<Number of times it was accounted. */
+        uint64_t count = 0; /**<Total number of allocations. */
+        uint64_t bytes = 0; /**<Total number of bytes allocated. */
+        uint64_t max_count = 0; /**<Most allocations of a single sample. */
+
+        /** Accounts a sample.
+         *
+         * @param count The number of allocations of the sample.
+         * @param bytes The number of bytes allocated by the sample.
+         * */
+        void add(uint64_t count, uint64_t bytes);
+};
+
+/** Allocations of the commands keyed by their verb and of the engine
+ * phases.
+ *
+ * The verbs are handled the same way as CommandStats. Accounting never
+ * allocates, so it doesn't change what it measures.
+ * */
+class CommandAllocs {
+        public:
+                /** Constructor for CommandAllocs. */
+                CommandAllocs(void);
+
+                /** Adds a verb to account allocations to.
+                 *
+                 * @param verb The verb, in lower case.
+                 * */
+                void addVerb(const std::string &verb);
+                /** Accounts the allocations of a processed command.
+                 *
+                 * @param command The command, in lower case.
+                 * @param count The number of allocations.
+                 * @param bytes The number of bytes allocated.
+                 * */
+                void record(const std::string &command, uint64_t count,
+                            uint64_t bytes);
+                /** Accounts the allocations of an engine phase.
+                 *
+                 * @param phase The phase.
+                 * @param count The number of allocations.
+                 * @param bytes The number of bytes allocated.
+                 * */
+                void recordPhase(EnginePhase phase, uint64_t count, uint64_t bytes);
+
+                //////////
+                // Getters
+                /** Gets the allocations of a verb.
+                 *
+                 * @param verb The verb.
+                 * @return The allocations, nullptr if the verb wasn't added.
+                 * */
+                const AllocTotals* getVerb(const std::string &verb) const;
+                /** Gets the allocations of an engine phase.
+                 *
+                 * @param phase The phase.
+                 * @return The allocations.
+                 * */
+                const AllocTotals& getPhase(EnginePhase phase) const;
+
+                ////////////
+                // Operators
+                /** Overloaded operator to print the allocations.
+                 *
+                 * Prints the allocations of every phase and of every verb
+                 * that was used.
+                 *
+                 * @param out The output stream.
+                 * @param cls The class iteself.
+                 *
+                 * @return The new output stream.
+                 * */
+                friend std::ostream& operator << (std::ostream &out, const CommandAllocs &cls);
+        private:
+                /** The allocations of each verb. */
+                std::map<std::string, AllocTotals, std::less<>> m_verbs;
+                /** The allocations of each phase. */
+                AllocTotals m_phases[ENGINE_PHASES];
+};
+
+#endif // COMMAND_STATS_H_
@@ -1,9 +1,8 @@
 #include "enemies.h"
 
-#include <algorithm>
-#include <memory>
-
+#include "ascii-fold.h"
 #include "generics.h"
+#include "world.h"
 
 ///////////////
 // GenericEnemy
@@ -15,12 +14,25 @@
  * @param item The item the monster is protecting.
  * */
 GenericEnemy::GenericEnemy(int health, int damage, std::string name,
-                           std::shared_ptr<GenericItem> item): GenericEntity(health, damage),
+                           ItemHandle item):
+    GenericEnemy(GENERIC_ENEMY, health, damage, name, item) {
+
+}
+
+/** Constructor used by the subclasses to set their kind.
+ *
+ * @param kind The kind of the enemy.
+ * @param health The health of the monster.
+ * @param damage The damage of the monster.
+ * @param name The name of the enemy.
+ * @param item The item the monster is protecting.
+ * */
+GenericEnemy::GenericEnemy(EnemyKind kind, int health, int damage, std::string name,
+                           ItemHandle item): GenericEntity(health, damage),
                                                                m_prot_item(item),
-                                                               m_name(name) {
-    if (item != nullptr) {
-        this->m_prot_item->disallowPickup();
-    }
+                                                               m_name(name),
+                                                               m_kind(kind) {
+
 }
 
 //////////
@@ -29,6 +41,56 @@ std::string GenericEnemy::getName(void) const {
     return this->m_name;
 }
 
+/** Gets the concrete kind of the enemy.
+ *
+ * @return The kind of the enemy.
+ * @see EnemyKind
+ * */
+EnemyKind GenericEnemy::getKind(void) const {
+    return this->m_kind;
+}
+
+/** Gets the item the enemy is protecting.
+ *
+ * @return The handle of the item, a null handle if the enemy isn't
+ * protecting an item.
+ * */
+ItemHandle GenericEnemy::getProtectedItem(void) const {
+    return this->m_prot_item;
+}
+
+//////////
+// Setters
+/** Sets the world the enemy lives in.
+ *
+ * This is called by World::createEnemy() and makes the protected item
+ * unable to be picked up.
+ *
+ * @param world The world owning the enemy.
+ * */
+void GenericEnemy::setWorld(World *world) {
+    this->m_world = world;
+
+    GenericItem *item = this->m_world->getItem(this->m_prot_item);
+    if (item != nullptr) {
+        item->disallowPickup();
+    }
+}
+
+/////////
+// Others
+/** Modifies the damage dealt to the enemy by an attacker.
+ *
+ * A GenericEnemy takes the damage unchanged.
+ *
+ * @param damage The damage of the attacker.
+ * @param inventory The inventory of the attacker.
+ * @return The damage the enemy will take.
+ * */
+int GenericEnemy::modifyDamage(int damage, Inventory *inventory) {
+    return damage;
+}
+
 ////////////////////
 // Callbacks "slots"
 /** Callback function to call when the entity died.
@@ -36,8 +98,13 @@ std::string GenericEnemy::getName(void) const {
  * Overriden to allow the protected item to be pickedup.
  * */
 void GenericEnemy::onDeath(void) {
-    if (this->m_prot_item != nullptr) {
-        this->m_prot_item->allowPickup();
+    if (this->m_world == nullptr) {
+        return;
+    }
+
+    GenericItem *item = this->m_world->getItem(this->m_prot_item);
+    if (item != nullptr) {
+        item->allowPickup();
     }
 }
 
@@ -63,8 +130,8 @@ std::ostream& operator << (std::ostream &out, const GenericEnemy &cls) {
  * @note This operator compares the name of the enemy and it is not case
  * sensitive.
  * */
-bool GenericEnemy::operator == (GenericEnemy other) const {
-    return *this == other.getName();
+bool GenericEnemy::operator == (const GenericEnemy &other) const {
+    return *this == other.m_name;
 }
 
 /** Checks if the enemies are the same.
@@ -77,22 +144,8 @@ bool GenericEnemy::operator == (GenericEnemy other) const {
  * @note This operator compares the name of the enemy and it is not case
  * sensitive.
  * */
-bool GenericEnemy::operator == (std::string other) const {
-    // Converting to lower case
-    std::string this_lower = this->getName();
-    std::string other_lower = other;
-
-    std::transform(this_lower.begin(), this_lower.end(),
-                   this_lower.begin(), ::tolower);
-    std::transform(other.begin(), other.end(),
-                   other_lower.begin(), ::tolower);
-
-    // Doing check
-    if (this_lower == other_lower) {
-        return true;
-    } else {
-        return false;
-    }
+bool GenericEnemy::operator == (const std::string &other) const {
+    return equalsFolded(this->m_name, other);
 }
 
 ///////////
@@ -105,8 +158,8 @@ bool GenericEnemy::operator == (std::string other) const {
  * @param item The item the monster is protecting.
  * */
 Werewolf::Werewolf(int health, int damage, std::string name,
-                   std::shared_ptr<GenericItem> item):
-    GenericEnemy(health, damage, name, item) {
+                   ItemHandle item):
+    GenericEnemy(WEREWOLF, health, damage, name, item) {
 
 }
 
@@ -118,6 +171,19 @@ Werewolf::Werewolf(int health, int damage, std::string name,
  * @param inventory The inventory of the damaging entity.
  * */
 int Werewolf::takeDamage(int damage, Inventory *inventory) {
+    return GenericEnemy::takeDamage(Werewolf::modifyDamage(damage, inventory),
+                                    inventory);
+}
+
+/** Modifies the damage dealt to the werewolf by an attacker.
+ *
+ * Each silver spear in the attacker's inventory adds 3 damage.
+ *
+ * @param damage The damage of the attacker.
+ * @param inventory The inventory of the attacker.
+ * @return The damage the werewolf will take.
+ * */
+int Werewolf::modifyDamage(int damage, Inventory *inventory) {
     // Checking for silver spears
     for (unsigned int i = 0; i < inventory->maxSize(); i++) {
         GenericItem *item = inventory->getItem(i);
@@ -131,7 +197,7 @@ int Werewolf::takeDamage(int damage, Inventory *inventory) {
         }
     }
 
-    return GenericEnemy::takeDamage(damage, inventory);
+    return damage;
 }
 
 //////////
@@ -144,8 +210,8 @@ int Werewolf::takeDamage(int damage, Inventory *inventory) {
  * @param item The item the monster is protecting.
  * */
 Vampire::Vampire(int health, int damage, std::string name,
-                 std::shared_ptr<GenericItem> item):
-    GenericEnemy(health, damage, name, item) {
+                 ItemHandle item):
+    GenericEnemy(VAMPIRE, health, damage, name, item) {
 
 }
 
@@ -157,6 +223,20 @@ Vampire::Vampire(int health, int damage, std::string name,
  * @param inventory The inventory of the damaging entity.
  * */
 int Vampire::takeDamage(int damage, Inventory *inventory) {
+    return GenericEnemy::takeDamage(Vampire::modifyDamage(damage, inventory),
+                                    inventory);
+}
+
+/** Modifies the damage dealt to the vampire by an attacker.
+ *
+ * Each sword in the attacker's inventory removes 1 damage and each
+ * diamond cross adds 4 damage.
+ *
+ * @param damage The damage of the attacker.
+ * @param inventory The inventory of the attacker.
+ * @return The damage the vampire will take.
+ * */
+int Vampire::modifyDamage(int damage, Inventory *inventory) {
     // Reducing damage from swords and checking for diamond cross
     for (unsigned int i = 0; i < inventory->maxSize(); i++) {
         GenericItem *item = inventory->getItem(i);
@@ -173,5 +253,5 @@ int Vampire::takeDamage(int damage, Inventory *inventory) {
         }
     }
 
-    return GenericEnemy::takeDamage(damage, inventory);
+    return damage;
 }
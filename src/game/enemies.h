@@ -2,10 +2,21 @@
 #define MONSTERS_H_
 
 #include <string>
-#include <memory>
 
 #include "generics.h"
 #include "player.h"
+#include "world.h"
+
+/** Enumeration of the concrete enemy classes.
+ *
+ * The set of enemies is closed so the combat code can dispatch on the kind
+ * instead of going through virtual calls.
+ * */
+enum EnemyKind {
+GENERIC_ENEMY, /**<A GenericEnemy. */
+WEREWOLF, /**<A Werewolf. */
+VAMPIRE /**<A Vampire. */
+};
 
 /** A class representing an enemy the player have to fight. */
 class GenericEnemy: public GenericEntity {
@@ -18,7 +29,7 @@ class GenericEnemy: public GenericEntity {
                  * @param item The item the monster is protecting.
                  * */
                 GenericEnemy(int health = 5, int damage = 1, std::string name = "",
-                             std::shared_ptr<GenericItem> item = nullptr);
+                             ItemHandle item = nullptr);
 
                 //////////
                 // Getters
@@ -27,6 +38,41 @@ class GenericEnemy: public GenericEntity {
                  * @return The name of the enemy.
                  * */
                 std::string getName(void) const;
+                /** Gets the concrete kind of the enemy.
+                 *
+                 * @return The kind of the enemy.
+                 * @see EnemyKind
+                 * */
+                EnemyKind getKind(void) const;
+                /** Gets the item the enemy is protecting.
+                 *
+                 * @return The handle of the item, a null handle if the enemy
+                 * isn't protecting an item.
+                 * */
+                ItemHandle getProtectedItem(void) const;
+
+                //////////
+                // Setters
+                /** Sets the world the enemy lives in.
+                 *
+                 * This is called by World::createEnemy() and makes the
+                 * protected item unable to be picked up.
+                 *
+                 * @param world The world owning the enemy.
+                 * */
+                void setWorld(World *world);
+
+                /////////
+                // Others
+                /** Modifies the damage dealt to the enemy by an attacker.
+                 *
+                 * A GenericEnemy takes the damage unchanged.
+                 *
+                 * @param damage The damage of the attacker.
+                 * @param inventory The inventory of the attacker.
+                 * @return The damage the enemy will take.
+                 * */
+                static int modifyDamage(int damage, Inventory *inventory);
 
                 ////////////////////
                 // Callbacks "slots"
@@ -55,7 +101,7 @@ class GenericEnemy: public GenericEntity {
                  * @note This operator compares the name of the enemy and
                  * it is not case sensitive.
                  * */
-                virtual bool operator == (GenericEnemy other) const;
+                virtual bool operator == (const GenericEnemy &other) const;
                 /** Checks if the enemies are the same.
                  *
                  * @overload
@@ -66,11 +112,23 @@ class GenericEnemy: public GenericEntity {
                  * @note This operator compares the name of the enemy and
                  * it is not case sensitive.
                  * */
-                virtual bool operator == (std::string other) const;
+                virtual bool operator == (const std::string &other) const;
+        protected:
+                /** Constructor used by the subclasses to set their kind.
+                 *
+                 * @param kind The kind of the enemy.
+                 * @param health The health of the monster.
+                 * @param damage The damage of the monster.
+                 * @param name The name of the enemy.
+                 * @param item The item the monster is protecting.
+                 * */
+                GenericEnemy(EnemyKind kind, int health, int damage, std::string name,
+                             ItemHandle item);
         private:
-                /**The item the monster is protecting. */
-                std::shared_ptr<GenericItem> m_prot_item = nullptr;
+                ItemHandle m_prot_item = nullptr; /**<The item the monster is protecting. */
+                World *m_world = nullptr; /**<The world owning the enemy. */
                 std::string m_name = ""; /**<The name of the enemy. */
+                EnemyKind m_kind = GENERIC_ENEMY; /**<The kind of the enemy. */
 };
 
 /** Class representing a werewolf enemy.
@@ -88,7 +146,7 @@ class Werewolf: public GenericEnemy {
                  * @param item The item the monster is protecting.
                  * */
                 Werewolf(int health = 12, int damage = 2, std::string name = "",
-                         std::shared_ptr<GenericItem> item = nullptr);
+                         ItemHandle item = nullptr);
                 /** Deal damage to the entity.
                  *
                  * Overriden to take damage according to the monster.
@@ -97,6 +155,15 @@ class Werewolf: public GenericEnemy {
                  * @param inventory The inventory of the damaging entity.
                  * */
                 virtual int takeDamage(int damage, Inventory *inventory) override;
+                /** Modifies the damage dealt to the werewolf by an attacker.
+                 *
+                 * Each silver spear in the attacker's inventory adds 3 damage.
+                 *
+                 * @param damage The damage of the attacker.
+                 * @param inventory The inventory of the attacker.
+                 * @return The damage the werewolf will take.
+                 * */
+                static int modifyDamage(int damage, Inventory *inventory);
 };
 
 /** Class representing a vampire enemy.
@@ -115,7 +182,7 @@ class Vampire: public GenericEnemy {
          * @param item The item the monster is protecting.
          * */
         Vampire(int health = 12, int damage = 3, std::string name = "",
-                std::shared_ptr<GenericItem> item = nullptr);
+                ItemHandle item = nullptr);
         /** Deal damage to the entity.
          *
          * Overriden to take damage according to the monster.
@@ -124,6 +191,16 @@ class Vampire: public GenericEnemy {
          * @param inventory The inventory of the damaging entity.
          * */
         virtual int takeDamage(int damage, Inventory *inventory) override;
+        /** Modifies the damage dealt to the vampire by an attacker.
+         *
+         * Each sword in the attacker's inventory removes 1 damage and each
+         * diamond cross adds 4 damage.
+         *
+         * @param damage The damage of the attacker.
+         * @param inventory The inventory of the attacker.
+         * @return The damage the vampire will take.
+         * */
+        static int modifyDamage(int damage, Inventory *inventory);
 };
 
 #endif // MONSTERS_H_
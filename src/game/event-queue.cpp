@@ -0,0 +1,55 @@
+#include "event-queue.h"
+
+#include <iterator>
+#include <utility>
+
+/** Renders the text of an event.
+ *
+ * @param text The text.
+ * @return The buffer holding the text.
+ * */
+EventBuffer makeEvent(std::string text) {
+    return std::make_shared<const std::string>(std::move(text));
+}
+
+///////////////
+// EventQueue
+/** Adds an event.
+ *
+ * @param event The event, shared with the other recipients.
+ * */
+void EventQueue::push(const EventBuffer &event) {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    this->m_events.push_back(event);
+}
+
+/** Takes every event waiting.
+ *
+ * @param events Where the events are appended, in the order they were
+ * pushed.
+ * @return The number of events taken.
+ * */
+size_t EventQueue::drain(std::vector<EventBuffer> &events) {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    size_t count = this->m_events.size();
+    if (events.empty()) {
+        // Keeping the capacity of both vectors
+        events.swap(this->m_events);
+    } else {
+        events.insert(events.end(), std::make_move_iterator(this->m_events.begin()),
+                      std::make_move_iterator(this->m_events.end()));
+    }
+    this->m_events.clear();
+    return count;
+}
+
+//////////
+// Getters
+/** Gets the number of events waiting.
+ *
+ * @return The number of events.
+ * */
+size_t EventQueue::size(void) const {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return this->m_events.size();
+}
@@ -0,0 +1,61 @@
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+/** @file event-queue.h
+ *
+ * Header file containing the events announced to the players in a room.
+ *
+ * An event is rendered once into an immutable buffer shared by every
+ * recipient, so announcing it to a crowded room only pushes one pointer per
+ * player.
+ * */
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Immutable text of an event, shared by everyone it is sent to. */
+using EventBuffer = std::shared_ptr<const std::string>;
+
+/** Renders the text of an event.
+ *
+ * @param text The text.
+ * @return The buffer holding the text.
+ * */
+EventBuffer makeEvent(std::string text);
+
+/** The events waiting to be read by one player.
+ *
+ * Events may be pushed from any thread, they are taken by the thread
+ * serving the player.
+ * */
+class EventQueue {
+        public:
+                /** Adds an event.
+                 *
+                 * @param event The event, shared with the other recipients.
+                 * */
+                void push(const EventBuffer &event);
+                /** Takes every event waiting.
+                 *
+                 * @param events Where the events are appended, in the order
+                 * they were pushed.
+                 * @return The number of events taken.
+                 * */
+                size_t drain(std::vector<EventBuffer> &events);
+
+                //////////
+                // Getters
+                /** Gets the number of events waiting.
+                 *
+                 * @return The number of events.
+                 * */
+                size_t size(void) const;
+        private:
+                mutable std::mutex m_mutex; /**<Guards m_events. */
+                std::vector<EventBuffer> m_events; /**<Events waiting. */
+};
+
+#endif // EVENT_QUEUE_H_
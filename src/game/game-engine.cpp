@@ -3,10 +3,73 @@
 #include <iostream>
 #include <exception>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "ascii-fold.h"
+#include "json-record.h"
+#include "trace.h"
+#include "object-pool.h"
+
+/** Latency statistics of the commands processed on a thread. */
+struct ThreadStats {
+    CommandStats stats; /**<The statistics. */
+    uint64_t serial; /**<Number of the thread, never reused. */
+};
+
+/** Gets the latency statistics of the commands processed on the calling
+ * thread.
+ *
+ * The full histograms are kept per thread rather than per game, so a
+ * server running many sessions keeps one histogram per verb, and no lock
+ * is taken to record a command. Each game only keeps the buckets it used.
+ *
+ * @return The statistics of the thread.
+ * */
+static ThreadStats& threadStats(void) {
+    static std::atomic<uint64_t> serials{0};
+    thread_local ThreadStats stats{CommandStats(), ++serials};
+    return stats;
+}
 
 /** Deafult constructor for HKGE. */
 HKGE::HKGE(void) {
+    for (auto command: this->m_commands) {
+        this->m_verbs.insert(command.first);
+        this->m_latencies.addVerb(command.first);
+#ifdef GAME_ALLOC_TRACKING
+        this->m_allocs.addVerb(command.first);
+#endif
+    }
+    // Hidden commands
+    this->m_verbs.insert("stats");
+    this->m_argument_verbs.insert("complete");
+    this->m_argument_verbs.insert("format");
+    this->m_latencies.addVerb("stats");
+    this->m_latencies.addVerb("complete");
+    this->m_latencies.addVerb("format");
+#ifdef GAME_ALLOC_TRACKING
+    this->m_allocs.addVerb("stats");
+    this->m_allocs.addVerb("complete");
+    this->m_allocs.addVerb("format");
+#endif
+#ifdef GAME_TRACING
+    this->m_verbs.insert("trace");
+    this->m_latencies.addVerb("trace");
+    // Creating the trace buffer of the thread before the first span
+    threadTraceBuffer();
+#endif
+    this->useThreadStats();
+}
+
+/** Destructor for HKGE, removes the player from the InterestMap it is in. */
+HKGE::~HKGE(void) {
+    this->setInterest(nullptr, nullptr);
 }
 
 /** Starts the adventure game.
@@ -14,25 +77,173 @@ HKGE::HKGE(void) {
  * @return The exit status of the game.
  */
 int HKGE::start(void) {
-    while (this->getCommand() > 0) {
-        GameStatus status = this->processCommand();
+    while (true) {
+#ifdef GAME_ALLOC_TRACKING
+        AllocStats before = allocStats();
+#endif
+        if (this->getCommand() <= 0) {
+            break;
+        }
+#ifdef GAME_ALLOC_TRACKING
+        this->accountPhase(INPUT_PHASE, before);
+#endif
+
+        GameStatus status = this->dispatchBatch();
         if (status != GameStatus::CONTINUE) {
+#ifdef GAME_ALLOC_TRACKING
+            before = allocStats();
+            this->endGame(status);
+            this->accountPhase(END_PHASE, before);
+            std::cerr << this->m_allocs;
+#else
             this->endGame(status);
+#endif
             break;
         }
     }
     return 0;
 }
 
+/** Runs a command as if it was typed in by the user.
+ *
+ * The command goes through the same handling as a typed command but
+ * endGame() isn't called.
+ *
+ * @param command The command to run, or several separated by ';'.
+ * @return The status of the game after the command.
+ *
+ * @see GameStatus
+ * */
+GameStatus HKGE::runCommand(std::string command) {
+#ifdef GAME_ALLOC_TRACKING
+    AllocStats before = allocStats();
+    this->inputCommand(command);
+    this->accountPhase(INPUT_PHASE, before);
+#else
+    this->inputCommand(command);
+#endif
+    return this->dispatchBatch();
+}
+
+/** Ends a game driven by runCommand().
+ *
+ * Calls endGame() like start() does when a command ends the game.
+ *
+ * @param status The status of the game.
+ *
+ * @see GameStatus
+ * */
+void HKGE::finish(GameStatus status) {
+    this->endGame(status);
+}
+
+/** Runs a command read from a transcript.
+ *
+ * The command was expanded when it was recorded, so it is dispatched
+ * without being parsed again. endGame() isn't called.
+ *
+ * @param entry The command.
+ * @return The status of the game after the command.
+ *
+ * @see GameStatus
+ * */
+GameStatus HKGE::replayCommand(const TranscriptEntry &entry) {
+    // Reusing the buffer of the current command
+    this->m_command.clear();
+    if (entry.verb != nullptr) {
+        this->m_command += *entry.verb;
+        if (entry.argument != nullptr) {
+            this->m_command += ' ';
+        }
+    }
+    if (entry.argument != nullptr) {
+        this->m_command += *entry.argument;
+    }
+    this->replayedCommand();
+    return this->dispatchCommand();
+}
+
+/** Gets the completions of a partly typed command.
+ *
+ * Without a space the command is completed to the verbs, after a verb
+ * taking an argument the argument is completed to the names given by
+ * getArgumentNames().
+ *
+ * @param prefix The partly typed command.
+ * @return The completed commands in alphabetical order.
+ * */
+std::vector<std::string> HKGE::complete(std::string prefix) {
+    foldCase(prefix);
+    std::vector<std::string> completions;
+    this->m_verbs.complete(prefix, completions);
+
+    size_t space = prefix.find(' ');
+    if (space == std::string::npos) {
+        this->m_argument_verbs.complete(prefix, completions);
+    } else {
+        // Completing the argument of the verb
+        std::string verb;
+        std::string_view argument(prefix);
+        argument.remove_prefix(space + 1);
+        const PrefixTrie *names = nullptr;
+        if (this->m_argument_verbs.resolve(std::string_view(prefix).substr(0, space), verb)) {
+            names = this->getArgumentNames(verb);
+        }
+        if (names != nullptr) {
+            std::vector<std::string> arguments;
+            names->complete(argument, arguments);
+            for (const std::string &name: arguments) {
+                completions.push_back(verb + " " + name);
+            }
+        }
+    }
+
+    std::sort(completions.begin(), completions.end());
+    return completions;
+}
+
+/** Prints the prompt asking for the next command.
+ *
+ * The prompt isn't followed by a new line, in JSON output it is a prompt
+ * record.
+ * */
+void HKGE::printPrompt(void) {
+    if (this->m_format == JSON_OUTPUT) {
+        JsonRecord(this->out(), "prompt");
+        return;
+    }
+    this->out() << "Enter Command (help for help): ";
+}
+
 //////////
 // Setters
 /** Adds a new command the game can handle.
+ *
+ * A command taking an argument is named with the argument in braces, such
+ * as "get {item}".
  *
  * @param name The command name.
  * @param description The description of what the command does.
  */
 void HKGE::addCommand(std::string name, std::string description) {
     this->m_commands.emplace(name, description);
+    size_t argument = name.find(" {");
+    if (argument == std::string::npos) {
+        this->m_verbs.insert(name);
+    } else {
+        this->m_argument_verbs.insert(std::string_view(name).substr(0, argument));
+    }
+
+    // The verb is the first word in lower case
+    std::string verb = name.substr(0, name.find(' '));
+    foldCase(verb);
+    if (this->m_stats_thread == threadStats().serial) {
+        threadStats().stats.addVerb(verb);
+    }
+    this->m_latencies.addVerb(verb);
+#ifdef GAME_ALLOC_TRACKING
+    this->m_allocs.addVerb(verb);
+#endif
 }
 
 /** Adds new commands the game can handle.
@@ -50,7 +261,9 @@ void HKGE::addCommand(std::string name, std::string description) {
  */
 void HKGE::addCommands(std::initializer_list<std::map<std::string,
                        std::string>::value_type> list) {
-    this->m_commands.insert(list);
+    for (auto command: list) {
+        this->addCommand(command.first, command.second);
+    }
 }
 
  /** Adds new commands with the same description.
@@ -100,16 +313,72 @@ void HKGE::setPlayer(Player *player) {
     this->m_player = std::shared_ptr<Player>(player);
 }
 
+/** Sets the stream the game writes its output to.
+ *
+ * @param output The output stream, it must outlive the game.
+ * */
+void HKGE::setOutput(std::ostream *output) {
+    this->m_output = output;
+}
+
 /** Sets the player is in Room.
  *
  * @param room The sets Room the player is in.
  * */
 void HKGE::setRoom(Room *room) {
     this->m_current_room = room;
+    if (this->m_interest != nullptr && room != nullptr) {
+        this->m_interest->move(this->m_events, room);
+    }
+}
+
+/** Sets the InterestMap tracking the rooms the player is interested in.
+ *
+ * The player is removed from the previous map and added to the new one at
+ * the current room.
+ *
+ * @param interest The map, it must outlive the game. nullptr to stop
+ * tracking the player.
+ * @param events The event queue the player is known by in the map.
+ * */
+void HKGE::setInterest(InterestMap *interest, EventQueue *events) {
+    if (this->m_interest != nullptr) {
+        this->m_interest->remove(this->m_events);
+    }
+    this->m_interest = interest;
+    this->m_events = events;
+    if (interest != nullptr && this->m_current_room != nullptr) {
+        interest->move(events, this->m_current_room);
+    }
+}
+
+/** Sets the transcript the processed commands are recorded into.
+ *
+ * @param transcript The transcript, it must outlive the game. nullptr to
+ * stop recording.
+ * */
+void HKGE::setTranscript(TranscriptWriter *transcript) {
+    this->m_transcript = transcript;
+}
+
+/** Sets the format of the output of the game.
+ *
+ * @param format The format.
+ * */
+void HKGE::setOutputFormat(OutputFormat format) {
+    this->m_format = format;
 }
 
 //////////
 // Getters
+/** Gets the stream the game writes its output to.
+ *
+ * @return The output stream, standard output by default.
+ * */
+std::ostream& HKGE::out(void) {
+    return *this->m_output;
+}
+
 /** Gets the Player class of the game.
  *
  * @return The Player class.
@@ -130,29 +399,121 @@ Room* HKGE::getRoom(void) {
  *
  * @return The current command.
  * */
-std::string HKGE::getCurrentCommand(void) {
+const std::string& HKGE::getCurrentCommand(void) const {
     return this->m_command;
 }
 
+/** Gets the verbs of the commands the game can handle.
+ *
+ * @return The verbs in lower case, hidden commands included.
+ * */
+std::vector<std::string> HKGE::getVerbs(void) const {
+    std::vector<std::string> verbs;
+    this->m_verbs.complete("", verbs);
+    this->m_argument_verbs.complete("", verbs);
+    return verbs;
+}
+
+/** Gets the format of the output of the game.
+ *
+ * @return The format, TEXT_OUTPUT by default.
+ * */
+OutputFormat HKGE::getOutputFormat(void) const {
+    return this->m_format;
+}
+
+/** Gets the latencies of the commands processed by the game.
+ *
+ * @return The command latencies.
+ * */
+const GameLatencies& HKGE::getStats(void) const {
+    return this->m_latencies;
+}
+
+/** Gets the latency statistics of the commands processed on the calling
+ * thread, by every game run on it.
+ *
+ * @return The command statistics.
+ * */
+const CommandStats& HKGE::getThreadStats(void) {
+    return threadStats().stats;
+}
+
+#ifdef GAME_ALLOC_TRACKING
+/** Gets the allocations of the processed commands and of the engine
+ * phases.
+ *
+ * Only available in builds with GAME_ALLOC_TRACKING.
+ *
+ * @return The allocation statistics.
+ * */
+const CommandAllocs& HKGE::getAllocs(void) const {
+    return this->m_allocs;
+}
+#endif
+
 ////////////
 // protected
 /** Gets the command from standard input.
  *
- * @return Always 1 indicating success.
+ * @return 1 indicating success, 0 if standard input ended.
  *  */
 int HKGE::getCommand(void) {
-    std::cout << "Enter Command (help for help): ";
-    std::getline(std::cin, this->m_command);
-    std::transform(this->m_command.begin(), this->m_command.end(),
-                   this->m_command.begin(), ::tolower);
+    GAME_TRACE_SCOPE("HKGE::getCommand");
+    std::string command;
+    this->printPrompt();
+    if (!std::getline(std::cin, command)) {
+        return 0;
+    }
+    this->inputCommand(command);
     return 1;
 }
 
+/** Sets the command typed in by the user.
+ *
+ * The command is converted to lower case and an abbreviated command is
+ * expanded.
+ *
+ * @param command The typed in command.
+ *
+ * @see expandCommand
+ * */
+void HKGE::inputCommand(std::string command) {
+    normalizeLine(command);
+    this->expandCommand(command);
+    this->m_command = command;
+}
+
+/** Gets the names an argument of a verb can abbreviate.
+ *
+ * @param verb The verb taking the argument.
+ * @return The names, nullptr if the argument isn't abbreviated.
+ * */
+const PrefixTrie* HKGE::getArgumentNames(const std::string &verb) {
+    return nullptr;
+}
+
+/** Called when a command read from a transcript becomes the current
+ * command, instead of inputCommand().
+ *
+ * Does nothing by default.
+ * */
+void HKGE::replayedCommand(void) {
+}
+
 /** Process the inputted command.
  *
  * Some defaults commands are handled by this function.
  * help: Prints the help message.
  * exit: Exits the game.
+ * stats: Prints the command latencies of the game and of the thread,
+ * allocations and object pools (not shown in help).
+ * trace: Writes the trace spans to trace.json (only in builds with
+ * GAME_TRACING, not shown in help).
+ * complete {prefix}: Prints the completions of a command separated by tabs
+ * (not shown in help).
+ * format {text|json}: Switches the output between text and JSON records
+ * (not shown in help).
  *
  * It also handles if the command is valid or not.
  *
@@ -161,18 +522,70 @@ int HKGE::getCommand(void) {
  * @see GameStatus
  * */
 GameStatus HKGE::processCommand(void) {
+    GAME_TRACE_SCOPE("HKGE::processCommand");
     // Handling Help Command
+    bool json = this->m_format == JSON_OUTPUT;
     if (this->m_command == "help") {
+        if (json) {
+            JsonRecord record(this->out(), "help");
+            record.beginList("commands");
+            for (auto &command: this->m_commands) {
+                record.beginObject().add("name", command.first)
+                    .add("description", command.second).end();
+            }
+            return GameStatus::CONTINUE;
+        }
         for (auto command: this->m_commands) {
-            std::cout << command.first << ": " << command.second << std::endl;
+            this->out() << command.first << ": " << command.second << std::endl;
         }
         return GameStatus::CONTINUE;
     } else if (this->m_command == "exit") { // Exit
         return GameStatus::EXIT;
+    } else if (this->m_command == "stats") { // Statistics
+        this->out() << this->m_latencies << threadStats().stats;
+#ifdef GAME_ALLOC_TRACKING
+        this->out() << this->m_allocs;
+#endif
+        writeObjectPoolStats(this->out());
+        return GameStatus::CONTINUE;
+#ifdef GAME_TRACING
+    } else if (this->m_command == "trace") { // Trace export
+        std::ofstream trace("trace.json");
+        writeChromeTrace(trace);
+        this->out() << "Trace written to trace.json" << std::endl;
+        return GameStatus::CONTINUE;
+#endif
+    } else if (this->m_command.compare(0, 9, "complete ") == 0) { // Completion
+        std::vector<std::string> completions = this->complete(this->m_command.substr(9));
+        if (json) {
+            JsonRecord record(this->out(), "complete");
+            record.beginList("completions");
+            for (const std::string &completion: completions) {
+                record.item(completion);
+            }
+            return GameStatus::CONTINUE;
+        }
+        for (size_t i = 0; i < completions.size(); i++) {
+            this->out() << (i == 0 ? "" : "\t") << completions[i];
+        }
+        this->out() << std::endl;
+        return GameStatus::CONTINUE;
+    } else if (this->m_command == "format text" || this->m_command == "format json") { // Format
+        this->m_format = this->m_command == "format json" ? JSON_OUTPUT : TEXT_OUTPUT;
+        if (this->m_format == JSON_OUTPUT) {
+            JsonRecord(this->out(), "format").add("format", "json");
+        } else {
+            this->out() << "Output format set to text." << std::endl;
+        }
+        return GameStatus::CONTINUE;
     }
 
     // Handling Invalid Command
-    std::cout << "Invalid Command." << std::endl;
+    if (json) {
+        JsonRecord(this->out(), "invalid").add("command", this->m_command);
+        return GameStatus::CONTINUE;
+    }
+    this->out() << "Invalid Command." << std::endl;
     return GameStatus::CONTINUE;
 }
 
@@ -183,9 +596,180 @@ GameStatus HKGE::processCommand(void) {
  * @see GameStatus
  * */
 void HKGE::endGame(GameStatus status) {
+#ifdef GAME_ALLOC_TRACKING
+    std::cerr << this->m_allocs;
+#endif
+    std::cerr << this->m_latencies;
     exit(0);
 }
 
+/////////
+// private
+/** Adds the verbs of the game to the latency statistics of the calling
+ * thread, unless the game already ran on it.
+ * */
+void HKGE::useThreadStats(void) {
+    ThreadStats &thread = threadStats();
+    if (this->m_stats_thread == thread.serial) {
+        return;
+    }
+    for (const auto &command: this->m_commands) {
+        std::string verb = command.first.substr(0, command.first.find(' '));
+        foldCase(verb);
+        thread.stats.addVerb(verb);
+    }
+    // Hidden commands
+    thread.stats.addVerb("stats");
+    thread.stats.addVerb("complete");
+    thread.stats.addVerb("format");
+#ifdef GAME_TRACING
+    thread.stats.addVerb("trace");
+#endif
+    this->m_stats_thread = thread.serial;
+}
+
+/** Expands an abbreviated command.
+ *
+ * A command that exactly matches a command is kept. Otherwise a prefix of
+ * exactly one command without an argument, or a prefix of exactly one verb
+ * taking an argument followed by a prefix of exactly one of its argument
+ * names, is expanded. A prefix of both a command without an argument and a
+ * verb taking one is ambiguous. Anything else is kept as is.
+ *
+ * @param command The command in lower case, it is expanded in place.
+ * */
+void HKGE::expandCommand(std::string &command) {
+    // Batches are expanded command by command
+    if (command.empty() || this->m_verbs.contains(command) ||
+        command.find(';') != std::string::npos) {
+        return;
+    }
+
+    size_t space = command.find(' ');
+    std::string_view verb = std::string_view(command).substr(0, space);
+    if (this->m_verbs.count(command) > 0 &&
+        this->m_argument_verbs.count(verb) > 0) {
+        return;
+    }
+
+    std::string expanded;
+    if (this->m_verbs.resolve(command, expanded)) {
+        command = expanded;
+        return;
+    }
+
+    if (space == std::string::npos) {
+        return;
+    }
+    std::string_view argument = std::string_view(command).substr(space + 1);
+    if (!this->m_argument_verbs.resolve(verb, expanded)) {
+        return;
+    }
+
+    // Expanding the argument
+    const PrefixTrie *names = this->getArgumentNames(expanded);
+    std::string name;
+    if (names != nullptr && !names->contains(argument) &&
+        names->resolve(argument, name)) {
+        command = expanded + " " + name;
+    } else if (expanded.size() != verb.size()) {
+        command = expanded + " " + std::string(argument);
+    }
+}
+
+/** Processes the current command, or each of the commands in it when they
+ * are separated by ';'.
+ *
+ * Batched commands run in order until one doesn't return CONTINUE, empty
+ * ones are skipped. The output of the whole batch is written at once. The
+ * batched commands don't go through the inputCommand() overrides, so an
+ * override remembering the typed line sees the whole batch.
+ *
+ * @return The status of the game after the last command that ran.
+ * */
+GameStatus HKGE::dispatchBatch(void) {
+    if (this->m_command.find(';') == std::string::npos) {
+        return this->dispatchCommand();
+    }
+    GAME_TRACE_SCOPE("HKGE::dispatchBatch");
+
+    // Buffering the output of the batch
+    std::ostringstream batch_output;
+    std::ostream *output = this->m_output;
+    this->m_output = &batch_output;
+
+    std::string batch = this->m_command;
+    GameStatus status = GameStatus::CONTINUE;
+    size_t start = 0;
+    while (start <= batch.size() && status == GameStatus::CONTINUE) {
+        size_t end = batch.find(';', start);
+        if (end == std::string::npos) {
+            end = batch.size();
+        }
+
+        // Trimming the spaces around the command
+        size_t first = batch.find_first_not_of(" \t", start);
+        if (first != std::string::npos && first < end) {
+            size_t last = batch.find_last_not_of(" \t", end - 1);
+            this->HKGE::inputCommand(batch.substr(first, last - first + 1));
+            status = this->dispatchCommand();
+        }
+        start = end + 1;
+    }
+
+    this->m_output = output;
+    *output << batch_output.str() << std::flush;
+    return status;
+}
+
+/** Processes the current command and records its latency.
+ *
+ * @return The status of the game.
+ * */
+GameStatus HKGE::dispatchCommand(void) {
+    GAME_TRACE_SCOPE("HKGE::dispatchCommand");
+#ifdef GAME_ALLOC_TRACKING
+    AllocStats before = allocStats();
+#endif
+    if (this->m_transcript != nullptr) {
+        this->m_transcript->record(this->m_command);
+    }
+    auto start = std::chrono::steady_clock::now();
+    GameStatus status = this->processCommand();
+    auto end = std::chrono::steady_clock::now();
+#ifdef GAME_ALLOC_TRACKING
+    AllocStats allocs = allocDelta(before, allocStats());
+    this->m_allocs.record(this->m_command, allocs.count, allocs.bytes);
+    this->accountPhase(DISPATCH_PHASE, before);
+#endif
+
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    this->m_latencies.record(this->m_command, ns);
+    this->useThreadStats();
+    threadStats().stats.record(this->m_command, ns);
+    return status;
+}
+
+#ifdef GAME_ALLOC_TRACKING
+/** Accounts the allocations made since a snapshot to a phase.
+ *
+ * The setup phase is accounted the first time this is called.
+ *
+ * @param phase The phase.
+ * @param before The snapshot taken when the phase started.
+ * */
+void HKGE::accountPhase(EnginePhase phase, AllocStats before) {
+    if (!this->m_setup_accounted) {
+        // Everything before the first phase belongs to the setup
+        AllocStats setup = allocDelta(this->m_setup_start, before);
+        this->m_allocs.recordPhase(SETUP_PHASE, setup.count, setup.bytes);
+        this->m_setup_accounted = true;
+    }
+    AllocStats allocs = allocDelta(before, allocStats());
+    this->m_allocs.recordPhase(phase, allocs.count, allocs.bytes);
+}
+#endif
+
 /** Sets the current command of the game.
  *
  * @param command The command to set to.
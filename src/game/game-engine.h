@@ -1,13 +1,23 @@
 #ifndef GAME_ENGINE_H_
 #define GAME_ENGINE_H_
 
+#include <iostream>
 #include <map>
+#include <ostream>
 #include <string>
 #include <memory>
 #include <list>
 
 #include "player.h"
 #include "room.h"
+#include "command-stats.h"
+#include "event-queue.h"
+#include "interest-map.h"
+#include "prefix-trie.h"
+#include "transcript.h"
+#ifdef GAME_ALLOC_TRACKING
+#include "alloc-counter.h"
+#endif
 
 /** Status of the game. */
 enum GameStatus {
@@ -17,20 +27,81 @@ EXIT, /**<The user exited the game. */
 CONTINUE /**<Continue the game. */
 };
 
+/** Format of the output of the game. */
+enum OutputFormat {
+TEXT_OUTPUT, /**<Sentences for people to read. */
+JSON_OUTPUT /**<A JSON object per line for bots to parse. */
+};
+
 /** Hong Kai Game Engine used to make adventure games. */
 class HKGE {
         public:
                 /** Deafult constructor for HKGE. */
                 HKGE(void);
+                /** Destructor for HKGE, removes the player from the
+                 * InterestMap it is in. */
+                virtual ~HKGE(void);
                 /** Starts the adventure game.
                  *
                  * @return The exit status of the game.
                  */
                 int start(void);
+                /** Runs a command as if it was typed in by the user.
+                 *
+                 * The command goes through the same handling as a typed
+                 * command but endGame() isn't called.
+                 *
+                 * @param command The command to run, or several separated by
+                 * ';'.
+                 * @return The status of the game after the command.
+                 *
+                 * @see GameStatus
+                 * */
+                GameStatus runCommand(std::string command);
+                /** Ends a game driven by runCommand().
+                 *
+                 * Calls endGame() like start() does when a command ends the
+                 * game.
+                 *
+                 * @param status The status of the game.
+                 *
+                 * @see GameStatus
+                 * */
+                void finish(GameStatus status);
+                /** Runs a command read from a transcript.
+                 *
+                 * The command was expanded when it was recorded, so it is
+                 * dispatched without being parsed again. endGame() isn't
+                 * called.
+                 *
+                 * @param entry The command.
+                 * @return The status of the game after the command.
+                 *
+                 * @see GameStatus
+                 * */
+                GameStatus replayCommand(const TranscriptEntry &entry);
+                /** Gets the completions of a partly typed command.
+                 *
+                 * Without a space the command is completed to the verbs,
+                 * after a verb taking an argument the argument is completed
+                 * to the names given by getArgumentNames().
+                 *
+                 * @param prefix The partly typed command.
+                 * @return The completed commands in alphabetical order.
+                 * */
+                std::vector<std::string> complete(std::string prefix);
+                /** Prints the prompt asking for the next command.
+                 *
+                 * The prompt isn't followed by a new line.
+                 * */
+                void printPrompt(void);
 
                 //////////
                 // Setters
                 /** Adds a new command the game can handle.
+                 *
+                 * A command taking an argument is named with the argument in
+                 * braces, such as "get {item}".
                  *
                  * @param name The command name.
                  * @param description The description of what the command does.
@@ -85,14 +156,50 @@ class HKGE {
                  * @param player The Player class.
                  * */
                 void setPlayer(Player *player);
+                /** Sets the stream the game writes its output to.
+                 *
+                 * @param output The output stream, it must outlive the game.
+                 * */
+                void setOutput(std::ostream *output);
                 /** Sets the player is in Room.
+                 *
+                 * The interest of the player is moved along with it.
                  *
                  * @param room The sets Room the player is in.
                  * */
                 void setRoom(Room *room);
+                /** Sets the InterestMap tracking the rooms the player is
+                 * interested in.
+                 *
+                 * The player is removed from the previous map and added to
+                 * the new one at the current room.
+                 *
+                 * @param interest The map, it must outlive the game. nullptr
+                 * to stop tracking the player.
+                 * @param events The event queue the player is known by in
+                 * the map.
+                 * */
+                void setInterest(InterestMap *interest, EventQueue *events);
+                /** Sets the transcript the processed commands are recorded
+                 * into.
+                 *
+                 * @param transcript The transcript, it must outlive the game.
+                 * nullptr to stop recording.
+                 * */
+                void setTranscript(TranscriptWriter *transcript);
+                /** Sets the format of the output of the game.
+                 *
+                 * @param format The format.
+                 * */
+                void setOutputFormat(OutputFormat format);
 
                 //////////
                 // Getters
+                /** Gets the stream the game writes its output to.
+                 *
+                 * @return The output stream, standard output by default.
+                 * */
+                std::ostream& out(void);
                 /** Gets the Player class of the game.
                  *
                  * @return The Player class.
@@ -107,18 +214,80 @@ class HKGE {
                  *
                  * @return The current command.
                  * */
-                std::string getCurrentCommand(void);
+                const std::string& getCurrentCommand(void) const;
+                /** Gets the verbs of the commands the game can handle.
+                 *
+                 * @return The verbs in lower case, hidden commands included.
+                 * */
+                std::vector<std::string> getVerbs(void) const;
+                /** Gets the format of the output of the game.
+                 *
+                 * @return The format, TEXT_OUTPUT by default.
+                 * */
+                OutputFormat getOutputFormat(void) const;
+                /** Gets the latencies of the commands processed by the
+                 * game.
+                 *
+                 * @return The command latencies.
+                 * */
+                const GameLatencies& getStats(void) const;
+                /** Gets the latency statistics of the commands processed on
+                 * the calling thread, by every game run on it.
+                 *
+                 * @return The command statistics.
+                 * */
+                static const CommandStats& getThreadStats(void);
+#ifdef GAME_ALLOC_TRACKING
+                /** Gets the allocations of the processed commands and of
+                 * the engine phases.
+                 *
+                 * Only available in builds with GAME_ALLOC_TRACKING.
+                 *
+                 * @return The allocation statistics.
+                 * */
+                const CommandAllocs& getAllocs(void) const;
+#endif
         protected:
                 /** Gets the command from standard input.
                  *
-                 * @return Always 1 indicating success.
+                 * @return 1 indicating success, 0 if standard input ended.
                  *  */
                 virtual int getCommand(void);
+                /** Sets the command typed in by the user.
+                 *
+                 * The command is converted to lower case and an abbreviated
+                 * command is expanded.
+                 *
+                 * @param command The typed in command.
+                 *
+                 * @see expandCommand
+                 * */
+                virtual void inputCommand(std::string command);
+                /** Called when a command read from a transcript becomes the
+                 * current command, instead of inputCommand().
+                 *
+                 * Does nothing by default.
+                 * */
+                virtual void replayedCommand(void);
+                /** Gets the names an argument of a verb can abbreviate.
+                 *
+                 * @param verb The verb taking the argument.
+                 * @return The names, nullptr if the argument isn't
+                 * abbreviated.
+                 * */
+                virtual const PrefixTrie* getArgumentNames(const std::string &verb);
                 /** Process the inputted command.
                  *
                  * Some defaults commands are handled by this function.
                  * help: Prints the help message.
                  * exit: Exits the game.
+                 * stats: Prints the command latencies of the game and of
+                 * the thread, allocations and object pools (not shown in
+                 * help).
+                 * trace: Writes the trace spans to trace.json (only in
+                 * builds with GAME_TRACING, not shown in help).
+                 * complete {prefix}: Prints the completions of a command
+                 * separated by tabs (not shown in help).
                  *
                  * It also handles if the command is valid or not.
                  *
@@ -140,13 +309,75 @@ class HKGE {
                  * */
                 void setCurrentCommand(std::string command);
         private:
+                /** Expands an abbreviated command.
+                 *
+                 * A command that exactly matches a command is kept. Otherwise
+                 * a prefix of exactly one command without an argument, or a
+                 * prefix of exactly one verb taking an argument followed by
+                 * a prefix of exactly one of its argument names, is
+                 * expanded. A prefix of both a command without an argument
+                 * and a verb taking one is ambiguous. Anything else is kept
+                 * as is.
+                 *
+                 * @param command The command in lower case, it is expanded
+                 * in place.
+                 * */
+                void expandCommand(std::string &command);
+                /** Adds the verbs of the game to the latency statistics of
+                 * the calling thread, unless the game already ran on it.
+                 * */
+                void useThreadStats(void);
+                /** Processes the current command, or each of the commands in
+                 * it when they are separated by ';'.
+                 *
+                 * Batched commands run in order until one doesn't return
+                 * CONTINUE, empty ones are skipped. The output of the whole
+                 * batch is written at once. The batched commands don't go
+                 * through the inputCommand() overrides, so an override
+                 * remembering the typed line sees the whole batch.
+                 *
+                 * @return The status of the game after the last command that
+                 * ran.
+                 * */
+                GameStatus dispatchBatch(void);
+                /** Processes the current command and records its latency.
+                 *
+                 * @return The status of the game.
+                 * */
+                GameStatus dispatchCommand(void);
+#ifdef GAME_ALLOC_TRACKING
+                /** Accounts the allocations made since a snapshot to a phase.
+                 *
+                 * The setup phase is accounted the first time this is
+                 * called.
+                 *
+                 * @param phase The phase.
+                 * @param before The snapshot taken when the phase started.
+                 * */
+                void accountPhase(EnginePhase phase, AllocStats before);
+
+                /** Allocations when the engine started being constructed. */
+                AllocStats m_setup_start = allocStats();
+                bool m_setup_accounted = false; /**<If the setup phase was accounted. */
+                CommandAllocs m_allocs; /**<Allocations of the processed commands. */
+#endif
+
                 std::string m_command = ""; /**<The current command to the game. */
                 /** A list of avaiable command. */
                 std::map<std::string, std::string> m_commands = {
                 {"help", "Shows the available commands"},
                 {"exit", "Exits the game"}};
+                PrefixTrie m_verbs; /**<Commands without an argument. */
+                PrefixTrie m_argument_verbs; /**<Verbs of commands taking an argument. */
                 Room *m_current_room = nullptr; /**<Current room the player is in. */
+                InterestMap *m_interest = nullptr; /**<Map tracking the player. */
+                EventQueue *m_events = nullptr; /**<The player in m_interest. */
+                TranscriptWriter *m_transcript = nullptr; /**<Where the commands are recorded. */
                 std::shared_ptr<Player> m_player = nullptr; /**<The player being controlled. */
+                std::ostream *m_output = &std::cout; /**<Where the output of the game is written. */
+                OutputFormat m_format = TEXT_OUTPUT; /**<Format of the output of the game. */
+                GameLatencies m_latencies; /**<Latencies of the processed commands. */
+                uint64_t m_stats_thread = 0; /**<Thread whose statistics have the verbs. */
 };
 
 
@@ -1,207 +1,422 @@
 #include "game.h"
 
 #include <iostream>
+#include <optional>
+#include <vector>
 
 #include "player.h"
 #include "items.h"
 #include "enemies.h"
-
-/** Setup Room2
+#include "world.h"
+#include "trace.h"
+#include "castle-map.h"
+#include "leaderboard.h"
+#include "varint.h"
+#include "json-record.h"
+#include "ascii-fold.h"
+
+/** Number of scores shown by the leaderboard command. */
+static const size_t LEADERBOARD_LENGTH = 10;
+/** Version of the format written by AdventureGame::saveState(). */
+static const uint64_t STATE_VERSION = 1;
+
+/** What an item slot holds in a saved state. */
+enum SavedItem {
+ITEM_GONE, /**<The item was destroyed. */
+ITEM_HELD, /**<The item can't be picked up. */
+ITEM_FREE /**<The item can be picked up. */
+};
+
+/** Creates the castle of the coursework.
  *
- * @param room Pointer to Room1
+ * @param world The world owning the castle.
+ * @return The room the player starts in.
  * */
-static Room* setupRoom2(Room *room) {
-    Room *room2 = room->setEast("Castle Hall");
-    room2->addItem(std::shared_ptr<Consumable> (new Consumable("Food", 5)));
-    return room2;
+static Room* buildCastle(World &world) {
+    return buildMap(world, CASTLE_MAP);
 }
 
-/** Setup Room3
- *
- * @param room Pointer to Room2
- * */
-static Room* setupRoom3(Room *room) {
-    Room *room3 = room->setEast("Armory");
-
-    std::shared_ptr<Weapon> spear(new Weapon("Silver Spear", 1));
-    room3->addItem(spear);
-    room3->addEnemey(std::shared_ptr<GenericEnemy>(
-                         new GenericEnemy(6, 1, "Zombie", spear)));
-
-    return room3;
+/** Constructor class for coursework game. */
+AdventureGame::AdventureGame(void): AdventureGame(buildCastle) {
 }
 
-/** Setup Room5
+/** Constructor for a game played in another world.
  *
- * @param room Pointer to Room2
+ * @param build Creates the rooms, items and enemies of the world and
+ * returns the room the player starts in. The player wins by bringing the
+ * Golden Chalice back to that room.
  * */
-static Room* setupRoom5(Room *room) {
-    Room *room5 = room->setSouth("Castle Center");
+AdventureGame::AdventureGame(std::function<Room*(World&)> build) {
+    Player *player = new Player(12, 1, 3, this->m_world);
+    this->setPlayer(player);
 
-    room5->addItem(std::shared_ptr<Weapon>(new Weapon("Sword", 2)));
-    room5->addEnemey(std::shared_ptr<GenericEnemy>(
-                         new GenericEnemy(5, 1, "Lizard-man")));
+    this->m_initial_room = build(this->m_world);
+    this->setRoom(this->m_initial_room);
 
-    return room5;
+    // Adding Commands
+    this->addMultipleCommands({"north", "n"}, "Go to the room north.");
+    this->addMultipleCommands({"south", "s"}, "Go to the room south.");
+    this->addMultipleCommands({"east", "e"}, "Go to the room east.");
+    this->addMultipleCommands({"west", "w"}, "Go to the room west.");
+    this->addMultipleCommands({"look", "l"}, "Shows what is in the room.");
+    this->addMultipleCommands({"killMonster", "km"}, "Kills the monster in the room.");
+    this->addMultipleCommands({"inventory", "i"}, "Shows the player's inventory.");
+    this->addCommands({
+        {"kill {monster}", "Kills the monster with the name {monster}."},
+        {"get {item}", "Gets the item with the name {item}."},
+        {"drop {item}", "Drops the item with the name {item}."},
+        {"eat food", "Eat the food in the inventory."},
+        {"drink elixir", "Drink the elixir in the inventory."},
+        {"use medpack", "Use the medpack in the inventory."},
+        {"unlock door", "Unlocks the locked rooms."},
+        {"leaderboard", "Shows the best scores of the games played."}
+    });
 }
 
-/** Setup Room8
+//////////
+// Getters
+/** Gets the world owning the rooms, items and enemies of the game.
  *
- * @param room Pointer to Room5
+ * @return The world.
  * */
-static Room* setupRoom8(Room *room) {
-    Room *room8 = room->setSouth("Religious Room");
-
-    std::shared_ptr<GenericItem> cross(new GenericItem("Diamond Cross"));
-    room8->addItem(cross);
-    room8->addEnemey(std::shared_ptr<Werewolf>(
-                         new Werewolf(12, 3, "Werewolf", cross)));
-
-    return room8;
+World& AdventureGame::getWorld(void) {
+    return this->m_world;
 }
 
-/** Setup Room4
+/** Gets the room the player started in.
  *
- * @param room Pointer to Room5
+ * @return The initial room.
  * */
-static Room* setupRoom4(Room *room) {
-    Room *room4 = room->setWest("Medical Room");
-
-    room4->addItem(std::shared_ptr<Consumable>(new Consumable("Medpack", 10)));
-
-    return room4;
+Room* AdventureGame::getInitialRoom(void) const {
+    return this->m_initial_room;
 }
 
-/** Setup Room7
+/** Saves the state of the game into a compact blob.
  *
- * @param room Pointer to Room4
+ * Only what can change after the world is built is saved: the room the
+ * player is in, the player, where every item is, the health of the enemies
+ * and the locked rooms. The command statistics aren't saved.
+ *
+ * @return The state.
  * */
-static Room* setupRoom7(Room *room) {
-    Room *room7 = room->setSouth("Storage Room");
-
-    std::shared_ptr<GenericItem> key(new GenericItem("Copper Key"));
-    room7->addItem(key);
-    room7->addEnemey(std::shared_ptr<Vampire>(new Vampire(12, 3, "Dracula", key)));
-
-    return room7;
+std::string AdventureGame::saveState(void) const {
+    // The getters of HKGE aren't const
+    AdventureGame *game = const_cast<AdventureGame *>(this);
+    const World &world = this->m_world;
+    Player *player = game->getPlayer();
+    Inventory *inventory = player->getInventory();
+    std::string state;
+    state.reserve(64);
+
+    writeVarint(state, STATE_VERSION);
+    writeVarint(state, world.roomCount());
+    writeVarint(state, world.itemSlots());
+    writeVarint(state, world.enemySlots());
+    writeVarint(state, inventory->maxSize());
+
+    writeVarint(state, game->getRoom()->getId());
+    writeSignedVarint(state, player->getXP());
+    writeSignedVarint(state, player->getCurrentHealth());
+    writeSignedVarint(state, player->getDamage());
+    writeVarint(state, this->previous_command.size());
+    state += this->previous_command;
+
+    // Item slots are written plus one, 0 is an empty slot
+    const ItemHandle *slots = inventory->getItems();
+    for (unsigned int i = 0; i < inventory->maxSize(); i++) {
+        writeVarint(state, slots[i] == nullptr ? 0 : slots[i].getIndex() + 1);
+    }
+    for (size_t i = 0; i < world.itemSlots(); i++) {
+        GenericItem *item = world.getItem(world.itemAt(i));
+        writeVarint(state, item == nullptr ? ITEM_GONE : item->canPickup() ? ITEM_FREE : ITEM_HELD);
+    }
+    for (size_t i = 0; i < world.enemySlots(); i++) {
+        GenericEnemy *enemy = world.getEnemy(world.enemyAt(i));
+        writeSignedVarint(state, enemy == nullptr ? 0 : enemy->getCurrentHealth());
+    }
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        Room *room = world.getRoom(id);
+        const std::vector<ItemHandle> &items = room->getItemHandles();
+        writeVarint(state, items.size() << 1 | (room->isLocked() ? 1 : 0));
+        for (ItemHandle item: items) {
+            writeVarint(state, item.getIndex());
+        }
+    }
+    return state;
 }
 
-/** Setup Room6
+/** Restores a state saved by saveState().
  *
- * @param room Pointer to Room5
+ * The game must not have run any command and be built the same way as the
+ * game the state was saved from.
+ *
+ * @param state The state.
+ * @return If the state was restored, false if it is corrupt or from another
+ * world, the game is then left as it was.
  * */
-static Room* setupRoom6(Room *room) {
-    Room *room6 = room->setEast("Magic Room");
+bool AdventureGame::loadState(const std::string &state) {
+    World &world = this->m_world;
+    Inventory *inventory = this->getPlayer()->getInventory();
+    size_t pos = 0;
+    uint64_t value;
+    auto read = [&](uint64_t limit) {
+        return readVarint(state, pos, value) && value < limit;
+    };
+    auto matches = [&](uint64_t expected) {
+        return readVarint(state, pos, value) && value == expected;
+    };
+
+    // Reading everything before changing anything
+    if (!matches(STATE_VERSION) || !matches(world.roomCount()) ||
+        !matches(world.itemSlots()) || !matches(world.enemySlots()) ||
+        !matches(inventory->maxSize()) || !read(world.roomCount())) {
+        return false;
+    }
+    size_t room = value;
+    int64_t xp, health, damage;
+    if (!readSignedVarint(state, pos, xp) || !readSignedVarint(state, pos, health) ||
+        !readSignedVarint(state, pos, damage) || !read(state.size() - pos + 1)) {
+        return false;
+    }
+    std::string previous_command = state.substr(pos, value);
+    pos += value;
 
-    room6->addItem(std::shared_ptr<Consumable>(new Consumable("Elixir", 10)));
-    room6->addEnemey(std::shared_ptr<GenericEnemy>(
-                         new GenericEnemy(4, 3, "Monster")));
+    std::vector<uint64_t> held(inventory->maxSize());
+    for (uint64_t &slot: held) {
+        if (!read(world.itemSlots() + 1)) {
+            return false;
+        }
+        slot = value;
+    }
+    std::vector<uint64_t> items(world.itemSlots());
+    for (uint64_t &item: items) {
+        if (!read(ITEM_FREE + 1)) {
+            return false;
+        }
+        item = value;
+    }
+    std::vector<int64_t> enemies(world.enemySlots());
+    for (int64_t &enemy: enemies) {
+        if (!readSignedVarint(state, pos, enemy)) {
+            return false;
+        }
+    }
+    std::vector<uint64_t> rooms(world.roomCount());
+    std::vector<uint64_t> placed;
+    for (uint64_t &contents: rooms) {
+        if (!read((world.itemSlots() + 1) << 1)) {
+            return false;
+        }
+        contents = value;
+        for (size_t i = 0; i < contents >> 1; i++) {
+            if (!read(world.itemSlots())) {
+                return false;
+            }
+            placed.push_back(value);
+        }
+    }
+    if (pos != state.size()) {
+        return false;
+    }
 
-    return room6;
+    // Every item is in one place at most, and only if it wasn't destroyed
+    std::vector<bool> seen(world.itemSlots(), false);
+    for (uint64_t slot: held) {
+        if (slot != 0) {
+            placed.push_back(slot - 1);
+        }
+    }
+    for (uint64_t item: placed) {
+        if (seen[item] || items[item] == ITEM_GONE) {
+            return false;
+        }
+        seen[item] = true;
+    }
+    for (uint64_t slot: held) {
+        if (slot != 0 && items[slot - 1] != ITEM_FREE) {
+            return false;
+        }
+    }
+
+    // Taking every item out, then putting back the ones left
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        while (world.getRoom(id)->removeItem() != nullptr) {
+        }
+    }
+    for (unsigned int i = 0; i < inventory->maxSize(); i++) {
+        inventory->removeItem(i);
+    }
+    for (size_t i = 0; i < items.size(); i++) {
+        GenericItem *item = world.getItem(world.itemAt(i));
+        if (item == nullptr) {
+            continue;
+        } else if (items[i] == ITEM_GONE) {
+            world.destroyItem(world.itemAt(i));
+        } else if (items[i] == ITEM_FREE) {
+            item->allowPickup();
+        } else {
+            item->disallowPickup();
+        }
+    }
+    for (size_t i = 0; i < held.size(); i++) {
+        if (held[i] != 0) {
+            inventory->addItem(world.itemAt(held[i] - 1), (int) i);
+        }
+    }
+    auto next_placed = placed.begin();
+    for (size_t id = 0; id < rooms.size(); id++) {
+        Room *restored = world.getRoom(id);
+        for (size_t i = 0; i < rooms[id] >> 1; i++) {
+            restored->addItem(world.itemAt(*next_placed++));
+        }
+        if (rooms[id] & 1) {
+            restored->lockRoom();
+        } else {
+            restored->unlockRoom();
+        }
+    }
+    for (size_t i = 0; i < enemies.size(); i++) {
+        GenericEnemy *enemy = world.getEnemy(world.enemyAt(i));
+        if (enemy != nullptr) {
+            enemy->setCurrentHealth((int) enemies[i]);
+        }
+    }
+
+    Player *player = this->getPlayer();
+    player->addXP((int) xp - player->getXP());
+    player->setCurrentHealth((int) health);
+    player->setDamage((int) damage);
+    this->previous_command = previous_command;
+    this->setRoom(world.getRoom(room));
+    return true;
 }
 
-/** Setup Room9
+/** Adds the room the player is in to a JSON record.
  *
- * @param room Pointer to Room6
+ * @param record The record.
+ * @param room The room.
  * */
-static Room* setupRoom9(Room *room) {
-    Room *room9 = room->setSouth("Boss Room");
-
-    auto ptr = std::shared_ptr<GenericItem>(new GenericItem("Golden Chalice"));
-    room9->addItem(ptr);
-    room9->addEnemey(std::shared_ptr<GenericEnemy>(
-                         new GenericEnemy(12, 4, "Dragon", ptr)));
-    room9->lockRoom();
-
-    return room9;
+static void addRoom(JsonRecord &record, const Room *room) {
+    record.add("room_id", room->getId()).add("room", room->getName());
 }
 
-/** Constructor class for coursework game. */
-AdventureGame::AdventureGame(void) {
-    Player *player = new Player();
-    this->setPlayer(player);
-
-    // Room 1
-    rooms[0] = new Room("Castle Entrance");
-    this->m_initial_room = rooms[0];
-    this->setRoom(rooms[0]);
-    // Room 2
-    rooms[1] = setupRoom2(rooms[0]);
-    // Room 3
-    rooms[2] = setupRoom3(rooms[1]);
-    // Room 5
-    rooms[4] = setupRoom5(rooms[1]);
-    // Room 8
-    rooms[7] = setupRoom8(rooms[4]);
-    // Room 4
-    rooms[3] = setupRoom4(rooms[4]);
-    // Room 7
-    rooms[6] = setupRoom7(rooms[3]);
-    // Room 6
-    rooms[5] = setupRoom6(rooms[4]);
-    // Room 9
-    rooms[8] = setupRoom9(rooms[5]);
-
-    // Adding Commands
-    this->addMultipleCommands({"north", "n"}, "Go to the room north.");
-    this->addMultipleCommands({"south", "s"}, "Go to the room south.");
-    this->addMultipleCommands({"east", "e"}, "Go to the room east.");
-    this->addMultipleCommands({"west", "w"}, "Go to the room west.");
-    this->addMultipleCommands({"look", "l"}, "Shows what is in the room.");
-    this->addMultipleCommands({"killMonster", "km"}, "Kills the monster in the room.");
-    this->addMultipleCommands({"inventory", "i"}, "Shows the player's inventory.");
-    this->addCommands({
-        {"kill {monster}", "Kills the monster with the name {monster}."},
-        {"get {item}", "Gets the item with the name {item}."},
-        {"drop {item}", "Drops the item with the name {item}."},
-        {"eat food", "Eat the food in the inventory."},
-        {"drink elixir", "Drink the elixir in the inventory."},
-        {"use medpack", "Use the medpack in the inventory."},
-        {"unlock door", "Unlocks the locked rooms."}
-    });
+/** Adds the enemies, items and exits of a room to a JSON record.
+ *
+ * Handles of enemies and items the world destroyed are skipped.
+ *
+ * @param record The record.
+ * @param room The room.
+ * */
+static void addRoomContent(JsonRecord &record, const Room *room) {
+    World *world = room->getWorld();
+    record.beginList("enemies");
+    for (EnemyHandle handle: room->getEnemyHandles()) {
+        GenericEnemy *enemy = world->getEnemy(handle);
+        if (enemy == nullptr) {
+            continue;
+        }
+        record.beginObject().add("id", handle.getValue()).add("name", enemy->getName())
+            .addBool("dead", enemy->isDead()).add("hp", enemy->getCurrentHealth()).end();
+    }
+    record.end().beginList("items");
+    for (ItemHandle handle: room->getItemHandles()) {
+        GenericItem *item = world->getItem(handle);
+        if (item == nullptr) {
+            continue;
+        }
+        record.beginObject().add("id", handle.getValue())
+            .add("name", item->getName()).end();
+    }
+    record.end().beginList("exits");
+    static const char *DIRECTIONS[] = {"north", "south", "east", "west"};
+    for (Direction direction: {Direction::NORTH, Direction::SOUTH,
+        Direction::EAST, Direction::WEST}) {
+        Room *exit = room->getRoom(direction);
+        if (exit == nullptr) {
+            continue;
+        }
+        record.beginObject().add("direction", DIRECTIONS[direction])
+            .add("room_id", exit->getId()).add("room", exit->getName())
+            .addBool("locked", exit->isLocked()).end();
+    }
+    record.end();
 }
 
-/** Destuctor function to delete dynamically allocated room. */
-AdventureGame::~AdventureGame(void) {
-    for (int i = 0; i < 9; i++) {
-        if (rooms[i] != nullptr) {
-            delete rooms[i];
+/** Adds the slots of an inventory to a JSON record.
+ *
+ * @param record The record.
+ * @param inventory The inventory.
+ * */
+static void addInventory(JsonRecord &record, const Inventory *inventory) {
+    const ItemHandle *items = inventory->getItems();
+    record.beginList("inventory");
+    for (unsigned int i = 0; i < inventory->maxSize(); i++) {
+        if (items[i] == nullptr) {
+            continue;
         }
+        record.beginObject().add("slot", i).add("id", items[i].getValue())
+            .add("name", inventory->getItem(i)->getName()).end();
     }
+    record.end();
+}
+
+/** Adds the health, damage and XP of the player to a JSON record.
+ *
+ * @param record The record.
+ * @param player The player.
+ * */
+static void addPlayer(JsonRecord &record, const Player *player) {
+    record.add("hp", player->getCurrentHealth()).add("max_hp", player->getMaxHealth())
+        .add("damage", player->getDamage()).add("xp", player->getXP());
 }
 
 /** Overriden to add new commands. */
 GameStatus AdventureGame::processCommand(void) {
-    std::string cmd = this->getCurrentCommand();
+    GAME_TRACE_SCOPE("AdventureGame::processCommand");
+    const std::string &cmd = this->getCurrentCommand();
+    bool json = this->getOutputFormat() == JSON_OUTPUT;
 
     // Movement Commands
     if (cmd == "north" || cmd == "n" ||
         cmd == "south" || cmd == "s" ||
         cmd == "east" || cmd == "e" ||
         cmd == "west" || cmd == "w") {
+        GAME_TRACE_SCOPE("AdventureGame::move");
+        std::string direction = cmd;
 
         // Setting short form to the long form
-        if(cmd == "n") {
-            cmd = "north";
-        } else if(cmd == "s") {
-            cmd = "south";
-        } else if(cmd == "e") {
-            cmd = "east";
-        } else if(cmd == "w") {
-            cmd = "west";
+        if(direction == "n") {
+            direction = "north";
+        } else if(direction == "s") {
+            direction = "south";
+        } else if(direction == "e") {
+            direction = "east";
+        } else if(direction == "w") {
+            direction = "west";
         }
 
         // Getting Room
-        Room *room = this->getRoom()->getRoom(cmd);
+        Room *room = this->getRoom()->getRoom(direction);
         if (room != nullptr) {
             // Checking if the room is locked
             if (room->isLocked()) {
-                std::cout << "The room is locked you must find a way to"
-                          << " unlock it." << std::endl;
+                if (json) {
+                    addRoom(JsonRecord(this->out(), "move").add("direction", direction)
+                            .add("status", "LOCKED").add("to_room_id", room->getId()),
+                            this->getRoom());
+                } else {
+                    this->out() << "The room is locked you must find a way to"
+                              << " unlock it." << std::endl;
+                }
             } else {
                 this->setRoom(room);
-                std::cout << "You go " << cmd << " to "
-                          << room->getName() << std::endl;
+                if (json) {
+                    addRoom(JsonRecord(this->out(), "move").add("direction", direction)
+                            .add("status", "MOVED"), room);
+                } else {
+                    this->out() << "You go " << direction << " to "
+                              << room->getName() << std::endl;
+                }
             }
 
             // Checking if the room is the intial room
@@ -214,9 +429,12 @@ GameStatus AdventureGame::processCommand(void) {
             } else {
                 return GameStatus::CONTINUE;
             }
+        } else if (json) {
+            addRoom(JsonRecord(this->out(), "move").add("direction", direction)
+                    .add("status", "NO_ROOM"), this->getRoom());
         } else {
-            std::cout << "There is no room to the "
-                      << cmd << std::endl;
+            this->out() << "There is no room to the "
+                      << direction << std::endl;
         }
 
         return GameStatus::CONTINUE;
@@ -224,47 +442,68 @@ GameStatus AdventureGame::processCommand(void) {
 
     // Look command
     if (cmd == "look" || cmd == "l") {
+        GAME_TRACE_SCOPE("AdventureGame::look");
         Room *room = this->getRoom();
-        std::cout << "You looked around. " << *room;
+        if (json) {
+            JsonRecord record(this->out(), "look");
+            addRoom(record, room);
+            addRoomContent(record, room);
+        } else {
+            this->out() << "You looked around. " << *room;
+        }
         return GameStatus::CONTINUE;
     }
 
     // Fight Commands
     if (cmd == "killmonster" || cmd == "km") {
-        GenericEnemy *target = nullptr;
-        // Getting the target enemy
-        try {
-            target = this->getRoom()->getEnemies().at(0);
-        } catch (std::out_of_range const &e) {
-            std::cout << "There is no enemies here. " << std::endl;
+        GAME_TRACE_SCOPE("AdventureGame::killmonster");
+        // Getting the first enemy the world didn't destroy
+        World *world = this->getRoom()->getWorld();
+        const std::vector<EnemyHandle> &enemies = this->getRoom()->getEnemyHandles();
+        size_t index = 0;
+        while (index < enemies.size() && world->getEnemy(enemies[index]) == nullptr) {
+            index++;
+        }
+        if (index == enemies.size()) {
+            if (json) {
+                JsonRecord(this->out(), "kill").add("status", killStatusName(NO_ENEMY));
+            } else {
+                this->out() << "There is no enemies here. " << std::endl;
+            }
             return GameStatus::CONTINUE;
         }
+        GenericEnemy *target = world->getEnemy(enemies[index]);
 
-        // Killing the first enemy
+        // Killing the enemy
         int current_health = this->getPlayer()->getCurrentHealth();
-        KillStatus status = this->getRoom()->killEnemy(0, this->getPlayer());
+        KillStatus status = this->getRoom()->killEnemy(index, this->getPlayer());
         int new_health = this->getPlayer()->getCurrentHealth();
 
+        if (json) {
+            this->recordKill(status, target->getName(), new_health - current_health);
+            return status == KILL_FAILURE ? GameStatus::DEFEAT : GameStatus::CONTINUE;
+        }
+
         // Status handler
         switch (status) {
             case KILL_FAILURE:
-                std::cout << "You died while trying to kill " << *target
+                this->out() << "You died while trying to kill " << *target
                           << "." << std::endl;
                 return GameStatus::DEFEAT;
                 break;
             case NO_ENEMY:
                 // Probabbly won't happen
-                std::cout << "There is no enemies here. " << std::endl;
+                this->out() << "There is no enemies here. " << std::endl;
                 break;
             case DEAD_ENEMY:
-                std::cout << "The " << *target
+                this->out() << "The " << *target
                           << " is already dead." << std::endl;
                 break;
             case KILL_SUCCESS:
-                std::cout << "You killed the " << *target
+                this->out() << "You killed the " << *target
                           << ". It dealt " << (current_health - new_health)
                           << " damage to you. " << std::endl;
-                std::cout << *(this->getPlayer());
+                this->out() << *(this->getPlayer());
                 break;
         }
         return GameStatus::CONTINUE;
@@ -272,6 +511,7 @@ GameStatus AdventureGame::processCommand(void) {
 
     // Alternate kill
     if (cmd.substr(0, 5) == "kill ") {
+        GAME_TRACE_SCOPE("AdventureGame::kill");
         // Getting the target
         std::string target = cmd.substr(5, cmd.size());
 
@@ -280,26 +520,31 @@ GameStatus AdventureGame::processCommand(void) {
         KillStatus status = this->getRoom()->killEnemy(target, this->getPlayer());
         int new_health = this->getPlayer()->getCurrentHealth();
 
+        if (json) {
+            this->recordKill(status, target, new_health - current_health);
+            return status == KILL_FAILURE ? GameStatus::DEFEAT : GameStatus::CONTINUE;
+        }
+
         // Status handler
         switch (status) {
             case KILL_FAILURE:
-                std::cout << "You died while trying to kill " << target
+                this->out() << "You died while trying to kill " << target
                           << "." << std::endl;
                 return GameStatus::DEFEAT;
                 break;
             case NO_ENEMY:
-                std::cout << "There is no " << target
+                this->out() << "There is no " << target
                           << " in the room." << std::endl;
                 break;
             case DEAD_ENEMY:
-                std::cout << "The " << target
+                this->out() << "The " << target
                           << " is already dead." << std::endl;
                 break;
             case KILL_SUCCESS:
-                std::cout << "You killed the " << target
+                this->out() << "You killed the " << target
                           << ". It dealt " << (current_health - new_health)
                           << " damage to you. " << std::endl;
-                std::cout << *(this->getPlayer());
+                this->out() << *(this->getPlayer());
                 break;
         }
         return GameStatus::CONTINUE;
@@ -307,44 +552,58 @@ GameStatus AdventureGame::processCommand(void) {
 
     // Get
     if (cmd.substr(0, 4) == "get ") {
+        GAME_TRACE_SCOPE("AdventureGame::get");
         std::string item = cmd.substr(4, cmd.size());
         auto removed_item = this->getRoom()->removeItem(item);
 
         // If item not in the room
         if (removed_item == nullptr) {
-            std::cout << "There is no item " << item << " in the room."
-                      << std::endl;
+            if (json) {
+                JsonRecord(this->out(), "get").add("status", "NOT_IN_ROOM").add("item", item);
+            } else {
+                this->out() << "There is no item " << item << " in the room."
+                          << std::endl;
+            }
             return GameStatus::CONTINUE;
         } else {
             // Adding item into inventory
             AddItemStatus status = this->getPlayer()->addItem(removed_item);
+            if (json) {
+                JsonRecord(this->out(), "get").add("status", addItemStatusName(status))
+                    .add("item", this->getWorld().getItem(removed_item)->getName())
+                    .add("item_id", removed_item.getValue());
+                if (status != AddItemStatus::SUCCESS) {
+                    this->getRoom()->addItem(removed_item);
+                }
+                return GameStatus::CONTINUE;
+            }
 
             // Handling the status
             switch (status) {
                 case AddItemStatus::CANNOT_PICKUP:
-                    std::cout << item << " cannot be picked up." << std::endl;
+                    this->out() << item << " cannot be picked up." << std::endl;
                     break;
                 case AddItemStatus::INDEX_OUT_OF_RANGE:
                     // Probabbly won't happen
-                    std::cout << "Tried to insert item out size of inventory"
+                    this->out() << "Tried to insert item out size of inventory"
                               << std::endl;
                     break;
                 case AddItemStatus::INVALID_INDEX:
                     // Probabbly won't happen
-                    std::cout << "Inventory slot already filled" << std::endl;
+                    this->out() << "Inventory slot already filled" << std::endl;
                     break;
                 case AddItemStatus::NO_SPACE:
-                    std::cout << "There is no space in your inventory left"
+                    this->out() << "There is no space in your inventory left"
                               << std::endl;
                     break;
                 case AddItemStatus::SUCCESS:
-                    std::cout << "You added " << item << " to your inventory."
+                    this->out() << "You added " << item << " to your inventory."
                               << std::endl;
                     return GameStatus::CONTINUE;
                     break;
                 case AddItemStatus::INVALID_ITEM:
                     // Probabbly won't happen
-                    std::cout << "The item cannot be added." << std::endl;
+                    this->out() << "The item cannot be added." << std::endl;
                     break;
             }
             this->getRoom()->addItem(removed_item);
@@ -355,70 +614,110 @@ GameStatus AdventureGame::processCommand(void) {
 
     // Drop
     if (cmd.substr(0, 5) == "drop ") {
+        GAME_TRACE_SCOPE("AdventureGame::drop");
         std::string item = cmd.substr(5, cmd.size());
         auto dropped_item = this->getPlayer()->dropItem(item);
 
         // Handling dropped item
         if (dropped_item == nullptr) {
-            std::cout << "Item " << item << " not in inventory." << std::endl;
+            if (json) {
+                JsonRecord(this->out(), "drop").add("status", "NOT_HELD").add("item", item);
+            } else {
+                this->out() << "Item " << item << " not in inventory." << std::endl;
+            }
         } else {
             this->getRoom()->addItem(dropped_item);
-            std::cout << "You dropped " << item << " on the floor." << std::endl;
+            if (json) {
+                JsonRecord(this->out(), "drop").add("status", "DROPPED")
+                    .add("item", this->getWorld().getItem(dropped_item)->getName())
+                    .add("item_id", dropped_item.getValue());
+            } else {
+                this->out() << "You dropped " << item << " on the floor." << std::endl;
+            }
         }
         return GameStatus::CONTINUE;
     }
 
     // Inventory
     if (cmd == "inventory" || cmd == "i") {
-        std::cout << *(this->getPlayer()->getInventory());
+        GAME_TRACE_SCOPE("AdventureGame::inventory");
+        if (json) {
+            Inventory *inventory = this->getPlayer()->getInventory();
+            JsonRecord record(this->out(), "inventory");
+            record.add("size", inventory->maxSize());
+            addInventory(record, inventory);
+        } else {
+            this->out() << *(this->getPlayer()->getInventory());
+        }
         return GameStatus::CONTINUE;
     }
 
     // Healing
     if (cmd == "eat food") {
+        GAME_TRACE_SCOPE("AdventureGame::eat food");
         GenericItem *food = this->getPlayer()->getInventory()->getItem("Food");
-        if (food == nullptr) {
-            std::cout << "You don't have any food in your inventory." << std::endl;
+        if (json) {
+            this->useItem(food, "Food");
+        } else if (food == nullptr) {
+            this->out() << "You don't have any food in your inventory." << std::endl;
         } else {
             this->getPlayer()->useItem(food);
-            std::cout << "You ate some food." << std::endl;
-            std::cout << *(this->getPlayer());
+            this->out() << "You ate some food." << std::endl;
+            this->out() << *(this->getPlayer());
         }
         return GameStatus::CONTINUE;
     } else if (cmd == "drink elixir") {
+        GAME_TRACE_SCOPE("AdventureGame::drink elixir");
         GenericItem *elixir = this->getPlayer()->getInventory()->getItem("Elixir");
-        if (elixir == nullptr) {
-            std::cout << "You don't have an elixir in your inventory." << std::endl;
+        if (json) {
+            this->useItem(elixir, "Elixir");
+        } else if (elixir == nullptr) {
+            this->out() << "You don't have an elixir in your inventory." << std::endl;
         } else {
             this->getPlayer()->useItem(elixir);
-            std::cout << "You drank the elixir." << std::endl;
-            std::cout << *(this->getPlayer());
+            this->out() << "You drank the elixir." << std::endl;
+            this->out() << *(this->getPlayer());
         }
         return GameStatus::CONTINUE;
     } else if (cmd == "use medpack") {
+        GAME_TRACE_SCOPE("AdventureGame::use medpack");
         GenericItem *medpack = this->getPlayer()->getInventory()->getItem("Medpack");
-        if (medpack == nullptr) {
-            std::cout << "You don't have a medpack in your inventory." << std::endl;
+        if (json) {
+            this->useItem(medpack, "Medpack");
+        } else if (medpack == nullptr) {
+            this->out() << "You don't have a medpack in your inventory." << std::endl;
         } else {
             this->getPlayer()->useItem(medpack);
-            std::cout << "You used the medpack." << std::endl;
-            std::cout << *(this->getPlayer());
+            this->out() << "You used the medpack." << std::endl;
+            this->out() << *(this->getPlayer());
         }
         return GameStatus::CONTINUE;
     }
 
     // Unlocking door
     if (cmd == "unlock door") {
+        GAME_TRACE_SCOPE("AdventureGame::unlock door");
         bool unlocked = false;
 
         // If player doesn't have copper key
         if (this->getPlayer()->getInventory()->getItem("Copper Key")
             == nullptr) {
-            std::cout << "You don't have any keys to unlock doors."
-                      << std::endl;
+            if (json) {
+                JsonRecord(this->out(), "unlock").add("status", "NO_KEY");
+            } else {
+                this->out() << "You don't have any keys to unlock doors."
+                          << std::endl;
+            }
             return GameStatus::CONTINUE;
         }
 
+        // The unlocked rooms are listed as they are unlocked
+        std::optional<JsonRecord> record;
+        if (json) {
+            record.emplace(this->out(), "unlock");
+            record->beginList("rooms");
+        }
+
         // Looping over all rooms
         for (Direction direction: {Direction::NORTH, Direction::SOUTH,
             Direction::EAST, Direction::WEST}) {
@@ -431,52 +730,169 @@ GameStatus AdventureGame::processCommand(void) {
             // Unlocking locked rooms
             if (room->isLocked()) {
                 room->unlockRoom();
-                std::cout << "You unlocked " << room->getName() << " with your "
-                          << "copper key" << std::endl;
+                if (json) {
+                    record->beginObject().add("room_id", room->getId())
+                        .add("room", room->getName()).end();
+                } else {
+                    this->out() << "You unlocked " << room->getName() << " with your "
+                              << "copper key" << std::endl;
+                }
                 unlocked = true;
             }
         }
 
-        // If no rooms were unlocked
-        if (!unlocked) {
-            std::cout << "There is no room to be unlocked." << std::endl;
+        if (json) {
+            record->end().add("status", unlocked ? "UNLOCKED" : "NOTHING_LOCKED");
+        } else if (!unlocked) {
+            // If no rooms were unlocked
+            this->out() << "There is no room to be unlocked." << std::endl;
         }
         return GameStatus::CONTINUE;
     }
 
+    // Leaderboard
+    if (cmd == "leaderboard") {
+        GAME_TRACE_SCOPE("AdventureGame::leaderboard");
+        Leaderboard &leaderboard = globalLeaderboard();
+        int xp = this->getPlayer()->getXP();
+        if (json) {
+            JsonRecord record(this->out(), "leaderboard");
+            record.add("games", leaderboard.games()).beginList("top");
+            for (const LeaderboardEntry &entry: leaderboard.top(LEADERBOARD_LENGTH)) {
+                record.beginObject().add("rank", entry.rank).add("score", entry.score)
+                    .add("games", entry.games).end();
+            }
+            record.end().add("xp", xp).add("rank", leaderboard.rank(xp));
+            return GameStatus::CONTINUE;
+        }
+        this->out() << "Leaderboard (" << leaderboard.games() << " games):"
+                    << std::endl;
+        for (const LeaderboardEntry &entry: leaderboard.top(LEADERBOARD_LENGTH)) {
+            this->out() << entry.rank << ". " << entry.score << " XP";
+            if (entry.games > 1) {
+                this->out() << " (" << entry.games << " games)";
+            }
+            this->out() << std::endl;
+        }
+        this->out() << "Your score of " << xp << " would rank "
+                    << leaderboard.rank(xp) << "." << std::endl;
+        return GameStatus::CONTINUE;
+    }
+
     return HKGE::processCommand();
 }
 
+/** Writes the JSON record of a fight.
+ *
+ * @param status The result of the fight.
+ * @param name The name of the enemy fought.
+ * @param hp_delta The change of the health of the player.
+ * */
+void AdventureGame::recordKill(KillStatus status, const std::string &name, int hp_delta) {
+    JsonRecord record(this->out(), "kill");
+    record.add("status", killStatusName(status));
+
+    // The first enemy with the name is the one fought
+    Room *room = this->getRoom();
+    for (EnemyHandle handle: room->getEnemyHandles()) {
+        GenericEnemy *enemy = room->getWorld()->getEnemy(handle);
+        if (status != NO_ENEMY && enemy != nullptr &&
+            equalsFolded(enemy->getName(), name)) {
+            record.add("enemy", enemy->getName()).add("enemy_id", handle.getValue())
+                .add("enemy_hp", enemy->getCurrentHealth()).add("hp_delta", hp_delta);
+            addPlayer(record, this->getPlayer());
+            return;
+        }
+    }
+    record.add("enemy", name);
+}
+
+/** Uses an item of the inventory and writes its JSON record.
+ *
+ * @param item The item, nullptr if the player doesn't have it.
+ * @param name The name of the item.
+ * */
+void AdventureGame::useItem(GenericItem *item, const std::string &name) {
+    JsonRecord record(this->out(), "use");
+    record.add("item", name);
+    if (item == nullptr) {
+        record.add("status", "NOT_HELD");
+        return;
+    }
+    int current_health = this->getPlayer()->getCurrentHealth();
+    this->getPlayer()->useItem(item);
+    record.add("status", "USED")
+        .add("hp_delta", this->getPlayer()->getCurrentHealth() - current_health);
+    addPlayer(record, this->getPlayer());
+}
+
 /** Overriden endGame() to display XP.
+ *
+ * The XP is submitted to the leaderboard. The command latencies are written
+ * to standard error. In JSON output a single end record is written.
  *
  * @param status The status of the game.
  * */
 void AdventureGame::endGame(GameStatus status) {
+    globalLeaderboard().submit(this->getPlayer()->getXP());
+    if (this->getOutputFormat() == JSON_OUTPUT) {
+        JsonRecord(this->out(), "end")
+            .add("status", status == GameStatus::DEFEAT ? "DEFEAT" :
+                 status == GameStatus::VICTORY ? "VICTORY" : "EXIT")
+            .add("xp", this->getPlayer()->getXP());
+        std::cerr << this->getStats();
+        return;
+    }
+
     if (status == GameStatus::DEFEAT) {
         // If lossed
-        std::cout << "You Lost" << std::endl;
+        this->out() << "You Lost" << std::endl;
     } else if (status == GameStatus::EXIT) {
         // If exited
-        std::cout << "Exitting..." << std::endl;
+        this->out() << "Exitting..." << std::endl;
     } else if (status == GameStatus::VICTORY){
         // If won
-        std::cout << "You Win" << std::endl;
+        this->out() << "You Win" << std::endl;
     }
     // Printing score and thank you
-    std::cout << "Score: " << this->getPlayer()->getXP() << std::endl;
-    std::cout << "Thank You for playing Adventure Game!!" << std::endl;
+    this->out() << "Score: " << this->getPlayer()->getXP() << std::endl;
+    this->out() << "Thank You for playing Adventure Game!!" << std::endl;
+    std::cerr << this->getStats();
 }
 
-/** Overriden getCommand() to keep track of previous command.
+/** Overriden inputCommand() to keep track of previous command.
+ *
+ * An empty command repeats the previous command, the whole line for a
+ * batch.
  *
- * @return Always 1 indicating success.
+ * @param command The typed in command.
  * */
-int AdventureGame::getCommand(void) {
-    HKGE::getCommand();
+void AdventureGame::inputCommand(std::string command) {
+    HKGE::inputCommand(command);
     if (this->getCurrentCommand() == "") {
         this->setCurrentCommand(this->previous_command);
     } else {
         this->previous_command = this->getCurrentCommand();
     }
-    return 1;
+}
+
+/** Overriden replayedCommand() to keep track of previous command. */
+void AdventureGame::replayedCommand(void) {
+    this->previous_command = this->getCurrentCommand();
+}
+
+/** Overriden getArgumentNames() to abbreviate names in the room.
+ *
+ * get abbreviates the items and kill the enemies in the room.
+ *
+ * @param verb The verb taking the argument.
+ * @return The names, nullptr if the argument isn't abbreviated.
+ * */
+const PrefixTrie* AdventureGame::getArgumentNames(const std::string &verb) {
+    if (verb == "get") {
+        return &this->getRoom()->getItemNames();
+    } else if (verb == "kill") {
+        return &this->getRoom()->getEnemyNames();
+    }
+    return nullptr;
 }
@@ -1,18 +1,59 @@
 #ifndef GAME_H_
 #define GAME_H_
 
+#include <functional>
 #include <string>
 
 #include "game-engine.h"
 #include "room.h"
+#include "world.h"
 
 /** The game that is specified by the coursework. */
 class AdventureGame: public HKGE {
     public:
         /** Constructor class for coursework game. */
         AdventureGame(void);
-        /** Destuctor function to delete dynamically allocated room. */
-        ~AdventureGame(void);
+        /** Constructor for a game played in another world.
+         *
+         * @param build Creates the rooms, items and enemies of the world and
+         * returns the room the player starts in. The player wins by
+         * bringing the Golden Chalice back to that room.
+         * */
+        AdventureGame(std::function<Room*(World&)> build);
+
+        /** Saves the state of the game into a compact blob.
+         *
+         * Only what can change after the world is built is saved: the
+         * room the player is in, the player, where every item is, the
+         * health of the enemies and the locked rooms. The command
+         * statistics aren't saved.
+         *
+         * @return The state.
+         * */
+        std::string saveState(void) const;
+        /** Restores a state saved by saveState().
+         *
+         * The game must not have run any command and be built the same
+         * way as the game the state was saved from.
+         *
+         * @param state The state.
+         * @return If the state was restored, false if it is corrupt or from
+         * another world, the game is then left as it was.
+         * */
+        bool loadState(const std::string &state);
+
+        //////////
+        // Getters
+        /** Gets the world owning the rooms, items and enemies of the game.
+         *
+         * @return The world.
+         * */
+        World& getWorld(void);
+        /** Gets the room the player started in.
+         *
+         * @return The initial room.
+         * */
+        Room* getInitialRoom(void) const;
     protected:
         /** Overriden to add new commands.
          *
@@ -20,18 +61,50 @@ class AdventureGame: public HKGE {
          * */
         virtual GameStatus processCommand(void) override;
         /** Overriden endGame() to display XP.
+         *
+         * The XP is submitted to the leaderboard. The command latencies are
+         * written to standard error. In JSON output a single end record is
+         * written.
          *
          * @param status The status of the game.
          * */
         virtual void endGame(GameStatus status) override;
-        /** Overriden getCommand() to keep track of previous command.
+        /** Overriden inputCommand() to keep track of previous command.
+         *
+         * An empty command repeats the previous command, the whole line
+         * for a batch.
+         *
+         * @param command The typed in command.
+         * */
+        virtual void inputCommand(std::string command) override;
+        /** Overriden replayedCommand() to keep track of previous command.
+         * */
+        virtual void replayedCommand(void) override;
+        /** Overriden getArgumentNames() to abbreviate names in the room.
          *
-         * @return Always 1 indicating success.
+         * get abbreviates the items and kill the enemies in the room.
+         *
+         * @param verb The verb taking the argument.
+         * @return The names, nullptr if the argument isn't abbreviated.
          * */
-        virtual int getCommand(void) override;
+        virtual const PrefixTrie* getArgumentNames(const std::string &verb) override;
     private:
+        /** Writes the JSON record of a fight.
+         *
+         * @param status The result of the fight.
+         * @param name The name of the enemy fought.
+         * @param hp_delta The change of the health of the player.
+         * */
+        void recordKill(KillStatus status, const std::string &name, int hp_delta);
+        /** Uses an item of the inventory and writes its JSON record.
+         *
+         * @param item The item, nullptr if the player doesn't have it.
+         * @param name The name of the item.
+         * */
+        void useItem(GenericItem *item, const std::string &name);
+
+        World m_world; /**<Owner of the items and enemies of the game. */
         Room *m_initial_room = nullptr; /**<The initial room the player spawns in. */
-        Room *rooms[9] = {}; /**<All the rooms of the game. */
         std::string previous_command = ""; /**<Previous typed command. */
 };
 
@@ -2,7 +2,8 @@
 
 #include <string>
 #include <iostream>
-#include <algorithm>
+
+#include "ascii-fold.h"
 
 ////////////////
 // GenericEntity
@@ -55,6 +56,14 @@ void GenericEntity::healEntity(int health) {
     }
 }
 
+/** Sets the current health of the entity, without calling onDeath().
+ *
+ * @param health The health, at most the max health.
+ * */
+void GenericEntity::setCurrentHealth(int health) {
+    this->m_current_health = std::min(health, this->m_max_health);
+}
+
 /** Gets the damage the entity currently deals.
  *
  * @return The damage the entity deals.
@@ -165,8 +174,8 @@ void GenericItem::togglePickup(void) {
  * @note This operation copares the name of the items and it is not case
  * sensitive.
  * */
-bool GenericItem::operator == (GenericItem other) const {
-    return *this == other.getName();
+bool GenericItem::operator == (const GenericItem &other) const {
+    return *this == other.m_name;
 }
 
 /** Checks if the items are the same.
@@ -178,20 +187,8 @@ bool GenericItem::operator == (GenericItem other) const {
  * @note This operation copares the name of the items and it is not case
  * sensitive.
  * */
-bool GenericItem::operator == (std::string other) const {
-    std::string this_lower = this->getName();
-    std::string other_lower = other;
-
-    std::transform(this_lower.begin(), this_lower.end(),
-                   this_lower.begin(), ::tolower);
-    std::transform(other.begin(), other.end(),
-                   other_lower.begin(), ::tolower);
-
-    if (this_lower == other_lower) {
-        return true;
-    } else {
-        return false;
-    }
+bool GenericItem::operator == (const std::string &other) const {
+    return equalsFolded(this->m_name, other);
 }
 
 /** Overloaded operator to print the item.
@@ -25,6 +25,8 @@ class GenericEntity {
                  * @param damage The damage the entity deals.
                  * */
                 GenericEntity(int max_health, int damage);
+                /** Destructor of GenericEntity. */
+                virtual ~GenericEntity(void) = default;
 
                 //////////
                 // Setters
@@ -45,6 +47,12 @@ class GenericEntity {
                  * @param health The amount of health to heal.
                  * */
                 void healEntity(int health);
+                /** Sets the current health of the entity, without calling
+                 * onDeath().
+                 *
+                 * @param health The health, at most the max health.
+                 * */
+                void setCurrentHealth(int health);
 
                 //////////
                 // Getters
@@ -100,6 +108,8 @@ class GenericItem {
                  * @param name The name of the item.
                  * */
                 GenericItem(std::string name = "");
+                /** Destructor of GenericItem. */
+                virtual ~GenericItem(void) = default;
 
                 //////////
                 // Getters
@@ -132,7 +142,7 @@ class GenericItem {
                  * @note This operation copares the name of the items and it is
                  * not case sensitive.
                  * */
-                virtual bool operator == (GenericItem other) const;
+                virtual bool operator == (const GenericItem &other) const;
                 /** Checks if the items are the same.
                  *
                  * @overload
@@ -142,7 +152,7 @@ class GenericItem {
                  * @note This operation copares the name of the items and it is
                  * not case sensitive.
                  * */
-                virtual bool operator == (std::string other) const;
+                virtual bool operator == (const std::string &other) const;
                 /** Overloaded operator to print the item.
                  *
                  * @param out The output stream.
@@ -0,0 +1,90 @@
+#include "hibernating-game.h"
+
+/** Constructor for Awake. */
+HibernatingGame::Awake::Awake(void) {
+    this->game.setOutput(&this->output);
+}
+
+/** Constructor for HibernatingGame, starts a new game. */
+HibernatingGame::HibernatingGame(void):
+    m_awake(new Awake()), m_last_used(std::chrono::steady_clock::now()) {
+}
+
+/** Gets the game, rehydrating it if it was hibernated.
+ *
+ * @return The game.
+ * */
+AdventureGame& HibernatingGame::get(void) {
+    this->m_last_used = std::chrono::steady_clock::now();
+    if (this->m_awake == nullptr) {
+        // A state saved by a game built the same way always loads
+        this->m_awake.reset(new Awake());
+        this->m_awake->game.loadState(this->m_state);
+        this->m_awake->game.setOutputFormat(this->m_format);
+        std::string().swap(this->m_state);
+    }
+    return this->m_awake->game;
+}
+
+/** Takes the output the game wrote since the last call.
+ *
+ * @return The output, empty while hibernated.
+ * */
+std::string HibernatingGame::takeOutput(void) {
+    if (this->m_awake == nullptr) {
+        return "";
+    }
+    std::string output = this->m_awake->output.str();
+    this->m_awake->output.str("");
+    return output;
+}
+
+/** Saves the game and frees it.
+ *
+ * @return If the game was hibernated, false if it already was or has output
+ * not taken yet.
+ * */
+bool HibernatingGame::hibernate(void) {
+    if (this->m_awake == nullptr || this->m_awake->output.tellp() > 0) {
+        return false;
+    }
+    this->m_state = this->m_awake->game.saveState();
+    this->m_format = this->m_awake->game.getOutputFormat();
+    this->m_state.shrink_to_fit();
+    this->m_awake.reset();
+    return true;
+}
+
+//////////
+// Getters
+/** Checks if the game is hibernated.
+ *
+ * @return If the game is hibernated.
+ * */
+bool HibernatingGame::isHibernated(void) const {
+    return this->m_awake == nullptr;
+}
+
+/** Gets the last time get() was called.
+ *
+ * @return The time.
+ * */
+std::chrono::steady_clock::time_point HibernatingGame::getLastUsed(void) const {
+    return this->m_last_used;
+}
+
+/** Gets the bytes kept while hibernated.
+ *
+ * @return The size of the object and the saved state, 0 if the game isn't
+ * hibernated.
+ * */
+size_t HibernatingGame::hibernatedBytes(void) const {
+    if (this->m_awake != nullptr) {
+        return 0;
+    }
+    // A short state is stored in the string itself
+    const char *data = this->m_state.data();
+    bool inline_state = data >= (const char *) &this->m_state &&
+                        data < (const char *) (&this->m_state + 1);
+    return sizeof(*this) + (inline_state ? 0 : this->m_state.capacity() + 1);
+}
@@ -0,0 +1,84 @@
+#ifndef HIBERNATING_GAME_H_
+#define HIBERNATING_GAME_H_
+
+/** @file hibernating-game.h
+ *
+ * Header file containing a game that frees itself while its player is idle
+ * and comes back on the next command.
+ * */
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "game.h"
+
+/** An AdventureGame that can be hibernated into its saved state.
+ *
+ * Hibernating frees the game, its world and its output stream and only
+ * keeps the blob written by AdventureGame::saveState(). The next get()
+ * rebuilds the game and loads the blob back.
+ * */
+class HibernatingGame {
+        public:
+                /** Constructor for HibernatingGame, starts a new game. */
+                HibernatingGame(void);
+                HibernatingGame(const HibernatingGame &) = delete;
+                HibernatingGame& operator = (const HibernatingGame &) = delete;
+
+                /** Gets the game, rehydrating it if it was hibernated.
+                 *
+                 * @return The game.
+                 * */
+                AdventureGame& get(void);
+                /** Takes the output the game wrote since the last call.
+                 *
+                 * @return The output, empty while hibernated.
+                 * */
+                std::string takeOutput(void);
+                /** Saves the game and frees it.
+                 *
+                 * @return If the game was hibernated, false if it already
+                 * was or has output not taken yet.
+                 * */
+                bool hibernate(void);
+
+                //////////
+                // Getters
+                /** Checks if the game is hibernated.
+                 *
+                 * @return If the game is hibernated.
+                 * */
+                bool isHibernated(void) const;
+                /** Gets the last time get() was called.
+                 *
+                 * @return The time.
+                 * */
+                std::chrono::steady_clock::time_point getLastUsed(void) const;
+                /** Gets the bytes kept while hibernated.
+                 *
+                 * @return The size of the object and the saved state, 0 if
+                 * the game isn't hibernated.
+                 * */
+                size_t hibernatedBytes(void) const;
+        private:
+                /** A game and the stream it writes to. */
+                struct Awake {
+                    std::ostringstream output; /**<The output of the game. */
+                    AdventureGame game; /**<The game. */
+
+                    /** Constructor for Awake. */
+                    Awake(void);
+                };
+
+                std::unique_ptr<Awake> m_awake; /**<The game, nullptr while hibernated. */
+                std::string m_state; /**<The saved game while hibernated. */
+                /** The output format of the game while hibernated. */
+                OutputFormat m_format = TEXT_OUTPUT;
+                /** The last time get() was called. */
+                std::chrono::steady_clock::time_point m_last_used;
+};
+
+#endif // HIBERNATING_GAME_H_
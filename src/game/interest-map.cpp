@@ -0,0 +1,147 @@
+#include "interest-map.h"
+
+#include <algorithm>
+
+/** Constructor for InterestMap.
+ *
+ * @param world The world, its rooms must all be created.
+ * @param radius The number of exits a player sees through, 0 for only the
+ * room it is in.
+ * */
+InterestMap::InterestMap(const World &world, unsigned int radius):
+    m_world(world), m_radius(radius), m_interested(world.roomCount()),
+    m_seen(world.roomCount(), 0) {
+}
+
+/** Moves a player, adding it if it isn't in the map.
+ *
+ * @param player The event queue of the player.
+ * @param room The room the player is in.
+ * */
+void InterestMap::move(EventQueue *player, const Room *room) {
+    std::vector<size_t> &interest = this->m_interest[player];
+    this->findInterest(room, this->m_found);
+
+    // Both lists are sorted, only the rooms in one of them change
+    auto before = interest.begin();
+    auto after = this->m_found.begin();
+    while (before != interest.end() || after != this->m_found.end()) {
+        if (after == this->m_found.end() ||
+            (before != interest.end() && *before < *after)) {
+            std::vector<EventQueue *> &interested = this->m_interested[*before];
+            *std::find(interested.begin(), interested.end(), player) = interested.back();
+            interested.pop_back();
+            before++;
+        } else if (before == interest.end() || *after < *before) {
+            this->m_interested[*after].push_back(player);
+            after++;
+        } else {
+            before++;
+            after++;
+        }
+    }
+    interest.swap(this->m_found);
+}
+
+/** Removes a player.
+ *
+ * @param player The event queue of the player.
+ * */
+void InterestMap::remove(EventQueue *player) {
+    auto interest = this->m_interest.find(player);
+    if (interest == this->m_interest.end()) {
+        return;
+    }
+
+    for (size_t id: interest->second) {
+        std::vector<EventQueue *> &interested = this->m_interested[id];
+        *std::find(interested.begin(), interested.end(), player) = interested.back();
+        interested.pop_back();
+    }
+    this->m_interest.erase(interest);
+}
+
+/** Delivers an update of a room to the players interested in it.
+ *
+ * @param room The room.
+ * @param event The update.
+ * @param except The player causing the update, it isn't sent the update.
+ * @return The number of players the update was sent to.
+ * */
+size_t InterestMap::route(const Room *room, const EventBuffer &event,
+                          const EventQueue *except) const {
+    size_t sent = 0;
+    for (EventQueue *player: this->m_interested[room->getId()]) {
+        if (player != except) {
+            player->push(event);
+            sent++;
+        }
+    }
+    return sent;
+}
+
+//////////
+// Getters
+/** Gets the number of exits a player sees through.
+ *
+ * @return The radius.
+ * */
+unsigned int InterestMap::getRadius(void) const {
+    return this->m_radius;
+}
+
+/** Gets the rooms a player is interested in.
+ *
+ * @param player The event queue of the player.
+ * @return The ids of the rooms in increasing order, empty if the player
+ * isn't in the map.
+ * */
+const std::vector<size_t>& InterestMap::getInterest(const EventQueue *player) const {
+    static const std::vector<size_t> none;
+    auto interest = this->m_interest.find(player);
+    return interest == this->m_interest.end() ? none : interest->second;
+}
+
+/** Gets the players interested in a room.
+ *
+ * @param room The room.
+ * @return The event queues of the players.
+ * */
+const std::vector<EventQueue *>& InterestMap::getInterested(const Room *room) const {
+    return this->m_interested[room->getId()];
+}
+
+/////////
+// private
+/** Finds the rooms within the radius of a room.
+ *
+ * @param room The room.
+ * @param rooms Where the ids of the rooms are stored, in increasing order.
+ * */
+void InterestMap::findInterest(const Room *room, std::vector<size_t> &rooms) {
+    rooms.clear();
+    this->m_search++;
+    this->m_seen[room->getId()] = this->m_search;
+    rooms.push_back(room->getId());
+
+    // Breadth first, one ring of rooms per exit
+    size_t ring_start = 0;
+    for (unsigned int hop = 0; hop < this->m_radius; hop++) {
+        size_t ring_end = rooms.size();
+        for (size_t i = ring_start; i < ring_end; i++) {
+            const Room *from = this->m_world.getRoom(rooms[i]);
+            for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+                Room *exit = from->getRoom(direction);
+                if (exit != nullptr && this->m_seen[exit->getId()] != this->m_search) {
+                    this->m_seen[exit->getId()] = this->m_search;
+                    rooms.push_back(exit->getId());
+                }
+            }
+        }
+        if (ring_end == rooms.size()) {
+            break;
+        }
+        ring_start = ring_end;
+    }
+    std::sort(rooms.begin(), rooms.end());
+}
@@ -0,0 +1,107 @@
+#ifndef INTEREST_MAP_H_
+#define INTEREST_MAP_H_
+
+/** @file interest-map.h
+ *
+ * Header file containing the rooms each player is interested in, so an
+ * update of a room is only delivered to the players near it.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "event-queue.h"
+#include "room.h"
+#include "world.h"
+
+/** The players interested in each room of a world.
+ *
+ * A player is interested in the rooms within a number of exits of the room
+ * it is in, locked rooms included. Moving a player only touches the rooms
+ * entering or leaving its interest, and routing an update of a room only
+ * visits the players interested in it.
+ *
+ * Moving and removing players must not run at the same time as anything
+ * else on the map. route() and the getters only read it, so they can run
+ * on several threads at once, as SharedWorld does under a shared lock.
+ * */
+class InterestMap {
+        public:
+                /** Constructor for InterestMap.
+                 *
+                 * @param world The world, its rooms must all be created.
+                 * @param radius The number of exits a player sees through,
+                 * 0 for only the room it is in.
+                 * */
+                InterestMap(const World &world, unsigned int radius);
+                InterestMap(const InterestMap &) = delete;
+                InterestMap& operator = (const InterestMap &) = delete;
+
+                /** Moves a player, adding it if it isn't in the map.
+                 *
+                 * @param player The event queue of the player.
+                 * @param room The room the player is in.
+                 * */
+                void move(EventQueue *player, const Room *room);
+                /** Removes a player.
+                 *
+                 * @param player The event queue of the player.
+                 * */
+                void remove(EventQueue *player);
+                /** Delivers an update of a room to the players interested
+                 * in it.
+                 *
+                 * @param room The room.
+                 * @param event The update.
+                 * @param except The player causing the update, it isn't sent
+                 * the update.
+                 * @return The number of players the update was sent to.
+                 * */
+                size_t route(const Room *room, const EventBuffer &event,
+                             const EventQueue *except = nullptr) const;
+
+                //////////
+                // Getters
+                /** Gets the number of exits a player sees through.
+                 *
+                 * @return The radius.
+                 * */
+                unsigned int getRadius(void) const;
+                /** Gets the rooms a player is interested in.
+                 *
+                 * @param player The event queue of the player.
+                 * @return The ids of the rooms in increasing order, empty if
+                 * the player isn't in the map.
+                 * */
+                const std::vector<size_t>& getInterest(const EventQueue *player) const;
+                /** Gets the players interested in a room.
+                 *
+                 * @param room The room.
+                 * @return The event queues of the players.
+                 * */
+                const std::vector<EventQueue *>& getInterested(const Room *room) const;
+        private:
+                /** Finds the rooms within the radius of a room.
+                 *
+                 * @param room The room.
+                 * @param rooms Where the ids of the rooms are stored, in
+                 * increasing order.
+                 * */
+                void findInterest(const Room *room, std::vector<size_t> &rooms);
+
+                const World &m_world; /**<The world. */
+                unsigned int m_radius; /**<Exits a player sees through. */
+                /** Players interested in each room by id. */
+                std::vector<std::vector<EventQueue *>> m_interested;
+                /** Rooms each player is interested in. */
+                std::unordered_map<const EventQueue *, std::vector<size_t>> m_interest;
+                /** Search of the last room each room was seen in by
+                 * findInterest(). */
+                std::vector<uint32_t> m_seen;
+                uint32_t m_search = 0; /**<Number of searches done. */
+                std::vector<size_t> m_found; /**<Rooms found by the last search. */
+};
+
+#endif // INTEREST_MAP_H_
@@ -1,27 +1,58 @@
 #include "inventory.h"
 
 #include <iostream>
-#include <memory>
 #include <algorithm>
 
 #include "generics.h"
+#include "world.h"
+
+/** Gets the name of an add item status.
+ *
+ * @param status The add item status.
+ * @return The name of the enumerator, such as "NO_SPACE".
+ * */
+const char* addItemStatusName(AddItemStatus status) {
+    switch (status) {
+        case NO_SPACE:
+            return "NO_SPACE";
+        case INDEX_OUT_OF_RANGE:
+            return "INDEX_OUT_OF_RANGE";
+        case INVALID_INDEX:
+            return "INVALID_INDEX";
+        case CANNOT_PICKUP:
+            return "CANNOT_PICKUP";
+        case INVALID_ITEM:
+            return "INVALID_ITEM";
+        case SUCCESS:
+            return "SUCCESS";
+    }
+    return "UNKNOWN";
+}
 
 /////////////////////
 // Inventory
 /** Constructor for Inventory class.
  *
  * @param size The size of the inventory.
+ * @param world The world owning the items.
  * */
-Inventory::Inventory(unsigned int size): m_max_size(size) {
-    this->inventory_list = new std::shared_ptr<GenericItem>[this->m_max_size];
+Inventory::Inventory(unsigned int size, World &world): m_max_size(size),
+                                                       m_world(&world) {
+    if (this->m_max_size <= INLINE_SLOTS) {
+        this->inventory_list = this->m_inline_list;
+    } else {
+        this->inventory_list = new ItemHandle[this->m_max_size];
+    }
 }
 
 /** Destructor of Inventory.
  *
- * Used to deallocate the inventory list array.
+ * Used to deallocate the inventory list array if it isn't stored inline.
  * */
 Inventory::~Inventory(void) {
-    delete [] inventory_list;
+    if (this->inventory_list != this->m_inline_list) {
+        delete [] inventory_list;
+    }
 }
 
 /** Adds an item in the inventory.
@@ -32,20 +63,21 @@ Inventory::~Inventory(void) {
  * @return The status of adding the item.
  * @see AddItemStatus
  * */
-AddItemStatus Inventory::addItem(std::shared_ptr<GenericItem> item, int index) {
-    if (item == nullptr) {
+AddItemStatus Inventory::addItem(ItemHandle item, int index) {
+    GenericItem *object = this->m_world->getItem(item);
+    if (object == nullptr) {
         return AddItemStatus::INVALID_ITEM;
     }
 
     if (this->getAvaiableSpaces() <= 0) {
         return AddItemStatus::NO_SPACE;
-    } else if (!item->canPickup()) {
+    } else if (!object->canPickup()) {
         return AddItemStatus::CANNOT_PICKUP;
     } else {
         if (index < 0) { // Adding to nearest avaiable slot
             for (unsigned int i = 0; i < this->maxSize(); i++) {
                 if (this->inventory_list[i] == nullptr) {
-                    this->inventory_list[i] = std::shared_ptr<GenericItem>(item);
+                    this->inventory_list[i] = item;
                     break;
                 }
             }
@@ -59,7 +91,7 @@ AddItemStatus Inventory::addItem(std::shared_ptr<GenericItem> item, int index) {
                 return AddItemStatus::INVALID_INDEX;
             } else {
                 // Adding item to index
-                this->inventory_list[index] = std::shared_ptr<GenericItem>(item);
+                this->inventory_list[index] = item;
                 return AddItemStatus::SUCCESS;
             }
         }
@@ -69,15 +101,15 @@ AddItemStatus Inventory::addItem(std::shared_ptr<GenericItem> item, int index) {
 /** Removes an item in the inventory.
  *
  * @param item The item to remove.
- * @return Pointer to the removed item (nullptr is returned
+ * @return Handle to the removed item (nullptr is returned
  * if the item is not in inventory).
  * */
-std::shared_ptr<GenericItem> Inventory::removeItem(GenericItem *item) {
-    std::shared_ptr<GenericItem> current_item = nullptr;
+ItemHandle Inventory::removeItem(GenericItem *item) {
+    ItemHandle current_item = nullptr;
     // Looping over all items
     for (unsigned int i = 0; i < this->m_max_size; i++) {
         // Checking if they are the same
-        if(this->inventory_list[i].get() == item) {
+        if(this->m_world->getItem(this->inventory_list[i]) == item) {
             current_item = this->inventory_list[i];
             this->inventory_list[i] = nullptr;
             return current_item;
@@ -94,20 +126,21 @@ std::shared_ptr<GenericItem> Inventory::removeItem(GenericItem *item) {
  * item found in the inventory.
  *
  * @param item The item name to remove.
- * @return Pointer to the removed item (nullptr is returned
+ * @return Handle to the removed item (nullptr is returned
  * if the item is not in inventory).
  * */
-std::shared_ptr<GenericItem> Inventory::removeItem(std::string item) {
-    std::shared_ptr<GenericItem> current_item = nullptr;
+ItemHandle Inventory::removeItem(std::string item) {
+    ItemHandle current_item = nullptr;
     // Looping over all items
     for (unsigned int i = 0; i < this->maxSize(); i++) {
         // Checking if it is a valid item
-        if (this->inventory_list[i] == nullptr) {
+        GenericItem *object = this->m_world->getItem(this->inventory_list[i]);
+        if (object == nullptr) {
             continue;
         }
 
         // Checking if it they are the same
-        if(*(this->inventory_list[i]) == item) {
+        if(*object == item) {
             current_item = this->inventory_list[i];
             this->inventory_list[i] = nullptr;
             return current_item;
@@ -123,12 +156,12 @@ std::shared_ptr<GenericItem> Inventory::removeItem(std::string item) {
  * on the list instead.
  *
  * @param index The index of the item to remove.
- * @return Pointer to the removed item (nullptr is returned
+ * @return Handle to the removed item (nullptr is returned
  * if the index is not valid ie index too big or item slot is
  * empty).
  * */
-std::shared_ptr<GenericItem> Inventory::removeItem(unsigned int index) {
-    std::shared_ptr<GenericItem> current_item = nullptr;
+ItemHandle Inventory::removeItem(unsigned int index) {
+    ItemHandle current_item = nullptr;
     // Checking if index is within the inventory
     if (index > (this->maxSize() - 1)) {
         return current_item;
@@ -149,12 +182,13 @@ GenericItem* Inventory::getItem(std::string item) const {
     // Looping over all items
     for (unsigned int i = 0; i < this->m_max_size; i++) {
         // Checking if it is holding an item
-        if (this->inventory_list[i] == nullptr) {
+        GenericItem *object = this->m_world->getItem(this->inventory_list[i]);
+        if (object == nullptr) {
             continue;
         }
         // Checking if the item name is the same
-        if(*(this->inventory_list[i]) == item) {
-            return this->inventory_list[i].get();
+        if(*object == item) {
+            return object;
         }
     }
     return nullptr;
@@ -174,15 +208,27 @@ GenericItem* Inventory::getItem(unsigned int index) const {
     if (index > (this->maxSize() - 1)) {
         return nullptr;
     } else {
-        return this->inventory_list[index].get();
+        return this->m_world->getItem(this->inventory_list[index]);
     }
 }
 
-/** Gets the list of items in the inventory. */
-std::shared_ptr<GenericItem>* Inventory::getItems() const {
+/** Gets the list of items in the inventory.
+ *
+ * @return The handles of the inventory slots, maxSize() long. Empty slots
+ * are null handles.
+ * */
+const ItemHandle* Inventory::getItems() const {
     return this->inventory_list;
 }
 
+/** Gets the world owning the items in the inventory.
+ *
+ * @return The world.
+ * */
+World* Inventory::getWorld(void) const {
+    return this->m_world;
+}
+
 /** Gets the max size of the inventory.
  *
  * @return Max size of the inventory.
@@ -220,8 +266,9 @@ std::ostream& operator << (std::ostream &out, const Inventory &cls) {
     for (unsigned int i = 0; i < cls.maxSize(); i++) {
         out << i << " ";
         // Printing the name if there is an item
-        if (cls.inventory_list[i] != nullptr) {
-            out << *(cls.inventory_list[i]);
+        GenericItem *item = cls.getItem(i);
+        if (item != nullptr) {
+            out << *item;
         }
         out << std::endl;
     }
@@ -2,9 +2,9 @@
 #define INVENTORY_H_
 
 #include <string>
-#include <memory>
 
 #include "generics.h"
+#include "world.h"
 
 enum AddItemStatus {
 NO_SPACE, /**<There is no space in the inventory. */
@@ -15,17 +15,35 @@ INVALID_ITEM, /**<If the item is invalid (nullptr is given). */
 SUCCESS /**<Succesfully added the item. */
 };
 
-/** Class representing the inventory of the player. */
+/** Gets the name of an add item status.
+ *
+ * @param status The add item status.
+ * @return The name of the enumerator, such as "NO_SPACE".
+ * */
+const char* addItemStatusName(AddItemStatus status);
+
+/** Class representing the inventory of the player.
+ *
+ * Up to INLINE_SLOTS slots are stored inside the object, larger
+ * inventories allocate their slots.
+ * */
 class Inventory {
         public:
+                /** Number of slots stored inside the inventory. */
+                static constexpr unsigned int INLINE_SLOTS = 4;
+
                 /** Constructor for Inventory class.
                  *
                  * @param size The size of the inventory.
+                 * @param world The world owning the items.
                  * */
-                Inventory(unsigned int size = 3);
+                Inventory(unsigned int size, World &world);
+                Inventory(const Inventory &) = delete;
+                Inventory& operator = (const Inventory &) = delete;
                 /** Destructor of Inventory.
                  *
-                 * Used to deallocate the inventory list array.
+                 * Used to deallocate the inventory list array if it
+                 * isn't stored inline.
                  * */
                 ~Inventory(void);
 
@@ -39,14 +57,14 @@ class Inventory {
                  * @return The status of adding the item.
                  * @see AddItemStatus
                  * */
-                AddItemStatus addItem(std::shared_ptr<GenericItem> item, int index = -1);
+                AddItemStatus addItem(ItemHandle item, int index = -1);
                 /** Removes an item in the inventory.
                  *
                  * @param item The item to remove.
-                 * @return Pointer to the removed item (nullptr is returned
+                 * @return Handle to the removed item (nullptr is returned
                  * if the item is not in inventory).
                  * */
-                std::shared_ptr<GenericItem> removeItem(GenericItem *item);
+                ItemHandle removeItem(GenericItem *item);
                 /** Removes an item in the inventory.
                  *
                  * @overload
@@ -55,10 +73,10 @@ class Inventory {
                  * item found in the inventory.
                  *
                  * @param item The item name to remove.
-                 * @return Pointer to the removed item (nullptr is returned
+                 * @return Handle to the removed item (nullptr is returned
                  * if the item is not in inventory).
                  * */
-                std::shared_ptr<GenericItem> removeItem(std::string item);
+                ItemHandle removeItem(std::string item);
                 /** Removes an item in the inventory.
                  *
                  * @overload
@@ -66,11 +84,11 @@ class Inventory {
                  * on the list instead.
                  *
                  * @param index The index of the item to remove.
-                 * @return Pointer to the removed item (nullptr is returned
+                 * @return Handle to the removed item (nullptr is returned
                  * if the index is not valid ie index too big or item slot is
                  * empty).
                  * */
-                std::shared_ptr<GenericItem> removeItem(unsigned int index);
+                ItemHandle removeItem(unsigned int index);
 
                 //////////
                 // Getters
@@ -92,8 +110,17 @@ class Inventory {
                  * if the item isn't in the inventory).
                  * */
                 GenericItem* getItem(unsigned int index) const;
-                /** Gets the list of items in the inventory. */
-                std::shared_ptr<GenericItem>* getItems() const;
+                /** Gets the list of items in the inventory.
+                 *
+                 * @return The handles of the inventory slots, maxSize() long.
+                 * Empty slots are null handles.
+                 * */
+                const ItemHandle* getItems() const;
+                /** Gets the world owning the items in the inventory.
+                 *
+                 * @return The world.
+                 * */
+                World* getWorld(void) const;
                 /** Gets the max size of the inventory.
                  *
                  * @return Max size of the inventory.
@@ -119,7 +146,10 @@ class Inventory {
                 unsigned int m_max_size = 3; /**<The maximum amount of items the inventory
                                               * can store. */
                 /** The list of items current stored in the inventory. */
-                std::shared_ptr<GenericItem> *inventory_list;
+                ItemHandle *inventory_list;
+                /** The slots of inventories of up to INLINE_SLOTS. */
+                ItemHandle m_inline_list[INLINE_SLOTS];
+                World *m_world = nullptr; /**<The world owning the items. */
 };
 
 #endif // INVENTORY_H_
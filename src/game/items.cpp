@@ -3,6 +3,7 @@
 #include <string>
 
 #include "player.h"
+#include "world.h"
 
 /////////
 // Weapon
@@ -37,6 +38,14 @@ void Weapon::onDropped(Player &entity) {
     entity.setDamage(damage);
 }
 
+/** Gets the damage increase of the weapon.
+ *
+ * @return The damage increase.
+ * */
+int Weapon::getDamage(void) const {
+    return this->m_damage;
+}
+
 /////////////
 // Consumable
 /** Constructor class for a Consumable item.
@@ -52,11 +61,21 @@ Consumable::Consumable(std::string name, int healing):
 
 /** Overriden use behavior from GenericItem.
  *
- * This is use to heal the entity.
+ * This is use to heal the entity. The consumable is destroyed afterwards.
  *
  * @param entity The entity that dropped the weapon.
  * */
 void Consumable::onUsed(Player &entity) {
     entity.healEntity(this->m_healing);
-    entity.dropItem(this);
+    // The consumable is used up, this destroys the item
+    World *world = entity.getInventory()->getWorld();
+    world->destroyItem(entity.dropItem(this));
+}
+
+/** Gets the health healed by the consumable.
+ *
+ * @return The health healed.
+ * */
+int Consumable::getHealing(void) const {
+    return this->m_healing;
 }
@@ -29,6 +29,11 @@ class Weapon: public GenericItem {
          * @param entity The entity that dropped the weapon.
          * */
         virtual void onDropped(Player &entity) override;
+        /** Gets the damage increase of the weapon.
+         *
+         * @return The damage increase.
+         * */
+        int getDamage(void) const;
     private:
         int m_damage = 3;
 };
@@ -45,11 +50,17 @@ class Consumable: public GenericItem {
         Consumable(std::string name = "", int healing = 5);
         /** Overriden use behavior from GenericItem.
          *
-         * This is use to heal the entity.
+         * This is use to heal the entity. The consumable is destroyed
+         * afterwards.
          *
          * @param entity The entity that dropped the weapon.
          * */
         virtual void onUsed(Player &entity) override;
+        /** Gets the health healed by the consumable.
+         *
+         * @return The health healed.
+         * */
+        int getHealing(void) const;
     private:
         int m_healing = 5;
 };
@@ -0,0 +1,168 @@
+#include "json-record.h"
+
+/** Constructor for JsonRecord, starts the object.
+ *
+ * @param out The stream the record is written to.
+ * @param event The name of the event.
+ * */
+JsonRecord::JsonRecord(std::ostream &out, std::string_view event):
+    m_out(out) {
+    this->m_out << "{\"event\":";
+    this->writeString(event);
+}
+
+/** Destructor for JsonRecord, closes whatever is still open and ends the
+ * line. */
+JsonRecord::~JsonRecord(void) {
+    while (this->m_depth > 0) {
+        this->end();
+    }
+    this->m_out << "}\n";
+}
+
+/** Adds a string field.
+ *
+ * @param key The name of the field.
+ * @param value The string, it is escaped.
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::add(std::string_view key, std::string_view value) {
+    this->next(key);
+    this->writeString(value);
+    return *this;
+}
+
+/** Adds an integer field.
+ *
+ * @param key The name of the field.
+ * @param value The integer.
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::add(std::string_view key, int64_t value) {
+    this->next(key);
+    this->m_out << value;
+    return *this;
+}
+
+/** Adds a boolean field.
+ *
+ * @param key The name of the field.
+ * @param value The boolean.
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::addBool(std::string_view key, bool value) {
+    this->next(key);
+    this->m_out << (value ? "true" : "false");
+    return *this;
+}
+
+/** Adds a string to the list being written.
+ *
+ * @param value The string, it is escaped.
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::item(std::string_view value) {
+    this->next("");
+    this->writeString(value);
+    return *this;
+}
+
+/** Starts a list field.
+ *
+ * @param key The name of the field.
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::beginList(std::string_view key) {
+    this->next(key);
+    this->open(true);
+    return *this;
+}
+
+/** Starts an object in the list being written.
+ *
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::beginObject(void) {
+    this->next("");
+    this->open(false);
+    return *this;
+}
+
+/** Ends the list or the object being written.
+ *
+ * @return The record.
+ * */
+JsonRecord& JsonRecord::end(void) {
+    if (this->m_depth > 0) {
+        this->m_out << ((this->m_is_list >> this->m_depth) & 1 ? ']' : '}');
+        this->m_depth--;
+    }
+    return *this;
+}
+
+/////////
+// private
+/** Writes the separator before a value and its key.
+ *
+ * @param key The name of the field, empty in a list.
+ * */
+void JsonRecord::next(std::string_view key) {
+    uint32_t level = 1u << this->m_depth;
+    if (this->m_has_value & level) {
+        this->m_out << ',';
+    }
+    this->m_has_value |= level;
+    if (!(this->m_is_list & level)) {
+        this->writeString(key);
+        this->m_out << ':';
+    }
+}
+
+/** Writes an escaped string in quotes.
+ *
+ * @param text The string.
+ * */
+void JsonRecord::writeString(std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    this->m_out << '"';
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = (unsigned char) text[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        // Writing the plain run before the escaped character
+        this->m_out.write(text.data() + start, i - start);
+        start = i + 1;
+        if (c == '"' || c == '\\') {
+            this->m_out << '\\' << (char) c;
+        } else if (c == '\n') {
+            this->m_out << "\\n";
+        } else if (c == '\t') {
+            this->m_out << "\\t";
+        } else {
+            this->m_out << "\\u00" << HEX[c >> 4] << HEX[c & 15];
+        }
+    }
+    this->m_out.write(text.data() + start, text.size() - start);
+    this->m_out << '"';
+}
+
+/** Opens a list or an object.
+ *
+ * @param list If a list is opened.
+ * */
+void JsonRecord::open(bool list) {
+    if (this->m_depth >= MAX_DEPTH) {
+        return;
+    }
+    this->m_out << (list ? '[' : '{');
+    this->m_depth++;
+    uint32_t level = 1u << this->m_depth;
+    this->m_has_value &= ~level;
+    if (list) {
+        this->m_is_list |= level;
+    } else {
+        this->m_is_list &= ~level;
+    }
+}
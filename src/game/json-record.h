@@ -0,0 +1,111 @@
+#ifndef JSON_RECORD_H_
+#define JSON_RECORD_H_
+
+/** @file json-record.h
+ *
+ * Header file containing the writer of the line delimited JSON records the
+ * game outputs for bot clients.
+ * */
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/** Writes one JSON object on its own line.
+ *
+ * The object is written as its fields are added and closed with a new line
+ * when the record is destroyed, so nothing is allocated. Every record has
+ * an "event" field naming it.
+ *
+ * @code
+ * JsonRecord(out, "get").add("status", "SUCCESS").add("item_id", 3);
+ * @endcode
+ *
+ * Writes {"event":"get","status":"SUCCESS","item_id":3}.
+ * */
+class JsonRecord {
+        public:
+                /** Most lists and objects nested in a record. */
+                static constexpr int MAX_DEPTH = 31;
+
+                /** Constructor for JsonRecord, starts the object.
+                 *
+                 * @param out The stream the record is written to.
+                 * @param event The name of the event.
+                 * */
+                JsonRecord(std::ostream &out, std::string_view event);
+                /** Destructor for JsonRecord, closes whatever is still open
+                 * and ends the line. */
+                ~JsonRecord(void);
+                JsonRecord(const JsonRecord &) = delete;
+                JsonRecord& operator = (const JsonRecord &) = delete;
+
+                /** Adds a string field.
+                 *
+                 * @param key The name of the field.
+                 * @param value The string, it is escaped.
+                 * @return The record.
+                 * */
+                JsonRecord& add(std::string_view key, std::string_view value);
+                /** Adds an integer field.
+                 *
+                 * @param key The name of the field.
+                 * @param value The integer.
+                 * @return The record.
+                 * */
+                JsonRecord& add(std::string_view key, int64_t value);
+                /** Adds a boolean field.
+                 *
+                 * @param key The name of the field.
+                 * @param value The boolean.
+                 * @return The record.
+                 * */
+                JsonRecord& addBool(std::string_view key, bool value);
+                /** Adds a string to the list being written.
+                 *
+                 * @param value The string, it is escaped.
+                 * @return The record.
+                 * */
+                JsonRecord& item(std::string_view value);
+                /** Starts a list field.
+                 *
+                 * @param key The name of the field.
+                 * @return The record.
+                 * */
+                JsonRecord& beginList(std::string_view key);
+                /** Starts an object in the list being written.
+                 *
+                 * @return The record.
+                 * */
+                JsonRecord& beginObject(void);
+                /** Ends the list or the object being written.
+                 *
+                 * @return The record.
+                 * */
+                JsonRecord& end(void);
+        private:
+                /** Writes the separator before a value and its key.
+                 *
+                 * @param key The name of the field, empty in a list.
+                 * */
+                void next(std::string_view key);
+                /** Writes an escaped string in quotes.
+                 *
+                 * @param text The string.
+                 * */
+                void writeString(std::string_view text);
+                /** Opens a list or an object.
+                 *
+                 * @param list If a list is opened.
+                 * */
+                void open(bool list);
+
+                std::ostream &m_out; /**<Where the record is written. */
+                int m_depth = 0; /**<Number of lists and objects open. */
+                /** Bit i is set once level i has a value. */
+                uint32_t m_has_value = 1;
+                /** Bit i is set if level i is a list. */
+                uint32_t m_is_list = 0;
+};
+
+#endif // JSON_RECORD_H_
@@ -0,0 +1,220 @@
+#include "leaderboard.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+
+/** Shard of the next thread submitting a score. */
+static std::atomic<size_t> next_shard{0};
+
+/** Gets the time of the steady clock.
+ *
+ * @return The time in nanoseconds.
+ * */
+static int64_t steadyNow(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Constructor for Leaderboard. */
+Leaderboard::Leaderboard(void): m_better(MAX_SCORE + 1, 0) {
+}
+
+//////////
+// Setters
+/** Submits the score of an ended game.
+ *
+ * Saves the leaderboard if it is persisted and the interval passed since
+ * the last save.
+ *
+ * @param score The score.
+ * */
+void Leaderboard::submit(int score) {
+    Shard &shard = this->threadShard();
+    shard.counts[clampScore(score)].fetch_add(1, std::memory_order_relaxed);
+    shard.version.fetch_add(1, std::memory_order_release);
+
+    // Only the thread claiming the due save writes the file
+    int64_t next_save = this->m_next_save.load(std::memory_order_relaxed);
+    if (next_save >= 0 && steadyNow() >= next_save &&
+        this->m_next_save.compare_exchange_strong(next_save, INT64_MAX,
+                                                  std::memory_order_relaxed)) {
+        this->save();
+    }
+}
+
+/** Persists the leaderboard to a file.
+ *
+ * The scores already in the file are added to the leaderboard.
+ *
+ * @param path The file.
+ * @param interval The least time between two saves done by submit(), 0
+ * saves after every submitted score.
+ * @return If the file could be read, a missing file is treated as empty.
+ * */
+bool Leaderboard::persistTo(const std::string &path,
+                            std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(this->m_save_mutex);
+    this->m_path = path;
+    this->m_interval = interval;
+    this->m_next_save.store(steadyNow() + std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(interval).count(),
+                            std::memory_order_relaxed);
+    return this->load();
+}
+
+/** Writes the leaderboard to its file.
+ *
+ * The file is replaced at once, so a reader never sees it partly written.
+ *
+ * @return If the file was written, false if the leaderboard isn't
+ * persisted.
+ * */
+bool Leaderboard::save(void) {
+    std::lock_guard<std::mutex> lock(this->m_save_mutex);
+    if (this->m_path.empty()) {
+        return false;
+    }
+    this->m_next_save.store(steadyNow() + std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(this->m_interval).count(),
+                            std::memory_order_relaxed);
+
+    std::vector<LeaderboardEntry> scores = this->top(MAX_SCORE + 1);
+    std::string temporary = this->m_path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        for (const LeaderboardEntry &entry: scores) {
+            file << entry.score << " " << entry.games << "\n";
+        }
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), this->m_path.c_str()) == 0;
+}
+
+//////////
+// Getters
+/** Gets the best scores.
+ *
+ * @param count The number of distinct scores.
+ * @return The best scores from the best.
+ * */
+std::vector<LeaderboardEntry> Leaderboard::top(size_t count) {
+    std::lock_guard<std::mutex> lock(this->m_merge_mutex);
+    this->merge();
+    count = std::min(count, this->m_scores.size());
+    return std::vector<LeaderboardEntry>(this->m_scores.begin(),
+                                         this->m_scores.begin() + count);
+}
+
+/** Gets the rank a score would have.
+ *
+ * @param score The score.
+ * @return The rank, 1 more than the number of games with a better score.
+ * */
+uint64_t Leaderboard::rank(int score) {
+    std::lock_guard<std::mutex> lock(this->m_merge_mutex);
+    this->merge();
+    return this->m_better[clampScore(score)] + 1;
+}
+
+/** Gets the number of games submitted.
+ *
+ * @return The number of games.
+ * */
+uint64_t Leaderboard::games(void) {
+    std::lock_guard<std::mutex> lock(this->m_merge_mutex);
+    this->merge();
+    return this->m_games;
+}
+
+/////////
+// private
+/** Gets the shard of the calling thread.
+ *
+ * Threads are given the shards in turn the first time they submit.
+ *
+ * @return The shard.
+ * */
+Leaderboard::Shard& Leaderboard::threadShard(void) {
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return this->m_shards[shard];
+}
+
+/** Clamps a score to the counted scores.
+ *
+ * @param score The score.
+ * @return The counted score.
+ * */
+int Leaderboard::clampScore(int score) {
+    return std::clamp(score, 0, MAX_SCORE);
+}
+
+/** Merges the shards if a score was submitted since the last merge,
+ * m_merge_mutex must be held.
+ * */
+void Leaderboard::merge(void) {
+    uint64_t version = 0;
+    for (const Shard &shard: this->m_shards) {
+        version += shard.version.load(std::memory_order_acquire);
+    }
+    if (version == this->m_merged_version) {
+        return;
+    }
+
+    // Scores submitted while merging bump the version again, so they are
+    // merged by the next query
+    this->m_merged_version = version;
+    this->m_scores.clear();
+    uint64_t better = 0;
+    for (int score = MAX_SCORE; score >= 0; score--) {
+        this->m_better[score] = better;
+        uint64_t games = 0;
+        for (const Shard &shard: this->m_shards) {
+            games += shard.counts[score].load(std::memory_order_relaxed);
+        }
+        if (games > 0) {
+            LeaderboardEntry entry;
+            entry.score = score;
+            entry.games = games;
+            entry.rank = better + 1;
+            this->m_scores.push_back(entry);
+            better += games;
+        }
+    }
+    this->m_games = better;
+}
+
+/** Adds the scores of the file to the leaderboard.
+ *
+ * @return If the file could be read.
+ * */
+bool Leaderboard::load(void) {
+    std::ifstream file(this->m_path);
+    if (!file.is_open()) {
+        return true;
+    }
+
+    Shard &shard = this->threadShard();
+    int score;
+    uint64_t games;
+    while (file >> score >> games) {
+        shard.counts[clampScore(score)].fetch_add((uint32_t) games,
+                                                  std::memory_order_relaxed);
+        shard.version.fetch_add(games, std::memory_order_release);
+    }
+    return file.eof();
+}
+
+/////////////
+// Functions
+/** Gets the leaderboard of the process.
+ *
+ * @return The leaderboard shared by every game.
+ * */
+Leaderboard& globalLeaderboard(void) {
+    static Leaderboard leaderboard;
+    return leaderboard;
+}
@@ -0,0 +1,150 @@
+#ifndef LEADERBOARD_H_
+#define LEADERBOARD_H_
+
+/** @file leaderboard.h
+ *
+ * Header file containing the leaderboard of the scores of every game ended
+ * in the process.
+ * */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Games that ended with the same score. */
+struct LeaderboardEntry {
+        int score = 0; /**<The score. */
+        uint64_t games = 0; /**<Number of games with the score. */
+        uint64_t rank = 0; /**<Rank of the score, 1 is the best. */
+};
+
+/** Leaderboard of scores updated by many sessions at once.
+ *
+ * Every thread counts its scores in its own shard without locking. The
+ * shards are only merged when a query finds that a score was submitted
+ * since the last merge, so repeated queries are answered from the merged
+ * view. Scores above MAX_SCORE are counted as MAX_SCORE and negative scores
+ * as 0.
+ * */
+class Leaderboard {
+        public:
+                /** Number of shards the scores are counted in. */
+                static constexpr size_t SHARDS = 16;
+                /** Highest score counted separately. */
+                static constexpr int MAX_SCORE = 4095;
+
+                /** Constructor for Leaderboard. */
+                Leaderboard(void);
+                Leaderboard(const Leaderboard &) = delete;
+                Leaderboard& operator = (const Leaderboard &) = delete;
+
+                //////////
+                // Setters
+                /** Submits the score of an ended game.
+                 *
+                 * Saves the leaderboard if it is persisted and the interval
+                 * passed since the last save.
+                 *
+                 * @param score The score.
+                 * */
+                void submit(int score);
+                /** Persists the leaderboard to a file.
+                 *
+                 * The scores already in the file are added to the
+                 * leaderboard.
+                 *
+                 * @param path The file.
+                 * @param interval The least time between two saves done by
+                 * submit(), 0 saves after every submitted score.
+                 * @return If the file could be read, a missing file is
+                 * treated as empty.
+                 * */
+                bool persistTo(const std::string &path,
+                               std::chrono::milliseconds interval);
+                /** Writes the leaderboard to its file.
+                 *
+                 * The file is replaced at once, so a reader never sees it
+                 * partly written.
+                 *
+                 * @return If the file was written, false if the leaderboard
+                 * isn't persisted.
+                 * */
+                bool save(void);
+
+                //////////
+                // Getters
+                /** Gets the best scores.
+                 *
+                 * @param count The number of distinct scores.
+                 * @return The best scores from the best.
+                 * */
+                std::vector<LeaderboardEntry> top(size_t count);
+                /** Gets the rank a score would have.
+                 *
+                 * @param score The score.
+                 * @return The rank, 1 more than the number of games with a
+                 * better score.
+                 * */
+                uint64_t rank(int score);
+                /** Gets the number of games submitted.
+                 *
+                 * @return The number of games.
+                 * */
+                uint64_t games(void);
+        private:
+                /** The scores counted by some of the threads. */
+                struct alignas(64) Shard {
+                    std::atomic<uint64_t> version{0}; /**<Number of scores submitted. */
+                    std::atomic<uint32_t> counts[MAX_SCORE + 1] = {}; /**<Games of each score. */
+                };
+
+                /** Gets the shard of the calling thread.
+                 *
+                 * @return The shard.
+                 * */
+                Shard& threadShard(void);
+                /** Clamps a score to the counted scores.
+                 *
+                 * @param score The score.
+                 * @return The counted score.
+                 * */
+                static int clampScore(int score);
+                /** Merges the shards if a score was submitted since the last
+                 * merge, m_merge_mutex must be held.
+                 * */
+                void merge(void);
+                /** Adds the scores of the file to the leaderboard.
+                 *
+                 * @return If the file could be read.
+                 * */
+                bool load(void);
+
+                Shard m_shards[SHARDS]; /**<The shards. */
+
+                std::mutex m_merge_mutex; /**<Guards the merged view. */
+                uint64_t m_merged_version = 0; /**<Scores submitted at the last merge. */
+                uint64_t m_games = 0; /**<Games merged. */
+                /** Games with a better score than each score. */
+                std::vector<uint64_t> m_better;
+                /** The distinct scores from the best. */
+                std::vector<LeaderboardEntry> m_scores;
+
+                std::mutex m_save_mutex; /**<Guards the file. */
+                std::string m_path; /**<The file, empty if not persisted. */
+                std::chrono::milliseconds m_interval{0}; /**<Least time between saves. */
+                /** Time of the next save by submit() in steady clock
+                 * nanoseconds, -1 if not persisted. */
+                std::atomic<int64_t> m_next_save{-1};
+};
+
+/** Gets the leaderboard of the process.
+ *
+ * @return The leaderboard shared by every game.
+ * */
+Leaderboard& globalLeaderboard(void);
+
+#endif // LEADERBOARD_H_
@@ -0,0 +1,73 @@
+#include "object-pool.h"
+
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <mutex>
+
+/** A pool registered to be reported. */
+struct PoolEntry {
+    const char *name; /**<The mangled name of the type of the pool. */
+    PoolStats (*stats)(void); /**<Gets the counters of the pool. */
+};
+
+/** Guards the registered pools. */
+static std::mutex registry_mutex;
+/** The pools registered so far. */
+static std::vector<PoolEntry> registry;
+
+/** Converts the mangled name of a type to the name in the source.
+ *
+ * @param name The mangled name.
+ * @return The name of the type, the mangled name if it can't be converted.
+ * */
+static std::string demangle(const char *name) {
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr) {
+        return name;
+    }
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+}
+
+/** Registers a pool so its counters are reported.
+ *
+ * @param name The mangled name of the type of the pool.
+ * @param stats Gets the counters of the pool.
+ * */
+void registerObjectPool(const char *name, PoolStats (*stats)(void)) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back({name, stats});
+}
+
+/** Gets the counters of every pool used so far.
+ *
+ * @return The name of the type of each pool with its counters.
+ * */
+std::vector<std::pair<std::string, PoolStats>> objectPoolStats(void) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::vector<std::pair<std::string, PoolStats>> pools;
+    for (const PoolEntry &entry: registry) {
+        pools.emplace_back(demangle(entry.name), entry.stats());
+    }
+    return pools;
+}
+
+/** Writes the counters of every pool used so far.
+ *
+ * @param out The stream to write to.
+ * */
+void writeObjectPoolStats(std::ostream &out) {
+    out << "Object pools:" << std::endl;
+    out << std::left << std::setw(14) << "type" << std::right
+        << std::setw(8) << "live" << std::setw(12) << "high water"
+        << std::setw(10) << "capacity" << std::endl;
+    for (const auto &pool: objectPoolStats()) {
+        out << std::left << std::setw(14) << pool.first << std::right
+            << std::setw(8) << pool.second.live
+            << std::setw(12) << pool.second.high_water
+            << std::setw(10) << pool.second.capacity << std::endl;
+    }
+}
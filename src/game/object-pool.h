@@ -0,0 +1,263 @@
+#ifndef OBJECT_POOL_H_
+#define OBJECT_POOL_H_
+
+/** @file object-pool.h
+ *
+ * Header file containing the pools the items and enemies of the worlds are
+ * allocated from.
+ *
+ * Every type has its own pool of cache line aligned slots carved from
+ * blocks. Each thread keeps a cache of free slots, only refilling and
+ * flushing it in batches goes through the lock of the shared pool. The
+ * blocks are never given back to the global allocator.
+ * */
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/** Size of a cache line. */
+constexpr size_t CACHE_LINE = 64;
+
+/** Counters of an object pool. */
+struct PoolStats {
+        size_t live = 0; /**<Number of objects allocated from the pool. */
+        size_t high_water = 0; /**<Most objects allocated at once. */
+        size_t capacity = 0; /**<Number of slots carved from blocks. */
+};
+
+/** Registers a pool so its counters are reported.
+ *
+ * @param name The mangled name of the type of the pool.
+ * @param stats Gets the counters of the pool.
+ * */
+void registerObjectPool(const char *name, PoolStats (*stats)(void));
+
+/** Gets the counters of every pool used so far.
+ *
+ * @return The name of the type of each pool with its counters.
+ * */
+std::vector<std::pair<std::string, PoolStats>> objectPoolStats(void);
+
+/** Writes the counters of every pool used so far.
+ *
+ * @param out The stream to write to.
+ * */
+void writeObjectPoolStats(std::ostream &out);
+
+/** Pool of objects of a single type.
+ *
+ * @code
+ * Weapon *sword = ObjectPool<Weapon>::create("Sword", 2);
+ * ObjectPool<Weapon>::destroy(sword);
+ * @endcode
+ * */
+template <class T>
+class ObjectPool {
+        public:
+                /** Number of slots of a block. */
+                static constexpr size_t BLOCK_SLOTS = 64;
+                /** Number of slots moved between a thread and the shared
+                 * pool at once. */
+                static constexpr size_t BATCH_SLOTS = 32;
+
+                ObjectPool(void) = delete;
+
+                /** Constructs an object in the pool.
+                 *
+                 * @param args The arguments to the constructor of the object.
+                 * @return The new object.
+                 * */
+                template <class... Args>
+                static T* create(Args&&... args) {
+                    Slot *slot = allocate();
+                    try {
+                        return new (slot->storage) T(std::forward<Args>(args)...);
+                    } catch (...) {
+                        deallocate(slot);
+                        throw;
+                    }
+                }
+                /** Destroys an object created by the pool.
+                 *
+                 * @param object The object to destroy, nullptr is ignored.
+                 * */
+                static void destroy(T *object) {
+                    if (object == nullptr) {
+                        return;
+                    }
+                    object->~T();
+                    deallocate(reinterpret_cast<Slot *>(object));
+                }
+
+                //////////
+                // Getters
+                /** Gets the counters of the pool.
+                 *
+                 * @return The counters.
+                 * */
+                static PoolStats stats(void) {
+                    Shared &pool = shared();
+                    PoolStats stats;
+                    stats.live = pool.live.load(std::memory_order_relaxed);
+                    stats.high_water = pool.high_water.load(std::memory_order_relaxed);
+                    stats.capacity = pool.capacity.load(std::memory_order_relaxed);
+                    return stats;
+                }
+        private:
+                /** A slot holding an object or the next free slot. */
+                union alignas(CACHE_LINE) Slot {
+                    Slot *next; /**<The next free slot. */
+                    alignas(T) unsigned char storage[sizeof(T)]; /**<The object. */
+                };
+
+                /** The free slots shared by every thread. */
+                struct Shared {
+                    std::mutex mutex; /**<Guards the free slots and blocks. */
+                    Slot *free = nullptr; /**<The free slots. */
+                    std::vector<Slot *> blocks; /**<The blocks carved so far. */
+                    std::atomic<size_t> live{0}; /**<Objects allocated. */
+                    std::atomic<size_t> high_water{0}; /**<Most objects allocated. */
+                    std::atomic<size_t> capacity{0}; /**<Slots carved. */
+                };
+
+                /** The free slots cached by a thread. */
+                struct Cache {
+                    Slot *free = nullptr; /**<The free slots. */
+                    size_t size = 0; /**<Number of free slots. */
+                    bool registered = false; /**<If the flusher was created. */
+                    bool closed = false; /**<If the thread is exiting. */
+                };
+
+                /** Gives the cache of a thread back to the shared pool when
+                 * the thread exits. */
+                struct Flusher {
+                    ~Flusher(void) {
+                        Cache &thread_cache = cache();
+                        flush(thread_cache, thread_cache.size);
+                        thread_cache.closed = true;
+                    }
+                };
+
+                /** Gets the shared pool, it lives until the process exits
+                 * so objects can be destroyed at any time.
+                 *
+                 * @return The shared pool.
+                 * */
+                static Shared& shared(void) {
+                    static Shared *pool = [](void) {
+                        registerObjectPool(typeid(T).name(), &ObjectPool::stats);
+                        return new Shared();
+                    }();
+                    return *pool;
+                }
+                /** Gets the cache of the calling thread.
+                 *
+                 * @return The cache.
+                 * */
+                static Cache& cache(void) {
+                    thread_local Cache thread_cache;
+                    if (!thread_cache.registered) {
+                        thread_cache.registered = true;
+                        thread_local Flusher flusher;
+                        (void) flusher;
+                    }
+                    return thread_cache;
+                }
+
+                /** Takes a free slot.
+                 *
+                 * @return The slot.
+                 * */
+                static Slot* allocate(void) {
+                    Shared &pool = shared();
+                    Cache &thread_cache = cache();
+                    if (thread_cache.free == nullptr) {
+                        refill(thread_cache);
+                    }
+                    Slot *slot = thread_cache.free;
+                    thread_cache.free = slot->next;
+                    thread_cache.size--;
+
+                    size_t live = pool.live.fetch_add(1, std::memory_order_relaxed) + 1;
+                    size_t high_water = pool.high_water.load(std::memory_order_relaxed);
+                    while (live > high_water &&
+                           !pool.high_water.compare_exchange_weak(
+                               high_water, live, std::memory_order_relaxed)) {
+                    }
+                    return slot;
+                }
+                /** Gives back a slot.
+                 *
+                 * @param slot The slot.
+                 * */
+                static void deallocate(Slot *slot) {
+                    Shared &pool = shared();
+                    pool.live.fetch_sub(1, std::memory_order_relaxed);
+                    Cache &thread_cache = cache();
+                    if (thread_cache.closed) {
+                        std::lock_guard<std::mutex> lock(pool.mutex);
+                        slot->next = pool.free;
+                        pool.free = slot;
+                        return;
+                    }
+
+                    slot->next = thread_cache.free;
+                    thread_cache.free = slot;
+                    thread_cache.size++;
+                    if (thread_cache.size > 2 * BATCH_SLOTS) {
+                        flush(thread_cache, BATCH_SLOTS);
+                    }
+                }
+                /** Moves a batch of free slots from the shared pool to the
+                 * cache of a thread, carving a new block if there are none.
+                 *
+                 * @param thread_cache The cache of the thread.
+                 * */
+                static void refill(Cache &thread_cache) {
+                    Shared &pool = shared();
+                    std::lock_guard<std::mutex> lock(pool.mutex);
+                    if (pool.free == nullptr) {
+                        Slot *block = static_cast<Slot *>(::operator new(
+                            BLOCK_SLOTS * sizeof(Slot), std::align_val_t(alignof(Slot))));
+                        pool.blocks.push_back(block);
+                        for (size_t i = 0; i < BLOCK_SLOTS; i++) {
+                            block[i].next = pool.free;
+                            pool.free = &block[i];
+                        }
+                        pool.capacity.fetch_add(BLOCK_SLOTS, std::memory_order_relaxed);
+                    }
+                    for (size_t i = 0; i < BATCH_SLOTS && pool.free != nullptr; i++) {
+                        Slot *slot = pool.free;
+                        pool.free = slot->next;
+                        slot->next = thread_cache.free;
+                        thread_cache.free = slot;
+                        thread_cache.size++;
+                    }
+                }
+                /** Moves free slots from the cache of a thread to the shared
+                 * pool.
+                 *
+                 * @param thread_cache The cache of the thread.
+                 * @param count The number of slots to move.
+                 * */
+                static void flush(Cache &thread_cache, size_t count) {
+                    Shared &pool = shared();
+                    std::lock_guard<std::mutex> lock(pool.mutex);
+                    for (size_t i = 0; i < count && thread_cache.free != nullptr; i++) {
+                        Slot *slot = thread_cache.free;
+                        thread_cache.free = slot->next;
+                        thread_cache.size--;
+                        slot->next = pool.free;
+                        pool.free = slot;
+                    }
+                }
+};
+
+#endif // OBJECT_POOL_H_
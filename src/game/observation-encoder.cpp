@@ -0,0 +1,192 @@
+#include "observation-encoder.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "enemies.h"
+#include "inventory.h"
+
+/** Writes a value if it changed.
+ *
+ * @param buffer The buffer.
+ * @param index Where the value goes.
+ * @param value The value.
+ * @param full If the value is written even if it didn't change.
+ * @param written Counts the values written.
+ * */
+template<typename T>
+static inline void put(T *buffer, size_t index, int32_t value, bool full, size_t &written) {
+    T converted = (T) value;
+    if (full || buffer[index] != converted) {
+        buffer[index] = converted;
+        written++;
+    }
+}
+
+/** Reads a count from a previous encoding.
+ *
+ * @param value The value in the buffer.
+ * @param limit The largest count.
+ * @return The count, limit if the value isn't a count.
+ * */
+template<typename T>
+static inline size_t previousCount(T value, size_t limit) {
+    return value >= 0 && value <= (T) limit ? (size_t) value : limit;
+}
+
+/** Constructor for ObservationEncoder.
+ *
+ * @param max_items The most items in a room that are encoded, the others are
+ * left out.
+ * @param max_enemies The most enemies in a room that are encoded, the others
+ * are left out.
+ * @param inventory_slots The size of the inventory of the player.
+ * */
+ObservationEncoder::ObservationEncoder(size_t max_items, size_t max_enemies,
+                                       unsigned int inventory_slots):
+    m_max_items(max_items), m_max_enemies(max_enemies),
+    m_inventory_slots(inventory_slots) {
+}
+
+/** Encodes what the player of a game observes.
+ *
+ * @param game The game, it must have a player and a room.
+ * @param buffer The buffer, getSize() values long.
+ * @param full If every value is written, otherwise only the values
+ * different from the buffer are.
+ * @return The number of values written.
+ * */
+size_t ObservationEncoder::encode(HKGE &game, int32_t *buffer, bool full) const {
+    return this->encodeInto(game, buffer, full);
+}
+
+/** Encodes what the player of a game observes.
+ *
+ * @overload
+ *
+ * @param game The game, it must have a player and a room.
+ * @param buffer The buffer, getSize() values long.
+ * @param full If every value is written, otherwise only the values
+ * different from the buffer are.
+ * @return The number of values written.
+ * */
+size_t ObservationEncoder::encode(HKGE &game, float *buffer, bool full) const {
+    return this->encodeInto(game, buffer, full);
+}
+
+//////////
+// Getters
+/** Gets the number of values of an encoding.
+ *
+ * @return The number of values.
+ * */
+size_t ObservationEncoder::getSize(void) const {
+    return this->getEnemiesOffset() + this->m_max_enemies * ENEMY_FIELDS;
+}
+
+/** Gets where the inventory slots start.
+ *
+ * @return The index of the first slot.
+ * */
+size_t ObservationEncoder::getInventoryOffset(void) const {
+    return HEADER_FIELDS;
+}
+
+/** Gets where the items in the room start.
+ *
+ * @return The index of the first item.
+ * */
+size_t ObservationEncoder::getItemsOffset(void) const {
+    return this->getInventoryOffset() + this->m_inventory_slots;
+}
+
+/** Gets where the enemies in the room start.
+ *
+ * @return The index of the first enemy.
+ * */
+size_t ObservationEncoder::getEnemiesOffset(void) const {
+    return this->getItemsOffset() + this->m_max_items;
+}
+
+/////////
+// private
+/** Encodes into a buffer of any type of number.
+ *
+ * @param game The game.
+ * @param buffer The buffer.
+ * @param full If every value is written.
+ * @return The number of values written.
+ * */
+template<typename T>
+size_t ObservationEncoder::encodeInto(HKGE &game, T *buffer, bool full) const {
+    Room *room = game.getRoom();
+    Player *player = game.getPlayer();
+    World *world = room->getWorld();
+    size_t written = 0;
+
+    // The room and its exits
+    int32_t exits = 0;
+    int32_t locks = 0;
+    for (Direction direction: {Direction::NORTH, Direction::SOUTH,
+        Direction::EAST, Direction::WEST}) {
+        Room *exit = room->getRoom(direction);
+        if (exit != nullptr) {
+            exits |= 1 << direction;
+            locks |= (exit->isLocked() ? 1 : 0) << direction;
+        }
+    }
+    put(buffer, ROOM_FIELD, (int32_t) room->getId(), full, written);
+    put(buffer, EXITS_FIELD, exits, full, written);
+    put(buffer, LOCKS_FIELD, locks, full, written);
+
+    // The player
+    put(buffer, HEALTH_FIELD, player->getCurrentHealth(), full, written);
+    put(buffer, MAX_HEALTH_FIELD, player->getMaxHealth(), full, written);
+    put(buffer, DAMAGE_FIELD, player->getDamage(), full, written);
+    put(buffer, XP_FIELD, player->getXP(), full, written);
+
+    // The inventory, a smaller one leaves the last slots empty
+    Inventory *inventory = player->getInventory();
+    const ItemHandle *slots = inventory->getItems();
+    size_t offset = this->getInventoryOffset();
+    for (unsigned int i = 0; i < this->m_inventory_slots; i++) {
+        bool held = i < inventory->maxSize() && slots[i] != nullptr;
+        put(buffer, offset + i, held ? (int32_t) slots[i].getIndex() + 1 : 0, full, written);
+    }
+
+    // The items and enemies in the room, the places the previous room filled
+    // are emptied
+    const std::vector<ItemHandle> &items = room->getItemHandles();
+    const std::vector<EnemyHandle> &enemies = room->getEnemyHandles();
+    size_t item_count = std::min(items.size(), this->m_max_items);
+    size_t enemy_count = std::min(enemies.size(), this->m_max_enemies);
+    size_t item_places = full ? this->m_max_items :
+                         std::max(item_count, previousCount(buffer[ITEMS_FIELD], this->m_max_items));
+    size_t enemy_places = full ? this->m_max_enemies :
+                          std::max(enemy_count, previousCount(buffer[ENEMIES_FIELD], this->m_max_enemies));
+    put(buffer, ITEMS_FIELD, (int32_t) item_count, full, written);
+    put(buffer, ENEMIES_FIELD, (int32_t) enemy_count, full, written);
+
+    offset = this->getItemsOffset();
+    for (size_t i = 0; i < item_places; i++) {
+        put(buffer, offset + i, i < item_count ? (int32_t) items[i].getIndex() + 1 : 0,
+            full, written);
+    }
+    offset = this->getEnemiesOffset();
+    for (size_t i = 0; i < enemy_places; i++) {
+        int32_t id = 0;
+        int32_t alive = 0;
+        int32_t health = 0;
+        // An enemy destroyed by the world is an empty place
+        GenericEnemy *enemy = i < enemy_count ? world->getEnemy(enemies[i]) : nullptr;
+        if (enemy != nullptr) {
+            id = (int32_t) enemies[i].getIndex() + 1;
+            alive = enemy->isDead() ? 0 : 1;
+            health = enemy->getCurrentHealth();
+        }
+        put(buffer, offset + i * ENEMY_FIELDS, id, full, written);
+        put(buffer, offset + i * ENEMY_FIELDS + 1, alive, full, written);
+        put(buffer, offset + i * ENEMY_FIELDS + 2, health, full, written);
+    }
+    return written;
+}
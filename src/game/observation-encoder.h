@@ -0,0 +1,127 @@
+#ifndef OBSERVATION_ENCODER_H_
+#define OBSERVATION_ENCODER_H_
+
+/** @file observation-encoder.h
+ *
+ * Header file containing the encoder of the state a player observes into
+ * fixed-size numbers for learning agents and analytics.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "game-engine.h"
+
+/** Encodes what the player of a game observes into a buffer of numbers.
+ *
+ * The buffer has getSize() values laid out as:
+ * - ROOM_FIELD: the id of the room the player is in.
+ * - EXITS_FIELD: a bit for every exit of the room, 1 << NORTH to 1 << WEST.
+ * - LOCKS_FIELD: a bit for every exit leading to a locked room.
+ * - HEALTH_FIELD to XP_FIELD: the health, most health, damage and XP of the
+ *   player.
+ * - ITEMS_FIELD and ENEMIES_FIELD: the number of items and enemies in the
+ *   room that are encoded.
+ * - getInventoryOffset(): the item in each inventory slot.
+ * - getItemsOffset(): the items in the room.
+ * - getEnemiesOffset(): ENEMY_FIELDS values for every enemy in the room,
+ *   its id, 1 if it is alive and its health.
+ *
+ * Items and enemies are identified by the index of their handle plus one, 0
+ * is an empty place.
+ *
+ * The buffer is expected to hold the previous encoding of the same game,
+ * and only the values that changed are written. Only the room and the
+ * inventory are read and only the places of the items and enemies of the
+ * previous and the current room are visited, so the cost of an encoding
+ * doesn't depend on the size of the world. A full encoding writes every
+ * value.
+ * */
+class ObservationEncoder {
+        public:
+                static constexpr size_t ROOM_FIELD = 0; /**<Id of the room. */
+                static constexpr size_t EXITS_FIELD = 1; /**<Exits of the room. */
+                static constexpr size_t LOCKS_FIELD = 2; /**<Locked exits of the room. */
+                static constexpr size_t HEALTH_FIELD = 3; /**<Health of the player. */
+                static constexpr size_t MAX_HEALTH_FIELD = 4; /**<Most health of the player. */
+                static constexpr size_t DAMAGE_FIELD = 5; /**<Damage of the player. */
+                static constexpr size_t XP_FIELD = 6; /**<XP of the player. */
+                static constexpr size_t ITEMS_FIELD = 7; /**<Items in the room. */
+                static constexpr size_t ENEMIES_FIELD = 8; /**<Enemies in the room. */
+                /** Number of values before the inventory. */
+                static constexpr size_t HEADER_FIELDS = 9;
+                /** Number of values of an enemy. */
+                static constexpr size_t ENEMY_FIELDS = 3;
+
+                /** Constructor for ObservationEncoder.
+                 *
+                 * @param max_items The most items in a room that are
+                 * encoded, the others are left out.
+                 * @param max_enemies The most enemies in a room that are
+                 * encoded, the others are left out.
+                 * @param inventory_slots The size of the inventory of the
+                 * player.
+                 * */
+                ObservationEncoder(size_t max_items = 0, size_t max_enemies = 0,
+                                   unsigned int inventory_slots = 3);
+
+                /** Encodes what the player of a game observes.
+                 *
+                 * @param game The game, it must have a player and a room.
+                 * @param buffer The buffer, getSize() values long.
+                 * @param full If every value is written, otherwise only the
+                 * values different from the buffer are.
+                 * @return The number of values written.
+                 * */
+                size_t encode(HKGE &game, int32_t *buffer, bool full = false) const;
+                /** Encodes what the player of a game observes.
+                 *
+                 * @overload
+                 *
+                 * @param game The game, it must have a player and a room.
+                 * @param buffer The buffer, getSize() values long.
+                 * @param full If every value is written, otherwise only the
+                 * values different from the buffer are.
+                 * @return The number of values written.
+                 * */
+                size_t encode(HKGE &game, float *buffer, bool full = false) const;
+
+                //////////
+                // Getters
+                /** Gets the number of values of an encoding.
+                 *
+                 * @return The number of values.
+                 * */
+                size_t getSize(void) const;
+                /** Gets where the inventory slots start.
+                 *
+                 * @return The index of the first slot.
+                 * */
+                size_t getInventoryOffset(void) const;
+                /** Gets where the items in the room start.
+                 *
+                 * @return The index of the first item.
+                 * */
+                size_t getItemsOffset(void) const;
+                /** Gets where the enemies in the room start.
+                 *
+                 * @return The index of the first enemy.
+                 * */
+                size_t getEnemiesOffset(void) const;
+        private:
+                /** Encodes into a buffer of any type of number.
+                 *
+                 * @param game The game.
+                 * @param buffer The buffer.
+                 * @param full If every value is written.
+                 * @return The number of values written.
+                 * */
+                template<typename T>
+                size_t encodeInto(HKGE &game, T *buffer, bool full) const;
+
+                size_t m_max_items; /**<Most items encoded. */
+                size_t m_max_enemies; /**<Most enemies encoded. */
+                unsigned int m_inventory_slots; /**<Slots of the inventory. */
+};
+
+#endif // OBSERVATION_ENCODER_H_
@@ -1,10 +1,10 @@
 #include "player.h"
 
-#include <memory>
 #include <string>
 
 #include "generics.h"
 #include "inventory.h"
+#include "world.h"
 
 //////////////////
 // Player
@@ -13,9 +13,10 @@
  * @param health The max health of the player.
  * @param damage The base damage of the player.
  * @param inventory_size The inventory size of the player.
+ * @param world The world owning the items the player picks up.
  * */
-Player::Player(int health, int damage, int inventory_size): GenericEntity(health, damage) {
-    this->inventory = std::shared_ptr<Inventory>(new Inventory(inventory_size));
+Player::Player(int health, int damage, int inventory_size, World &world):
+    GenericEntity(health, damage), inventory(inventory_size, world) {
 }
 
 //////////
@@ -25,7 +26,7 @@ Player::Player(int health, int damage, int inventory_size): GenericEntity(health
  * @return The inventory of the player.
  * */
 Inventory* Player::getInventory(void) const {
-    return this->inventory.get();
+    return &this->inventory;
 }
 
 /** Gets the current XP of the player.
@@ -44,23 +45,24 @@ int Player::getXP(void) const {
  * @return The status of adding the item.
  * @see AddItemStatus
  * */
-AddItemStatus Player::addItem(std::shared_ptr<GenericItem> item) {
-    if (item != nullptr) {
-        item->onPickup(*this);
+AddItemStatus Player::addItem(ItemHandle item) {
+    GenericItem *object = this->inventory.getWorld()->getItem(item);
+    if (object != nullptr) {
+        object->onPickup(*this);
     }
-    return this->inventory->addItem(item);
+    return this->inventory.addItem(item);
 };
 
 /** Drops an item from the player's inventory.
  *
  * @param item The item to remove.
- * @return Pointer to the removed item.
+ * @return Handle to the removed item.
  * */
-std::shared_ptr<GenericItem> Player::dropItem(GenericItem *item) {
+ItemHandle Player::dropItem(GenericItem *item) {
     if (item != nullptr) {
         item->onDropped(*this);
     }
-    return this->inventory->removeItem(item);
+    return this->inventory.removeItem(item);
 }
 
 /** Removes an item in the inventory.
@@ -70,12 +72,13 @@ std::shared_ptr<GenericItem> Player::dropItem(GenericItem *item) {
  * of the item itself.
  *
  * @param item The item name to remove.
- * @return Pointer to the removed item.
+ * @return Handle to the removed item.
  * */
-std::shared_ptr<GenericItem> Player::dropItem(std::string item) {
-    auto selected_item = this->inventory->removeItem(item);
-    if (selected_item != nullptr) {
-        selected_item->onDropped(*this);
+ItemHandle Player::dropItem(std::string item) {
+    auto selected_item = this->inventory.removeItem(item);
+    GenericItem *object = this->inventory.getWorld()->getItem(selected_item);
+    if (object != nullptr) {
+        object->onDropped(*this);
     }
     return selected_item;
 }
@@ -87,16 +90,25 @@ std::shared_ptr<GenericItem> Player::dropItem(std::string item) {
  * on the list instead.
  *
  * @param index The index of the item to remove.
- * @return Pointer to the removed item.
+ * @return Handle to the removed item.
  * */
-std::shared_ptr<GenericItem> Player::dropItem(int index) {
-    auto selected_item = this->inventory->removeItem(index);
-    if (selected_item != nullptr) {
-        selected_item->onDropped(*this);
+ItemHandle Player::dropItem(int index) {
+    auto selected_item = this->inventory.removeItem(index);
+    GenericItem *object = this->inventory.getWorld()->getItem(selected_item);
+    if (object != nullptr) {
+        object->onDropped(*this);
     }
     return selected_item;
 }
 
+/** Adds XP to the player.
+ *
+ * @param xp The amount of XP to add.
+ * */
+void Player::addXP(int xp) {
+    this->m_xp += xp;
+}
+
 /////////
 // Others
 /** Overridden dealDamage() to gain xp on damage.
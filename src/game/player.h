@@ -3,10 +3,10 @@
 
 #include <string>
 #include <ostream>
-#include <memory>
 
 #include "generics.h"
 #include "inventory.h"
+#include "world.h"
 
 /** Class representing the player. */
 class Player: public GenericEntity {
@@ -16,8 +16,9 @@ class Player: public GenericEntity {
                  * @param health The max health of the player.
                  * @param damage The base damage of the player.
                  * @param inventory_size The inventory size of the player.
+                 * @param world The world owning the items the player picks up.
                  * */
-                Player(int health = 12, int damage = 1, int inventory_size = 3);
+                Player(int health, int damage, int inventory_size, World &world);
 
                 //////////
                 // Getters
@@ -40,13 +41,13 @@ class Player: public GenericEntity {
                  * @return The status of adding the item.
                  * @see AddItemStatus
                  * */
-                AddItemStatus addItem(std::shared_ptr<GenericItem> item);
+                AddItemStatus addItem(ItemHandle item);
                 /** Drops an item from the player's inventory.
                  *
                  * @param item The item to remove.
-                 * @return Pointer to the removed item.
+                 * @return Handle to the removed item.
                  * */
-                std::shared_ptr<GenericItem> dropItem(GenericItem *item);
+                ItemHandle dropItem(GenericItem *item);
                 /** Removes an item in the inventory.
                  *
                  * @overload
@@ -54,9 +55,9 @@ class Player: public GenericEntity {
                  * of the item itself.
                  *
                  * @param item The item name to remove.
-                 * @return Pointer to the removed item.
+                 * @return Handle to the removed item.
                  * */
-                std::shared_ptr<GenericItem> dropItem(std::string item);
+                ItemHandle dropItem(std::string item);
                 /** Removes an item in the inventory.
                  *
                  * @overload
@@ -64,9 +65,14 @@ class Player: public GenericEntity {
                  * on the list instead.
                  *
                  * @param index The index of the item to remove.
-                 * @return Pointer to the removed item.
+                 * @return Handle to the removed item.
                  * */
-                std::shared_ptr<GenericItem> dropItem(int index);
+                ItemHandle dropItem(int index);
+                /** Adds XP to the player.
+                 *
+                 * @param xp The amount of XP to add.
+                 * */
+                void addXP(int xp);
 
                 /////////
                 // Others
@@ -93,7 +99,9 @@ class Player: public GenericEntity {
                                                   const Player &cls);
         private:
                 int m_xp = 0; /**<The amount of xp the player current have. */
-                std::shared_ptr<Inventory> inventory = nullptr; /**<The player's inventory. */
+                /** The player's inventory, mutable as getInventory() gives it
+                 * out to change. */
+                mutable Inventory inventory;
 };
 
 #endif // PLAYER_H_
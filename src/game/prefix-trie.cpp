@@ -0,0 +1,260 @@
+#include "prefix-trie.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ascii-fold.h"
+
+/** Converts a character to lower case.
+ *
+ * @param c The character.
+ * @return The lower case character.
+ * */
+static char fold(char c) {
+    return foldAscii(c);
+}
+
+/** Constructor for PrefixTrie. */
+PrefixTrie::PrefixTrie(void) {
+}
+
+//////////
+// Setters
+/** Inserts a word.
+ *
+ * @param word The word.
+ * */
+void PrefixTrie::insert(std::string_view word) {
+    bool is_new = !this->contains(word);
+    uint32_t node = ROOT;
+    if (is_new) {
+        this->node(node).words++;
+    }
+
+    for (char c: word) {
+        c = fold(c);
+        // Finding the child, the siblings are sorted
+        uint32_t previous = NONE;
+        uint32_t child = this->node(node).first_child;
+        while (child != NONE && this->node(child).c < c) {
+            previous = child;
+            child = this->node(child).next_sibling;
+        }
+
+        // Creating the child, the rest of the word at most is needed
+        if (child == NONE || this->node(child).c != c) {
+            uint32_t created = this->m_nodes.size();
+            if (created == this->m_nodes.capacity()) {
+                this->m_nodes.reserve(std::max<size_t>(created * 2, created + word.size()));
+            }
+            this->m_nodes.push_back(Node{c, NONE, child, 0, 0});
+            if (previous == NONE) {
+                this->node(node).first_child = created;
+            } else {
+                this->node(previous).next_sibling = created;
+            }
+            child = created;
+        }
+
+        node = child;
+        if (is_new) {
+            this->node(node).words++;
+        }
+    }
+    this->node(node).count++;
+}
+
+/** Erases a word once.
+ *
+ * Nodes are kept when their words are gone so inserting the word again
+ * doesn't allocate.
+ *
+ * @param word The word.
+ * @return If the word was in the trie.
+ * */
+bool PrefixTrie::erase(std::string_view word) {
+    uint32_t end = this->find(word);
+    if (end == NONE || this->node(end).count == 0) {
+        return false;
+    }
+    if (--this->node(end).count > 0) {
+        return true;
+    }
+
+    // The last copy of the word is gone
+    uint32_t node = ROOT;
+    this->node(node).words--;
+    for (char c: word) {
+        c = fold(c);
+        node = this->node(node).first_child;
+        while (this->node(node).c != c) {
+            node = this->node(node).next_sibling;
+        }
+        this->node(node).words--;
+    }
+    return true;
+}
+
+/** Erases every word. */
+void PrefixTrie::clear(void) {
+    this->m_nodes.clear();
+    this->m_root = Node{'\0', NONE, NONE, 0, 0};
+}
+
+/** Reserves the nodes of the words of another trie.
+ *
+ * Inserting only words of the other trie then never allocates, whatever is
+ * erased in between.
+ *
+ * @param words The trie of the words.
+ * */
+void PrefixTrie::reserve(const PrefixTrie &words) {
+    this->m_nodes.reserve(words.m_nodes.size());
+}
+
+//////////
+// Getters
+/** Checks if a word is in the trie.
+ *
+ * @param word The word.
+ * @return If the word is in the trie.
+ * */
+bool PrefixTrie::contains(std::string_view word) const {
+    uint32_t node = this->find(word);
+    return node != NONE && this->node(node).count > 0;
+}
+
+/** Resolves a prefix to a word.
+ *
+ * A word equal to the prefix wins, otherwise the prefix must start exactly
+ * one word.
+ *
+ * @param prefix The prefix.
+ * @param word Where the word is stored.
+ * @return If the prefix resolved to a word.
+ * */
+bool PrefixTrie::resolve(std::string_view prefix, std::string &word) const {
+    uint32_t node = this->find(prefix);
+    if (node == NONE) {
+        return false;
+    }
+    if (this->node(node).count == 0 && this->node(node).words != 1) {
+        return false;
+    }
+
+    word.resize(prefix.size());
+    for (size_t i = 0; i < prefix.size(); i++) {
+        word[i] = fold(prefix[i]);
+    }
+
+    // Following the only word left to its end
+    while (this->node(node).count == 0) {
+        node = this->node(node).first_child;
+        while (this->node(node).words == 0) {
+            node = this->node(node).next_sibling;
+        }
+        word.push_back(this->node(node).c);
+    }
+    return true;
+}
+
+/** Gets the words starting with a prefix.
+ *
+ * @param prefix The prefix.
+ * @param words Where the words are appended in alphabetical order.
+ * */
+void PrefixTrie::complete(std::string_view prefix,
+                          std::vector<std::string> &words) const {
+    uint32_t node = this->find(prefix);
+    if (node == NONE) {
+        return;
+    }
+
+    std::string word(prefix.size(), '\0');
+    for (size_t i = 0; i < prefix.size(); i++) {
+        word[i] = fold(prefix[i]);
+    }
+    this->collect(node, word, words);
+}
+
+/** Counts the different words starting with a prefix.
+ *
+ * @param prefix The prefix.
+ * @return The number of words.
+ * */
+size_t PrefixTrie::count(std::string_view prefix) const {
+    uint32_t node = this->find(prefix);
+    return node == NONE ? 0 : this->node(node).words;
+}
+
+/** Gets the number of different words in the trie.
+ *
+ * @return The number of words.
+ * */
+size_t PrefixTrie::size(void) const {
+    return this->m_root.words;
+}
+
+/////////
+// private
+/** Gets a node.
+ *
+ * @param index The index of the node.
+ * @return The node.
+ * */
+PrefixTrie::Node& PrefixTrie::node(uint32_t index) {
+    return index == ROOT ? this->m_root : this->m_nodes[index];
+}
+
+/** Gets a node.
+ *
+ * @param index The index of the node.
+ * @return The node.
+ * */
+const PrefixTrie::Node& PrefixTrie::node(uint32_t index) const {
+    return index == ROOT ? this->m_root : this->m_nodes[index];
+}
+
+/** Finds the node of a prefix.
+ *
+ * @param prefix The prefix.
+ * @return The index of the node, NONE if no word starts with the prefix.
+ * */
+uint32_t PrefixTrie::find(std::string_view prefix) const {
+    uint32_t node = ROOT;
+    for (char c: prefix) {
+        c = fold(c);
+        node = this->node(node).first_child;
+        while (node != NONE && this->node(node).c < c) {
+            node = this->node(node).next_sibling;
+        }
+        if (node == NONE || this->node(node).c != c) {
+            return NONE;
+        }
+    }
+    return this->node(node).words > 0 ? node : NONE;
+}
+
+/** Appends the words of a subtree.
+ *
+ * @param node The root of the subtree.
+ * @param word The word leading to the node.
+ * @param words Where the words are appended.
+ * */
+void PrefixTrie::collect(uint32_t node, std::string &word,
+                         std::vector<std::string> &words) const {
+    if (this->node(node).count > 0) {
+        words.push_back(word);
+    }
+    for (uint32_t child = this->node(node).first_child; child != NONE;
+         child = this->node(child).next_sibling) {
+        if (this->node(child).words == 0) {
+            continue;
+        }
+        word.push_back(this->node(child).c);
+        this->collect(child, word, words);
+        word.pop_back();
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef PREFIX_TRIE_H_
+#define PREFIX_TRIE_H_
+
+/** @file prefix-trie.h
+ *
+ * Header file containing the trie used to resolve abbreviated commands and
+ * names.
+ * */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** A set of words indexed by their prefixes.
+ *
+ * Words are case insensitive and stored in lower case. The nodes are kept
+ * in a single vector with their children in a sorted sibling list, so
+ * looking up a prefix walks at most one node per character per sibling
+ * and the words are enumerated in alphabetical order.
+ *
+ * A word can be inserted more than once, it stays in the trie until it
+ * is erased as many times.
+ *
+ * The root isn't in the vector, so an empty trie allocates nothing.
+ * */
+class PrefixTrie {
+        public:
+                /** Constructor for PrefixTrie. */
+                PrefixTrie(void);
+
+                //////////
+                // Setters
+                /** Inserts a word.
+                 *
+                 * @param word The word.
+                 * */
+                void insert(std::string_view word);
+                /** Erases a word once.
+                 *
+                 * @param word The word.
+                 * @return If the word was in the trie.
+                 * */
+                bool erase(std::string_view word);
+                /** Erases every word. */
+                void clear(void);
+                /** Reserves the nodes of the words of another trie.
+                 *
+                 * Inserting only words of the other trie then never
+                 * allocates, whatever is erased in between.
+                 *
+                 * @param words The trie of the words.
+                 * */
+                void reserve(const PrefixTrie &words);
+
+                //////////
+                // Getters
+                /** Checks if a word is in the trie.
+                 *
+                 * @param word The word.
+                 * @return If the word is in the trie.
+                 * */
+                bool contains(std::string_view word) const;
+                /** Resolves a prefix to a word.
+                 *
+                 * A word equal to the prefix wins, otherwise the prefix must
+                 * start exactly one word.
+                 *
+                 * @param prefix The prefix.
+                 * @param word Where the word is stored.
+                 * @return If the prefix resolved to a word.
+                 * */
+                bool resolve(std::string_view prefix, std::string &word) const;
+                /** Gets the words starting with a prefix.
+                 *
+                 * @param prefix The prefix.
+                 * @param words Where the words are appended in alphabetical
+                 * order.
+                 * */
+                void complete(std::string_view prefix,
+                              std::vector<std::string> &words) const;
+                /** Counts the different words starting with a prefix.
+                 *
+                 * @param prefix The prefix.
+                 * @return The number of words.
+                 * */
+                size_t count(std::string_view prefix) const;
+                /** Gets the number of different words in the trie.
+                 *
+                 * @return The number of words.
+                 * */
+                size_t size(void) const;
+        private:
+                /** Index of a missing node. */
+                static constexpr uint32_t NONE = UINT32_MAX;
+                /** Index of the root. */
+                static constexpr uint32_t ROOT = NONE - 1;
+
+                /** A node of the trie. */
+                struct Node {
+                        char c; /**<The character leading to the node. */
+                        uint32_t first_child; /**<The first child, NONE if none. */
+                        uint32_t next_sibling; /**<The next sibling, NONE if none. */
+                        uint32_t count; /**<Times the word ending here was inserted. */
+                        uint32_t words; /**<Different words ending in the subtree. */
+                };
+
+                /** Gets a node.
+                 *
+                 * @param index The index of the node.
+                 * @return The node.
+                 * */
+                Node& node(uint32_t index);
+                /** Gets a node.
+                 *
+                 * @param index The index of the node.
+                 * @return The node.
+                 * */
+                const Node& node(uint32_t index) const;
+                /** Finds the node of a prefix.
+                 *
+                 * @param prefix The prefix.
+                 * @return The index of the node, NONE if no word starts with
+                 * the prefix.
+                 * */
+                uint32_t find(std::string_view prefix) const;
+                /** Appends the words of a subtree.
+                 *
+                 * @param node The root of the subtree.
+                 * @param word The word leading to the node.
+                 * @param words Where the words are appended.
+                 * */
+                void collect(uint32_t node, std::string &word,
+                             std::vector<std::string> &words) const;
+
+                Node m_root = {'\0', NONE, NONE, 0, 0}; /**<The root. */
+                std::vector<Node> m_nodes; /**<The nodes below the root. */
+};
+
+#endif // PREFIX_TRIE_H_
@@ -1,20 +1,52 @@
 #include "room.h"
 
 #include <vector>
-#include <memory>
 #include <algorithm>
 #include <exception>
 #include <iostream>
 #include <sstream>
+#include <typeinfo>
 
 #include "generics.h"
 #include "enemies.h"
+#include "combat.h"
+#include "world.h"
+#include "trace.h"
+#include "ascii-fold.h"
+
+/** Reads the name of a direction.
+ *
+ * @param name The name, in any case.
+ * @param direction Set to the direction named.
+ * @return If the name is a direction.
+ * */
+static bool parseDirection(std::string name, Direction &direction) {
+    // Converting to lower case
+    foldCase(name);
+    if (name == "north") {
+        direction = NORTH;
+    } else if (name == "south") {
+        direction = SOUTH;
+    } else if (name == "east") {
+        direction = EAST;
+    } else if (name == "west") {
+        direction = WEST;
+    } else {
+        return false;
+    }
+    return true;
+}
 
 /** Constructor for Room class.
+ *
+ * Rooms owned by a world are created with World::createRoom().
  *
  * @param name The name of the room.
+ * @param world The world owning the items and enemies in the room.
+ * @param id The id of the room in the world.
  * */
-Room::Room(std::string name): m_name(name) {
+Room::Room(std::string name, World &world, size_t id):
+    m_world(&world), m_id(id), m_name(name) {
 }
 
 //////////
@@ -23,16 +55,24 @@ Room::Room(std::string name): m_name(name) {
  *
  * @param item The item to add.
  * */
-void Room::addItem(std::shared_ptr<GenericItem> item) {
+void Room::addItem(ItemHandle item) {
     this->m_items.push_back(item);
+    GenericItem *object = this->m_world->getItem(item);
+    if (object != nullptr) {
+        this->m_item_names.insert(object->getName());
+    }
 }
 
 /** Adds an enemy to the room.
  *
  * @param enemy The enemy to add.
  * */
-void Room::addEnemey(std::shared_ptr<GenericEnemy> enemy) {
+void Room::addEnemey(EnemyHandle enemy) {
     this->m_enemies.push_back(enemy);
+    GenericEnemy *object = this->m_world->getEnemy(enemy);
+    if (object != nullptr) {
+        this->m_enemy_names.insert(object->getName());
+    }
 }
 
 /** Removes an the first item with the same name from the room.
@@ -40,13 +80,14 @@ void Room::addEnemey(std::shared_ptr<GenericEnemy> enemy) {
  * @param item The item name to remove.
  * @return The item removed.
  * */
-std::shared_ptr<GenericItem> Room::removeItem(std::string item) {
-    std::shared_ptr<GenericItem> ret = nullptr;
+ItemHandle Room::removeItem(std::string item) {
+    ItemHandle ret = nullptr;
 
     // Looping over all item
     for (size_t i = 0; i < this->m_items.size(); i++) {
         // Checking if the name is the same
-        if (*(this->m_items.at(i)) == item) {
+        GenericItem *object = this->m_world->getItem(this->m_items[i]);
+        if (object != nullptr && *object == item) {
             ret = this->removeItem(i);
             return ret;
         }
@@ -59,13 +100,14 @@ std::shared_ptr<GenericItem> Room::removeItem(std::string item) {
  * @param enemy The enemy name to remove.
  * @return The enemy removed.
  * */
-std::shared_ptr<GenericEnemy> Room::removeEnemey(std::string enemy) {
-    std::shared_ptr<GenericEnemy> ret = nullptr;
+EnemyHandle Room::removeEnemey(std::string enemy) {
+    EnemyHandle ret = nullptr;
 
     // Looping over all item
     for (size_t i = 0; i < this->m_enemies.size(); i++) {
         // Checking if the name is the same
-        if (*(this->m_items.at(i)) == enemy) {
+        GenericEnemy *object = this->m_world->getEnemy(this->m_enemies[i]);
+        if (object != nullptr && *object == enemy) {
             ret = this->removeEnemey(i);
             return ret;
         }
@@ -79,12 +121,12 @@ std::shared_ptr<GenericEnemy> Room::removeEnemey(std::string enemy) {
  * last item on the list. (nullptr will be returned if index is out of range).
  * @return item The item removed.
  * */
-std::shared_ptr<GenericItem> Room::removeItem(size_t index) {
-    std::shared_ptr<GenericItem> ret = nullptr;
+ItemHandle Room::removeItem(size_t index) {
+    ItemHandle ret = nullptr;
 
     // index < 0 (-1)
-    if (index < 0) {
-        ret = this->m_items.at(this->m_items.size() - 1);
+    if (index == (size_t) -1 && !this->m_items.empty()) {
+        ret = this->m_items.back();
         this->m_items.pop_back();
     } else if (index < this->m_items.size()) { // Positive index
         ret = this->m_items.at(index);
@@ -92,6 +134,11 @@ std::shared_ptr<GenericItem> Room::removeItem(size_t index) {
     } else { // Out of range
         ret = nullptr;
     }
+
+    GenericItem *object = this->m_world->getItem(ret);
+    if (object != nullptr) {
+        this->m_item_names.erase(object->getName());
+    }
     return ret;
 }
 
@@ -101,19 +148,24 @@ std::shared_ptr<GenericItem> Room::removeItem(size_t index) {
  * last item on the list. (nullptr will be returned if index is out of range).
  * @return enemy The enemy removed.
  * */
-std::shared_ptr<GenericEnemy> Room::removeEnemey(size_t index) {
-    std::shared_ptr<GenericEnemy> ret = nullptr;
+EnemyHandle Room::removeEnemey(size_t index) {
+    EnemyHandle ret = nullptr;
 
     // index < 0 (-1)
-    if (index < 0) {
-        ret = *(this->m_enemies.end() - 1);
-        this->m_items.pop_back();
-    } else if (index < this->m_items.size()) { // Positive index
+    if (index == (size_t) -1 && !this->m_enemies.empty()) {
+        ret = this->m_enemies.back();
+        this->m_enemies.pop_back();
+    } else if (index < this->m_enemies.size()) { // Positive index
         ret = this->m_enemies.at(index);
-        this->m_items.erase(this->m_items.begin() + index);
+        this->m_enemies.erase(this->m_enemies.begin() + index);
     } else { // Out of range
         ret = nullptr;
     }
+
+    GenericEnemy *object = this->m_world->getEnemy(ret);
+    if (object != nullptr) {
+        this->m_enemy_names.erase(object->getName());
+    }
     return ret;
 }
 
@@ -135,6 +187,15 @@ void Room::lockRoom(void) {
     this->m_locked = true;
 }
 
+/** Reserves the names of the items that can be put in the room, adding them
+ * then doesn't grow the names of the room.
+ *
+ * @param names The names of the items.
+ * */
+void Room::reserveItemNames(const PrefixTrie &names) {
+    this->m_item_names.reserve(names);
+}
+
 /** Dynmaically add a new room to the north.
  *
  * @param name The name of the room.
@@ -271,6 +332,8 @@ Room* Room::setRoom(Room *room, Direction direction) {
 }
 
 /** Dynmaically add a new room in the direction given.
+ *
+ * The new room is created by the world of this room.
  *
  * @param name The name of the room.
  * @param direction The direction of the room to set.
@@ -280,16 +343,11 @@ Room* Room::setRoom(Room *room, Direction direction) {
  * @see Direction
  * */
 Room* Room::setRoom(std::string name, Direction direction) {
-    // Creating new room
-    Room *room = new Room(name);
-
-    Room* ret = this->setRoom(room, direction);
-
-    // If failed to set room delete the pointer
-    if (ret == nullptr) {
-        delete room;
+    // The world can't take back a room
+    if (this->getRoom(direction) != nullptr) {
+        return nullptr;
     }
-    return ret;
+    return this->setRoom(this->m_world->createRoom(name), direction);
 }
 
 /** Sets the room in the direction given.
@@ -301,22 +359,16 @@ Room* Room::setRoom(std::string name, Direction direction) {
  * is invalid.
  * */
 Room* Room::setRoom(Room *room, std::string direction) {
-    // Converting to lower case
-    std::transform(direction.begin(), direction.end(), direction.begin(), ::tolower);
-    if (direction == "north") {
-        return this->setRoom(room, NORTH);
-    } else if (direction == "south") {
-        return this->setRoom(room, SOUTH);
-    } else if (direction == "east") {
-        return this->setRoom(room, EAST);
-    } else if (direction == "west") {
-        return this->setRoom(room, WEST);
-    } else {
+    Direction parsed;
+    if (!parseDirection(direction, parsed)) {
         return nullptr;
     }
+    return this->setRoom(room, parsed);
 }
 
 /** Dynmaically add a new room in the direction given.
+ *
+ * The new room is created by the world of this room.
  *
  * @param name The name of the room.
  * @param direction The direction of the room to set.
@@ -325,16 +377,11 @@ Room* Room::setRoom(Room *room, std::string direction) {
  * is invalid.
  * */
 Room* Room::setRoom(std::string name, std::string direction) {
-    // Creating new room
-    Room *room = new Room(name);
-
-    Room* ret = this->setRoom(room, direction);
-
-    // If failed to set room delete the pointer
-    if (ret == nullptr) {
-        delete room;
+    Direction parsed;
+    if (!parseDirection(direction, parsed)) {
+        return nullptr;
     }
-    return ret;
+    return this->setRoom(name, parsed);
 }
 
 //////////
@@ -347,6 +394,14 @@ std::string Room::getName(void) const {
     return this->m_name;
 }
 
+/** Gets the id of the room in its world.
+ *
+ * @return The id, NO_ID if the room isn't owned by a world.
+ * */
+size_t Room::getId(void) const {
+    return this->m_id;
+}
+
 /** Gets the enemies in the room.
  *
  * @return A vector of all the enemies.
@@ -355,7 +410,10 @@ std::vector<GenericEnemy *> Room::getEnemies(void) const {
     std::vector<GenericEnemy *> ret_vector;
 
     for (std::size_t i = 0; i < this->m_enemies.size(); i++) {
-        ret_vector.push_back(this->m_enemies.at(i).get());
+        GenericEnemy *enemy = this->m_world->getEnemy(this->m_enemies[i]);
+        if (enemy != nullptr) {
+            ret_vector.push_back(enemy);
+        }
     }
 
     return ret_vector;
@@ -369,12 +427,31 @@ std::vector<GenericItem *> Room::getItems(void) const {
     std::vector<GenericItem *> ret_vector;
 
     for (std::size_t i = 0; i < this->m_items.size(); i++) {
-        ret_vector.push_back(this->m_items.at(i).get());
+        GenericItem *item = this->m_world->getItem(this->m_items[i]);
+        if (item != nullptr) {
+            ret_vector.push_back(item);
+        }
     }
 
     return ret_vector;
 }
 
+/** Gets the handles of the items in the room.
+ *
+ * @return The handles in the order the items are listed.
+ * */
+const std::vector<ItemHandle>& Room::getItemHandles(void) const {
+    return this->m_items;
+}
+
+/** Gets the handles of the enemies in the room.
+ *
+ * @return The handles in the order the enemies are listed.
+ * */
+const std::vector<EnemyHandle>& Room::getEnemyHandles(void) const {
+    return this->m_enemies;
+}
+
 /** Gets if the room is locked or not.
  *
  * @return If the room is locked or not.
@@ -383,6 +460,30 @@ bool Room::isLocked(void) const {
     return this->m_locked;
 }
 
+/** Gets the world owning the items and enemies in the room.
+ *
+ * @return The world.
+ * */
+World* Room::getWorld(void) const {
+    return this->m_world;
+}
+
+/** Gets the names of the items in the room.
+ *
+ * @return The names indexed by their prefixes.
+ * */
+const PrefixTrie& Room::getItemNames(void) const {
+    return this->m_item_names;
+}
+
+/** Gets the names of the enemies in the room.
+ *
+ * @return The names indexed by their prefixes.
+ * */
+const PrefixTrie& Room::getEnemyNames(void) const {
+    return this->m_enemy_names;
+}
+
 /** Gets the room of the given direction.
  *
  * @param direction The direction of the room to get.
@@ -418,7 +519,7 @@ Room* Room::getRoom(Direction direction) const {
  * if the room doesn't exist or the direction is invalid.
  * */
 Room* Room::getRoom(std::string direction) const {
-    std::transform(direction.begin(), direction.end(), direction.begin(), ::tolower);
+    foldCase(direction);
 
     if (direction == "north") {
         return this->getRoom(NORTH);
@@ -474,6 +575,7 @@ Room* Room::getWest(void) const {
  * @return The description of the room.
  * */
 std::string Room::getDescription(void) const {
+    GAME_TRACE_SCOPE("Room::getDescription");
     std::ostringstream description;
 
     description << "You are in a " << this->getName() << ". ";
@@ -513,8 +615,9 @@ std::string Room::getDescription(void) const {
  * */
 KillStatus Room::killEnemy(std::string name, GenericEntity *killer) {
     // Looping over all enemies
-    for (size_t i = 0; i < this->getEnemies().size(); i++) {
-        if (*(this->getEnemies().at(i)) == name) {
+    for (size_t i = 0; i < this->m_enemies.size(); i++) {
+        GenericEnemy *enemy = this->m_world->getEnemy(this->m_enemies[i]);
+        if (enemy != nullptr && *enemy == name) {
             return this->killEnemy(i, killer);
         }
     }
@@ -522,6 +625,9 @@ KillStatus Room::killEnemy(std::string name, GenericEntity *killer) {
 }
 
 /** Kills the first enemy in the list with the same name.
+ *
+ * Fights where the killer is a Player are resolved by the compile time
+ * dispatched kernel in combat.h.
  *
  * @param index The index of the enemy in the list.
  * @param killer The entity that is killing the enemy.
@@ -530,12 +636,13 @@ KillStatus Room::killEnemy(std::string name, GenericEntity *killer) {
  * @see KillStatus
  * */
 KillStatus Room::killEnemy(size_t index, GenericEntity *killer) {
-    GenericEnemy* enemy = nullptr;
-
+    GAME_TRACE_SCOPE("Room::killEnemy");
     // Checking if it is a valid enemy
-    try {
-        enemy = this->getEnemies().at(index);
-    } catch (std::out_of_range const &err) {
+    if (index >= this->m_enemies.size()) {
+        return KillStatus::NO_ENEMY;
+    }
+    GenericEnemy *enemy = this->m_world->getEnemy(this->m_enemies[index]);
+    if (enemy == nullptr) {
         return KillStatus::NO_ENEMY;
     }
 
@@ -544,19 +651,11 @@ KillStatus Room::killEnemy(size_t index, GenericEntity *killer) {
         return KillStatus::DEAD_ENEMY;
     }
 
-    // Deal Damage until either dies
-    while (!killer->isDead() && !enemy->isDead()) {
-        killer->dealDamage(enemy);
-        if (!(enemy->isDead())) {
-            enemy->dealDamage(killer);
-        }
-    }
-
-    // If killer died
-    if (killer->isDead()) {
-        return KillStatus::KILL_FAILURE;
-    } else { // Successful kill
-        return KillStatus::KILL_SUCCESS;
+    // Only an exact Player is known to not override the damage methods
+    if (typeid(*killer) == typeid(Player)) {
+        return fight(static_cast<Player *>(killer), enemy);
+    } else {
+        return fightVirtual(killer, enemy);
     }
 }
 
@@ -3,10 +3,12 @@
 
 #include <vector>
 #include <string>
-#include <memory>
 
 #include "generics.h"
 #include "enemies.h"
+#include "combat.h"
+#include "world.h"
+#include "prefix-trie.h"
 
 /** Enumeration of Direction of the room. */
 enum Direction {
@@ -16,22 +18,22 @@ EAST, /**<The east direction. */
 WEST /**<The west direction. */
 };
 
-/** Enumeration of kill statuses. */
-enum KillStatus {
-KILL_SUCCESS, /**<Sucessfully killed enemy. */
-KILL_FAILURE, /**<Failed to kill enemy. */
-NO_ENEMY, /**<The enemy given isn't valid. */
-DEAD_ENEMY /**<The enemy is already dead. */
-};
-
 /** A class representing a room in the adventure game. */
 class Room {
         public:
+                /** Id of a room that isn't owned by a World. */
+                static constexpr size_t NO_ID = (size_t) -1;
+
                 /** Constructor for Room class.
+                 *
+                 * Rooms owned by a world are created with World::createRoom().
                  *
                  * @param name The name of the room.
+                 * @param world The world owning the items and enemies in the
+                 * room.
+                 * @param id The id of the room in the world.
                  * */
-                Room(std::string name = "Room");
+                Room(std::string name, World &world, size_t id = NO_ID);
 
                 //////////
                 // Setters
@@ -39,24 +41,24 @@ class Room {
                  *
                  * @param item The item to add.
                  * */
-                void addItem(std::shared_ptr<GenericItem> item);
+                void addItem(ItemHandle item);
                 /** Adds an enemy to the room.
                  *
                  * @param enemy The enemy to add.
                  * */
-                void addEnemey(std::shared_ptr<GenericEnemy> enemy);
+                void addEnemey(EnemyHandle enemy);
                 /** Removes an the first item with the same name from the room.
                  *
                  * @param item The item name to remove.
                  * @return The item removed.
                  * */
-                std::shared_ptr<GenericItem> removeItem(std::string item);
+                ItemHandle removeItem(std::string item);
                 /** Removes an the first enemy with the same name from the room.
                  *
                  * @param enemy The enemy name to remove.
                  * @return The enemy removed.
                  * */
-                std::shared_ptr<GenericEnemy> removeEnemey(std::string enemy);
+                EnemyHandle removeEnemey(std::string enemy);
                 /** Removes an item to the item room.
                  *
                  * @param index The index of the item to remove. -1 to remove
@@ -64,7 +66,7 @@ class Room {
                  * out of range).
                  * @return item The item removed.
                  * */
-                std::shared_ptr<GenericItem> removeItem(size_t index = -1);
+                ItemHandle removeItem(size_t index = -1);
                 /** Removes an enemy to the room.
                  *
                  * @param index The index of the enemy to remove -1 to remove
@@ -72,7 +74,7 @@ class Room {
                  * out of range).
                  * @return enemy The enemy removed.
                  * */
-                std::shared_ptr<GenericEnemy> removeEnemey(size_t index = -1);
+                EnemyHandle removeEnemey(size_t index = -1);
                 /** Sets the name of the room.
                  *
                  * @param name The name of the room.
@@ -82,6 +84,12 @@ class Room {
                 void unlockRoom(void);
                 /** Locks the room. */
                 void lockRoom(void);
+                /** Reserves the names of the items that can be put in the
+                 * room, adding them then doesn't grow the names of the room.
+                 *
+                 * @param names The names of the items.
+                 * */
+                void reserveItemNames(const PrefixTrie &names);
 
                 // Room setting
                 /** Dynmaically add a new room to the north.
@@ -151,6 +159,8 @@ class Room {
                  * */
                 Room* setRoom(Room *room, Direction direction);
                 /** Dynmaically add a new room in the direction given.
+                 *
+                 * The new room is created by the world of this room.
                  *
                  * @param name The name of the room.
                  * @param direction The direction of the room to set.
@@ -170,6 +180,8 @@ class Room {
                  * */
                 Room* setRoom(Room *room, std::string direction);
                 /** Dynmaically add a new room in the direction given.
+                 *
+                 * The new room is created by the world of this room.
                  *
                  * @param name The name of the room.
                  * @param direction The direction of the room to set.
@@ -186,6 +198,11 @@ class Room {
                  * @return The name of the room.
                  * */
                 std::string getName(void) const;
+                /** Gets the id of the room in its world.
+                 *
+                 * @return The id, NO_ID if the room isn't owned by a world.
+                 * */
+                size_t getId(void) const;
                 /** Gets the enemies in the room.
                  *
                  * @return A vector of all the enemies.
@@ -196,11 +213,36 @@ class Room {
                  * @return A vector of all the items.
                  * */
                 std::vector<GenericItem *> getItems(void) const;
+                /** Gets the handles of the items in the room.
+                 *
+                 * @return The handles in the order the items are listed.
+                 * */
+                const std::vector<ItemHandle>& getItemHandles(void) const;
+                /** Gets the handles of the enemies in the room.
+                 *
+                 * @return The handles in the order the enemies are listed.
+                 * */
+                const std::vector<EnemyHandle>& getEnemyHandles(void) const;
                 /** Gets if the room is locked or not.
                  *
                  * @return If the room is locked or not.
                  */
                 bool isLocked(void) const;
+                /** Gets the world owning the items and enemies in the room.
+                 *
+                 * @return The world.
+                 * */
+                World* getWorld(void) const;
+                /** Gets the names of the items in the room.
+                 *
+                 * @return The names indexed by their prefixes.
+                 * */
+                const PrefixTrie& getItemNames(void) const;
+                /** Gets the names of the enemies in the room.
+                 *
+                 * @return The names indexed by their prefixes.
+                 * */
+                const PrefixTrie& getEnemyNames(void) const;
                 /** Gets the room of the given direction.
                  *
                  * @param direction The direction of the room to get.
@@ -259,6 +301,9 @@ class Room {
                  * */
                 KillStatus killEnemy(std::string name, GenericEntity *killer);
                 /** Kills the first enemy in the list with the same name.
+                 *
+                 * Fights where the killer is a Player are resolved by the
+                 * compile time dispatched kernel in combat.h.
                  *
                  * @param index The index of the enemy in the list.
                  * @param killer The entity that is killing the enemy.
@@ -280,8 +325,12 @@ class Room {
                 friend std::ostream& operator << (std::ostream &out, const Room &cls);
         private:
                 bool m_locked = false;
-                std::vector<std::shared_ptr<GenericItem>> m_items;
-                std::vector<std::shared_ptr<GenericEnemy>> m_enemies;
+                std::vector<ItemHandle> m_items;
+                std::vector<EnemyHandle> m_enemies;
+                PrefixTrie m_item_names;
+                PrefixTrie m_enemy_names;
+                World *m_world = nullptr;
+                size_t m_id = NO_ID;
                 Room *north = nullptr;
                 Room *south = nullptr;
                 Room *east = nullptr;
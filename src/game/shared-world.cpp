@@ -0,0 +1,417 @@
+#include "shared-world.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "generics.h"
+#include "items.h"
+
+////////////////
+// SharedWorld
+/** Constructor for SharedWorld.
+ *
+ * With a radius the events of a room are routed through an InterestMap to
+ * the players within that many exits of it, and name the room. The map has
+ * its own lock, taken after the locks of the rooms: shared to route an
+ * event, exclusive to move a player.
+ *
+ * @param build Creates the rooms, items and enemies of the world and
+ * returns the room the players start in.
+ * @param radius The number of exits the players hear events through, 0 for
+ * only the room they are in.
+ * */
+SharedWorld::SharedWorld(std::function<Room*(World&)> build, unsigned int radius) {
+    this->m_start = build(this->m_world);
+    this->m_rooms.reset(new RoomState[this->m_world.roomCount()]);
+    if (radius > 0) {
+        this->m_interest.reset(new InterestMap(this->m_world, radius));
+    }
+}
+
+//////////
+// Getters
+/** Gets the world owning the rooms, items and enemies.
+ *
+ * @return The world.
+ * */
+World& SharedWorld::getWorld(void) {
+    return this->m_world;
+}
+
+/** Gets the room the players start in.
+ *
+ * @return The room.
+ * */
+Room* SharedWorld::getStartRoom(void) const {
+    return this->m_start;
+}
+
+/** Gets the version of a room, bumped by every change of the room.
+ *
+ * @param room The room.
+ * @return The version.
+ * */
+uint64_t SharedWorld::getVersion(const Room *room) const {
+    return this->state(room).version.load(std::memory_order_acquire);
+}
+
+/** Gets the number of players in a room.
+ *
+ * @param room The room.
+ * @return The number of players.
+ * */
+size_t SharedWorld::getOccupants(const Room *room) const {
+    return this->state(room).occupants.load(std::memory_order_relaxed);
+}
+
+/** Gets the number of exits the players hear events through.
+ *
+ * @return The radius, 0 for only the room they are in.
+ * */
+unsigned int SharedWorld::getRadius(void) const {
+    return this->m_interest == nullptr ? 0 : this->m_interest->getRadius();
+}
+
+/////////
+// private
+/** Gets the state of a room.
+ *
+ * @param room The room.
+ * @return The state.
+ * */
+SharedWorld::RoomState& SharedWorld::state(const Room *room) const {
+    return this->m_rooms[room->getId()];
+}
+
+/** Marks a room as changed, its lock must be held.
+ *
+ * @param room The room.
+ * */
+void SharedWorld::changed(const Room *room) {
+    this->state(room).version.fetch_add(1, std::memory_order_release);
+}
+
+/** Announces an event to the players in a room, or within the radius of
+ * it, its lock must be held.
+ *
+ * The event is rendered once, only if someone listens, and shared by all
+ * the recipients.
+ *
+ * @param room The room.
+ * @param except The queue of the player causing the event, it isn't sent
+ * the event.
+ * @param actor The name of the player causing the event.
+ * @param action What the player did.
+ * @param object What the player did it to, empty for nothing.
+ * */
+void SharedWorld::announce(const Room *room, const EventQueue *except,
+                           const std::string &actor, const char *action,
+                           const std::string &object) {
+    std::shared_lock<std::shared_mutex> interest_lock(this->m_interest_mutex, std::defer_lock);
+    const std::vector<EventQueue *> *listeners = &this->state(room).listeners;
+    if (this->m_interest != nullptr) {
+        interest_lock.lock();
+        listeners = &this->m_interest->getInterested(room);
+    }
+    if (listeners->empty() || (listeners->size() == 1 && (*listeners)[0] == except)) {
+        return;
+    }
+
+    // Players in other rooms are told where it happened
+    std::string text = this->m_interest != nullptr ? room->getName() + ": " : "";
+    text.reserve(text.size() + actor.size() + std::strlen(action) + object.size() + 4);
+    text.append(actor).append(" ").append(action);
+    if (!object.empty()) {
+        text.append(" ").append(object);
+    }
+    text.append(".\n");
+    EventBuffer event = makeEvent(std::move(text));
+    if (this->m_interest != nullptr) {
+        this->m_interest->route(room, event, except);
+        return;
+    }
+    for (EventQueue *listener: *listeners) {
+        if (listener != except) {
+            listener->push(event);
+        }
+    }
+}
+
+/** Locks the rooms.
+ *
+ * @param world The world of the rooms.
+ * @param first A room.
+ * @param second Another room, nullptr or the same room to only lock the
+ * first.
+ * */
+SharedWorld::RoomGuard::RoomGuard(SharedWorld &world, const Room *first,
+                                  const Room *second) {
+    if (second == nullptr || second == first) {
+        this->m_first = &world.state(first).mutex;
+    } else if (first->getId() < second->getId()) {
+        this->m_first = &world.state(first).mutex;
+        this->m_second = &world.state(second).mutex;
+    } else {
+        this->m_first = &world.state(second).mutex;
+        this->m_second = &world.state(first).mutex;
+    }
+
+    this->m_first->lock();
+    if (this->m_second != nullptr) {
+        this->m_second->lock();
+    }
+}
+
+/** Unlocks the rooms. */
+SharedWorld::RoomGuard::~RoomGuard(void) {
+    if (this->m_second != nullptr) {
+        this->m_second->unlock();
+    }
+    this->m_first->unlock();
+}
+
+/////////////////
+// SharedPlayer
+/** Constructor for SharedPlayer, enters the start room.
+ *
+ * @param world The world the player acts in.
+ * @param room The room the player starts in, nullptr for the start room of
+ * the world.
+ * @param events Where the events of the rooms the player is in are sent,
+ * nullptr to not listen.
+ * */
+SharedPlayer::SharedPlayer(SharedWorld &world, Room *room, EventQueue *events):
+    m_world(world), m_player(12, 1, 3, world.getWorld()),
+    m_room(room == nullptr ? world.getStartRoom() : room), m_events(events),
+    m_name("Player " + std::to_string(world.m_joined.fetch_add(1) + 1)) {
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    this->enter();
+}
+
+/** Destructor for SharedPlayer, leaves the room and the InterestMap of the
+ * world. */
+SharedPlayer::~SharedPlayer(void) {
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    this->leave();
+    if (this->m_world.m_interest != nullptr && this->m_events != nullptr) {
+        std::lock_guard<std::shared_mutex> lock(this->m_world.m_interest_mutex);
+        this->m_world.m_interest->remove(this->m_events);
+    }
+}
+
+/** Moves to the room in a direction.
+ *
+ * @param direction The direction.
+ * @return The status of the move.
+ * */
+MoveStatus SharedPlayer::move(Direction direction) {
+    // The exits never change, only the lock of the next room does
+    Room *next = this->m_room->getRoom(direction);
+    if (next == nullptr) {
+        return NO_ROOM;
+    }
+
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room, next);
+    if (next->isLocked()) {
+        return LOCKED_ROOM;
+    }
+    this->leave();
+    this->m_room = next;
+    this->enter();
+    return MOVE_SUCCESS;
+}
+
+/** Takes an item from the room.
+ *
+ * Only one of several players taking the same item gets it.
+ *
+ * @param item The name of the item.
+ * @return The status of adding the item, INVALID_ITEM if the item isn't in
+ * the room.
+ * */
+AddItemStatus SharedPlayer::take(const std::string &item) {
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    ItemHandle removed = this->m_room->removeItem(item);
+    if (removed == nullptr) {
+        return INVALID_ITEM;
+    }
+
+    AddItemStatus status = this->m_player.addItem(removed);
+    if (status != SUCCESS) {
+        this->m_room->addItem(removed);
+    } else {
+        this->m_world.announce(this->m_room, this->m_events, this->m_name,
+                               "picks up the", item);
+    }
+    this->m_world.changed(this->m_room);
+    return status;
+}
+
+/** Drops an item in the room.
+ *
+ * @param item The name of the item.
+ * @return If the item was in the inventory.
+ * */
+bool SharedPlayer::drop(const std::string &item) {
+    ItemHandle dropped = this->m_player.dropItem(item);
+    if (dropped == nullptr) {
+        return false;
+    }
+
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    this->m_room->addItem(dropped);
+    this->m_world.announce(this->m_room, this->m_events, this->m_name,
+                           "drops the", item);
+    this->m_world.changed(this->m_room);
+    return true;
+}
+
+/** Uses a consumable in the inventory.
+ *
+ * @param item The name of the item.
+ * @return If the item was in the inventory.
+ * */
+bool SharedPlayer::use(const std::string &item) {
+    GenericItem *used = this->m_player.getInventory()->getItem(item);
+    if (used == nullptr) {
+        return false;
+    }
+
+    // Consumables destroy themselves through the world
+    std::lock_guard<std::mutex> lock(this->m_world.m_destroy_mutex);
+    return this->m_player.useItem(used);
+}
+
+/** Kills an enemy in the room.
+ *
+ * @param enemy The name of the enemy.
+ * @return The kill status.
+ * */
+KillStatus SharedPlayer::kill(const std::string &enemy) {
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    KillStatus status = this->m_room->killEnemy(enemy, &this->m_player);
+    if (status == KILL_SUCCESS) {
+        this->m_world.announce(this->m_room, this->m_events, this->m_name,
+                               "kills", enemy);
+    } else if (status == KILL_FAILURE) {
+        this->m_world.announce(this->m_room, this->m_events, this->m_name,
+                               "fails to kill", enemy);
+    }
+    if (status == KILL_SUCCESS || status == KILL_FAILURE) {
+        this->m_world.changed(this->m_room);
+    }
+    return status;
+}
+
+/** Unlocks the locked rooms next to the room.
+ *
+ * @return If a room was unlocked, false without the Copper Key.
+ * */
+bool SharedPlayer::unlock(void) {
+    if (this->m_player.getInventory()->getItem("Copper Key") == nullptr) {
+        return false;
+    }
+
+    bool unlocked = false;
+    for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+        Room *room = this->m_room->getRoom(direction);
+        if (room == nullptr) {
+            continue;
+        }
+        SharedWorld::RoomGuard guard(this->m_world, this->m_room, room);
+        if (room->isLocked()) {
+            room->unlockRoom();
+            this->m_world.changed(room);
+            unlocked = true;
+        }
+    }
+    return unlocked;
+}
+
+/** Describes the room.
+ *
+ * The description is only rebuilt when the room changed.
+ *
+ * @return The description of the room.
+ * */
+const std::string& SharedPlayer::look(void) {
+    if (this->m_described == this->m_room &&
+        this->m_world.getVersion(this->m_room) == this->m_described_version) {
+        return this->m_description;
+    }
+
+    SharedWorld::RoomGuard guard(this->m_world, this->m_room);
+    this->m_description = this->m_room->getDescription();
+    this->m_described = this->m_room;
+    this->m_described_version = this->m_world.getVersion(this->m_room);
+    return this->m_description;
+}
+
+//////////
+// Getters
+/** Gets the player.
+ *
+ * @return The player.
+ * */
+Player& SharedPlayer::getPlayer(void) {
+    return this->m_player;
+}
+
+/** Gets the room the player is in.
+ *
+ * @return The room.
+ * */
+Room* SharedPlayer::getRoom(void) const {
+    return this->m_room;
+}
+
+/** Gets the name the player is announced by.
+ *
+ * @return The name.
+ * */
+const std::string& SharedPlayer::getName(void) const {
+    return this->m_name;
+}
+
+/////////
+// private
+/** Starts listening to the events of the room and announces the arrival,
+ * the lock of the room must be held.
+ *
+ * With a radius the interest of the player is moved to the room.
+ * */
+void SharedPlayer::enter(void) {
+    SharedWorld::RoomState &state = this->m_world.state(this->m_room);
+    state.occupants.fetch_add(1, std::memory_order_relaxed);
+    this->m_world.announce(this->m_room, this->m_events, this->m_name, "arrives");
+    if (this->m_events == nullptr) {
+        return;
+    }
+    if (this->m_world.m_interest != nullptr) {
+        std::lock_guard<std::shared_mutex> lock(this->m_world.m_interest_mutex);
+        this->m_world.m_interest->move(this->m_events, this->m_room);
+    } else {
+        state.listeners.push_back(this->m_events);
+    }
+}
+
+/** Stops listening to the events of the room and announces the departure,
+ * the lock of the room must be held.
+ *
+ * With a radius the interest of the player is kept until it enters the
+ * next room.
+ * */
+void SharedPlayer::leave(void) {
+    SharedWorld::RoomState &state = this->m_world.state(this->m_room);
+    state.occupants.fetch_sub(1, std::memory_order_relaxed);
+    if (this->m_events != nullptr && this->m_world.m_interest == nullptr) {
+        auto listener = std::find(state.listeners.begin(), state.listeners.end(),
+                                  this->m_events);
+        if (listener != state.listeners.end()) {
+            *listener = state.listeners.back();
+            state.listeners.pop_back();
+        }
+    }
+    this->m_world.announce(this->m_room, this->m_events, this->m_name, "leaves");
+}
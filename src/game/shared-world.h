@@ -0,0 +1,289 @@
+#ifndef SHARED_WORLD_H_
+#define SHARED_WORLD_H_
+
+/** @file shared-world.h
+ *
+ * Header file containing a world shared by players acting from several
+ * threads.
+ *
+ * Every room has its own lock, so players in different rooms never wait on
+ * each other. Actions touching two rooms lock them in the order of their
+ * ids, which rules out deadlocks. Every change of a room bumps its version,
+ * so a player can tell without locking that what it saw of a room is still
+ * up to date. What a player does in a room is announced once to the
+ * EventQueue of every other player there, or of every other player within
+ * a radius of exits when the world has one.
+ * */
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "combat.h"
+#include "event-queue.h"
+#include "interest-map.h"
+#include "inventory.h"
+#include "player.h"
+#include "room.h"
+#include "world.h"
+
+class SharedPlayer;
+
+/** Enumeration of the results of moving a SharedPlayer. */
+enum MoveStatus {
+MOVE_SUCCESS, /**<The player entered the room. */
+NO_ROOM, /**<There is no room in the direction. */
+LOCKED_ROOM /**<The room in the direction is locked. */
+};
+
+/** A world whose rooms are shared by players on several threads.
+ *
+ * The rooms, items and enemies are created once by the build function.
+ * Afterwards the rooms and items only change through SharedPlayer.
+ * */
+class SharedWorld {
+        public:
+                /** Constructor for SharedWorld.
+                 *
+                 * With a radius the events of a room are routed through an
+                 * InterestMap to the players within that many exits of it,
+                 * and name the room. The map has its own lock, taken after
+                 * the locks of the rooms: shared to route an event,
+                 * exclusive to move a player.
+                 *
+                 * @param build Creates the rooms, items and enemies of the
+                 * world and returns the room the players start in.
+                 * @param radius The number of exits the players hear events
+                 * through, 0 for only the room they are in.
+                 * */
+                SharedWorld(std::function<Room*(World&)> build, unsigned int radius = 0);
+                SharedWorld(const SharedWorld &) = delete;
+                SharedWorld& operator = (const SharedWorld &) = delete;
+
+                //////////
+                // Getters
+                /** Gets the world owning the rooms, items and enemies.
+                 *
+                 * @return The world.
+                 * */
+                World& getWorld(void);
+                /** Gets the room the players start in.
+                 *
+                 * @return The room.
+                 * */
+                Room* getStartRoom(void) const;
+                /** Gets the version of a room, bumped by every change of the
+                 * room.
+                 *
+                 * @param room The room.
+                 * @return The version.
+                 * */
+                uint64_t getVersion(const Room *room) const;
+                /** Gets the number of players in a room.
+                 *
+                 * @param room The room.
+                 * @return The number of players.
+                 * */
+                size_t getOccupants(const Room *room) const;
+                /** Gets the number of exits the players hear events through.
+                 *
+                 * @return The radius, 0 for only the room they are in.
+                 * */
+                unsigned int getRadius(void) const;
+        private:
+                friend class SharedPlayer;
+
+                /** The lock, version and players of a room. */
+                struct alignas(64) RoomState {
+                    std::mutex mutex; /**<Guards the room. */
+                    std::atomic<uint64_t> version{0}; /**<Changes of the room. */
+                    std::atomic<size_t> occupants{0}; /**<Players in the room. */
+                    /** Event queues of the players in the room, guarded by
+                     * mutex. Unused with a radius. */
+                    std::vector<EventQueue *> listeners;
+                };
+
+                /** Holds the locks of one or two rooms, taken in the order of
+                 * their ids. */
+                class RoomGuard {
+                        public:
+                                /** Locks the rooms.
+                                 *
+                                 * @param world The world of the rooms.
+                                 * @param first A room.
+                                 * @param second Another room, nullptr or the
+                                 * same room to only lock the first.
+                                 * */
+                                RoomGuard(SharedWorld &world, const Room *first,
+                                          const Room *second = nullptr);
+                                /** Unlocks the rooms. */
+                                ~RoomGuard(void);
+                                RoomGuard(const RoomGuard &) = delete;
+                                RoomGuard& operator = (const RoomGuard &) = delete;
+                        private:
+                                std::mutex *m_first = nullptr; /**<Lock taken first. */
+                                std::mutex *m_second = nullptr; /**<Lock taken second. */
+                };
+
+                /** Gets the state of a room.
+                 *
+                 * @param room The room.
+                 * @return The state.
+                 * */
+                RoomState& state(const Room *room) const;
+                /** Marks a room as changed, its lock must be held.
+                 *
+                 * @param room The room.
+                 * */
+                void changed(const Room *room);
+                /** Announces an event to the players in a room, or within
+                 * the radius of it, its lock must be held.
+                 *
+                 * The event is rendered once, only if someone listens, and
+                 * shared by all the recipients.
+                 *
+                 * @param room The room.
+                 * @param except The queue of the player causing the event,
+                 * it isn't sent the event.
+                 * @param actor The name of the player causing the event.
+                 * @param action What the player did.
+                 * @param object What the player did it to, empty for
+                 * nothing.
+                 * */
+                void announce(const Room *room, const EventQueue *except,
+                              const std::string &actor, const char *action,
+                              const std::string &object = "");
+
+                World m_world; /**<Owner of the rooms, items and enemies. */
+                Room *m_start = nullptr; /**<The room the players start in. */
+                std::unique_ptr<RoomState[]> m_rooms; /**<The state of each room by id. */
+                /** The players within the radius of each room, nullptr
+                 * without a radius. */
+                std::unique_ptr<InterestMap> m_interest;
+                std::shared_mutex m_interest_mutex; /**<Guards m_interest. */
+                /** Guards destroying items, which changes the free list of
+                 * the world. */
+                std::mutex m_destroy_mutex;
+                std::atomic<size_t> m_joined{0}; /**<Players that joined. */
+};
+
+/** A player acting in a SharedWorld.
+ *
+ * A SharedPlayer is used by one thread at a time, the world it acts in may
+ * be used by any number of threads.
+ * */
+class SharedPlayer {
+        public:
+                /** Constructor for SharedPlayer, enters the start room.
+                 *
+                 * @param world The world the player acts in.
+                 * @param room The room the player starts in, nullptr for the
+                 * start room of the world.
+                 * @param events Where the events of the rooms the player is
+                 * in are sent, nullptr to not listen.
+                 * */
+                SharedPlayer(SharedWorld &world, Room *room = nullptr,
+                             EventQueue *events = nullptr);
+                /** Destructor for SharedPlayer, leaves the room and the
+                 * InterestMap of the world. */
+                ~SharedPlayer(void);
+                SharedPlayer(const SharedPlayer &) = delete;
+                SharedPlayer& operator = (const SharedPlayer &) = delete;
+
+                /** Moves to the room in a direction.
+                 *
+                 * @param direction The direction.
+                 * @return The status of the move.
+                 * */
+                MoveStatus move(Direction direction);
+                /** Takes an item from the room.
+                 *
+                 * Only one of several players taking the same item gets it.
+                 *
+                 * @param item The name of the item.
+                 * @return The status of adding the item, INVALID_ITEM if the
+                 * item isn't in the room.
+                 * */
+                AddItemStatus take(const std::string &item);
+                /** Drops an item in the room.
+                 *
+                 * @param item The name of the item.
+                 * @return If the item was in the inventory.
+                 * */
+                bool drop(const std::string &item);
+                /** Uses a consumable in the inventory.
+                 *
+                 * @param item The name of the item.
+                 * @return If the item was in the inventory.
+                 * */
+                bool use(const std::string &item);
+                /** Kills an enemy in the room.
+                 *
+                 * @param enemy The name of the enemy.
+                 * @return The kill status.
+                 * */
+                KillStatus kill(const std::string &enemy);
+                /** Unlocks the locked rooms next to the room.
+                 *
+                 * @return If a room was unlocked, false without the Copper
+                 * Key.
+                 * */
+                bool unlock(void);
+                /** Describes the room.
+                 *
+                 * The description is only rebuilt when the room changed.
+                 *
+                 * @return The description of the room.
+                 * */
+                const std::string& look(void);
+
+                //////////
+                // Getters
+                /** Gets the player.
+                 *
+                 * @return The player.
+                 * */
+                Player& getPlayer(void);
+                /** Gets the room the player is in.
+                 *
+                 * @return The room.
+                 * */
+                Room* getRoom(void) const;
+                /** Gets the name the player is announced by.
+                 *
+                 * @return The name.
+                 * */
+                const std::string& getName(void) const;
+        private:
+                /** Starts listening to the events of the room and announces
+                 * the arrival, the lock of the room must be held.
+                 *
+                 * With a radius the interest of the player is moved to the
+                 * room.
+                 * */
+                void enter(void);
+                /** Stops listening to the events of the room and announces
+                 * the departure, the lock of the room must be held.
+                 *
+                 * With a radius the interest of the player is kept until it
+                 * enters the next room.
+                 * */
+                void leave(void);
+
+                SharedWorld &m_world; /**<The world the player acts in. */
+                Player m_player; /**<The player. */
+                Room *m_room; /**<The room the player is in. */
+                EventQueue *m_events; /**<Where the events are sent. */
+                std::string m_name; /**<The name the player is announced by. */
+                std::string m_description; /**<Last description of a room. */
+                const Room *m_described = nullptr; /**<Room of m_description. */
+                /** Version of the room of m_description. */
+                uint64_t m_described_version = 0;
+};
+
+#endif // SHARED_WORLD_H_
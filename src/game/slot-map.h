@@ -0,0 +1,277 @@
+#ifndef SLOT_MAP_H_
+#define SLOT_MAP_H_
+
+/** @file slot-map.h
+ *
+ * Header file containing a generational handle (Handle) and the slot map
+ * (SlotMap) that owns the objects the handles refers to.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** A 32-bit generational reference to an object owned by a SlotMap.
+ *
+ * The lower bits are the index of the slot and the upper bits are the
+ * generation of the slot when the object was inserted. When the object is
+ * erased the generation of the slot is bumped so any handle still pointing
+ * to it becomes stale. A value of 0 is never given out and is used as
+ * the null handle.
+ * */
+template <class T>
+class Handle {
+        public:
+                /** Number of bits used for the slot index. */
+                static constexpr uint32_t INDEX_BITS = 20;
+                /** Mask of the slot index. */
+                static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+                /** Largest generation a slot can have. */
+                static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+                /** Constructs a null handle. */
+                constexpr Handle(void) = default;
+                /** Constructs a null handle.
+                 *
+                 * This allows handles to be initialised and compared with
+                 * nullptr like the smart pointers they replace.
+                 * */
+                constexpr Handle(std::nullptr_t) {}
+                /** Constructs a handle from its raw value.
+                 *
+                 * @param value The raw value of the handle.
+                 * */
+                constexpr explicit Handle(uint32_t value): m_value(value) {}
+                /** Constructs a handle from a slot index and generation.
+                 *
+                 * @param index The index of the slot.
+                 * @param generation The generation of the slot.
+                 * @return The handle.
+                 * */
+                static constexpr Handle make(uint32_t index, uint32_t generation) {
+                    return Handle((generation << INDEX_BITS) | (index & INDEX_MASK));
+                }
+
+                //////////
+                // Getters
+                /** Gets the slot index of the handle.
+                 *
+                 * @return The slot index.
+                 * */
+                constexpr uint32_t getIndex(void) const {
+                    return this->m_value & INDEX_MASK;
+                }
+                /** Gets the generation of the handle.
+                 *
+                 * @return The generation.
+                 * */
+                constexpr uint32_t getGeneration(void) const {
+                    return this->m_value >> INDEX_BITS;
+                }
+                /** Gets the raw value of the handle.
+                 *
+                 * @return The raw value.
+                 * */
+                constexpr uint32_t getValue(void) const {
+                    return this->m_value;
+                }
+
+                ////////////
+                // Operators
+                /** Checks if the handle is not null.
+                 *
+                 * @note This doesn't check if the handle is stale.
+                 * */
+                constexpr explicit operator bool(void) const {
+                    return this->m_value != 0;
+                }
+                /** Checks if the handles are the same. */
+                constexpr bool operator == (Handle other) const {
+                    return this->m_value == other.m_value;
+                }
+                /** Checks if the handles are different. */
+                constexpr bool operator != (Handle other) const {
+                    return this->m_value != other.m_value;
+                }
+        private:
+                uint32_t m_value = 0; /**<Generation and index of the handle. */
+};
+
+/** Container owning objects and giving out Handle to them.
+ *
+ * Erased slots are reused through a free list so the storage never
+ * shrinks and handles are only ever invalidated by bumping the
+ * generation of the slot.
+ * */
+template <class T>
+class SlotMap {
+        public:
+                /** Function used to destroy an object in the slot map. */
+                using Deleter = void (*)(T *);
+
+                /** Constructor for SlotMap. */
+                SlotMap(void) = default;
+                SlotMap(const SlotMap &) = delete;
+                SlotMap& operator = (const SlotMap &) = delete;
+                /** Destructor of SlotMap.
+                 *
+                 * Destroys all the objects still in the slot map.
+                 * */
+                ~SlotMap(void) {
+                    for (Slot &slot: this->m_slots) {
+                        if (slot.object != nullptr) {
+                            slot.deleter(slot.object);
+                        }
+                    }
+                }
+
+                //////////
+                // Setters
+                /** Reserves slots so inserting up to a number of objects
+                 * doesn't grow the storage.
+                 *
+                 * @param count The number of objects.
+                 * */
+                void reserve(size_t count) {
+                    this->m_slots.reserve(count);
+                }
+                /** Takes ownership of an object.
+                 *
+                 * @param object The object to insert.
+                 * @param deleter The function used to destroy the object.
+                 * @return The handle to the object. A null handle is returned
+                 * if the slot map is full.
+                 * */
+                Handle<T> insert(T *object, Deleter deleter) {
+                    uint32_t index;
+                    if (!this->m_free.empty()) {
+                        index = this->m_free.back();
+                        this->m_free.pop_back();
+                    } else if (this->m_slots.size() <= Handle<T>::INDEX_MASK) {
+                        index = (uint32_t) this->m_slots.size();
+                        this->m_slots.emplace_back();
+                    } else {
+                        return nullptr;
+                    }
+
+                    Slot &slot = this->m_slots[index];
+                    slot.object = object;
+                    slot.deleter = deleter;
+                    this->m_size++;
+                    return Handle<T>::make(index, slot.generation);
+                }
+                /** Destroys the object the handle refers to.
+                 *
+                 * @param handle The handle of the object.
+                 * @return true if the object was destroyed, false if the
+                 * handle is stale or null.
+                 * */
+                bool erase(Handle<T> handle) {
+                    Slot *slot = this->find(handle);
+                    if (slot == nullptr) {
+                        return false;
+                    }
+
+                    T *object = slot->object;
+                    Deleter deleter = slot->deleter;
+                    slot->object = nullptr;
+                    // Generation 0 is reserved for the null handle
+                    if (slot->generation == Handle<T>::MAX_GENERATION) {
+                        slot->generation = 1;
+                    } else {
+                        slot->generation++;
+                    }
+                    this->m_free.push_back(handle.getIndex());
+                    this->m_size--;
+
+                    deleter(object);
+                    return true;
+                }
+
+                //////////
+                // Getters
+                /** Gets the object the handle refers to.
+                 *
+                 * @param handle The handle of the object.
+                 * @return The object. nullptr is returned if the handle is
+                 * stale or null.
+                 * */
+                T* get(Handle<T> handle) const {
+                    const Slot *slot = this->find(handle);
+                    return slot == nullptr ? nullptr : slot->object;
+                }
+                /** Checks if the handle refers to a live object.
+                 *
+                 * @param handle The handle of the object.
+                 * @return If the object is alive.
+                 * */
+                bool contains(Handle<T> handle) const {
+                    return this->find(handle) != nullptr;
+                }
+                /** Gets the handle of the object at the slot index.
+                 *
+                 * @param index The index of the slot.
+                 * @return The handle of the object. A null handle is returned
+                 * if the slot is empty or out of range.
+                 * */
+                Handle<T> handleAt(uint32_t index) const {
+                    if (index >= this->m_slots.size() ||
+                        this->m_slots[index].object == nullptr) {
+                        return nullptr;
+                    }
+                    return Handle<T>::make(index, this->m_slots[index].generation);
+                }
+                /** Gets the number of live objects.
+                 *
+                 * @return The number of live objects.
+                 * */
+                size_t size(void) const {
+                    return this->m_size;
+                }
+                /** Gets the number of slots, live or free.
+                 *
+                 * @return The number of slots.
+                 * */
+                size_t capacity(void) const {
+                    return this->m_slots.size();
+                }
+        private:
+                /** A slot of the slot map. */
+                struct Slot {
+                    T *object = nullptr; /**<The object, nullptr if free. */
+                    Deleter deleter = nullptr; /**<Destroys the object. */
+                    uint32_t generation = 1; /**<Current generation. */
+                };
+
+                /** Finds the slot of a live handle.
+                 *
+                 * @param handle The handle to find.
+                 * @return The slot, nullptr if the handle is stale or null.
+                 * */
+                const Slot* find(Handle<T> handle) const {
+                    uint32_t index = handle.getIndex();
+                    if (!handle || index >= this->m_slots.size()) {
+                        return nullptr;
+                    }
+                    const Slot &slot = this->m_slots[index];
+                    if (slot.object == nullptr ||
+                        slot.generation != handle.getGeneration()) {
+                        return nullptr;
+                    }
+                    return &slot;
+                }
+                /** Finds the slot of a live handle.
+                 *
+                 * @overload
+                 * */
+                Slot* find(Handle<T> handle) {
+                    return const_cast<Slot *>(
+                        static_cast<const SlotMap *>(this)->find(handle));
+                }
+
+                std::vector<Slot> m_slots; /**<All the slots. */
+                std::vector<uint32_t> m_free; /**<Indices of the free slots. */
+                size_t m_size = 0; /**<Number of live objects. */
+};
+
+#endif // SLOT_MAP_H_
@@ -0,0 +1,93 @@
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+/** @file spsc-queue.h
+ *
+ * Header file containing a bounded queue between one producer thread and
+ * one consumer thread.
+ * */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/** Bounded lock-free queue with a single producer and a single consumer.
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * each on its own cache line. Both keep a copy of the other index and only
+ * reload it when the copy says the queue is full or empty.
+ * */
+template <class T>
+class SpscQueue {
+        public:
+                /** Constructor for SpscQueue.
+                 *
+                 * @param capacity The least number of elements the queue
+                 * holds, rounded up to a power of two.
+                 * */
+                explicit SpscQueue(size_t capacity) {
+                    size_t size = 2;
+                    while (size < capacity) {
+                        size *= 2;
+                    }
+                    this->m_mask = size - 1;
+                    this->m_slots.reset(new T[size]);
+                }
+                SpscQueue(const SpscQueue &) = delete;
+                SpscQueue& operator = (const SpscQueue &) = delete;
+
+                /** Adds an element, only called by the producer.
+                 *
+                 * @param value The element.
+                 * @return If it was added, false if the queue is full.
+                 * */
+                bool push(const T &value) {
+                    size_t tail = this->m_producer.tail.load(std::memory_order_relaxed);
+                    if (tail - this->m_producer.head_cache > this->m_mask) {
+                        this->m_producer.head_cache =
+                            this->m_consumer.head.load(std::memory_order_acquire);
+                        if (tail - this->m_producer.head_cache > this->m_mask) {
+                            return false;
+                        }
+                    }
+                    this->m_slots[tail & this->m_mask] = value;
+                    this->m_producer.tail.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+                /** Takes the oldest element, only called by the consumer.
+                 *
+                 * @param value Where the element is stored.
+                 * @return If there was an element.
+                 * */
+                bool pop(T &value) {
+                    size_t head = this->m_consumer.head.load(std::memory_order_relaxed);
+                    if (head == this->m_consumer.tail_cache) {
+                        this->m_consumer.tail_cache =
+                            this->m_producer.tail.load(std::memory_order_acquire);
+                        if (head == this->m_consumer.tail_cache) {
+                            return false;
+                        }
+                    }
+                    value = this->m_slots[head & this->m_mask];
+                    this->m_consumer.head.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+        private:
+                /** Indices written by the producer. */
+                struct alignas(64) Producer {
+                    std::atomic<size_t> tail{0}; /**<Next slot to write. */
+                    size_t head_cache = 0; /**<Last head seen. */
+                };
+                /** Indices written by the consumer. */
+                struct alignas(64) Consumer {
+                    std::atomic<size_t> head{0}; /**<Next slot to read. */
+                    size_t tail_cache = 0; /**<Last tail seen. */
+                };
+
+                Producer m_producer; /**<Indices of the producer. */
+                Consumer m_consumer; /**<Indices of the consumer. */
+                size_t m_mask = 0; /**<Number of slots minus one. */
+                std::unique_ptr<T[]> m_slots; /**<The slots. */
+};
+
+#endif // SPSC_QUEUE_H_
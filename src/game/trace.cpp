@@ -0,0 +1,131 @@
+#include "trace.h"
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/** Guards the list of registered buffers. */
+static std::mutex registry_mutex;
+/** Buffers of every thread that recorded a span.
+ *
+ * The buffers are never freed so they can be exported after their thread
+ * exited.
+ * */
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+/** Start of the trace clock. */
+static const std::chrono::steady_clock::time_point trace_epoch =
+    std::chrono::steady_clock::now();
+
+///////////////
+// TraceBuffer
+/** Constructor for TraceBuffer.
+ *
+ * @param thread_id The id of the owning thread in the trace.
+ * */
+TraceBuffer::TraceBuffer(uint32_t thread_id):
+    m_events(new TraceEvent[CAPACITY]), m_head(0), m_tail(0), m_dropped(0),
+    m_thread_id(thread_id) {
+}
+
+/** Records a span, only called by the owning thread.
+ *
+ * @param name The name of the span.
+ * @param start_ns The start of the span.
+ * @param duration_ns The duration of the span.
+ * */
+void TraceBuffer::record(const char *name, uint64_t start_ns,
+                         uint64_t duration_ns) {
+    uint64_t head = this->m_head.load(std::memory_order_relaxed);
+    if (head - this->m_tail.load(std::memory_order_acquire) == CAPACITY) {
+        this->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    this->m_events[head % CAPACITY] = TraceEvent{name, start_ns, duration_ns};
+    this->m_head.store(head + 1, std::memory_order_release);
+}
+
+//////////
+// Getters
+/** Gets the number of events recorded but not drained yet.
+ *
+ * @return The number of events.
+ * */
+size_t TraceBuffer::size(void) const {
+    return this->m_head.load(std::memory_order_acquire) -
+        this->m_tail.load(std::memory_order_acquire);
+}
+
+/** Gets the id of the owning thread in the trace.
+ *
+ * @return The thread id.
+ * */
+uint32_t TraceBuffer::getThreadId(void) const {
+    return this->m_thread_id;
+}
+
+/////////////
+// Functions
+/** Gets the time of the trace clock.
+ *
+ * @return The nanoseconds since the trace clock started.
+ * */
+uint64_t traceNow(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - trace_epoch).count();
+}
+
+/** Gets the trace buffer of the calling thread.
+ *
+ * The buffer is created and registered the first time a thread calls it,
+ * later calls don't lock.
+ *
+ * @return The buffer of the thread.
+ * */
+TraceBuffer& threadTraceBuffer(void) {
+    thread_local TraceBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.emplace_back(new TraceBuffer(registry.size() + 1));
+        buffer = registry.back().get();
+    }
+    return *buffer;
+}
+
+/** Writes the spans of every thread as Chrome trace-event JSON and drains
+ * them, so the next export starts with the spans recorded after this one.
+ *
+ * @param out The stream to write to.
+ * */
+void writeChromeTrace(std::ostream &out) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\": [";
+    bool first = true;
+    for (const auto &buffer: registry) {
+        uint32_t thread_id = buffer->getThreadId();
+        uint64_t dropped = buffer->drain([&](const TraceEvent &event) {
+            out << (first ? "\n" : ",\n")
+                << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\""
+                << ", \"ts\": " << event.start_ns / 1000.0
+                << ", \"dur\": " << event.duration_ns / 1000.0
+                << ", \"pid\": 1, \"tid\": " << thread_id << "}";
+            first = false;
+        });
+        if (dropped > 0) {
+            out << (first ? "\n" : ",\n")
+                << "  {\"name\": \"dropped spans\", \"ph\": \"C\", \"ts\": 0"
+                << ", \"pid\": 1, \"tid\": " << thread_id
+                << ", \"args\": {\"dropped\": " << dropped << "}}";
+            first = false;
+        }
+    }
+    out << "\n], \"displayTimeUnit\": \"ns\"}" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
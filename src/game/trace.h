@@ -0,0 +1,152 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/** @file trace.h
+ *
+ * Header file containing the scoped trace spans of the game engine.
+ *
+ * Spans are recorded with GAME_TRACE_SCOPE() into a buffer owned by the
+ * recording thread and exported as Chrome trace-event JSON, which can be
+ * opened in chrome://tracing or Perfetto.
+ *
+ * Unless the game is built with GAME_TRACING, GAME_TRACE_SCOPE() expands to
+ * nothing and tracing has no cost.
+ * */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#ifdef GAME_TRACING
+#define GAME_TRACE_CONCAT_(a, b) a##b
+#define GAME_TRACE_CONCAT(a, b) GAME_TRACE_CONCAT_(a, b)
+/** Traces the rest of the enclosing scope as a span.
+ *
+ * @param name The name of the span, must be a string literal.
+ * */
+#define GAME_TRACE_SCOPE(name) \
+    TraceScope GAME_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define GAME_TRACE_SCOPE(name) ((void) 0)
+#endif
+
+/** A finished span. */
+struct TraceEvent {
+    const char *name; /**<Name of the span. */
+    uint64_t start_ns; /**<Start of the span since the trace clock started. */
+    uint64_t duration_ns; /**<Duration of the span. */
+};
+
+/** The spans recorded by a single thread.
+ *
+ * The buffer is a ring between the owning thread, which records events,
+ * and the exporter, which drains them. Each side publishes its position
+ * with a release store, so neither locks. Once the exporter falls
+ * CAPACITY events behind further spans are dropped instead of overwriting
+ * events it hasn't drained, until the next drain frees their slots.
+ * */
+class TraceBuffer {
+        public:
+                /** Number of events a buffer can hold. */
+                static constexpr size_t CAPACITY = 1 << 16;
+
+                /** Constructor for TraceBuffer.
+                 *
+                 * @param thread_id The id of the owning thread in the trace.
+                 * */
+                TraceBuffer(uint32_t thread_id);
+
+                /** Records a span, only called by the owning thread.
+                 *
+                 * @param name The name of the span.
+                 * @param start_ns The start of the span.
+                 * @param duration_ns The duration of the span.
+                 * */
+                void record(const char *name, uint64_t start_ns,
+                            uint64_t duration_ns);
+                /** Drains the recorded events, only called by one thread at
+                 * a time.
+                 *
+                 * @param visit Called with each event in the order they
+                 * were recorded.
+                 * @return The number of spans dropped since the last drain.
+                 * */
+                template<typename Visit>
+                uint64_t drain(Visit &&visit) {
+                    uint64_t head = this->m_head.load(std::memory_order_acquire);
+                    uint64_t tail = this->m_tail.load(std::memory_order_relaxed);
+                    for (; tail != head; tail++) {
+                        visit(this->m_events[tail % CAPACITY]);
+                    }
+                    this->m_tail.store(tail, std::memory_order_release);
+                    return this->m_dropped.exchange(0, std::memory_order_relaxed);
+                }
+
+                //////////
+                // Getters
+                /** Gets the number of events recorded but not drained yet.
+                 *
+                 * @return The number of events.
+                 * */
+                size_t size(void) const;
+                /** Gets the id of the owning thread in the trace.
+                 *
+                 * @return The thread id.
+                 * */
+                uint32_t getThreadId(void) const;
+        private:
+                std::unique_ptr<TraceEvent[]> m_events; /**<The events. */
+                std::atomic<uint64_t> m_head; /**<Number of recorded events. */
+                std::atomic<uint64_t> m_tail; /**<Number of drained events. */
+                std::atomic<uint64_t> m_dropped; /**<Spans dropped since the last drain. */
+                uint32_t m_thread_id; /**<Id of the owning thread. */
+};
+
+/** Gets the time of the trace clock.
+ *
+ * @return The nanoseconds since the trace clock started.
+ * */
+uint64_t traceNow(void);
+
+/** Gets the trace buffer of the calling thread.
+ *
+ * The buffer is created and registered the first time a thread calls it,
+ * later calls don't lock. The engine calls it when a game is constructed,
+ * so its first span doesn't allocate.
+ *
+ * @return The buffer of the thread.
+ * */
+TraceBuffer& threadTraceBuffer(void);
+
+/** Writes the spans of every thread as Chrome trace-event JSON and drains
+ * them, so the next export starts with the spans recorded after this one.
+ *
+ * @param out The stream to write to.
+ * */
+void writeChromeTrace(std::ostream &out);
+
+/** Records the lifetime of the object as a span. */
+class TraceScope {
+        public:
+                /** Constructor for TraceScope, starts the span.
+                 *
+                 * @param name The name of the span, must outlive the trace.
+                 * */
+                explicit TraceScope(const char *name):
+                    m_name(name), m_start(traceNow()) {}
+                /** Destructor for TraceScope, records the span. */
+                ~TraceScope(void) {
+                    threadTraceBuffer().record(this->m_name, this->m_start,
+                                               traceNow() - this->m_start);
+                }
+
+                TraceScope(const TraceScope&) = delete;
+                TraceScope& operator=(const TraceScope&) = delete;
+        private:
+                const char *m_name; /**<Name of the span. */
+                uint64_t m_start; /**<Start of the span. */
+};
+
+#endif // TRACE_H_
@@ -0,0 +1,223 @@
+#include "transcript.h"
+
+#include <string_view>
+
+#include "varint.h"
+
+/** Computes the checksum of the verbs of a game.
+ *
+ * @param verbs The verbs.
+ * @return The checksum.
+ * */
+uint32_t verbsChecksum(const std::vector<std::string> &verbs) {
+    // FNV-1a of the verbs each followed by a 0
+    uint32_t hash = 2166136261u;
+    for (const std::string &verb: verbs) {
+        for (char c: verb) {
+            hash = (hash ^ (unsigned char) c) * 16777619u;
+        }
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+///////////////////
+// TranscriptWriter
+/** Constructor for TranscriptWriter.
+ *
+ * The time of the commands is counted from now.
+ *
+ * @param verbs The verbs of the game, in lower case.
+ * */
+TranscriptWriter::TranscriptWriter(const std::vector<std::string> &verbs):
+    m_start(std::chrono::steady_clock::now()) {
+    writeVarint(this->m_data, VERSION);
+    writeVarint(this->m_data, verbsChecksum(verbs));
+    for (const std::string &verb: verbs) {
+        this->m_verbs.emplace(verb, this->m_verbs.size() + 1);
+    }
+}
+
+/** Records a command at the current time.
+ *
+ * @param command The command, already expanded and in lower case.
+ * */
+void TranscriptWriter::record(const std::string &command) {
+    this->record(command, std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - this->m_start).count());
+}
+
+/** Records a command at a given time.
+ *
+ * @param command The command, already expanded and in lower case.
+ * @param time Milliseconds since the transcript started, a time before the
+ * previous command is recorded as the time of the previous command.
+ * */
+void TranscriptWriter::record(const std::string &command, uint64_t time) {
+    // Splitting the verb, a command without a known verb is kept whole
+    std::string_view verb(command);
+    std::string_view argument;
+    bool has_argument = false;
+    size_t space = command.find(' ');
+    if (space != std::string::npos) {
+        verb = verb.substr(0, space);
+        argument = std::string_view(command).substr(space + 1);
+        has_argument = true;
+    }
+    uint64_t verb_id = 0;
+    auto found_verb = this->m_verbs.find(verb);
+    if (found_verb != this->m_verbs.end()) {
+        verb_id = found_verb->second;
+    } else {
+        argument = command;
+        has_argument = true;
+    }
+    writeVarint(this->m_data, verb_id << 1 | has_argument);
+
+    if (has_argument) {
+        auto found_argument = this->m_arguments.find(argument);
+        if (found_argument != this->m_arguments.end()) {
+            writeVarint(this->m_data, found_argument->second);
+        } else {
+            // A new argument is written after the next id
+            uint64_t id = this->m_arguments.size();
+            this->m_arguments.emplace(argument, id);
+            writeVarint(this->m_data, id);
+            writeVarint(this->m_data, argument.size());
+            this->m_data.append(argument);
+        }
+    }
+
+    if (time < this->m_last_time) {
+        time = this->m_last_time;
+    }
+    writeVarint(this->m_data, time - this->m_last_time);
+    this->m_last_time = time;
+    this->m_count++;
+}
+
+//////////
+// Getters
+/** Gets the transcript written so far.
+ *
+ * @return The transcript.
+ * */
+const std::string& TranscriptWriter::getData(void) const {
+    return this->m_data;
+}
+
+/** Gets the number of commands recorded.
+ *
+ * @return The number of commands.
+ * */
+size_t TranscriptWriter::getCount(void) const {
+    return this->m_count;
+}
+
+///////////////////
+// TranscriptReader
+/** Constructor for TranscriptReader.
+ *
+ * @param data The transcript, it must outlive the reader.
+ * @param verbs The verbs of the game the transcript was recorded from, the
+ * transcript is corrupt if they differ.
+ * */
+TranscriptReader::TranscriptReader(const std::string &data,
+                                   const std::vector<std::string> &verbs):
+    m_data(data), m_verbs(verbs) {
+    uint64_t version = 0;
+    uint64_t checksum = 0;
+    this->m_valid = readVarint(this->m_data, this->m_pos, version) &&
+                    version == TranscriptWriter::VERSION &&
+                    readVarint(this->m_data, this->m_pos, checksum) &&
+                    checksum == verbsChecksum(verbs);
+}
+
+/** Reads the next command.
+ *
+ * The strings of the entry stay valid as long as the reader.
+ *
+ * @param entry Where the command is stored.
+ * @return If a command was read, false at the end of the transcript or if
+ * it is corrupt.
+ * */
+bool TranscriptReader::next(TranscriptEntry &entry) {
+    if (!this->m_valid || this->atEnd()) {
+        return false;
+    }
+
+    uint64_t verb = 0;
+    if (!readVarint(this->m_data, this->m_pos, verb) ||
+        (verb >> 1) > this->m_verbs.size()) {
+        this->m_valid = false;
+        return false;
+    }
+    entry.verb = (verb >> 1) == 0 ? nullptr : &this->m_verbs[(verb >> 1) - 1];
+    entry.argument = nullptr;
+
+    if (verb & 1) {
+        uint64_t id = 0;
+        if (!readVarint(this->m_data, this->m_pos, id) ||
+            id > this->m_arguments.size()) {
+            this->m_valid = false;
+            return false;
+        }
+        if (id == this->m_arguments.size()) {
+            // The first use of an argument
+            this->m_arguments.emplace_back();
+            if (!this->readString(this->m_arguments.back())) {
+                this->m_valid = false;
+                return false;
+            }
+        }
+        entry.argument = &this->m_arguments[id];
+    } else if (entry.verb == nullptr) {
+        this->m_valid = false;
+        return false;
+    }
+
+    uint64_t delta = 0;
+    if (!readVarint(this->m_data, this->m_pos, delta)) {
+        this->m_valid = false;
+        return false;
+    }
+    this->m_time += delta;
+    entry.time = this->m_time;
+    return true;
+}
+
+//////////
+// Getters
+/** Checks if everything read so far was well formed.
+ *
+ * @return If the transcript isn't corrupt.
+ * */
+bool TranscriptReader::isValid(void) const {
+    return this->m_valid;
+}
+
+/** Checks if every command was read.
+ *
+ * @return If the end of the transcript was reached.
+ * */
+bool TranscriptReader::atEnd(void) const {
+    return this->m_pos >= this->m_data.size();
+}
+
+/////////
+// private
+/** Reads a length prefixed string.
+ *
+ * @param text Where the string is stored.
+ * @return If there was a whole string.
+ * */
+bool TranscriptReader::readString(std::string &text) {
+    uint64_t size = 0;
+    if (!readVarint(this->m_data, this->m_pos, size) ||
+        size > this->m_data.size() - this->m_pos) {
+        return false;
+    }
+    text.assign(this->m_data, this->m_pos, size);
+    this->m_pos += size;
+    return true;
+}
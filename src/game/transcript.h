@@ -0,0 +1,149 @@
+#ifndef TRANSCRIPT_H_
+#define TRANSCRIPT_H_
+
+/** @file transcript.h
+ *
+ * Header file containing the compact binary transcript of the commands a
+ * game processed, which can be replayed without parsing them again.
+ *
+ * A transcript starts with its version and a checksum of the verbs of the
+ * game it was recorded from, the verbs themselves aren't written. Every
+ * command is then a varint holding the id of its verb and if it has an
+ * argument, the id of the argument and the milliseconds since the previous
+ * command. An argument is written in full the first time it is used and by
+ * its id after that.
+ * */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+/** Computes the checksum of the verbs of a game.
+ *
+ * @param verbs The verbs.
+ * @return The checksum.
+ * */
+uint32_t verbsChecksum(const std::vector<std::string> &verbs);
+
+/** A command read from a transcript. */
+struct TranscriptEntry {
+        /** The verb, nullptr if the command didn't start with a verb of the
+         * game. */
+        const std::string *verb = nullptr;
+        /** The text after the verb, or the whole command without a verb,
+         * nullptr if there is none. */
+        const std::string *argument = nullptr;
+        uint64_t time = 0; /**<Milliseconds since the transcript started. */
+};
+
+/** Records the commands processed by a game into a transcript. */
+class TranscriptWriter {
+        public:
+                /** Version of the transcripts written. */
+                static constexpr uint64_t VERSION = 1;
+
+                /** Constructor for TranscriptWriter.
+                 *
+                 * The time of the commands is counted from now.
+                 *
+                 * @param verbs The verbs of the game, in lower case.
+                 * */
+                TranscriptWriter(const std::vector<std::string> &verbs);
+
+                /** Records a command at the current time.
+                 *
+                 * @param command The command, already expanded and in lower
+                 * case.
+                 * */
+                void record(const std::string &command);
+                /** Records a command at a given time.
+                 *
+                 * @param command The command, already expanded and in lower
+                 * case.
+                 * @param time Milliseconds since the transcript started, a
+                 * time before the previous command is recorded as the time
+                 * of the previous command.
+                 * */
+                void record(const std::string &command, uint64_t time);
+
+                //////////
+                // Getters
+                /** Gets the transcript written so far.
+                 *
+                 * @return The transcript.
+                 * */
+                const std::string& getData(void) const;
+                /** Gets the number of commands recorded.
+                 *
+                 * @return The number of commands.
+                 * */
+                size_t getCount(void) const;
+        private:
+                /** Ids of the verbs, 0 is for commands without a verb. */
+                std::map<std::string, uint64_t, std::less<>> m_verbs;
+                /** Ids of the arguments already written. */
+                std::map<std::string, uint64_t, std::less<>> m_arguments;
+                std::string m_data; /**<The transcript. */
+                size_t m_count = 0; /**<Number of commands recorded. */
+                uint64_t m_last_time = 0; /**<Time of the last command. */
+                /** When the transcript started. */
+                std::chrono::steady_clock::time_point m_start;
+};
+
+/** Reads the commands of a transcript in the order they were recorded. */
+class TranscriptReader {
+        public:
+                /** Constructor for TranscriptReader.
+                 *
+                 * @param data The transcript, it must outlive the reader.
+                 * @param verbs The verbs of the game the transcript was
+                 * recorded from, the transcript is corrupt if they differ.
+                 * */
+                TranscriptReader(const std::string &data,
+                                 const std::vector<std::string> &verbs);
+
+                /** Reads the next command.
+                 *
+                 * The strings of the entry stay valid as long as the reader.
+                 *
+                 * @param entry Where the command is stored.
+                 * @return If a command was read, false at the end of the
+                 * transcript or if it is corrupt.
+                 * */
+                bool next(TranscriptEntry &entry);
+
+                //////////
+                // Getters
+                /** Checks if everything read so far was well formed.
+                 *
+                 * @return If the transcript isn't corrupt.
+                 * */
+                bool isValid(void) const;
+                /** Checks if every command was read.
+                 *
+                 * @return If the end of the transcript was reached.
+                 * */
+                bool atEnd(void) const;
+        private:
+                /** Reads a length prefixed string.
+                 *
+                 * @param text Where the string is stored.
+                 * @return If there was a whole string.
+                 * */
+                bool readString(std::string &text);
+
+                const std::string &m_data; /**<The transcript. */
+                size_t m_pos = 0; /**<Position of the next command. */
+                bool m_valid = true; /**<If the transcript isn't corrupt. */
+                /** The verbs, the verb with id i is at i - 1. */
+                std::vector<std::string> m_verbs;
+                /** The arguments by id, a deque so they never move. */
+                std::deque<std::string> m_arguments;
+                uint64_t m_time = 0; /**<Time of the last command. */
+};
+
+#endif // TRANSCRIPT_H_
@@ -0,0 +1,58 @@
+#include "varint.h"
+
+/** Appends an unsigned integer.
+ *
+ * @param out Where the integer is appended.
+ * @param value The integer.
+ * */
+void writeVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char) value);
+}
+
+/** Appends a signed integer.
+ *
+ * @param out Where the integer is appended.
+ * @param value The integer.
+ * */
+void writeSignedVarint(std::string &out, int64_t value) {
+    writeVarint(out, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+/** Reads an unsigned integer.
+ *
+ * @param in The encoded data.
+ * @param pos The position of the integer, moved past it.
+ * @param value Where the integer is stored.
+ * @return If there was a whole integer at the position.
+ * */
+bool readVarint(const std::string &in, size_t &pos, uint64_t &value) {
+    value = 0;
+    for (size_t i = 0; i < MAX_VARINT_BYTES && pos < in.size(); i++) {
+        uint8_t byte = (uint8_t) in[pos++];
+        value |= (uint64_t) (byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Reads a signed integer.
+ *
+ * @param in The encoded data.
+ * @param pos The position of the integer, moved past it.
+ * @param value Where the integer is stored.
+ * @return If there was a whole integer at the position.
+ * */
+bool readSignedVarint(const std::string &in, size_t &pos, int64_t &value) {
+    uint64_t encoded;
+    if (!readVarint(in, pos, encoded)) {
+        return false;
+    }
+    value = (int64_t) (encoded >> 1) ^ -(int64_t) (encoded & 1);
+    return true;
+}
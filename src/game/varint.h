@@ -0,0 +1,50 @@
+#ifndef VARINT_H_
+#define VARINT_H_
+
+/** @file varint.h
+ *
+ * Header file containing the variable length encoding of integers used by
+ * the compact binary formats of the game.
+ *
+ * Every byte holds 7 bits of the integer, lowest first, with the top bit
+ * set when more bytes follow. Signed integers are zigzag encoded first so
+ * small negative numbers stay short.
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/** Most bytes a 64 bit integer takes. */
+constexpr size_t MAX_VARINT_BYTES = 10;
+
+/** Appends an unsigned integer.
+ *
+ * @param out Where the integer is appended.
+ * @param value The integer.
+ * */
+void writeVarint(std::string &out, uint64_t value);
+/** Appends a signed integer.
+ *
+ * @param out Where the integer is appended.
+ * @param value The integer.
+ * */
+void writeSignedVarint(std::string &out, int64_t value);
+/** Reads an unsigned integer.
+ *
+ * @param in The encoded data.
+ * @param pos The position of the integer, moved past it.
+ * @param value Where the integer is stored.
+ * @return If there was a whole integer at the position.
+ * */
+bool readVarint(const std::string &in, size_t &pos, uint64_t &value);
+/** Reads a signed integer.
+ *
+ * @param in The encoded data.
+ * @param pos The position of the integer, moved past it.
+ * @param value Where the integer is stored.
+ * @return If there was a whole integer at the position.
+ * */
+bool readSignedVarint(const std::string &in, size_t &pos, int64_t &value);
+
+#endif // VARINT_H_
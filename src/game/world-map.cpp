@@ -0,0 +1,99 @@
+#include "world-map.h"
+
+#include <vector>
+
+#include "enemies.h"
+#include "generics.h"
+#include "items.h"
+#include "room.h"
+#include "world.h"
+
+/** Creates an item of a map.
+ *
+ * @param world The world owning the item.
+ * @param spec The item.
+ * @return The handle to the item.
+ * */
+static ItemHandle createItem(World &world, const ItemSpec &spec) {
+    switch (spec.kind) {
+        case WEAPON_ITEM:
+            return world.createItem<Weapon>(spec.name, spec.value);
+        case CONSUMABLE_ITEM:
+            return world.createItem<Consumable>(spec.name, spec.value);
+        default:
+            return world.createItem<GenericItem>(spec.name);
+    }
+}
+
+/** Creates an enemy of a map.
+ *
+ * @param world The world owning the enemy.
+ * @param spec The enemy.
+ * @param item The item protected by the enemy.
+ * @return The handle to the enemy.
+ * */
+static EnemyHandle createEnemy(World &world, const EnemySpec &spec, ItemHandle item) {
+    switch (spec.kind) {
+        case WEREWOLF:
+            return world.createEnemy<Werewolf>(spec.health, spec.damage, spec.name, item);
+        case VAMPIRE:
+            return world.createEnemy<Vampire>(spec.health, spec.damage, spec.name, item);
+        default:
+            return world.createEnemy<GenericEnemy>(spec.health, spec.damage, spec.name, item);
+    }
+}
+
+/** Creates the rooms, items and enemies of a map.
+ *
+ * Every room reserves the names of all the items, so dropping an item
+ * anywhere doesn't grow the names of the room.
+ *
+ * @param world The world owning the map, it must not have any room yet.
+ * @param map The map, it must be valid.
+ * @return The room the player starts in.
+ *
+ * @see isValidMap
+ * */
+Room* buildMap(World &world, const WorldMap &map) {
+    world.reserve(map.room_count, map.item_count, map.enemy_count);
+
+    // Rooms, the exits are linked once both sides exist
+    for (size_t i = 0; i < map.room_count; i++) {
+        const RoomSpec &spec = map.rooms[i];
+        Room *room = world.createRoom(spec.name);
+        for (int direction = NORTH; direction <= WEST; direction++) {
+            int exit = spec.exits[direction];
+            if (exit != NO_SPEC && (size_t) exit < i) {
+                room->setRoom(world.getRoom(exit), (Direction) direction);
+            }
+        }
+        if (spec.locked) {
+            room->lockRoom();
+        }
+    }
+
+    // Any item can be dropped in any room, so every room has room for the
+    // names of all of them
+    PrefixTrie item_names;
+    for (size_t i = 0; i < map.item_count; i++) {
+        item_names.insert(map.items[i].name);
+    }
+    for (size_t i = 0; i < map.room_count; i++) {
+        world.getRoom(i)->reserveItemNames(item_names);
+    }
+
+    // Items and enemies
+    std::vector<ItemHandle> items;
+    items.reserve(map.item_count);
+    for (size_t i = 0; i < map.item_count; i++) {
+        items.push_back(createItem(world, map.items[i]));
+        world.getRoom(map.items[i].room)->addItem(items.back());
+    }
+    for (size_t i = 0; i < map.enemy_count; i++) {
+        const EnemySpec &spec = map.enemies[i];
+        ItemHandle item = spec.protects == NO_SPEC ? nullptr : items[spec.protects];
+        world.getRoom(spec.room)->addEnemey(createEnemy(world, spec, item));
+    }
+
+    return world.getRoom(map.start);
+}
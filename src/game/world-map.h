@@ -0,0 +1,155 @@
+#ifndef WORLD_MAP_H_
+#define WORLD_MAP_H_
+
+/** @file world-map.h
+ *
+ * Header file containing the tables describing a world at compile time and
+ * the function building a World from them.
+ * */
+
+#include <cstddef>
+
+#include "enemies.h"
+#include "room.h"
+#include "world.h"
+
+/** Index used when a room, item or enemy of a map isn't there. */
+constexpr int NO_SPEC = -1;
+
+/** Enumeration of the types of item of a map. */
+enum ItemSpecKind {
+PLAIN_ITEM, /**<A GenericItem. */
+WEAPON_ITEM, /**<A Weapon, the value is its damage. */
+CONSUMABLE_ITEM /**<A Consumable, the value is its healing. */
+};
+
+/** A room of a map. */
+struct RoomSpec {
+        const char *name; /**<Name of the room. */
+        int exits[4]; /**<Room in each Direction, NO_SPEC if there is none. */
+        bool locked; /**<If the room starts locked. */
+};
+
+/** An item of a map. */
+struct ItemSpec {
+        const char *name; /**<Name of the item. */
+        ItemSpecKind kind; /**<Type of the item. */
+        int value; /**<Damage or healing of the item. */
+        int room; /**<Room the item starts in. */
+};
+
+/** An enemy of a map. */
+struct EnemySpec {
+        const char *name; /**<Name of the enemy. */
+        EnemyKind kind; /**<Type of the enemy. */
+        int health; /**<Health of the enemy. */
+        int damage; /**<Damage of the enemy. */
+        int room; /**<Room the enemy is in. */
+        int protects; /**<Item protected by the enemy, NO_SPEC if none. */
+};
+
+/** A world described by tables.
+ *
+ * The rooms, items and enemies are created in the order of the tables, so
+ * a room has the id of its index.
+ * */
+struct WorldMap {
+        const RoomSpec *rooms; /**<The rooms. */
+        size_t room_count; /**<Number of rooms. */
+        const ItemSpec *items; /**<The items. */
+        size_t item_count; /**<Number of items. */
+        const EnemySpec *enemies; /**<The enemies. */
+        size_t enemy_count; /**<Number of enemies. */
+        int start; /**<Room the player starts in. */
+};
+
+/** Gets the opposite of a direction.
+ *
+ * @param direction The direction.
+ * @return The opposite direction.
+ * */
+constexpr int oppositeDirection(int direction) {
+    return direction ^ 1;
+}
+
+/** Checks if an index refers to an entry of a table.
+ *
+ * @param index The index.
+ * @param count The number of entries of the table.
+ * @return If the index is in range.
+ * */
+constexpr bool isMapIndex(int index, size_t count) {
+    return index >= 0 && (size_t) index < count;
+}
+
+/** Checks that every exit of a map leads back to the room it is in.
+ *
+ * @param map The map.
+ * @return If the exits are reciprocal.
+ * */
+constexpr bool hasReciprocalExits(const WorldMap &map) {
+    for (size_t room = 0; room < map.room_count; room++) {
+        for (int direction = NORTH; direction <= WEST; direction++) {
+            int exit = map.rooms[room].exits[direction];
+            if (exit == NO_SPEC) {
+                continue;
+            }
+            if (!isMapIndex(exit, map.room_count) || (size_t) exit == room ||
+                map.rooms[exit].exits[oppositeDirection(direction)] != (int) room) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** Checks that the items and enemies of a map are in its rooms, and that
+ * protected items are in the room of their enemy.
+ *
+ * @param map The map.
+ * @return If the items and enemies are placed correctly.
+ * */
+constexpr bool hasPlacedEntities(const WorldMap &map) {
+    for (size_t item = 0; item < map.item_count; item++) {
+        if (!isMapIndex(map.items[item].room, map.room_count)) {
+            return false;
+        }
+    }
+    for (size_t enemy = 0; enemy < map.enemy_count; enemy++) {
+        const EnemySpec &spec = map.enemies[enemy];
+        if (!isMapIndex(spec.room, map.room_count)) {
+            return false;
+        }
+        if (spec.protects != NO_SPEC &&
+            (!isMapIndex(spec.protects, map.item_count) ||
+             map.items[spec.protects].room != spec.room)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Checks that a map can be built.
+ *
+ * @param map The map.
+ * @return If the map is valid.
+ * */
+constexpr bool isValidMap(const WorldMap &map) {
+    return isMapIndex(map.start, map.room_count) && hasReciprocalExits(map) &&
+           hasPlacedEntities(map);
+}
+
+/** Creates the rooms, items and enemies of a map.
+ *
+ * Every room reserves the names of all the items, so dropping an item
+ * anywhere doesn't grow the names of the room.
+ *
+ * @param world The world owning the map, it must not have any room yet.
+ * @param map The map, it must be valid.
+ * @return The room the player starts in.
+ *
+ * @see isValidMap
+ * */
+Room* buildMap(World &world, const WorldMap &map);
+
+#endif // WORLD_MAP_H_
@@ -0,0 +1,383 @@
+#include "world-partition.h"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <thread>
+#include <utility>
+
+#include "inventory.h"
+
+/** Gets the next random number of a xorshift generator.
+ *
+ * @param state The state of the generator, never 0.
+ * @return The random number.
+ * */
+static uint32_t nextRandom(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/** Visits the rooms of a world in breadth first order.
+ *
+ * Rooms not reachable from the start are visited after, from the room
+ * with the lowest id not seen yet.
+ *
+ * @param world The world.
+ * @param start The id of the first room.
+ * @return The ids of the rooms in the order they were visited.
+ * */
+static std::vector<size_t> breadthFirstOrder(const World &world, size_t start) {
+    std::vector<bool> seen(world.roomCount(), false);
+    std::vector<size_t> order;
+    order.reserve(world.roomCount());
+    size_t next_unseen = 0;
+    while (order.size() < world.roomCount()) {
+        if (seen[start]) {
+            while (seen[next_unseen]) {
+                next_unseen++;
+            }
+            start = next_unseen;
+        }
+        seen[start] = true;
+        size_t head = order.size();
+        order.push_back(start);
+        for (; head < order.size(); head++) {
+            Room *room = world.getRoom(order[head]);
+            for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+                Room *exit = room->getRoom(direction);
+                if (exit != nullptr && !seen[exit->getId()]) {
+                    seen[exit->getId()] = true;
+                    order.push_back(exit->getId());
+                }
+            }
+        }
+    }
+    return order;
+}
+
+/** Splits the rooms of a world into partitions of about the same size.
+ *
+ * Each partition grows from a room at the edge of the rooms left, always
+ * taking next the room with the most exits into it and the fewest to rooms
+ * left. Rooms on the border of a partition are then moved to the partition
+ * of most of their exits while that lowers the cut and keeps the sizes
+ * balanced.
+ *
+ * @param world The world.
+ * @param parts The number of partitions, at least 1.
+ * @return The partition.
+ * */
+WorldPartition partitionWorld(const World &world, size_t parts) {
+    WorldPartition partition;
+    partition.parts = std::max<size_t>(parts, 1);
+    size_t rooms = world.roomCount();
+    partition.part.assign(rooms, 0);
+    if (rooms == 0 || partition.parts == 1) {
+        return partition;
+    }
+
+    // Growing every partition from a room at the edge of the rooms left
+    std::vector<size_t> order = breadthFirstOrder(world, breadthFirstOrder(world, 0).back());
+    size_t capacity = (rooms + partition.parts - 1) / partition.parts;
+    std::vector<size_t> sizes(partition.parts, 0);
+    const uint32_t unassigned = (uint32_t) partition.parts;
+    partition.part.assign(rooms, unassigned);
+    size_t next_seed = 0;
+    for (uint32_t part = 0; part < partition.parts; part++) {
+        size_t target = part + 1 == partition.parts ? rooms : capacity * (part + 1);
+        std::priority_queue<std::tuple<int, int64_t, size_t>> frontier;
+        int64_t added = 0;
+        auto gain = [&](size_t id) {
+            int links = 0;
+            for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+                Room *exit = world.getRoom(id)->getRoom(direction);
+                if (exit != nullptr) {
+                    uint32_t other = partition.part[exit->getId()];
+                    links += other == part ? 1 : other == unassigned ? -1 : 0;
+                }
+            }
+            return links;
+        };
+        size_t assigned = std::accumulate(sizes.begin(), sizes.end(), (size_t) 0);
+        while (assigned < target) {
+            if (frontier.empty()) {
+                while (partition.part[order[next_seed]] != unassigned) {
+                    next_seed++;
+                }
+                frontier.emplace(gain(order[next_seed]), 0, order[next_seed]);
+            }
+            auto [room_gain, age, id] = frontier.top();
+            frontier.pop();
+            (void) age;
+            if (partition.part[id] != unassigned || room_gain != gain(id)) {
+                continue;
+            }
+            partition.part[id] = part;
+            sizes[part]++;
+            assigned++;
+            for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+                Room *exit = world.getRoom(id)->getRoom(direction);
+                if (exit != nullptr && partition.part[exit->getId()] == unassigned) {
+                    frontier.emplace(gain(exit->getId()), --added, exit->getId());
+                }
+            }
+        }
+    }
+
+    // Moving border rooms, every move lowers the cut so it ends
+    size_t max_size = capacity + capacity / 20;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (size_t id = 0; id < rooms; id++) {
+            uint32_t own = partition.part[id];
+            uint32_t neighbours[4];
+            size_t count = 0;
+            for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+                Room *exit = world.getRoom(id)->getRoom(direction);
+                if (exit != nullptr) {
+                    neighbours[count++] = partition.part[exit->getId()];
+                }
+            }
+
+            auto links = [&](uint32_t part) {
+                return std::count(neighbours, neighbours + count, part);
+            };
+            uint32_t best = own;
+            for (size_t i = 0; i < count; i++) {
+                if (links(neighbours[i]) > links(best) &&
+                    sizes[neighbours[i]] < max_size) {
+                    best = neighbours[i];
+                }
+            }
+            if (best != own && sizes[own] > 1) {
+                partition.part[id] = best;
+                sizes[own]--;
+                sizes[best]++;
+                improved = true;
+            }
+        }
+    }
+
+    partition.cut_edges = countCutEdges(world, partition.part);
+    return partition;
+}
+
+/** Counts the exits between rooms of different partitions.
+ *
+ * Every pair of linked rooms is counted once.
+ *
+ * @param world The world.
+ * @param part The partition of each room by id.
+ * @return The number of exits cut.
+ * */
+size_t countCutEdges(const World &world, const std::vector<uint32_t> &part) {
+    size_t cut = 0;
+    for (size_t id = 0; id < world.roomCount(); id++) {
+        for (Direction direction: {NORTH, SOUTH, EAST, WEST}) {
+            Room *exit = world.getRoom(id)->getRoom(direction);
+            if (exit != nullptr && exit->getId() > id &&
+                part[exit->getId()] != part[id]) {
+                cut++;
+            }
+        }
+    }
+    return cut;
+}
+
+/////////////////////
+// PartitionedWorld
+/** Constructor for Walker.
+ *
+ * @param world The world owning the items.
+ * @param room The room the player starts in.
+ * @param seed The seed of the random numbers.
+ * @param steps The number of steps.
+ * */
+PartitionedWorld::Walker::Walker(World *world, Room *room, uint32_t seed,
+                                 size_t steps):
+    player(12, 1, 3, *world), room(room), random(seed == 0 ? 1 : seed),
+    steps(steps) {
+}
+
+/** Constructor for PartitionedWorld.
+ *
+ * @param world The world, its rooms must not be used by anything else while
+ * players run.
+ * @param workers The number of workers, at least 1.
+ * */
+PartitionedWorld::PartitionedWorld(World &world, size_t workers):
+    m_world(world), m_workers(std::max<size_t>(workers, 1)),
+    m_partition(partitionWorld(world, m_workers)),
+    m_starting(m_workers) {
+    for (size_t i = 0; i < this->m_workers * this->m_workers; i++) {
+        this->m_queues.emplace_back(new SpscQueue<Walker *>(QUEUE_CAPACITY));
+    }
+}
+
+/** Runs players wandering the world.
+ *
+ * Every step a player picks up an item in the room, drops one or neither,
+ * and then takes a random exit. The route of a player only depends on the
+ * seed, so the number of handoffs doesn't depend on the timing of the
+ * workers. At the end the players drop what they carry.
+ *
+ * @param players The number of players, spread over the rooms.
+ * @param steps The number of steps of each player.
+ * @param seed The seed of the random numbers.
+ * @return The work done.
+ * */
+WalkStats PartitionedWorld::walk(size_t players, size_t steps, uint32_t seed) {
+    WalkStats total;
+    size_t rooms = this->m_world.roomCount();
+    if (rooms == 0 || players == 0) {
+        return total;
+    }
+
+    std::deque<Walker> walkers;
+    for (size_t i = 0; i < players; i++) {
+        Room *room = this->m_world.getRoom(i * rooms / players);
+        walkers.emplace_back(&this->m_world, room, seed + (uint32_t) i * 2654435761u, steps);
+        this->m_starting[this->m_partition.part[room->getId()]].push_back(&walkers.back());
+    }
+    this->m_players = steps == 0 ? 0 : players;
+    this->m_finished.store(0, std::memory_order_relaxed);
+
+    std::vector<WalkStats> stats(this->m_workers);
+    std::vector<std::thread> threads;
+    for (size_t worker = 1; worker < this->m_workers; worker++) {
+        threads.emplace_back(&PartitionedWorld::work, this, worker, std::ref(stats[worker]));
+    }
+    this->work(0, stats[0]);
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    // The items carried stay in the world for the next walk
+    for (Walker &walker: walkers) {
+        for (unsigned int slot = 0; slot < walker.player.getInventory()->maxSize(); slot++) {
+            ItemHandle item = walker.player.dropItem((int) slot);
+            if (item != nullptr) {
+                walker.room->addItem(item);
+            }
+        }
+    }
+
+    for (const WalkStats &worker: stats) {
+        total.steps += worker.steps;
+        total.handoffs += worker.handoffs;
+        total.items_taken += worker.items_taken;
+    }
+    return total;
+}
+
+//////////
+// Getters
+/** Gets the partition of the rooms.
+ *
+ * @return The partition.
+ * */
+const WorldPartition& PartitionedWorld::getPartition(void) const {
+    return this->m_partition;
+}
+
+/////////
+// private
+/** Runs the players of a partition until every player is done.
+ *
+ * @param worker The worker.
+ * @param stats Where the work done by the worker is stored.
+ * */
+void PartitionedWorld::work(size_t worker, WalkStats &stats) {
+    std::vector<Walker *> residents = std::move(this->m_starting[worker]);
+    this->m_starting[worker].clear();
+    // Handoffs waiting for space in a full queue
+    std::vector<std::pair<size_t, Walker *>> pending;
+
+    while (this->m_finished.load(std::memory_order_acquire) < this->m_players) {
+        for (size_t from = 0; from < this->m_workers; from++) {
+            Walker *arrived;
+            while (from != worker && this->queue(from, worker).pop(arrived)) {
+                residents.push_back(arrived);
+            }
+        }
+        for (size_t i = 0; i < pending.size();) {
+            if (this->queue(worker, pending[i].first).push(pending[i].second)) {
+                pending[i] = pending.back();
+                pending.pop_back();
+            } else {
+                i++;
+            }
+        }
+        if (residents.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < residents.size();) {
+            Walker *walker = residents[i];
+            Room *room = walker->room;
+            uint32_t random = nextRandom(walker->random);
+            walker->steps--;
+            stats.steps++;
+
+            // Picking up or dropping an item
+            if (random & 1) {
+                ItemHandle item = room->removeItem();
+                if (item != nullptr) {
+                    if (walker->player.addItem(item) == SUCCESS) {
+                        stats.items_taken++;
+                    } else {
+                        room->addItem(item);
+                    }
+                }
+            } else if (random & 2) {
+                int slot = (int) ((random >> 2) % walker->player.getInventory()->maxSize());
+                ItemHandle item = walker->player.dropItem(slot);
+                if (item != nullptr) {
+                    room->addItem(item);
+                }
+            }
+
+            // Moving, into another partition hands the player over and the
+            // walker belongs to the other worker once it is pushed
+            Room *next = room->getRoom((Direction) ((random >> 8) % 4));
+            if (next != nullptr && !next->isLocked()) {
+                walker->room = next;
+            }
+            size_t owner = this->m_partition.part[walker->room->getId()];
+            bool leaves = true;
+            if (walker->steps == 0) {
+                this->m_finished.fetch_add(1, std::memory_order_release);
+            } else if (owner != worker) {
+                stats.handoffs++;
+                if (!this->queue(worker, owner).push(walker)) {
+                    pending.emplace_back(owner, walker);
+                }
+            } else {
+                leaves = false;
+            }
+            if (leaves) {
+                residents[i] = residents.back();
+                residents.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+}
+
+/** Gets the queue from a worker to another.
+ *
+ * @param from The sending worker.
+ * @param to The receiving worker.
+ * @return The queue.
+ * */
+SpscQueue<PartitionedWorld::Walker *>& PartitionedWorld::queue(size_t from, size_t to) {
+    return *this->m_queues[from * this->m_workers + to];
+}
@@ -0,0 +1,145 @@
+#ifndef WORLD_PARTITION_H_
+#define WORLD_PARTITION_H_
+
+/** @file world-partition.h
+ *
+ * Header file containing the partitioning of the rooms of a world and the
+ * workers each running the players in one partition.
+ * */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "player.h"
+#include "room.h"
+#include "spsc-queue.h"
+#include "world.h"
+
+/** Partition of the rooms of a world. */
+struct WorldPartition {
+        size_t parts = 0; /**<Number of partitions. */
+        std::vector<uint32_t> part; /**<Partition of each room by id. */
+        size_t cut_edges = 0; /**<Exits between rooms of different partitions. */
+};
+
+/** Splits the rooms of a world into partitions of about the same size.
+ *
+ * Each partition grows from a room at the edge of the rooms left, always
+ * taking next the room with the most exits into it and the fewest to rooms
+ * left. Rooms on the border of a partition are then moved to the partition
+ * of most of their exits while that lowers the cut and keeps the sizes
+ * balanced.
+ *
+ * @param world The world.
+ * @param parts The number of partitions, at least 1.
+ * @return The partition.
+ * */
+WorldPartition partitionWorld(const World &world, size_t parts);
+
+/** Counts the exits between rooms of different partitions.
+ *
+ * Every pair of linked rooms is counted once.
+ *
+ * @param world The world.
+ * @param part The partition of each room by id.
+ * @return The number of exits cut.
+ * */
+size_t countCutEdges(const World &world, const std::vector<uint32_t> &part);
+
+/** Work done by the players of a PartitionedWorld. */
+struct WalkStats {
+        uint64_t steps = 0; /**<Steps taken by the players. */
+        uint64_t handoffs = 0; /**<Moves into another partition. */
+        uint64_t items_taken = 0; /**<Items picked up. */
+};
+
+/** A world whose partitions are each owned by one worker thread.
+ *
+ * Only the worker owning a partition touches its rooms, so the players in
+ * it run without locks. A player moving into another partition is handed
+ * to the worker owning it through the SpscQueue between the two workers.
+ * */
+class PartitionedWorld {
+        public:
+                /** Number of players a handoff queue holds. */
+                static constexpr size_t QUEUE_CAPACITY = 1024;
+
+                /** Constructor for PartitionedWorld.
+                 *
+                 * @param world The world, its rooms must not be used by
+                 * anything else while players run.
+                 * @param workers The number of workers, at least 1.
+                 * */
+                PartitionedWorld(World &world, size_t workers);
+
+                /** Runs players wandering the world.
+                 *
+                 * Every step a player picks up an item in the room, drops
+                 * one or neither, and then takes a random exit. The route of
+                 * a player only depends on the seed, so the number of
+                 * handoffs doesn't depend on the timing of the workers. At
+                 * the end the players drop what they carry.
+                 *
+                 * @param players The number of players, spread over the
+                 * rooms.
+                 * @param steps The number of steps of each player.
+                 * @param seed The seed of the random numbers.
+                 * @return The work done.
+                 * */
+                WalkStats walk(size_t players, size_t steps, uint32_t seed);
+
+                //////////
+                // Getters
+                /** Gets the partition of the rooms.
+                 *
+                 * @return The partition.
+                 * */
+                const WorldPartition& getPartition(void) const;
+        private:
+                /** A player wandering the world. */
+                struct Walker {
+                    Player player; /**<The player. */
+                    Room *room; /**<The room the player is in. */
+                    uint32_t random; /**<State of the random numbers. */
+                    size_t steps; /**<Steps left. */
+
+                    /** Constructor for Walker.
+                     *
+                     * @param world The world owning the items.
+                     * @param room The room the player starts in.
+                     * @param seed The seed of the random numbers.
+                     * @param steps The number of steps.
+                     * */
+                    Walker(World *world, Room *room, uint32_t seed, size_t steps);
+                };
+
+                /** Runs the players of a partition until every player is
+                 * done.
+                 *
+                 * @param worker The worker.
+                 * @param stats Where the work done by the worker is stored.
+                 * */
+                void work(size_t worker, WalkStats &stats);
+                /** Gets the queue from a worker to another.
+                 *
+                 * @param from The sending worker.
+                 * @param to The receiving worker.
+                 * @return The queue.
+                 * */
+                SpscQueue<Walker *>& queue(size_t from, size_t to);
+
+                World &m_world; /**<The world. */
+                size_t m_workers; /**<Number of workers. */
+                WorldPartition m_partition; /**<Partition owned by each worker. */
+                /** Handoff queues, from * m_workers + to. */
+                std::vector<std::unique_ptr<SpscQueue<Walker *>>> m_queues;
+                /** Players each worker starts with. */
+                std::vector<std::vector<Walker *>> m_starting;
+                std::atomic<size_t> m_finished{0}; /**<Players done. */
+                size_t m_players = 0; /**<Players running. */
+};
+
+#endif // WORLD_PARTITION_H_
@@ -0,0 +1,166 @@
+#include "world.h"
+
+#include <cstdint>
+
+#include "generics.h"
+#include "enemies.h"
+#include "room.h"
+
+/** Constructor for World. */
+World::World(void) {
+}
+
+/** Destructor for World, deletes the rooms. */
+World::~World(void) {
+    for (Room *room: this->m_rooms) {
+        delete room;
+    }
+}
+
+//////////
+// Setters
+/** Reserves storage for the rooms, items and enemies of the world.
+ *
+ * @param rooms The number of rooms.
+ * @param items The number of items.
+ * @param enemies The number of enemies.
+ * */
+void World::reserve(size_t rooms, size_t items, size_t enemies) {
+    this->m_rooms.reserve(rooms);
+    this->m_items.reserve(items);
+    this->m_enemies.reserve(enemies);
+}
+
+/** Creates a new room in the world.
+ *
+ * @param name The name of the room.
+ * @return The new room, its id is the number of rooms created before it.
+ * */
+Room* World::createRoom(std::string name) {
+    Room *room = new Room(name, *this, this->m_rooms.size());
+    this->m_rooms.push_back(room);
+    return room;
+}
+
+/** Destroys an item in the world.
+ *
+ * @param item The item to destroy.
+ * @return true if the item was destroyed, false if the handle is stale.
+ * */
+bool World::destroyItem(ItemHandle item) {
+    return this->m_items.erase(item);
+}
+
+/** Destroys an enemy in the world.
+ *
+ * @param enemy The enemy to destroy.
+ * @return true if the enemy was destroyed, false if the handle is stale.
+ * */
+bool World::destroyEnemy(EnemyHandle enemy) {
+    return this->m_enemies.erase(enemy);
+}
+
+//////////
+// Getters
+/** Gets the item the handle refers to.
+ *
+ * @param item The handle of the item.
+ * @return The item. nullptr is returned if the handle is stale.
+ * */
+GenericItem* World::getItem(ItemHandle item) const {
+    return this->m_items.get(item);
+}
+
+/** Gets the enemy the handle refers to.
+ *
+ * @param enemy The handle of the enemy.
+ * @return The enemy. nullptr is returned if the handle is stale.
+ * */
+GenericEnemy* World::getEnemy(EnemyHandle enemy) const {
+    return this->m_enemies.get(enemy);
+}
+
+/** Gets a room of the world.
+ *
+ * @param id The id of the room.
+ * @return The room. nullptr is returned if there is no room with the id.
+ * */
+Room* World::getRoom(size_t id) const {
+    if (id >= this->m_rooms.size()) {
+        return nullptr;
+    }
+    return this->m_rooms[id];
+}
+
+/** Gets the number of items in the world.
+ *
+ * @return The number of items.
+ * */
+size_t World::itemCount(void) const {
+    return this->m_items.size();
+}
+
+/** Gets the number of enemies in the world.
+ *
+ * @return The number of enemies.
+ * */
+size_t World::enemyCount(void) const {
+    return this->m_enemies.size();
+}
+
+////////////
+// private
+/** Attaches a newly created enemy to the world.
+ *
+ * @param enemy The new enemy.
+ * */
+void World::attachEnemy(GenericEnemy *enemy) {
+    enemy->setWorld(this);
+}
+
+/** Gets the number of rooms in the world.
+ *
+ * @return The number of rooms.
+ * */
+size_t World::roomCount(void) const {
+    return this->m_rooms.size();
+}
+
+/** Gets the handle of the item in a slot of the world.
+ *
+ * Slots are numbered in the order items were first created, so worlds built
+ * the same way number their items the same.
+ *
+ * @param index The index of the slot.
+ * @return The handle. A null handle is returned if the slot is empty or out
+ * of range.
+ * */
+ItemHandle World::itemAt(size_t index) const {
+    return index > UINT32_MAX ? nullptr : this->m_items.handleAt((uint32_t) index);
+}
+
+/** Gets the handle of the enemy in a slot of the world.
+ *
+ * @param index The index of the slot.
+ * @return The handle. A null handle is returned if the slot is empty or out
+ * of range.
+ * */
+EnemyHandle World::enemyAt(size_t index) const {
+    return index > UINT32_MAX ? nullptr : this->m_enemies.handleAt((uint32_t) index);
+}
+
+/** Gets the number of item slots, live or free.
+ *
+ * @return The number of slots.
+ * */
+size_t World::itemSlots(void) const {
+    return this->m_items.capacity();
+}
+
+/** Gets the number of enemy slots, live or free.
+ *
+ * @return The number of slots.
+ * */
+size_t World::enemySlots(void) const {
+    return this->m_enemies.capacity();
+}
@@ -0,0 +1,205 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+/** @file world.h
+ *
+ * Header file containing the World that owns all the items and enemies of
+ * an adventure game.
+ * */
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "object-pool.h"
+#include "slot-map.h"
+
+class GenericItem;
+class GenericEnemy;
+class Room;
+
+/** Handle to an item owned by a World. */
+using ItemHandle = Handle<GenericItem>;
+/** Handle to an enemy owned by a World. */
+using EnemyHandle = Handle<GenericEnemy>;
+
+/** Owner of the rooms, items and enemies of an adventure game.
+ *
+ * Rooms, inventories and enemies only store handles to the objects in the
+ * world. Moving an item between them is a handle copy and a handle to a
+ * destroyed object is detected instead of keeping the object alive.
+ *
+ * Rooms live as long as the world and are numbered in the order they were
+ * created. Items and enemies are allocated from the ObjectPool of their
+ * type.
+ * */
+class World {
+        public:
+                /** Constructor for World. */
+                World(void);
+                /** Destructor for World, deletes the rooms. */
+                ~World(void);
+                World(const World &) = delete;
+                World& operator = (const World &) = delete;
+
+                //////////
+                // Setters
+                /** Reserves storage for the rooms, items and enemies of
+                 * the world.
+                 *
+                 * @param rooms The number of rooms.
+                 * @param items The number of items.
+                 * @param enemies The number of enemies.
+                 * */
+                void reserve(size_t rooms, size_t items, size_t enemies);
+                /** Creates a new room in the world.
+                 *
+                 * @param name The name of the room.
+                 * @return The new room, its id is the number of rooms
+                 * created before it.
+                 * */
+                Room* createRoom(std::string name);
+                /** Creates a new item in the world.
+                 *
+                 * @code
+                 * ItemHandle sword = world.createItem<Weapon>("Sword", 2);
+                 * @endcode
+                 *
+                 * @param args The arguments to the constructor of the item.
+                 * @return The handle to the new item.
+                 * */
+                template <class T, class... Args>
+                ItemHandle createItem(Args&&... args) {
+                    T *item = ObjectPool<T>::create(std::forward<Args>(args)...);
+                    ItemHandle handle = this->m_items.insert(item, &World::destroy<GenericItem, T>);
+                    // The world is full
+                    if (handle == nullptr) {
+                        ObjectPool<T>::destroy(item);
+                    }
+                    return handle;
+                }
+                /** Creates a new enemy in the world.
+                 *
+                 * The item the enemy is protecting is made unable to be
+                 * picked up.
+                 *
+                 * @code
+                 * EnemyHandle dracula = world.createEnemy<Vampire>(12, 3, "Dracula", key);
+                 * @endcode
+                 *
+                 * @param args The arguments to the constructor of the enemy.
+                 * @return The handle to the new enemy.
+                 * */
+                template <class T, class... Args>
+                EnemyHandle createEnemy(Args&&... args) {
+                    T *enemy = ObjectPool<T>::create(std::forward<Args>(args)...);
+                    EnemyHandle handle = this->m_enemies.insert(enemy, &World::destroy<GenericEnemy, T>);
+                    // The world is full
+                    if (handle == nullptr) {
+                        ObjectPool<T>::destroy(enemy);
+                    } else {
+                        this->attachEnemy(enemy);
+                    }
+                    return handle;
+                }
+                /** Destroys an item in the world.
+                 *
+                 * @param item The item to destroy.
+                 * @return true if the item was destroyed, false if the
+                 * handle is stale.
+                 * */
+                bool destroyItem(ItemHandle item);
+                /** Destroys an enemy in the world.
+                 *
+                 * @param enemy The enemy to destroy.
+                 * @return true if the enemy was destroyed, false if the
+                 * handle is stale.
+                 * */
+                bool destroyEnemy(EnemyHandle enemy);
+
+                //////////
+                // Getters
+                /** Gets the item the handle refers to.
+                 *
+                 * @param item The handle of the item.
+                 * @return The item. nullptr is returned if the handle is stale.
+                 * */
+                GenericItem* getItem(ItemHandle item) const;
+                /** Gets the enemy the handle refers to.
+                 *
+                 * @param enemy The handle of the enemy.
+                 * @return The enemy. nullptr is returned if the handle is stale.
+                 * */
+                GenericEnemy* getEnemy(EnemyHandle enemy) const;
+                /** Gets a room of the world.
+                 *
+                 * @param id The id of the room.
+                 * @return The room. nullptr is returned if there is no room
+                 * with the id.
+                 * */
+                Room* getRoom(size_t id) const;
+                /** Gets the number of items in the world.
+                 *
+                 * @return The number of items.
+                 * */
+                size_t itemCount(void) const;
+                /** Gets the number of enemies in the world.
+                 *
+                 * @return The number of enemies.
+                 * */
+                size_t enemyCount(void) const;
+                /** Gets the number of rooms in the world.
+                 *
+                 * @return The number of rooms.
+                 * */
+                size_t roomCount(void) const;
+                /** Gets the handle of the item in a slot of the world.
+                 *
+                 * Slots are numbered in the order items were first created,
+                 * so worlds built the same way number their items the same.
+                 *
+                 * @param index The index of the slot.
+                 * @return The handle. A null handle is returned if the slot
+                 * is empty or out of range.
+                 * */
+                ItemHandle itemAt(size_t index) const;
+                /** Gets the handle of the enemy in a slot of the world.
+                 *
+                 * @param index The index of the slot.
+                 * @return The handle. A null handle is returned if the slot
+                 * is empty or out of range.
+                 * */
+                EnemyHandle enemyAt(size_t index) const;
+                /** Gets the number of item slots, live or free.
+                 *
+                 * @return The number of slots.
+                 * */
+                size_t itemSlots(void) const;
+                /** Gets the number of enemy slots, live or free.
+                 *
+                 * @return The number of slots.
+                 * */
+                size_t enemySlots(void) const;
+        private:
+                /** Destroys an object created by the world, giving its
+                 * slot back to the pool of its type.
+                 *
+                 * @param object The object to destroy.
+                 * */
+                template <class Base, class T>
+                static void destroy(Base *object) {
+                    ObjectPool<T>::destroy(static_cast<T *>(object));
+                }
+                /** Attaches a newly created enemy to the world.
+                 *
+                 * @param enemy The new enemy.
+                 * */
+                void attachEnemy(GenericEnemy *enemy);
+
+                SlotMap<GenericItem> m_items; /**<All the items in the world. */
+                SlotMap<GenericEnemy> m_enemies; /**<All the enemies in the world. */
+                std::vector<Room *> m_rooms; /**<All the rooms in the world by id. */
+};
+
+#endif // WORLD_H_